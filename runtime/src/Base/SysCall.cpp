@@ -7,7 +7,9 @@
 
 #include "SysCall.h"
 
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 #if defined(_WIN64)
 #include <processthreadsapi.h>
@@ -17,6 +19,7 @@
 #include "linux/futex.h"
 #include "sys/syscall.h"
 #endif
+#include "Base/Log.h"
 
 namespace MapleRuntime {
 #ifndef SYS_futex
@@ -56,4 +59,22 @@ int GetPid()
     return syscall(SYS_getpid);
 #endif
 }
+
+bool WriteAll(int fd, const void* data, size_t size)
+{
+    const char* pos = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, pos, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            LOG(RTLOG_ERROR, "Write fd %d failed. msg: %s", fd, strerror(errno));
+            return false;
+        }
+        pos += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
 } // namespace MapleRuntime
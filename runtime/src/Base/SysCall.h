@@ -7,6 +7,7 @@
 
 #ifndef MRT_SYSCALL_H
 #define MRT_SYSCALL_H
+#include <cstddef>
 #include <ctime>
 #if defined(_WIN64)
 #include <pthread.h>
@@ -27,6 +28,9 @@ pid_t GetTid();
 
 int GetPid();
 
+// Write all of `size` bytes to `fd`, retrying on EINTR and short writes.
+bool WriteAll(int fd, const void* data, size_t size);
+
 #if defined(__linux__) || defined(hongmeng)
 #ifndef PR_SET_VMA
 #define PR_SET_VMA 0x53564d41
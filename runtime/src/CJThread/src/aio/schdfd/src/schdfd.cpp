@@ -7,10 +7,14 @@
 
 #include <cerrno>
 #include <cstdint>
+#ifndef MRT_WINDOWS
+#include <poll.h>
+#endif
 #include "schdfd_impl.h"
 #include "schedule_impl.h"
 #include "processor.h"
 #include "timer_impl.h"
+#include "basetime.h"
 #include "securec.h"
 #include "log.h"
 #include "external.h"
@@ -22,6 +26,9 @@ extern "C" {
 #ifdef MRT_WINDOWS
 const int PROTOCOL_BUF_SIZE = 32;
 bool g_iocpCompleteSkipFlag = false;
+#else
+// A wait longer than busyPollMax * SCHDFD_BUSY_POLL_IDLE_FACTOR marks the fd as idle and clears its budget.
+const unsigned long long SCHDFD_BUSY_POLL_IDLE_FACTOR = 4;
 #endif
 
 static inline struct SchdfdSlot **SchdfdLoadLayerSlots(struct SchdfdManager *schdfdManager, int layerIndex)
@@ -428,6 +435,100 @@ void WakeallFd(SignedSocket fd)
     SchdfdDecref(fd, false);
 }
 
+#ifndef MRT_WINDOWS
+/* Poll fd without blocking until it is ready, the deadline passes, or the processor has other work.
+ * Returns true if the fd is ready for the given type.
+ */
+static bool SchdfdBusyPoll(SignedSocket fd, struct SchdfdFd *schdFd, SchdpollEventType type,
+                           unsigned long long deadline)
+{
+    struct Processor *processor = ProcessorGet();
+    std::atomic<uintptr_t> *waiter = (type == SHCDPOLL_READ) ? &schdFd->pd->cjthread.readWaiter :
+                                                               &schdFd->pd->cjthread.writeWaiter;
+    struct pollfd pfd;
+
+    pfd.fd = fd;
+    pfd.events = (type == SHCDPOLL_READ) ? POLLIN : POLLOUT;
+    do {
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 0) > 0) {
+            return true;
+        }
+        // Stop spinning once netpoll has delivered the event or the fd is closing, and never
+        // delay other runnable cjthreads of this processor.
+        if (atomic_load_explicit(waiter, std::memory_order_relaxed) != PD_NOWAIT ||
+            (processor != nullptr && ProcessorHasReady(processor))) {
+            return false;
+        }
+    } while (CurrentNanotimeGet() < deadline);
+    return false;
+}
+
+/* Learn the busy-poll budget of fd from the latest wait time. A wait finished during spinning
+ * widens the budget, a short park sets it to cover the wait, and a long park shrinks it until
+ * idle fds stop spinning.
+ */
+static void SchdfdBusyPollLearn(unsigned int *budget, unsigned long long waitNs, bool spinHit,
+                                unsigned long long busyPollMax)
+{
+    unsigned long long next;
+
+    if (spinHit) {
+        next = *budget + (*budget >> 1);
+    } else if (waitNs <= busyPollMax) {
+        next = waitNs + (waitNs >> 1);
+    } else if (waitNs <= busyPollMax * SCHDFD_BUSY_POLL_IDLE_FACTOR) {
+        next = *budget >> 1;
+    } else {
+        next = 0;
+    }
+    *budget = static_cast<unsigned int>(next > busyPollMax ? busyPollMax : next);
+}
+#endif
+
+/* Busy-poll fd within its learned budget and park the cjthread if the event does not arrive.
+ * Only one cjthread waits for the same fd and type, so the budget is not updated concurrently.
+ */
+static bool SchdfdSpinThenWait(SignedSocket fd, struct SchdfdFd *schdFd, SchdpollEventType type)
+{
+#ifdef MRT_WINDOWS
+    (void)fd;
+    return SchdpollWait(schdFd->pd, type);
+#else
+    struct SchdfdManager *schdfdManager = g_scheduleManager.schdfdManager;
+    unsigned long long busyPollMax = schdfdManager->busyPollMax;
+    unsigned int *budget;
+    unsigned long long start;
+    unsigned long long spinEnd;
+    unsigned long long end;
+    bool ready;
+
+    if (busyPollMax == 0) {
+        return SchdpollWait(schdFd->pd, type);
+    }
+    budget = (type == SHCDPOLL_READ) ? &schdFd->readSpinBudget : &schdFd->writeSpinBudget;
+    start = CurrentNanotimeGet();
+    spinEnd = start;
+    if (*budget != 0) {
+        ready = SchdfdBusyPoll(fd, schdFd, type, start + *budget);
+        spinEnd = CurrentNanotimeGet();
+        atomic_fetch_add_explicit(&schdfdManager->spinNs, spinEnd - start, std::memory_order_relaxed);
+        if (ready) {
+            atomic_fetch_add_explicit(&schdfdManager->spinHitCnt, 1ULL, std::memory_order_relaxed);
+            SchdfdBusyPollLearn(budget, spinEnd - start, true, busyPollMax);
+            return true;
+        }
+    }
+
+    ready = SchdpollWait(schdFd->pd, type);
+    end = CurrentNanotimeGet();
+    atomic_fetch_add_explicit(&schdfdManager->parkCnt, 1ULL, std::memory_order_relaxed);
+    atomic_fetch_add_explicit(&schdfdManager->parkNs, end - spinEnd, std::memory_order_relaxed);
+    SchdfdBusyPollLearn(budget, end - start, false, busyPollMax);
+    return ready;
+#endif
+}
+
 /* SchdfdWait cannot be called concurrently between the same fd and type,
  * and may require calling SchdfdLock/SchdfdUnlock to lock during concurrency.
  * SchdfdWaitInlock can be called for better performance.
@@ -453,7 +554,7 @@ int SchdfdWait(SignedSocket fd, SchdpollEventType type)
         return ERRNO_SCHDFD_NOT_ADD_NETPOLL;
     }
 
-    if (!SchdpollWait(schdFd->pd, type)) {
+    if (!SchdfdSpinThenWait(fd, schdFd, type)) {
         SchdfdDecref(fd, false);
         return ERRNO_SCHDFD_FD_CLOSING;
     }
@@ -478,7 +579,7 @@ int SchdfdWaitInlock(SignedSocket fd, SchdpollEventType type)
         LOG_ERROR(ERRNO_SCHDFD_NOT_ADD_NETPOLL, "fd %u not yet add to netpoll", fd);
         return ERRNO_SCHDFD_NOT_ADD_NETPOLL;
     }
-    if (!SchdpollWait(schdFd->pd, type)) {
+    if (!SchdfdSpinThenWait(fd, schdFd, type)) {
         return ERRNO_SCHDFD_FD_CLOSING;
     }
     return 0;
@@ -1638,7 +1638,8 @@ int SockRecvNonBlockGeneral(int fd, void *buf, unsigned int len, SocketFlag flag
     int cycles = 0;
     bool scheduleFree = false;
     struct ScheduleProcessor *schdProcessor = &(ScheduleGet()->schdProcessor);
-    unsigned int freeThreshold = schdProcessor->processorNum / PROCESSOR_FREE_RATIO;
+    unsigned int freeThreshold =
+        atomic_load_explicit(&schdProcessor->activeNum, std::memory_order_relaxed) / PROCESSOR_FREE_RATIO;
 
     do {
         recvRet = recv(fd, buf, static_cast<size_t>(len), flags);
@@ -107,6 +107,8 @@ struct SchdfdFd {
     struct SchdpollDesc *pd;      // schdpoll descriptor
     std::atomic<uintptr_t> readTimer;
     std::atomic<uintptr_t> writeTimer;
+    unsigned int readSpinBudget;  // Learned busy-poll budget before parking on read, ns
+    unsigned int writeSpinBudget; // Learned busy-poll budget before parking on write, ns
 #ifdef MRT_WINDOWS
     struct IocpOperation readOperation;  // IOCP read operation structure
     struct IocpOperation writeOperation; // IOCP write operation structure
@@ -132,6 +134,12 @@ struct SchdfdManager {
     struct SchdfdSlot **slots[SCHDFD_SLOTS_MAX_LAYER];   /* Global three-dimensional array of fd slots.
                                                             The maximum number of three-dimensional
                                                             arrays is 256 x 4096 x 4096. */
+    unsigned long long busyPollMax;                      /* Upper bound of the per-fd busy-poll budget, ns.
+                                                            0 means busy-poll is disabled. */
+    std::atomic<unsigned long long> spinHitCnt;          // Waits satisfied while busy-polling
+    std::atomic<unsigned long long> spinNs;              // Total time spent busy-polling, ns
+    std::atomic<unsigned long long> parkCnt;             // Waits that parked after busy-poll missed
+    std::atomic<unsigned long long> parkNs;              // Total time spent parked, ns
 };
 
 struct SchdfdManager* SchdfdManagerInit();
@@ -21,6 +21,11 @@ struct SchdfdManager *SchdfdManagerInit()
     for (int i = 0; i < SCHDFD_SLOTS_MAX_LAYER; i++) {
         schdfdManager->slots[i] = nullptr;
     }
+    schdfdManager->busyPollMax = 0;
+    schdfdManager->spinHitCnt.store(0);
+    schdfdManager->spinNs.store(0);
+    schdfdManager->parkCnt.store(0);
+    schdfdManager->parkNs.store(0);
     if (pthread_mutex_init(&schdfdManager->initLock, nullptr) != 0) {
         free(schdfdManager);
         return nullptr;
@@ -40,6 +40,7 @@ extern "C" {
 #define MID_HANDLE_POOL          MID_MAKE(19)
 #define MID_YTLS                 MID_MAKE(20)
 #define MID_TRACE                MID_MAKE(21)
+#define MID_FILEIO               MID_MAKE(22)
 
 #ifdef __cplusplus
 #if __cplusplus
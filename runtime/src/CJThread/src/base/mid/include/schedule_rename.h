@@ -194,13 +194,19 @@
 #define CJThreadeStateHookRegister             CJ_CJThreadStateHookRegister
 #define CJThreadMpark                          CJ_CJThreadMpark
 #define CJThreadPark                           CJ_CJThreadPark
+#define CJThreadParkFor                        CJ_CJThreadParkFor
+#define CJThreadParkHookSet                    CJ_CJThreadParkHookSet
 #define CJThreadWait                           CJ_CJThreadWait
 #define CJThreadResumeAndWait                  CJ_CJThreadResumeAndWait
 #define CJThreadMresched                       CJ_CJThreadMresched
 #define CJThreadResched                        CJ_CJThreadResched
 #define CJThreadPreemptResched                 CJ_CJThreadPreemptResched
+#define CJThreadWakeHandoff                    CJ_CJThreadWakeHandoff
 #define CJThreadReady                          CJ_CJThreadReady
 #define CJThreadAddBatch                       CJ_CJThreadAddBatch
+#define CJThreadNewBatch                       CJ_CJThreadNewBatch
+#define CJThreadSpawnBatchBegin                CJ_CJThreadSpawnBatchBegin
+#define CJThreadSpawnBatchEnd                  CJ_CJThreadSpawnBatchEnd
 #define CJThreadId                             CJ_CJThreadId
 #define CJThreadGetId                          CJ_CJThreadGetId
 #define CJThreadGetHandle                      CJ_CJThreadGetHandle
@@ -214,6 +220,7 @@
 #define CJThreadAttrStackSizeSet               CJ_CJThreadAttrStackSizeSet
 #define CJThreadAttrNameSet                    CJ_CJThreadAttrNameSet
 #define CJThreadAttrCjFromCSet                 CJ_CJThreadAttrCJFromCSet
+#define CJThreadAttrPrioritySet                CJ_CJThreadAttrPrioritySet
 #define CJThreadNewSetLocalData                CJ_CJThreadNewSetLocalData
 #define CJThreadNewSetAttr                     CJ_CJThreadNewSetAttr
 #define CJThreadAttrSpecificSet                CJ_CJThreadAttrSpecificSet
@@ -290,6 +297,8 @@
 #define ProcessorFree                           CJ_ProcessorFree
 #define ProcessorNonDefaultScheduleWake         CJ_ProcessorNonDefaultScheduleWake
 #define ProcessorWake                           CJ_ProcessorWake
+#define ProcessorWakeBatch                      CJ_ProcessorWakeBatch
+#define ProcessorSpinCap                        CJ_ProcessorSpinCap
 #define ProcessorAlloc                          CJ_ProcessorAlloc
 #define ProcessorThreadExit                     CJ_ProcessorThreadExit
 #define ProcessorGetspecific                    CJ_ProcessorGetSpecific
@@ -299,11 +308,16 @@
 #define ProcessorFreelistPop                    CJ_ProcessorFreelistPop
 #define ProcessorFreelistPut                    CJ_ProcessorFreelistPut
 #define ProcessorFreelistGet                    CJ_ProcessorFreelistGet
+#define ProcessorFreelistGetBatch               CJ_ProcessorFreelistGetBatch
 #define ProcessorStartBoundCJThread             CJ_ProcessorStartBoundCJThread
 #define ProcessorStopBoundCJThread              CJ_ProcessorStopBoundCJThread
 #define ProcessorNewId                          CJ_ProcessorNewId
 #define ProcessorId                             CJ_ProcessorId
+#define ProcessorIdTry                          CJ_ProcessorIdTry
 #define ProcessorCanSpin                        CJ_ProcessorCanSpin
+#define ProcessorSlotGet                        CJ_ProcessorSlotGet
+#define ProcessorSlotRunning                    CJ_ProcessorSlotRunning
+#define ProcessorSlotFind                       CJ_ProcessorSlotFind
 
 /* schdpoll */
 #define SchdpollInit                            CJ_SchdpollInit
@@ -337,6 +351,14 @@
 #define ScheduleAttrProcessorNumSet             CJ_ScheduleAttrProcessorNumSet
 #define ScheduleAttrStackProtectSet             CJ_ScheduleAttrStackProtectSet
 #define ScheduleAttrStackGrowSet                CJ_ScheduleAttrStackGrowSet
+#define ScheduleAttrBusyPollSet                 CJ_ScheduleAttrBusyPollSet
+#define ScheduleAttrPreemptSliceSet             CJ_ScheduleAttrPreemptSliceSet
+#define ScheduleAttrCpuPinSet                   CJ_ScheduleAttrCpuPinSet
+#define ScheduleAttrWakeHandoffSet              CJ_ScheduleAttrWakeHandoffSet
+#define ScheduleAttrSchmonBackoffSet            CJ_ScheduleAttrSchmonBackoffSet
+#define ScheduleAttrProcessorMaxSet             CJ_ScheduleAttrProcessorMaxSet
+#define ScheduleAttrCpuQuotaSet                 CJ_ScheduleAttrCpuQuotaSet
+#define ScheduleAttrParkSpinSet                 CJ_ScheduleAttrParkSpinSet
 #define ScheduleAttrRegisterFuncSet             CJ_ScheduleAttrRegisterFuncSet
 #define ScheduleRecursiveLockCreate             CJ_ScheduleRecursiveLockCreate
 #define ScheduleProcessorInit                   CJ_ScheduleProcessorInit
@@ -380,8 +402,28 @@
 #define ScheduleCJThreadCount                   CJ_ScheduleCJThreadCount
 #define ScheduleCJThreadCountPublic             CJ_ScheduleCJThreadCountPublic
 #define ScheduleRunningOSThreadCount            CJ_ScheduleRunningOSThreadCount
+#define ScheduleBusyPollStatsGet                CJ_ScheduleBusyPollStatsGet
+#define SchedulePreemptStatsGet                 CJ_SchedulePreemptStatsGet
+#define ScheduleStealStatsGet                   CJ_ScheduleStealStatsGet
+#define ScheduleWakeStatsGet                    CJ_ScheduleWakeStatsGet
+#define ScheduleProcessorNumSet                 CJ_ScheduleProcessorNumSet
+#define ScheduleProcessorNumGet                 CJ_ScheduleProcessorNumGet
+#define ScheduleProcessorStatsGet               CJ_ScheduleProcessorStatsGet
+#define ScheduleParkStatsGet                    CJ_ScheduleParkStatsGet
+#define ScheduleStackStatsGet                   CJ_ScheduleStackStatsGet
+#define ScheduleProcessorLoadGet                CJ_ScheduleProcessorLoadGet
+#define ScheduleTimerNumGet                     CJ_ScheduleTimerNumGet
+#define ScheduleLatencyStatsSet                 CJ_ScheduleLatencyStatsSet
+#define ScheduleLatencyStatsGet                 CJ_ScheduleLatencyStatsGet
+#define ScheduleLatencyBucketLower              CJ_ScheduleLatencyBucketLower
+#define ScheduleAttrStackReclaimSet             CJ_ScheduleAttrStackReclaimSet
+#define StackReclaimInit                        CJ_StackReclaimInit
+#define StackReclaimCheck                       CJ_StackReclaimCheck
+#define StackResidentSize                       CJ_StackResidentSize
+#define ScheduleBlockingHandoffCount            CJ_ScheduleBlockingHandoffCount
 #define SchdProcessorHookRegister               CJ_SchdProcessorHookRegister
 #define SchdSchmonHookRegister                  CJ_SchdSchmonHookRegister
+#define SchdSchmonDeadlineHookRegister          CJ_SchdSchmonDeadlineHookRegister
 #define SchdExitHookRegister                    CJ_SchdExitHookRegister
 #define SchdCheckExistenceHookRegister          CJ_SchdCheckExistenceHookRegister
 #define SchdCheckReadyHookRegister              CJ_SchdCheckReadyHookRegister
@@ -410,6 +452,8 @@
 #define ScheduleStartTrace                      CJ_ScheduleStartTrace
 #define ScheduleStopTrace                       CJ_ScheduleStopTrace
 #define ScheduleDumpTrace                       CJ_ScheduleDumpTrace
+#define ScheduleStartFlightRecorder             CJ_ScheduleStartFlightRecorder
+#define ScheduleDumpFlightRecorder              CJ_ScheduleDumpFlightRecorder
 #define ScheduleGetTraceReader                  CJ_ScheduleGetTraceReader
 #define ScheduleTraceEventOrigin                CJ_ScheduleTraceEventOrigin
 #define ScheduleTraceEvent                      CJ_ScheduleTraceEvent
@@ -428,8 +472,27 @@
 #define SchmonCheckAllprocessors                CJ_SchmonCheckAllProcessors
 #define SchmonRemovelistClear                   CJ_SchmonRemovelistClear
 #define SchmonCJThreadPoolClean                CJ_SchmonCJThreadPoolClean
+#define SchmonCpuQuotaCheck                     CJ_SchmonCpuQuotaCheck
 #define SchmonEntry                             CJ_SchmonEntry
 #define SchmonStart                             CJ_SchmonStart
+#define SchmonPreemptSliceBegin                 CJ_SchmonPreemptSliceBegin
+#define SchmonPreemptTimerDisarm                CJ_SchmonPreemptTimerDisarm
+#define SchmonPreemptOverrunRecord              CJ_SchmonPreemptOverrunRecord
+#define SchmonKick                              CJ_SchmonKick
+#define SchmonKickFini                          CJ_SchmonKickFini
+
+/* topology */
+#define TopologyInit                             CJ_TopologyInit
+#define TopologyFini                             CJ_TopologyFini
+#define TopologyPinCpu                           CJ_TopologyPinCpu
+#define TopologyThreadPin                        CJ_TopologyThreadPin
+#define TopologyThreadUnpin                      CJ_TopologyThreadUnpin
+#define TopologyCurrentCpu                       CJ_TopologyCurrentCpu
+
+/* cpu quota */
+#define CpuQuotaInit                             CJ_CpuQuotaInit
+#define CpuQuotaRead                             CJ_CpuQuotaRead
+#define CpuQuotaProcessorNum                     CJ_CpuQuotaProcessorNum
 
 /* thread */
 #define ThreadSleep                              CJ_ThreadSleep
@@ -490,6 +553,7 @@
 #define TimerTryStop                             CJ_TimerTryStop
 #define TimerExit                                CJ_TimerExit
 #define TimerSchmonCheck                         CJ_TimerSchmonCheck
+#define TimerSchmonDeadline                      CJ_TimerSchmonDeadline
 #define TimerCheckReady                          CJ_TimerCheckReady
 #define TimerNum                                 CJ_TimerNum
 #define ScheduleTimerHookInit                    CJ_ScheduleTimerHookInit
@@ -508,6 +572,7 @@
 #define WaitqueuePark                            CJ_WaitqueuePark
 #define WaitqueueWakeOne                         CJ_WaitqueueWakeOne
 #define WaitqueueWakeAll                         CJ_WaitqueueWakeAll
+#define WaitqueueRequeue                         CJ_WaitqueueRequeue
 #define WaitqueueDelete                          CJ_WaitqueueDelete
 #define WaitqueueNodeNew                         CJ_WaitqueueNodeNew
 #define WaitqueuePush                            CJ_WaitqueuePush
@@ -515,11 +580,20 @@
 #define WaitqueueWakePreparation                 CJ_WaitqueueWakePreparation
 #define WaitqueueGetWaitNum                      CJ_WaitqueueGetWaitNum
 
+/* fileio */
+#define FileioSubmit                             CJ_FileioSubmit
+#define FileioRead                               CJ_FileioRead
+#define FileioWrite                              CJ_FileioWrite
+#define FileioSync                               CJ_FileioSync
+#define FileioStatsGet                           CJ_FileioStatsGet
+
 /* syscall_impl */
 #define SyscallEnter                             CJ_SyscallEnter
 #define SyscallFastExit                          CJ_SyscallFastExit
 #define SyscallExit0                             CJ_SyscallExit0
 #define SyscallExit                              CJ_SyscallExit
+#define SyscallBlockingRegionEnter               CJ_SyscallBlockingRegionEnter
+#define SyscallBlockingRegionExit                CJ_SyscallBlockingRegionExit
 
 /* syscall_linux */
 #define SyscallRead                              CJ_SyscallRead
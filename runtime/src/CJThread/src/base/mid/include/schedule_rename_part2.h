@@ -57,6 +57,9 @@
 #define TraceReaderGet                            CJ_TraceReaderGet
 #define TraceRegister                             CJ_TraceRegister
 #define TraceDeregister                           CJ_TraceDeregister
+#define TraceFlightRecorderStart                  CJ_TraceFlightRecorderStart
+#define TraceFlightRecorderStop                   CJ_TraceFlightRecorderStop
+#define TraceFlightRecorderDump                   CJ_TraceFlightRecorderDump
 
 #endif
 
@@ -0,0 +1,131 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#ifndef MRT_FILEIO_H
+#define MRT_FILEIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "mid.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/**
+* @brief 0x10160001 Failed to initialize the io_uring instance, the worker pool is used instead
+*/
+#define ERRNO_FILEIO_URING_INIT_FAILED ((MID_FILEIO) | 0x001)
+
+/**
+* @brief 0x10160002 Failed to create the file I/O worker thread
+*/
+#define ERRNO_FILEIO_WORKER_CREATE_FAILED ((MID_FILEIO) | 0x002)
+
+/**
+* @brief 0x10160003 Failed to initialize the file I/O engine
+*/
+#define ERRNO_FILEIO_INIT_FAILED ((MID_FILEIO) | 0x003)
+
+/**
+ * @brief Operation type of a file I/O request
+ */
+enum FileioOpType {
+    FILEIO_OP_READ = 0,         /* read at offset, or at the current file position if offset is -1 */
+    FILEIO_OP_WRITE,            /* write at offset, or at the current file position if offset is -1 */
+    FILEIO_OP_FSYNC,            /* flush file data and metadata */
+    FILEIO_OP_FDATASYNC,        /* flush file data only */
+    FILEIO_OP_BUTT
+};
+
+/**
+ * @brief Engine that executes the file I/O requests
+ */
+enum FileioEngineType {
+    FILEIO_ENGINE_NONE = 0,     /* not initialized, requests are executed inline */
+    FILEIO_ENGINE_URING,        /* io_uring, with the worker pool for unsupported requests */
+    FILEIO_ENGINE_POOL,         /* bounded pool of blocking worker threads */
+};
+
+/**
+ * @brief File I/O request
+ */
+struct FileioRequest {
+    int fd;                     /* file descriptor */
+    int opType;                 /* operation type, see FileioOpType */
+    void *buf;                  /* data buffer, unused by sync operations */
+    size_t len;                 /* buffer length */
+    long long offset;           /* file offset, -1 means the current file position */
+    long long result;           /* [OUT] transferred bytes or 0 on success, -errno on failure */
+};
+
+/**
+ * @brief File I/O statistics
+ */
+struct FileioStats {
+    int engine;                             /* engine type, see FileioEngineType */
+    unsigned long long uringNum;            /* requests completed by io_uring */
+    unsigned long long poolNum;             /* requests completed by the worker pool */
+    unsigned long long inlineNum;           /* requests executed inline by the calling thread */
+    unsigned long long batchNum;            /* submissions of more than one request */
+    unsigned int workerNum;                 /* current number of worker threads */
+};
+
+/**
+ * @brief Submit a batch of file I/O requests and wait for all of them.
+ * @par The calling cjthread is parked until every request completes, and its processor keeps running other
+ * cjthreads meanwhile. The requests of one batch are executed concurrently, so their order on the same file
+ * is not guaranteed. When called outside a cjthread, the requests are executed inline.
+ * @param  reqs     [IN/OUT]  request array, the result field is filled on return
+ * @param  num      [IN]  number of requests
+ * @retval 0 represents success, non-zero returns an error code. The status of each request is in its result.
+ */
+int FileioSubmit(struct FileioRequest *reqs, unsigned int num);
+
+/**
+ * @brief Read from a file without blocking the processor.
+ * @param  fd       [IN]  file descriptor
+ * @param  buf      [IN]  data buffer
+ * @param  len      [IN]  buffer length
+ * @param  offset   [IN]  file offset, -1 reads from the current file position
+ * @retval Number of bytes read, or -errno on failure.
+ */
+long long FileioRead(int fd, void *buf, size_t len, long long offset);
+
+/**
+ * @brief Write to a file without blocking the processor.
+ * @param  fd       [IN]  file descriptor
+ * @param  buf      [IN]  data buffer
+ * @param  len      [IN]  buffer length
+ * @param  offset   [IN]  file offset, -1 writes at the current file position
+ * @retval Number of bytes written, or -errno on failure.
+ */
+long long FileioWrite(int fd, const void *buf, size_t len, long long offset);
+
+/**
+ * @brief Flush a file to the storage device without blocking the processor.
+ * @param  fd       [IN]  file descriptor
+ * @param  dataOnly [IN]  true flushes only the file data, like fdatasync
+ * @retval 0 on success, or -errno on failure.
+ */
+int FileioSync(int fd, bool dataOnly);
+
+/**
+ * @brief Get the file I/O statistics.
+ * @param  stats    [OUT]  statistics
+ * @retval 0 represents success, non-zero returns an error code.
+ */
+int FileioStatsGet(struct FileioStats *stats);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif
+
+#endif /* MRT_FILEIO_H */
@@ -0,0 +1,116 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#ifndef MRT_FILEIO_IMPL_H
+#define MRT_FILEIO_IMPL_H
+
+#include <pthread.h>
+#include <atomic>
+#include "schedule_impl.h"
+#include "fileio.h"
+#include "list.h"
+
+#if defined(MRT_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define FILEIO_URING_SUPPORT
+#endif
+#endif
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/* Waiter state before the cjthread is parked. */
+#define FILEIO_WAITER_NONE      ((uintptr_t)0)
+/* Waiter state after all requests of the batch are completed. */
+#define FILEIO_WAITER_DONE      ((uintptr_t)1)
+
+/**
+ * @brief Shared by all requests submitted in one FileioSubmit call.
+ */
+struct FileioWaiter {
+    std::atomic<unsigned int> pending;      /* number of requests not completed yet */
+    std::atomic<uintptr_t> state;           /* FILEIO_WAITER_NONE, FILEIO_WAITER_DONE or the parked cjthread */
+};
+
+/**
+ * @brief One request in flight, lives on the stack of the submitting cjthread.
+ */
+struct FileioTask {
+    struct Dulink link;                     /* node in the worker pool queue, must be the first member */
+    struct FileioRequest *req;
+    struct FileioWaiter *waiter;
+};
+
+#ifdef FILEIO_URING_SUPPORT
+/**
+ * @brief io_uring instance shared by all processors.
+ */
+struct FileioUring {
+    int ringFd;
+    unsigned int sqEntries;
+    unsigned int cqEntries;
+    std::atomic<unsigned int> inflight;     /* submitted but not reaped, kept below cqEntries */
+    std::atomic<unsigned int> failNum;      /* io_uring_enter failures in a row */
+    std::atomic<bool> disabled;             /* io_uring kept failing, new requests go to the worker pool */
+    pthread_mutex_t sqLock;                 /* serializes the submitters */
+    unsigned int *sqHead;
+    unsigned int *sqTail;
+    unsigned int *sqMask;
+    unsigned int *sqArray;
+    struct io_uring_sqe *sqes;
+    unsigned int *cqHead;
+    unsigned int *cqTail;
+    unsigned int *cqMask;
+    struct io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+    pthread_t reaper;                       /* completion thread */
+};
+#endif
+
+/**
+ * @brief Bounded pool of threads that execute the blocking calls.
+ */
+struct FileioPool {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    struct Dulink queue;                    /* FileioTask waiting for a worker */
+    unsigned int queueLen;
+    unsigned int workerNum;
+    unsigned int idleNum;
+    unsigned int maxWorkerNum;
+};
+
+/**
+ * @brief Process-wide file I/O engine, initialized on first use.
+ */
+struct FileioEngine {
+    pthread_once_t once;
+    int type;                               /* see FileioEngineType */
+    struct FileioPool pool;
+#ifdef FILEIO_URING_SUPPORT
+    struct FileioUring uring;
+#endif
+    std::atomic<unsigned long long> uringNum;
+    std::atomic<unsigned long long> poolNum;
+    std::atomic<unsigned long long> inlineNum;
+    std::atomic<unsigned long long> batchNum;
+};
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif
+
+#endif /* MRT_FILEIO_IMPL_H */
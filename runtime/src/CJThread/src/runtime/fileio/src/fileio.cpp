@@ -0,0 +1,726 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include "securec.h"
+#ifdef MRT_LINUX
+#include <sys/prctl.h>
+#endif
+#ifdef FILEIO_URING_SUPPORT
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#ifdef MRT_WINDOWS
+#include <io.h>
+#endif
+#include "log.h"
+#include "cjthread.h"
+#include "fileio_impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Upper limit of the blocking worker threads. */
+const unsigned int FILEIO_POOL_MAX_WORKER_NUM = 16;
+/* An idle worker exits after this many seconds without work. */
+const unsigned int FILEIO_POOL_KEEP_ALIVE_SEC = 10;
+/* Requests of a batch up to this number are tracked on the stack. */
+const unsigned int FILEIO_BATCH_STACK_NUM = 16;
+/* Largest transfer of one request, same as the limit of read and write on Linux. */
+const size_t FILEIO_MAX_TRANSFER = 0x7ffff000;
+#ifdef FILEIO_URING_SUPPORT
+/* Number of submission queue entries of the io_uring instance. */
+const unsigned int FILEIO_URING_ENTRIES = 256;
+/* Submits that consume no entry are tried this many times before the entries are failed. */
+const unsigned int FILEIO_URING_SUBMIT_RETRY = 8;
+/* After this many io_uring_enter failures in a row, new requests go to the worker pool. */
+const unsigned int FILEIO_URING_FAIL_LIMIT = 16;
+/* The reaper waits at most this long between polls of the completion queue while io_uring_enter fails. */
+const unsigned int FILEIO_URING_BACKOFF_MAX_US = 100000;
+#endif
+
+struct FileioEngine g_fileioEngine = {
+    .once = PTHREAD_ONCE_INIT,
+    .type = FILEIO_ENGINE_NONE,
+};
+
+MRT_INLINE static long long FileioResult(long long ret)
+{
+    return ret < 0 ? -static_cast<long long>(errno) : ret;
+}
+
+/* Execute the request with a blocking call on the current thread. */
+static long long FileioExecute(struct FileioRequest *req)
+{
+    long long ret;
+    size_t len = req->len > FILEIO_MAX_TRANSFER ? FILEIO_MAX_TRANSFER : req->len;
+
+    do {
+        switch (req->opType) {
+            case FILEIO_OP_READ:
+#ifdef MRT_WINDOWS
+                ret = req->offset < 0 ? read(req->fd, req->buf, static_cast<unsigned int>(len)) :
+                    (errno = ENOTSUP, -1);
+#else
+                ret = req->offset < 0 ? read(req->fd, req->buf, len) :
+                    pread(req->fd, req->buf, len, static_cast<off_t>(req->offset));
+#endif
+                break;
+            case FILEIO_OP_WRITE:
+#ifdef MRT_WINDOWS
+                ret = req->offset < 0 ? write(req->fd, req->buf, static_cast<unsigned int>(len)) :
+                    (errno = ENOTSUP, -1);
+#else
+                ret = req->offset < 0 ? write(req->fd, req->buf, len) :
+                    pwrite(req->fd, req->buf, len, static_cast<off_t>(req->offset));
+#endif
+                break;
+            case FILEIO_OP_FSYNC:
+#ifdef MRT_WINDOWS
+                ret = _commit(req->fd);
+#else
+                ret = fsync(req->fd);
+#endif
+                break;
+            case FILEIO_OP_FDATASYNC:
+#if defined(MRT_WINDOWS)
+                ret = _commit(req->fd);
+#elif defined(MRT_LINUX)
+                ret = fdatasync(req->fd);
+#else
+                ret = fsync(req->fd);
+#endif
+                break;
+            default:
+                errno = EINVAL;
+                ret = -1;
+                break;
+        }
+    } while (ret < 0 && errno == EINTR);
+    return FileioResult(ret);
+}
+
+/* Record the result, and wake up the submitter when the last request of its batch completes. */
+static void FileioComplete(struct FileioTask *task, long long result)
+{
+    struct FileioWaiter *waiter = task->waiter;
+    uintptr_t old;
+
+    task->req->result = result;
+    if (atomic_fetch_sub_explicit(&waiter->pending, 1u, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    // The waiter lives on the submitter's stack, it must not be touched after the exchange.
+    old = atomic_exchange_explicit(&waiter->state, FILEIO_WAITER_DONE, std::memory_order_acq_rel);
+    if (old != FILEIO_WAITER_NONE) {
+        CJThreadReady(reinterpret_cast<CJThreadHandle>(old));
+    }
+}
+
+static int FileioWaitPark(void *arg, CJThreadHandle handle)
+{
+    struct FileioWaiter *waiter = static_cast<struct FileioWaiter *>(arg);
+    uintptr_t expected = FILEIO_WAITER_NONE;
+
+    if (atomic_compare_exchange_strong_explicit(&waiter->state, &expected, reinterpret_cast<uintptr_t>(handle),
+                                                std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return 0;
+    }
+    // All requests completed before the cjthread is parked.
+    return -1;
+}
+
+static void *FileioWorkerEntry(void *arg)
+{
+    struct FileioPool *pool = static_cast<struct FileioPool *>(arg);
+    struct FileioTask *task;
+    struct timespec deadline;
+    int error;
+
+#ifdef MRT_LINUX
+    prctl(PR_SET_NAME, "cjfileio");
+#elif defined (MRT_MACOS)
+    pthread_setname_np("cjfileio");
+#endif
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        error = 0;
+        while (DulinkIsEmpty(&pool->queue) && error != ETIMEDOUT) {
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += FILEIO_POOL_KEEP_ALIVE_SEC;
+            pool->idleNum++;
+            error = pthread_cond_timedwait(&pool->cond, &pool->mutex, &deadline);
+            pool->idleNum--;
+        }
+        if (DulinkIsEmpty(&pool->queue)) {
+            break;
+        }
+        task = reinterpret_cast<struct FileioTask *>(pool->queue.next);
+        DulinkPopHead(&pool->queue);
+        pool->queueLen--;
+        pthread_mutex_unlock(&pool->mutex);
+
+        FileioComplete(task, FileioExecute(task->req));
+        atomic_fetch_add_explicit(&g_fileioEngine.poolNum, 1ull, std::memory_order_relaxed);
+
+        pthread_mutex_lock(&pool->mutex);
+    }
+    pool->workerNum--;
+    pthread_mutex_unlock(&pool->mutex);
+    return nullptr;
+}
+
+/* Must be called with pool->mutex held. */
+static int FileioWorkerCreate(struct FileioPool *pool)
+{
+    pthread_attr_t attr;
+    pthread_t tid;
+    int error;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    error = pthread_create(&tid, &attr, FileioWorkerEntry, pool);
+    pthread_attr_destroy(&attr);
+    if (error) {
+        LOG_ERROR(ERRNO_FILEIO_WORKER_CREATE_FAILED, "create fileio worker failed, error: %d", error);
+        return error;
+    }
+    pool->workerNum++;
+    return 0;
+}
+
+/* Queue the tasks to the worker pool, a worker is started while the queued tasks outnumber the idle workers. */
+static void FileioPoolDispatch(struct FileioTask **tasks, unsigned int num)
+{
+    struct FileioPool *pool = &g_fileioEngine.pool;
+    unsigned int i;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (i = 0; i < num; ++i) {
+        DulinkPushtail(&pool->queue, tasks[i]);
+    }
+    pool->queueLen += num;
+    while (pool->queueLen > pool->idleNum && pool->workerNum < pool->maxWorkerNum) {
+        if (FileioWorkerCreate(pool) != 0) {
+            break;
+        }
+    }
+    if (pool->workerNum == 0) {
+        // No worker is able to run the tasks, execute them on the current thread.
+        for (i = 0; i < num; ++i) {
+            DulinkRemove(&tasks[i]->link);
+        }
+        pool->queueLen -= num;
+        pthread_mutex_unlock(&pool->mutex);
+        for (i = 0; i < num; ++i) {
+            FileioComplete(tasks[i], FileioExecute(tasks[i]->req));
+        }
+        atomic_fetch_add_explicit(&g_fileioEngine.inlineNum, static_cast<unsigned long long>(num),
+                                  std::memory_order_relaxed);
+        return;
+    }
+    if (pool->idleNum > 0) {
+        if (num > 1) {
+            pthread_cond_broadcast(&pool->cond);
+        } else {
+            pthread_cond_signal(&pool->cond);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+#ifdef FILEIO_URING_SUPPORT
+MRT_INLINE static int FileioUringEnter(int ringFd, unsigned int toSubmit, unsigned int minComplete,
+                                       unsigned int flags)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+/* Count a failed io_uring_enter, io_uring is given up after FILEIO_URING_FAIL_LIMIT failures in a row. */
+static void FileioUringFailed(struct FileioUring *uring, int error)
+{
+    unsigned int failNum = atomic_fetch_add_explicit(&uring->failNum, 1u, std::memory_order_relaxed) + 1;
+
+    if (failNum < FILEIO_URING_FAIL_LIMIT) {
+        LOG_ERROR(error, "io_uring_enter failed");
+    } else if (failNum == FILEIO_URING_FAIL_LIMIT) {
+        atomic_store(&uring->disabled, true);
+        LOG_ERROR(error, "io_uring_enter keeps failing, use fileio worker pool");
+    }
+}
+
+/* Wait before the next poll of the completion queue, longer after each failure in a row. */
+static void FileioUringBackoff(struct FileioUring *uring)
+{
+    unsigned int failNum = atomic_load_explicit(&uring->failNum, std::memory_order_relaxed);
+    // 17: 1 << 17 us is above FILEIO_URING_BACKOFF_MAX_US
+    unsigned int us = failNum > 17 ? FILEIO_URING_BACKOFF_MAX_US : (1u << failNum);
+
+    usleep(us > FILEIO_URING_BACKOFF_MAX_US ? FILEIO_URING_BACKOFF_MAX_US : us);
+}
+
+/* Once io_uring is given up, the reaper exits after the requests in flight are reaped. */
+static bool FileioUringRetired(struct FileioUring *uring)
+{
+    bool retired;
+
+    if (!atomic_load(&uring->disabled)) {
+        return false;
+    }
+    // Submitters check disabled and add to inflight under sqLock.
+    pthread_mutex_lock(&uring->sqLock);
+    retired = atomic_load_explicit(&uring->inflight, std::memory_order_relaxed) == 0;
+    pthread_mutex_unlock(&uring->sqLock);
+    return retired;
+}
+
+/* Reap the completion queue and wake up the submitters. */
+static void *FileioUringReaperEntry(void *arg)
+{
+    struct FileioUring *uring = static_cast<struct FileioUring *>(arg);
+    struct io_uring_cqe *cqe;
+    struct FileioTask *task;
+    unsigned int head;
+    unsigned int tail;
+    long long result;
+
+#ifdef MRT_LINUX
+    prctl(PR_SET_NAME, "cjfileio_cq");
+#endif
+
+    while (true) {
+        head = *uring->cqHead;
+        tail = __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            if (FileioUringRetired(uring)) {
+                break;
+            }
+            // Completions are still posted to the ring while io_uring_enter fails, poll it instead of waiting.
+            if (atomic_load_explicit(&uring->failNum, std::memory_order_relaxed) != 0) {
+                FileioUringBackoff(uring);
+            }
+            if (FileioUringEnter(uring->ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0) {
+                if (errno != EINTR) {
+                    FileioUringFailed(uring, errno);
+                }
+            } else {
+                atomic_store_explicit(&uring->failNum, 0u, std::memory_order_relaxed);
+            }
+            continue;
+        }
+        while (head != tail) {
+            cqe = &uring->cqes[head & *uring->cqMask];
+            task = reinterpret_cast<struct FileioTask *>(static_cast<uintptr_t>(cqe->user_data));
+            result = cqe->res;
+            head++;
+            __atomic_store_n(uring->cqHead, head, __ATOMIC_RELEASE);
+            atomic_fetch_sub_explicit(&uring->inflight, 1u, std::memory_order_relaxed);
+            FileioComplete(task, result);
+        }
+    }
+    return nullptr;
+}
+
+static void FileioUringUnmap(struct FileioUring *uring)
+{
+    if (uring->sqes != nullptr) {
+        munmap(uring->sqes, uring->sqesSize);
+    }
+    if (uring->cqRing != nullptr && uring->cqRing != uring->sqRing) {
+        munmap(uring->cqRing, uring->cqRingSize);
+    }
+    if (uring->sqRing != nullptr) {
+        munmap(uring->sqRing, uring->sqRingSize);
+    }
+    close(uring->ringFd);
+}
+
+static int FileioUringInit(struct FileioUring *uring)
+{
+    struct io_uring_params params;
+    char *sq;
+    char *cq;
+    int error;
+
+    (void)memset_s(&params, sizeof(params), 0, sizeof(params));
+    uring->ringFd = static_cast<int>(syscall(__NR_io_uring_setup, FILEIO_URING_ENTRIES, &params));
+    if (uring->ringFd < 0) {
+        return errno;
+    }
+    // IORING_OP_READ, IORING_OP_WRITE and the current file position arrived together.
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        close(uring->ringFd);
+        return ENOTSUP;
+    }
+
+    uring->sqEntries = params.sq_entries;
+    uring->cqEntries = params.cq_entries;
+    uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    uring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring->sqRingSize = uring->sqRingSize > uring->cqRingSize ? uring->sqRingSize : uring->cqRingSize;
+        uring->cqRingSize = uring->sqRingSize;
+    }
+    uring->sqRing = nullptr;
+    uring->cqRing = nullptr;
+    uring->sqes = nullptr;
+
+    uring->sqRing = mmap(nullptr, uring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         uring->ringFd, IORING_OFF_SQ_RING);
+    if (uring->sqRing == MAP_FAILED) {
+        uring->sqRing = nullptr;
+        error = errno;
+        FileioUringUnmap(uring);
+        return error;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        uring->cqRing = uring->sqRing;
+    } else {
+        uring->cqRing = mmap(nullptr, uring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             uring->ringFd, IORING_OFF_CQ_RING);
+        if (uring->cqRing == MAP_FAILED) {
+            uring->cqRing = nullptr;
+            error = errno;
+            FileioUringUnmap(uring);
+            return error;
+        }
+    }
+    void *sqes = mmap(nullptr, uring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      uring->ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        error = errno;
+        FileioUringUnmap(uring);
+        return error;
+    }
+    uring->sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+    sq = static_cast<char *>(uring->sqRing);
+    cq = static_cast<char *>(uring->cqRing);
+    uring->sqHead = reinterpret_cast<unsigned int *>(sq + params.sq_off.head);
+    uring->sqTail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+    uring->sqMask = reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+    uring->sqArray = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+    uring->cqHead = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+    uring->cqTail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+    uring->cqMask = reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+    uring->cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+    uring->inflight = 0;
+    uring->failNum = 0;
+    uring->disabled = false;
+    pthread_mutex_init(&uring->sqLock, nullptr);
+
+    error = pthread_create(&uring->reaper, nullptr, FileioUringReaperEntry, uring);
+    if (error) {
+        pthread_mutex_destroy(&uring->sqLock);
+        FileioUringUnmap(uring);
+        return error;
+    }
+    pthread_detach(uring->reaper);
+    return 0;
+}
+
+MRT_INLINE static void FileioUringPrep(struct io_uring_sqe *sqe, struct FileioTask *task)
+{
+    struct FileioRequest *req = task->req;
+    size_t len = req->len > FILEIO_MAX_TRANSFER ? FILEIO_MAX_TRANSFER : req->len;
+
+    (void)memset_s(sqe, sizeof(*sqe), 0, sizeof(*sqe));
+    sqe->fd = req->fd;
+    sqe->user_data = static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(task));
+    switch (req->opType) {
+        case FILEIO_OP_READ:
+        case FILEIO_OP_WRITE:
+            sqe->opcode = req->opType == FILEIO_OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe->addr = static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(req->buf));
+            sqe->len = static_cast<unsigned int>(len);
+            // An offset of -1 means the current file position.
+            sqe->off = req->offset < 0 ? static_cast<unsigned long long>(-1) :
+                static_cast<unsigned long long>(req->offset);
+            break;
+        default:
+            sqe->opcode = IORING_OP_FSYNC;
+            sqe->fsync_flags = req->opType == FILEIO_OP_FDATASYNC ? IORING_FSYNC_DATASYNC : 0;
+            break;
+    }
+}
+
+/*
+ * Put as many tasks as possible into the submission queue and submit them. Returns the number of
+ * tasks taken, the rest are left to the worker pool. Tasks that the kernel does not accept are
+ * withdrawn from the queue and completed with the error.
+ */
+static unsigned int FileioUringDispatch(struct FileioTask **tasks, unsigned int num)
+{
+    struct FileioUring *uring = &g_fileioEngine.uring;
+    unsigned int head;
+    unsigned int tail;
+    unsigned int idx;
+    unsigned int taken = 0;
+    unsigned int inflight;
+    unsigned int unsubmitted;
+    unsigned int retry = 0;
+    unsigned int i;
+    int error = 0;
+    int ret;
+
+    pthread_mutex_lock(&uring->sqLock);
+    if (atomic_load(&uring->disabled)) {
+        pthread_mutex_unlock(&uring->sqLock);
+        return 0;
+    }
+    tail = *uring->sqTail;
+    head = __atomic_load_n(uring->sqHead, __ATOMIC_ACQUIRE);
+    inflight = atomic_load_explicit(&uring->inflight, std::memory_order_relaxed);
+    // Keep the completion queue from overflowing.
+    while (taken < num && tail - head < uring->sqEntries && inflight + taken < uring->cqEntries) {
+        idx = tail & *uring->sqMask;
+        FileioUringPrep(&uring->sqes[idx], tasks[taken]);
+        uring->sqArray[idx] = idx;
+        tail++;
+        taken++;
+    }
+    if (taken == 0) {
+        pthread_mutex_unlock(&uring->sqLock);
+        return 0;
+    }
+    atomic_fetch_add_explicit(&uring->inflight, taken, std::memory_order_relaxed);
+    __atomic_store_n(uring->sqTail, tail, __ATOMIC_RELEASE);
+    // The kernel consumes from its own head, a partial submit leaves the rest for the next enter.
+    unsubmitted = taken;
+    while (unsubmitted > 0) {
+        ret = FileioUringEnter(uring->ringFd, unsubmitted, 0, 0);
+        unsubmitted = tail - __atomic_load_n(uring->sqHead, __ATOMIC_ACQUIRE);
+        if (ret > 0 || (ret < 0 && errno == EINTR)) {
+            continue;
+        }
+        if (ret < 0 && errno != EAGAIN && errno != EBUSY) {
+            error = errno;
+            break;
+        }
+        if (++retry > FILEIO_URING_SUBMIT_RETRY) {
+            error = ret < 0 ? errno : EAGAIN;
+            break;
+        }
+    }
+    if (unsubmitted > 0) {
+        // Without SQPOLL the kernel only reads the queue inside io_uring_enter, which is serialized by sqLock,
+        // so the entries it has not consumed can be taken back. They are the last ones of this batch.
+        __atomic_store_n(uring->sqTail, tail - unsubmitted, __ATOMIC_RELEASE);
+        atomic_fetch_sub_explicit(&uring->inflight, unsubmitted, std::memory_order_relaxed);
+        FileioUringFailed(uring, error);
+    } else {
+        atomic_store_explicit(&uring->failNum, 0u, std::memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&uring->sqLock);
+    for (i = taken - unsubmitted; i < taken; ++i) {
+        FileioComplete(tasks[i], -static_cast<long long>(error));
+    }
+    atomic_fetch_add_explicit(&g_fileioEngine.uringNum, static_cast<unsigned long long>(taken - unsubmitted),
+                              std::memory_order_relaxed);
+    return taken;
+}
+#endif
+
+#ifndef MRT_WINDOWS
+/*
+ * Runs in the child of a fork. Only the forking thread lives on, so the workers and the reaper are
+ * gone and their locks may have been held at the fork. The ring is shared with the parent and must
+ * not be touched by the child, which drops it and goes on with the worker pool.
+ */
+static void FileioForkChild(void)
+{
+    struct FileioPool *pool = &g_fileioEngine.pool;
+
+    (void)pthread_mutex_init(&pool->mutex, nullptr);
+    (void)pthread_cond_init(&pool->cond, nullptr);
+    // The queued tasks belong to cjthreads of the parent.
+    DulinkInit(&pool->queue);
+    pool->queueLen = 0;
+    pool->workerNum = 0;
+    pool->idleNum = 0;
+#ifdef FILEIO_URING_SUPPORT
+    if (g_fileioEngine.type == FILEIO_ENGINE_URING) {
+        struct FileioUring *uring = &g_fileioEngine.uring;
+        atomic_store(&uring->disabled, true);
+        atomic_store_explicit(&uring->inflight, 0u, std::memory_order_relaxed);
+        (void)pthread_mutex_init(&uring->sqLock, nullptr);
+        FileioUringUnmap(uring);
+        g_fileioEngine.type = FILEIO_ENGINE_POOL;
+    }
+#endif
+}
+#endif
+
+static void FileioEngineInit(void)
+{
+    struct FileioPool *pool = &g_fileioEngine.pool;
+    int error;
+
+    error = pthread_mutex_init(&pool->mutex, nullptr);
+    if (error) {
+        LOG_ERROR(ERRNO_FILEIO_INIT_FAILED, "fileio pool mutex init failed, error: %d", error);
+        return;
+    }
+    error = pthread_cond_init(&pool->cond, nullptr);
+    if (error) {
+        pthread_mutex_destroy(&pool->mutex);
+        LOG_ERROR(ERRNO_FILEIO_INIT_FAILED, "fileio pool cond init failed, error: %d", error);
+        return;
+    }
+    DulinkInit(&pool->queue);
+    pool->queueLen = 0;
+    pool->workerNum = 0;
+    pool->idleNum = 0;
+    pool->maxWorkerNum = FILEIO_POOL_MAX_WORKER_NUM;
+    g_fileioEngine.type = FILEIO_ENGINE_POOL;
+#ifndef MRT_WINDOWS
+    error = pthread_atfork(nullptr, nullptr, FileioForkChild);
+    if (error) {
+        LOG_ERROR(ERRNO_FILEIO_INIT_FAILED, "fileio fork handler register failed, error: %d", error);
+    }
+#endif
+
+#ifdef FILEIO_URING_SUPPORT
+    error = FileioUringInit(&g_fileioEngine.uring);
+    if (error == 0) {
+        g_fileioEngine.type = FILEIO_ENGINE_URING;
+    } else {
+        // Old kernels, seccomp filters and io_uring_disabled all end up here.
+        LOG_INFO(ERRNO_FILEIO_URING_INIT_FAILED, "io_uring is unavailable, error: %d, use fileio worker pool", error);
+    }
+#endif
+}
+
+MRT_INLINE static void FileioDispatch(struct FileioTask **tasks, unsigned int num)
+{
+    unsigned int taken = 0;
+
+#ifdef FILEIO_URING_SUPPORT
+    if (g_fileioEngine.type == FILEIO_ENGINE_URING && !atomic_load(&g_fileioEngine.uring.disabled)) {
+        taken = FileioUringDispatch(tasks, num);
+    }
+#endif
+    if (taken < num) {
+        FileioPoolDispatch(tasks + taken, num - taken);
+    }
+}
+
+int FileioSubmit(struct FileioRequest *reqs, unsigned int num)
+{
+    struct FileioTask stackTasks[FILEIO_BATCH_STACK_NUM];
+    struct FileioTask *stackTaskPtrs[FILEIO_BATCH_STACK_NUM];
+    struct FileioTask *tasks = stackTasks;
+    struct FileioTask **taskPtrs = stackTaskPtrs;
+    struct FileioWaiter waiter;
+    unsigned int i;
+
+    if (reqs == nullptr || num == 0) {
+        return ERRNO_SCHD_ARG_INVALID;
+    }
+    pthread_once(&g_fileioEngine.once, FileioEngineInit);
+    if (CJThreadGet() == nullptr || g_fileioEngine.type == FILEIO_ENGINE_NONE) {
+        for (i = 0; i < num; ++i) {
+            reqs[i].result = FileioExecute(&reqs[i]);
+        }
+        atomic_fetch_add_explicit(&g_fileioEngine.inlineNum, static_cast<unsigned long long>(num),
+                                  std::memory_order_relaxed);
+        return 0;
+    }
+
+    if (num > FILEIO_BATCH_STACK_NUM) {
+        tasks = static_cast<struct FileioTask *>(malloc(num * (sizeof(struct FileioTask) +
+                                                               sizeof(struct FileioTask *))));
+        if (tasks == nullptr) {
+            LOG_ERROR(ERRNO_SCHD_MALLOC_FAILED, "malloc fileio tasks failed");
+            return ERRNO_SCHD_MALLOC_FAILED;
+        }
+        taskPtrs = reinterpret_cast<struct FileioTask **>(tasks + num);
+    }
+    if (num > 1) {
+        atomic_fetch_add_explicit(&g_fileioEngine.batchNum, 1ull, std::memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&waiter.pending, num, std::memory_order_relaxed);
+    atomic_store_explicit(&waiter.state, FILEIO_WAITER_NONE, std::memory_order_relaxed);
+    for (i = 0; i < num; ++i) {
+        tasks[i].req = &reqs[i];
+        tasks[i].waiter = &waiter;
+        taskPtrs[i] = &tasks[i];
+    }
+    FileioDispatch(taskPtrs, num);
+    CJThreadParkFor(FileioWaitPark, TRACE_EV_CJTHREAD_BLOCK, CJTHREAD_PARK_FILE, &waiter);
+
+    if (tasks != stackTasks) {
+        free(tasks);
+    }
+    return 0;
+}
+
+long long FileioRead(int fd, void *buf, size_t len, long long offset)
+{
+    struct FileioRequest req = {
+        .fd = fd, .opType = FILEIO_OP_READ, .buf = buf, .len = len, .offset = offset, .result = 0
+    };
+    int error = FileioSubmit(&req, 1);
+    return error ? -EINVAL : req.result;
+}
+
+long long FileioWrite(int fd, const void *buf, size_t len, long long offset)
+{
+    struct FileioRequest req = {
+        .fd = fd, .opType = FILEIO_OP_WRITE, .buf = const_cast<void *>(buf), .len = len, .offset = offset,
+        .result = 0
+    };
+    int error = FileioSubmit(&req, 1);
+    return error ? -EINVAL : req.result;
+}
+
+int FileioSync(int fd, bool dataOnly)
+{
+    struct FileioRequest req = {
+        .fd = fd, .opType = dataOnly ? FILEIO_OP_FDATASYNC : FILEIO_OP_FSYNC, .buf = nullptr, .len = 0,
+        .offset = 0, .result = 0
+    };
+    int error = FileioSubmit(&req, 1);
+    return error ? -EINVAL : static_cast<int>(req.result);
+}
+
+int FileioStatsGet(struct FileioStats *stats)
+{
+    if (stats == nullptr) {
+        return ERRNO_SCHD_ARG_INVALID;
+    }
+    stats->engine = g_fileioEngine.type;
+#ifdef FILEIO_URING_SUPPORT
+    if (stats->engine == FILEIO_ENGINE_URING && atomic_load(&g_fileioEngine.uring.disabled)) {
+        stats->engine = FILEIO_ENGINE_POOL;
+    }
+#endif
+    stats->uringNum = atomic_load_explicit(&g_fileioEngine.uringNum, std::memory_order_relaxed);
+    stats->poolNum = atomic_load_explicit(&g_fileioEngine.poolNum, std::memory_order_relaxed);
+    stats->inlineNum = atomic_load_explicit(&g_fileioEngine.inlineNum, std::memory_order_relaxed);
+    stats->batchNum = atomic_load_explicit(&g_fileioEngine.batchNum, std::memory_order_relaxed);
+    if (g_fileioEngine.type == FILEIO_ENGINE_NONE) {
+        stats->workerNum = 0;
+    } else {
+        pthread_mutex_lock(&g_fileioEngine.pool.mutex);
+        stats->workerNum = g_fileioEngine.pool.workerNum;
+        pthread_mutex_unlock(&g_fileioEngine.pool.mutex);
+    }
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -76,6 +76,97 @@ static inline int PthreadSpinDestroy(struct CJthreadSpinLock *lock)
     return pthread_mutex_destroy(&lock->lock);
 }
 
+#else
+#ifdef MRT_LINUX
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Counting semaphore on a futex word. Unlike sem_t, the count can be polled, so that an idle
+ * thread can spin on it for a while before it sleeps. */
+struct Semaphore {
+    std::atomic<int> value;         /* tokens posted and not taken yet */
+    std::atomic<int> waiters;       /* threads sleeping on value */
+};
+
+static inline int SemaphoreFutex(std::atomic<int> *addr, int op, int val)
+{
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<int *>(addr), op, val, nullptr, nullptr, 0));
+}
+
+static inline int SemaphoreInit(struct Semaphore *sem, int pshared, unsigned value)
+{
+    (void)pshared;
+    if (value > INT_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    sem->value.store(static_cast<int>(value));
+    sem->waiters.store(0);
+    return 0;
+}
+
+static inline bool SemaphoreTryWait(struct Semaphore *sem)
+{
+    int value = sem->value.load(std::memory_order_relaxed);
+    while (value > 0) {
+        if (sem->value.compare_exchange_weak(value, value - 1, std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The futex sleeps only while value is 0. Waiters are published before the sleep and posts
+ * check them after the increment, so a wake cannot be lost. */
+static inline int SemaphoreWaitFutex(struct Semaphore *sem, bool intr)
+{
+    int ret;
+
+    while (!SemaphoreTryWait(sem)) {
+        sem->waiters.fetch_add(1);
+        ret = SemaphoreFutex(&sem->value, FUTEX_WAIT_PRIVATE, 0);
+        sem->waiters.fetch_sub(1);
+        if (ret != 0 && errno == EINTR && intr) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static inline int SemaphoreWait(struct Semaphore *sem)
+{
+    return SemaphoreWaitFutex(sem, true);
+}
+
+static inline int SemaphoreWaitNoIntr(struct Semaphore *sem)
+{
+    return SemaphoreWaitFutex(sem, false);
+}
+
+static inline int SemaphorePost(struct Semaphore *sem)
+{
+    sem->value.fetch_add(1);
+    if (sem->waiters.load() != 0) {
+        (void)SemaphoreFutex(&sem->value, FUTEX_WAKE_PRIVATE, 1);
+    }
+    return 0;
+}
+
+/* Whether a token is available, without taking it. */
+static inline bool SemaphorePosted(struct Semaphore *sem)
+{
+    return sem->value.load(std::memory_order_acquire) > 0;
+}
+
+static inline int SemaphoreDestroy(struct Semaphore *sem)
+{
+    (void)sem;
+    return 0;
+}
 #else
 #include <semaphore.h>
 
@@ -111,6 +202,7 @@ static inline int SemaphoreDestroy(struct Semaphore *sem)
 {
     return sem_destroy(&sem->sem);
 }
+#endif
 
 #if defined (__ANDROID__) && (VOS_WORDSIZE == 32) && (MRT_HARDWARE_PLATFORM == MRT_ARM)
 struct CJthreadSpinLock {
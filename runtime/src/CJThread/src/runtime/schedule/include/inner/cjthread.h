@@ -30,6 +30,8 @@ extern "C" {
 #define CJTHREAD_KEYS_MAX 9
 #define CJTHREAD_ARG_ALIGN (16)
 #define CJTHREAD_INIT_ID (ULLONG_MAX)
+/* Max cjthreads held by a spawn batch before they are submitted */
+#define CJTHREAD_SPAWN_BATCH_MAX (1024)
 
 #define CJTHREAD_SANITIZER_CONTEXT_OFFSET (16)
 
@@ -106,12 +108,25 @@ enum CJThreadBuf {
 struct CJThreadAttrInner {
     size_t stackSize;                          /* stack size */
     bool cjFromC;                              /* create cjthread directly from side C */
+    unsigned int priority;                     /* priority class, see CJThreadPriority */
     bool named;
     char name[CJTHREAD_NAME_SIZE];             /* cjthread name */
     bool hasSpecificData;
     void *specificData[CJTHREAD_KEYS_MAX];     /* local data */
 };
 
+/**
+ * @brief Cjthreads spawned by a cjthread and not submitted yet, see CJThreadSpawnBatchBegin
+ */
+struct CJThreadSpawnBatch {
+    unsigned int depth;                      /* nesting of CJThreadSpawnBatchBegin */
+    unsigned int capacity;                   /* length of list and cached */
+    unsigned int num;                        /* cjthreads in list */
+    unsigned int cachedNum;                  /* control blocks in cached */
+    struct CJThread **list;                  /* ready cjthreads to be submitted */
+    struct CJThread **cached;                /* free control blocks taken from the free lists in bulk */
+};
+
 /**
  * @brief cjthread structure
  */
@@ -149,6 +164,13 @@ struct CJThread {
                                               Do not change it. */
     char name[CJTHREAD_NAME_SIZE];           /* cjthread name */
     bool isCJThread0;
+    unsigned int priority;                   /* priority class, see CJThreadPriority */
+    unsigned int wakeSeq;                    /* number of wakes, selects the sampled ones */
+    unsigned long long readyTime;            /* time of the sampled wake, 0 if not sampled */
+    unsigned long long runqTime;             /* time it entered a running queue, for the latency statistics */
+    struct CJThreadSpawnBatch *spawnBatch;   /* spawns deferred by CJThreadSpawnBatchBegin, NULL if none */
+    unsigned int parkEpoch;                  /* stack reclaim epoch of the last park */
+    std::atomic<int> stackReclaiming;        /* STACK_RECLAIM_BUSY while schmon releases the pages below the parked SP */
 #ifdef __OHOS__
     std::vector<unsigned long long> threadStackTopList;
 #endif
@@ -262,6 +284,17 @@ void CJThread0Make(struct CJThread *cjthread0);
  */
 int CJThreadPark(ParkCallbackFunc func, TraceEvent waitReason, void *arg);
 
+/**
+ * @brief Park the current cjthread as CJThreadPark does, for a kind of park that does not follow
+ * from waitReason. The kind is passed to the park hook, see CJThreadParkHookSet.
+ * @param func    [IN] Callback executed before the cjthread stops
+ * @param waitReason    [IN] Reason for park, which is used for trace.
+ * @param kind    [IN] what the cjthread parks for
+ * @param arg    [IN] Input callback parameter
+ * @retval 0 or error code
+ */
+int CJThreadParkFor(ParkCallbackFunc func, TraceEvent waitReason, CJThreadParkKind kind, void *arg);
+
 /**
  * @brief Apply for the cjthread stack memory.
  * @param schedule    [IN] Scheduler to which the cjthread belongs
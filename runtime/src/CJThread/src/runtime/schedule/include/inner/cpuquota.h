@@ -0,0 +1,68 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_CPUQUOTA_H
+#define MRT_CPUQUOTA_H
+
+#include <atomic>
+#include <stdbool.h>
+#include "schedule.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/* Length of the paths of the cgroup quota files */
+#define CPU_QUOTA_PATH_LEN 256
+
+/* Interval at which schmon reads the quota, 1s */
+#define CPU_QUOTA_CHECK_TIME (1000ULL * 1000 * 1000)
+
+/**
+ * @brief cgroup cpu quota followed by the active processors of the default scheduler
+ */
+struct ScheduleCpuQuota {
+    bool enable;                            /* whether the active processors follow the quota */
+    int version;                            /* cgroup version of the quota files, 0 if not found */
+    char quotaPath[CPU_QUOTA_PATH_LEN];     /* cpu.max on v2, cpu.cfs_quota_us on v1 */
+    char periodPath[CPU_QUOTA_PATH_LEN];    /* cpu.cfs_period_us on v1 */
+    unsigned int baseNum;                   /* active processors when there is no quota */
+    std::atomic<unsigned int> cpus;         /* last quota read, CPUs rounded up, 0 if unlimited */
+    unsigned long long lastCheck;           /* time of the last read, only used by schmon */
+};
+
+/**
+ * @brief Find the quota files of the cgroup of the process. Only supported on Linux.
+ * @param quota     [OUT] Quota, its version is 0 on failure.
+ * @retval 0 or error code
+ */
+int CpuQuotaInit(struct ScheduleCpuQuota *quota);
+
+/**
+ * @brief Read the quota.
+ * @param quota     [IN]  Quota initialized by CpuQuotaInit.
+ * @param cpus      [OUT] CPUs granted, rounded up, 0 if unlimited.
+ * @retval 0 or error code
+ */
+int CpuQuotaRead(const struct ScheduleCpuQuota *quota, unsigned int *cpus);
+
+/**
+ * @brief Read the quota and get the active processors it grants.
+ * @param quota     [IN] Quota initialized by CpuQuotaInit, its cpus is updated.
+ * @param capacity  [IN] Processors allocated.
+ * @retval The CPUs granted, or baseNum without a quota, within [1, capacity].
+ */
+unsigned int CpuQuotaProcessorNum(struct ScheduleCpuQuota *quota, unsigned int capacity);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif
+#endif /* MRT_CPUQUOTA_H */
@@ -10,6 +10,10 @@ struct CJThreadContext {
     {
         return r15pc;
     }
+    unsigned long long GetSP()
+    {
+        return r13sp;
+    }
 
     unsigned int r4;
     unsigned int r5;
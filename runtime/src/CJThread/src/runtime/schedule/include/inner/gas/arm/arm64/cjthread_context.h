@@ -17,6 +17,10 @@ struct CJThreadContext {
     {
         return pc;
     }
+    unsigned long long GetSP()
+    {
+        return sp;
+    }
     unsigned long long x18; /* 0x0 */
     unsigned long long x19; /* 0x8 */
     unsigned long long x20; /* 0x10 */
@@ -30,6 +30,10 @@ struct CJThreadContext {
     {
         return rip;
     }
+    unsigned long long GetSP()
+    {
+        return rsp;
+    }
     unsigned long long rsp;  /* 0x0 */
     unsigned long long rbp;  /* 0x8 */
     unsigned long long rbx;  /* 0x10 */
@@ -48,8 +48,14 @@ extern "C" {
 
 #define PROCESSOR_STEAL_SLEEP_THRESHOLD 2
 
+/* At most one in PROCESSOR_SPIN_CAP_DIVISOR active processors spins or searches for work. */
+#define PROCESSOR_SPIN_CAP_DIVISOR 4
+
 #define PROCESSOR_SCHED_COUNT_THRESHOLD 100
 
+/* Number of picks a lower priority class waits for while higher classes are served */
+#define PROCESSOR_PRIORITY_AGING 8
+
 /**
  * @brief processor state
  */
@@ -58,6 +64,7 @@ enum ProcessorState {
     PROCESSOR_RUNNING,
     PROCESSOR_EXITING,
     PROCESSOR_SYSCALL,
+    PROCESSOR_OFFLINE,              /* beyond the active processors of the scheduler, never allocated */
 };
 
 /**
@@ -77,6 +84,50 @@ struct ProcessorObservedRecord {
     unsigned long long lastTime;
 };
 
+/**
+ * @brief Timer-driven preemption state of a processor. The timer belongs to the processor and
+ * sends its signal to the thread currently bound to the processor. The timer is created, deleted
+ * and set under timerLock, which the signal handler only tries to take.
+ */
+struct ProcessorPreempt {
+    int timerId;                                    /* kernel id of the time-slice timer */
+    unsigned long long timerTid;                    /* thread that receives the timer signal, 0 if no timer */
+    std::atomic<bool> timerArmed;                   /* whether the timer is running */
+    std::atomic<bool> timerLock;                    /* held while timerId, timerTid or timerArmed change */
+    std::atomic<unsigned long long> sliceStart;     /* start time of the current slice, ns */
+    std::atomic<unsigned long long> requestTime;    /* time of the pending preemption request, 0 if none */
+    std::atomic<unsigned long long> requestCnt;     /* number of preemption requests */
+    std::atomic<unsigned long long> signalCnt;      /* number of timer signals received */
+    std::atomic<unsigned long long> overrunHist[SCHEDULE_PREEMPT_OVERRUN_BUCKETS]; /* see SchedulePreemptStats */
+};
+
+/**
+ * @brief Wake state of a processor, updated by the cjthreads it runs and the cjthreads they wake.
+ */
+struct ProcessorWakeInfo {
+    struct CJThread *handoff;                       /* last wakee placed in cjthreadNext by the running cjthread */
+    std::atomic<unsigned long long> affineCnt;      /* wakes placed in cjthreadNext */
+    std::atomic<unsigned long long> handoffCnt;     /* time slices handed to a wakee */
+};
+
+/**
+ * @brief Latency histogram of a processor, written only by the thread running the processor.
+ */
+struct ProcessorLatencyHist {
+    std::atomic<unsigned long long> count;
+    std::atomic<unsigned long long> sumNs;
+    std::atomic<unsigned long long> maxNs;
+    std::atomic<unsigned long long> buckets[SCHEDULE_LATENCY_BUCKETS];
+};
+
+/**
+ * @brief Latency statistics of a processor, see ScheduleLatencyStatsSet.
+ */
+struct ProcessorLatency {
+    unsigned long long sliceStart;                  /* time the running cjthread was picked, 0 if none */
+    struct ProcessorLatencyHist hist[SCHEDULE_LATENCY_KIND_NUM];
+};
+
 /**
  * @brief processor structure
  */
@@ -86,7 +137,7 @@ struct Processor {
     void *schedule;                              /* scheduler */
     unsigned long schedCnt;                      /* schedule count */
     struct ProcessorObservedRecord obRecord;     /* latest state */
-    struct Queue runq;                           /* lockless queue to run cjthread */
+    struct Queue runq;                           /* lockless queue to run cjthread of the normal class */
     struct CJthreadSpinLock lock;                /* lock of local cjthread free list */
     struct ProcessorFreelist freelist;           /* local cjthread free list */
     struct Thread *thread;                       /* bound thread */
@@ -94,6 +145,17 @@ struct Processor {
     void *pArray[PROCESSOR_PARRAY_NUM];          /* processor reserved position. Index 0 is
                                                   *used to store the timer heap structure */
     struct TraceBuf *traceBuf;                   /* processor local trace buffer */
+    struct TraceRing traceRing;                  /* filled trace buffers kept by the flight recorder */
+    struct ProcessorPreempt preempt;             /* time-slice preemption state */
+    int cpu;                                     /* pinned CPU, or the CPU last seen running the processor */
+    struct Thread *cpuThread;                    /* thread running the processor when cpu was recorded */
+    std::atomic<unsigned long long> stealCnt[SCHEDULE_TOPOLOGY_LEVEL_NUM]; /* steals by distance to the victim */
+    struct ProcessorWakeInfo wake;               /* wake-affine and wake-to-run state */
+    struct ProcessorLatency latency;             /* latency histograms */
+    struct Queue highRunq;                       /* running queue of the high class */
+    struct Queue lowRunq;                        /* running queue of the low class */
+    unsigned int agingCnt[CJTHREAD_PRIORITY_NUM]; /* picks that passed over a waiting class */
+    std::atomic<unsigned long long> runningId;   /* id of the cjthread being run, 0 while scheduling */
 };
 
 /**
@@ -102,7 +164,8 @@ struct Processor {
 struct ProcessorInfo {
     unsigned int processorId;                    /* processor id */
     int state;                                   /* processor state, 1 is running */
-    int runqCnt;                                 /* cjthread number of running queue */
+    int runqCnt;                                 /* cjthread number of running queues */
+    int classRunqCnt[CJTHREAD_PRIORITY_NUM];     /* cjthread number of the running queue of each class */
     unsigned long schedCnt;                      /* schedule count */
     unsigned long threadId;                      /* thread id */
 };
@@ -121,7 +184,8 @@ int ProcessorLocalWriteBatch(struct CJThread *cjthread[], unsigned int num);
  * @brief Put the specified cjthread and some cjthreads in the local queue of Processor into
  * the global queue.
  * @par Description: Place 1/4 of the local queue of a specified processor into the global
- * queue and add the specified cjthread to the global queue.
+ * queue and add the specified cjthread to the global queue. The local queue is the one of the
+ * class of the first cjthread, which is the queue that overflowed.
  * @attention
  * @param cjthread    [IN] The cjthread to be added to the running queue.
  * @param num    [IN] Number of cjthreads
@@ -129,6 +193,14 @@ int ProcessorLocalWriteBatch(struct CJThread *cjthread[], unsigned int num);
  */
 int ProcessorGlobalWrite(struct CJThread *cjthreadList[], unsigned int num);
 
+/**
+ * @brief Time the cjthreads entering a running queue for the run-queue wait, see ScheduleLatencyStatsSet.
+ * @par Description: A cjthread moved from one queue to another keeps the time it entered the first.
+ * @param cjthreadList    [IN] cjthreads entering a running queue
+ * @param num    [IN] Number of cjthreads
+ */
+void ProcessorLatencyRunqStamp(struct CJThread *cjthreadList[], unsigned int num);
+
 /**
  * @brief Find the next cjthread to be scheduled.
  * @par Description: Enable the processor to obtain the to-be-scheduled cjthread from the
@@ -204,13 +276,87 @@ MRT_INLINE static struct CJThread *ProcessorCJhreadNextRead(struct Processor *pr
 }
 
 /**
- * @brief Get the first cjthread to run from the local queue
+ * @brief Get CJthreadNext of the processor without taking it
+ * @param  processor        [IN]  processor
+ * @retval cjthread, which may be taken by the processor or a thief at any time
+ */
+MRT_INLINE static struct CJThread *ProcessorCJthreadNextPeek(struct Processor *processor)
+{
+    return atomic_load_explicit(&processor->cjthreadNext, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the local running queue of a priority class
+ * @param  processor        [IN]  processor
+ * @param  priority         [IN]  priority class
+ * @retval running queue
+ */
+MRT_INLINE static struct Queue *ProcessorRunqGet(struct Processor *processor, unsigned int priority)
+{
+    if (priority == CJTHREAD_PRIORITY_HIGH) {
+        return &processor->highRunq;
+    }
+    if (priority == CJTHREAD_PRIORITY_LOW) {
+        return &processor->lowRunq;
+    }
+    return &processor->runq;
+}
+
+/**
+ * @brief Get the number of cjthreads in the local running queues of all classes
+ * @param  processor        [IN]  processor
+ * @retval number of cjthreads
+ */
+MRT_INLINE static unsigned int ProcessorRunqLength(struct Processor *processor)
+{
+    return QueueLength(&processor->highRunq) + QueueLength(&processor->runq) + QueueLength(&processor->lowRunq);
+}
+
+/**
+ * @brief Whether a processor has a cjthread waiting to run, without taking it
+ * @param  processor        [IN]  processor
+ * @retval true if cjthreadNext or a local running queue is not empty
+ */
+MRT_INLINE static bool ProcessorHasReady(struct Processor *processor)
+{
+    return ProcessorCJthreadNextPeek(processor) != nullptr || ProcessorRunqLength(processor) != 0;
+}
+
+/**
+ * @brief Get the first cjthread to run from the local queues
+ * @par Description: Higher classes are picked first. Each pick that passes over a waiting lower
+ * class ages it, and a class aged PROCESSOR_PRIORITY_AGING times is picked next.
  * @param  processor        [IN]  processor
  * @retval cjthread
  */
 MRT_INLINE static struct CJThread *ProcessorLocalRead(struct Processor *processor)
 {
-    return (struct CJThread *)QueuePopHead(&processor->runq);
+    struct CJThread *cjthread;
+    unsigned int priority;
+    unsigned int lower;
+
+    for (priority = CJTHREAD_PRIORITY_NUM - 1; priority > CJTHREAD_PRIORITY_HIGH; priority--) {
+        if (processor->agingCnt[priority] >= PROCESSOR_PRIORITY_AGING) {
+            processor->agingCnt[priority] = 0;
+            cjthread = (struct CJThread *)QueuePopHead(ProcessorRunqGet(processor, priority));
+            if (cjthread != nullptr) {
+                return cjthread;
+            }
+        }
+    }
+    for (priority = CJTHREAD_PRIORITY_HIGH; priority < CJTHREAD_PRIORITY_NUM; priority++) {
+        cjthread = (struct CJThread *)QueuePopHead(ProcessorRunqGet(processor, priority));
+        if (cjthread == nullptr) {
+            continue;
+        }
+        for (lower = priority + 1; lower < CJTHREAD_PRIORITY_NUM; lower++) {
+            if (QueueLength(ProcessorRunqGet(processor, lower)) != 0) {
+                processor->agingCnt[lower]++;
+            }
+        }
+        return cjthread;
+    }
+    return nullptr;
 }
 /**
  * @brief Add a single cjthread to the local queue.
@@ -251,6 +397,17 @@ void ProcessorFreelistPut(struct Processor *processor, struct CJThread *freeCJTh
  */
 struct CJThread *ProcessorFreelistGet(struct Processor *processor);
 
+/**
+ * @brief Obtain cjthread control blocks in bulk.
+ * @par Description: Takes the control blocks from the local free list under one lock, then the
+ * rest from the global free list under one lock.
+ * @param processor    [IN] Processor bound to the current cjthread running
+ * @param list    [OUT] Control blocks obtained
+ * @param num    [IN] Max number of control blocks
+ * @retval Number of control blocks obtained
+ */
+unsigned int ProcessorFreelistGetBatch(struct Processor *processor, struct CJThread **list, unsigned int num);
+
 /**
  * @brief Obtain the information about all running processors.
  * @attention Only information about running processors is obtained.
@@ -22,6 +22,9 @@
 #include "threadlocal.h"
 #include "external.h"
 #include "trace_impl.h"
+#include "topology.h"
+#include "cpuquota.h"
+#include "stackreclaim.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -60,6 +63,8 @@ struct ScheduleGfreeList {
     pthread_mutex_t gfreeLock;          /* global free list lock */
     struct Dulink gfreeList;            /* global free list */
     unsigned int freeCJThreadNum;       /* cjthread num of global free list */
+    struct Dulink cleanList;            /* cjthreads whose stacks are reclaimed, used after gfreeList */
+    unsigned int cleanCJThreadNum;      /* cjthread num of clean list */
 };
 
 /**
@@ -80,6 +85,8 @@ struct ScheduleCJThread {
                                                     * only for the cjthreadMax decision. */
     std::atomic<unsigned long long> preemptCnt;          /* number of preemption times */
     std::atomic<unsigned long long> preemptSyscallCnt;   /* Number of syscall preemption times */
+    std::atomic<unsigned long long> handoffCnt;          /* Number of processor handoffs when
+                                                          * entering blocking regions */
     size_t stackSize;                         /* default stack size */
     bool stackProtect;                        /* whether to enable cjthread stack protection */
     bool stackGrow;                           /* whether to enable cjthread stack scaling */
@@ -102,6 +109,15 @@ struct ScheduleThread {
     std::atomic<unsigned int> searchingNum;     /* searching thread number */
     pthread_mutex_t allthreadMutex;             /* lock of allThreadDulink */
     struct Dulink allThreadList;                /* all thread list */
+    unsigned long long parkSpinMax;             /* max spin of idle threads before sleeping, ns. 0 means disabled */
+    std::atomic<unsigned long long> parkSpinBudget;     /* learned spin of idle threads, ns */
+    std::atomic<unsigned int> parkSpinNum;              /* idle threads spinning */
+    std::atomic<unsigned long long> parkSpinHitCnt;     /* idle periods ended while spinning */
+    std::atomic<unsigned long long> parkSpinSkipCnt;    /* spins skipped for the cap on spinning threads */
+    std::atomic<unsigned long long> parkSpinNs;         /* time spent spinning */
+    std::atomic<unsigned long long> parkCnt;            /* idle periods ended in a sleep */
+    std::atomic<unsigned long long> wakeBatchCnt;       /* calls of ProcessorWakeBatch that woke processors */
+    std::atomic<unsigned long long> wakeBatchNum;       /* processors woken by ProcessorWakeBatch */
 };
 
 /**
@@ -133,9 +149,15 @@ typedef int (*ProcessorExitFunc)(void *processor);
  * @brief Structure of the scheduler processor attribute
  */
 struct ScheduleProcessor {
-    unsigned int processorNum;                         /* processor number */
+    unsigned int processorNum;                         /* processor number, including the offline ones */
     std::atomic<unsigned int> freeNum;                      /* free processor number */
     struct Processor *processorGroup;                  /* processor group */
+    /* Processors below activeNum may run cjthreads, the others are offline or retiring. Only
+     * changed by ScheduleProcessorNumSet on the default scheduler. */
+    std::atomic<unsigned int> activeNum;
+    pthread_mutex_t resizeLock;                        /* serializes the changes of activeNum */
+    std::atomic<unsigned long long> growCnt;           /* times activeNum was raised */
+    std::atomic<unsigned long long> shrinkCnt;         /* times activeNum was lowered */
 };
 
 /**
@@ -143,6 +165,11 @@ struct ScheduleProcessor {
  */
 typedef int (*SchmonCheckFunc)(void *processor, unsigned long long now);
 
+/**
+ * @brief Function pointer defined for the timer deadline hook, returns 0 if the processor has no timer
+ */
+typedef unsigned long long (*SchmonDeadlineFunc)(void *processor);
+
 /* Number of checks running in the monitoring thread */
 #define SCHMON_HOOK_NUM 2
 /* The timer hook is placed at index 0 */
@@ -154,6 +181,14 @@ typedef int (*SchmonCheckFunc)(void *processor, unsigned long long now);
 struct Schmon {
     pthread_t schmonId;                                 /* thread tid */
     SchmonCheckFunc checkFunc[SCHMON_HOOK_NUM];         /* timer hooks */
+    SchmonDeadlineFunc deadlineFunc;                    /* earliest timer deadline of a processor */
+    unsigned long long preemptSlice;                    /* time slice of timer-driven preemption, ns.
+                                                         * 0 means preemption is driven by schmon */
+    bool backoffEnable;                                 /* whether the schmon cycle backs off when idle */
+    std::atomic<bool> backoff;                          /* schmon cycle is longer because all processors
+                                                         * are idle, a processor allocation kicks schmon */
+    int kickFd;                                         /* eventfd that interrupts the backoff, -1 if none */
+    void *kickPd;                                       /* pd of kickFd once it is added to netpoll */
 };
 
 /* nepoll */
@@ -173,6 +208,16 @@ struct ScheduleAttrInner {
     bool stackProtect;                 /* whether to enable cjthread stack protection */
     bool stackGrow;                    /* whether to enable cjthread stack scaling */
     unsigned int processorNum;         /* processor number */
+    unsigned long long busyPollMax;    /* max busy-poll budget of fd waits, ns. 0 means disabled */
+    unsigned long long preemptSlice;   /* time slice of timer-driven preemption, ns. 0 means disabled */
+    bool cpuPin;                       /* whether to pin the processor threads to CPUs */
+    bool wakeHandoff;                  /* whether a waker hands its time slice to the wakee */
+    unsigned int processorMax;         /* processors allocated, 0 means processorNum */
+    bool cpuQuota;                     /* whether the active processors follow the cgroup cpu quota */
+    unsigned long long parkSpinMax;    /* max spin of idle threads before sleeping, ns. 0 means disabled */
+    int stackReclaim;                  /* ScheduleStackReclaimMode of pooled and parked stacks */
+    size_t stackReclaimKeep;           /* bytes kept at the base of a reclaimed stack */
+    bool schmonBackoff;                /* whether the schmon cycle backs off while all processors are idle */
 };
 
 /**
@@ -198,6 +243,11 @@ struct ScheduleManager {
     unsigned long long arkVM = 0;
 
     struct Schmon schmon;
+    struct ScheduleTopology topology;                           /* CPU topology for stealing and pinning */
+    bool wakeHandoff;                                          /* whether wakers hand off their time slice */
+    std::atomic<bool> latencyStats;                            /* whether processors record latencies */
+    struct ScheduleCpuQuota cpuQuota;                          /* cgroup cpu quota followed by the processors */
+    struct ScheduleStackReclaim stackReclaim;                  /* release of pooled and parked stacks */
     ProcessorCheckFunc check[PROCESSOR_HOOK_NUM];               /* check timer */
     ProcessorExitFunc exit[PROCESSOR_PARRAY_NUM];               /* notify the timer exit */
     /* Check whether a timer exists in a processor. Currently, the timer is used only for
@@ -212,6 +262,8 @@ struct ScheduleManager {
     SchdCJThreadStateHookFunc schdCJThreadStateHook[CJTHREAD_STATE_HOOK_BUTT];
     SchdDestructorHookFunc destructorFunc;
     SchdMutatorStatusHookFunc mutatorStatusFunc;
+    std::atomic<SchdParkHookFunc> parkHook;                     /* called after long parks, see CJThreadParkHookSet */
+    std::atomic<unsigned long long> parkHookThreshold;
     std::atomic<unsigned int> cjSingleModeThreadRetryTime;
 
     struct SchdfdManager *schdfdManager = nullptr;
@@ -262,6 +314,14 @@ extern size_t g_pageSize;
 
 extern struct ScheduleManager g_scheduleManager;
 
+/**
+ * @brief Whether the processors record the latency statistics, see ScheduleLatencyStatsSet.
+ */
+MRT_INLINE static bool ScheduleLatencyStatsOn(void)
+{
+    return atomic_load_explicit(&g_scheduleManager.latencyStats, std::memory_order_relaxed);
+}
+
 /**
  * @brief Obtain the processor of the current thread.
  * @retval Pointer to the processor bound to the current cjthread.
@@ -336,6 +396,23 @@ void ProcessorSetspecific(struct Processor *processor, int key, void *value);
  */
 void ProcessorWake(struct Schedule *schedule, void *specPro);
 
+/**
+ * @brief Wakes up processors for a batch of ready cjthreads.
+ * @par Description: ProcessorWake starts at most one searching processor, which wakes the next one
+ * when it finds work. For a batch, the processors are woken in one pass instead, up to the number
+ * of cjthreads, the idle processors and the cap on spinning and searching threads.
+ * @param schedule    [IN] Current scheduler
+ * @param num    [IN] Number of cjthreads made ready.
+ */
+void ProcessorWakeBatch(struct Schedule *schedule, unsigned int num);
+
+/**
+ * @brief Max number of threads spinning or searching for work at a time.
+ * @param schedule    [IN] Current scheduler
+ * @retval A quarter of the active processors, at least 1.
+ */
+unsigned int ProcessorSpinCap(struct Schedule *schedule);
+
 /**
  * @brief Allocate an processor.
  * @par Description: Find a free processor in the processor resource group of the current
@@ -370,6 +447,14 @@ int SchdProcessorHookRegister(ProcessorCheckFunc func, unsigned int key);
  */
 int SchdSchmonHookRegister(SchmonCheckFunc func, unsigned int key);
 
+/**
+ * @brief The schmon of the schedule provides the registration function of the timer deadline hook,
+ * which bounds the schmon cycle when all processors are idle.
+ * @param func    [IN] Function to be registered
+ * @retval 0 or error code
+ */
+int SchdSchmonDeadlineHookRegister(SchmonDeadlineFunc func);
+
 /**
  * @brief schedule The registration function provided for external systems is invoked when
  * the system exits.
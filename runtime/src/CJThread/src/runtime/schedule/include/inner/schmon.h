@@ -40,6 +40,35 @@ int SchmonStart(ScheduleHandle handle);
  */
 void SchmonPreemptRunning(struct Processor *processor);
 
+/**
+ * @brief Start a new time slice of timer-driven preemption, arming the time-slice timer of the
+ * processor for the current thread if needed. Called on the thread bound to the processor.
+ * @param  processor        [IN]  current processor
+ */
+void SchmonPreemptSliceBegin(struct Processor *processor);
+
+/**
+ * @brief Stop the time-slice timer of the processor before it is released.
+ * @param  processor        [IN]  current processor
+ */
+void SchmonPreemptTimerDisarm(struct Processor *processor);
+
+/**
+ * @brief Record the overrun of the pending preemption request when the processor schedules again.
+ * @param  processor        [IN]  current processor
+ */
+void SchmonPreemptOverrunRecord(struct Processor *processor);
+
+/**
+ * @brief Interrupt the backoff wait of schmon, used when a processor starts running.
+ */
+void SchmonKick(void);
+
+/**
+ * @brief Release the kick fd of schmon after schmon exits.
+ */
+void SchmonKickFini(void);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -0,0 +1,113 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_STACKRECLAIM_H
+#define MRT_STACKRECLAIM_H
+
+#include <atomic>
+#include <sched.h>
+#include "macro_def.h"
+#include "schedule.h"
+#include "cjthread.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/* Interval at which schmon reclaims stacks, 1s */
+#define STACK_RECLAIM_CHECK_TIME (1000ULL * 1000 * 1000)
+
+/* Bytes kept at the base of a reclaimed stack by default, 16KB */
+#define STACK_RECLAIM_KEEP_DEFAULT (16UL * 1024)
+
+/* Checks a cjthread stays parked before its stack is shrunk */
+#define STACK_RECLAIM_PARK_EPOCHS 2
+
+/* parkEpoch of a parked cjthread whose stack is shrunk already */
+#define STACK_RECLAIM_EPOCH_DONE (~0U)
+
+/* Smallest release a parked stack is shrunk for, 64KB */
+#define STACK_RECLAIM_PARKED_MIN (64UL * 1024)
+
+/* Stacks reclaimed per hold of a lock */
+#define STACK_RECLAIM_BATCH 64
+
+/* Batches of parked stacks reclaimed per check */
+#define STACK_RECLAIM_PARKED_ROUNDS 16
+
+/* States of CJThread stackReclaiming */
+#define STACK_RECLAIM_IDLE 0
+#define STACK_RECLAIM_BUSY 1        /* schmon is releasing the pages below the parked SP */
+#define STACK_RECLAIM_WAITED 2      /* and a thread sleeps until it is done */
+
+/**
+ * @brief Release of the stack pages of pooled and long-parked cjthreads
+ */
+struct ScheduleStackReclaim {
+    std::atomic<int> mode;                              /* ScheduleStackReclaimMode */
+    size_t keepSize;                                    /* bytes kept at the base, page aligned */
+    std::atomic<unsigned int> epoch;                    /* number of checks, see CJThread parkEpoch */
+    unsigned long long lastCheck;                       /* time of the last check, only used by schmon */
+    std::atomic<unsigned long long> pooledCnt;          /* pooled stacks reclaimed */
+    std::atomic<unsigned long long> parkedCnt;          /* parked stacks reclaimed */
+    std::atomic<unsigned long long> releasedBytes;      /* bytes given back by the reclaims */
+};
+
+/**
+ * @brief Initialize the stack reclaim of the default scheduler.
+ * @param reclaim   [OUT] Stack reclaim.
+ * @param mode      [IN]  ScheduleStackReclaimMode. Ignored if the platform does not support it.
+ * @param keepSize  [IN]  Bytes kept at the base of a stack, rounded up to pages.
+ */
+void StackReclaimInit(struct ScheduleStackReclaim *reclaim, int mode, size_t keepSize);
+
+/**
+ * @brief Reclaim the stacks in the global free list and the stacks of the cjthreads parked for
+ * STACK_RECLAIM_PARK_EPOCHS checks of the default scheduler. Called by schmon without
+ * allScheduleListLock, the locks of the lists are only held to take the stacks out of them.
+ * @param reclaim   [IN] Stack reclaim.
+ * @param now       [IN] Current time, ns.
+ */
+void StackReclaimCheck(struct ScheduleStackReclaim *reclaim, unsigned long long now);
+
+/**
+ * @brief Get the resident bytes of a stack.
+ * @param addr      [IN] Low address of the stack.
+ * @param size      [IN] Size of the stack.
+ * @retval Resident bytes, or size if it is unknown on this platform.
+ */
+size_t StackResidentSize(const char *addr, size_t size);
+
+/* A cjthread that leaves CJTHREAD_PENDING waits until schmon has released the pages below its SP.
+ * The state change must be sequentially consistent and come before this check. The wait is rare
+ * and lasts one madvise, the waiter sleeps on the futex of the flag until schmon clears it. */
+MRT_INLINE static void StackReclaimWait(struct CJThread *cjthread)
+{
+    int state = atomic_load(&cjthread->stackReclaiming);
+
+    while (state != STACK_RECLAIM_IDLE) {
+#ifdef MRT_LINUX
+        if (state == STACK_RECLAIM_BUSY &&
+            !atomic_compare_exchange_strong(&cjthread->stackReclaiming, &state, STACK_RECLAIM_WAITED)) {
+            continue;
+        }
+        (void)SemaphoreFutex(&cjthread->stackReclaiming, FUTEX_WAIT_PRIVATE, STACK_RECLAIM_WAITED);
+#else
+        (void)sched_yield();
+#endif
+        state = atomic_load(&cjthread->stackReclaiming);
+    }
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif
+#endif /* MRT_STACKRECLAIM_H */
@@ -77,6 +77,9 @@ struct Thread {
     struct CJThread *boundCJThread;         /* bound cjthread */
     void *nextProcessor;                    /* next processor to be bound to the thread */
     struct Dulink allThreadDulink;          /* link to thread management queue of the scheduler */
+    bool cpuPinned;                         /* whether the thread is pinned to pinnedCpu */
+    int pinnedCpu;                          /* CPU of the processor the thread was pinned for */
+    void *sigStack;                         /* alternate signal stack, see ThreadSigStackInit */
 };
 
 
@@ -0,0 +1,121 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_TOPOLOGY_H
+#define MRT_TOPOLOGY_H
+
+#include <stdbool.h>
+#ifdef MRT_LINUX
+#include <sched.h>
+#endif
+#include "macro_def.h"
+#include "schedule.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/**
+ * @brief Position of a CPU in the machine topology
+ */
+struct TopologyCpu {
+    int core;                       /* first CPU of the physical core, -1 if unknown */
+    int cache;                      /* first CPU sharing the last level cache, -1 if unknown */
+    int node;                       /* NUMA node, -1 if unknown */
+};
+
+/**
+ * @brief CPU topology of the machine, discovered when the default scheduler is created
+ */
+struct ScheduleTopology {
+    bool valid;                     /* whether the topology is discovered */
+    bool pin;                       /* whether the processor threads are pinned to CPUs */
+    int cpuMax;                     /* largest CPU id plus 1 */
+    struct TopologyCpu *cpus;       /* indexed by CPU id */
+    int *pinOrder;                  /* allowed CPUs in pinning order, one core after another */
+    unsigned int pinNum;            /* number of CPUs in pinOrder */
+    unsigned int nodeNum;           /* number of NUMA nodes */
+#ifdef MRT_LINUX
+    cpu_set_t allowed;              /* affinity mask of the process when the topology was discovered */
+#endif
+};
+
+/**
+ * @brief Discover the CPU topology. Only supported on Linux, where it is read from sysfs.
+ * @param topology  [OUT] Topology.
+ * @param pin       [IN]  Whether the processor threads are pinned to CPUs.
+ * @retval 0 or error code. On failure the topology is not valid and stealing ignores it.
+ */
+int TopologyInit(struct ScheduleTopology *topology, bool pin);
+
+/**
+ * @brief Release the topology.
+ * @param topology  [IN] Topology.
+ */
+void TopologyFini(struct ScheduleTopology *topology);
+
+/**
+ * @brief Get the CPU a processor is pinned to.
+ * @param topology  [IN] Topology.
+ * @param index     [IN] Index of the processor in the default scheduler.
+ * @retval CPU id, or -1 if the processors are not pinned.
+ */
+int TopologyPinCpu(const struct ScheduleTopology *topology, unsigned int index);
+
+/**
+ * @brief Pin the current thread to a CPU.
+ * @param cpu       [IN] CPU id.
+ * @retval 0 or error code
+ */
+int TopologyThreadPin(int cpu);
+
+/**
+ * @brief Let the current thread run on all CPUs allowed when the topology was discovered again.
+ * @par Description: Called when a pinned thread blocks in a syscall after handing off its
+ * processor, so that it does not compete with the next thread of the processor for the CPU.
+ * @param topology  [IN] Topology.
+ * @retval 0 or error code
+ */
+int TopologyThreadUnpin(const struct ScheduleTopology *topology);
+
+/**
+ * @brief Get the CPU the current thread is running on.
+ * @retval CPU id, or -1 if unknown.
+ */
+int TopologyCurrentCpu(void);
+
+/* Distance between two CPUs, see ScheduleTopologyLevel. Unknown CPUs are remote. */
+MRT_INLINE static unsigned int TopologyLevelGet(const struct ScheduleTopology *topology, int cpuA, int cpuB)
+{
+    const struct TopologyCpu *a;
+    const struct TopologyCpu *b;
+
+    if (cpuA < 0 || cpuB < 0 || cpuA >= topology->cpuMax || cpuB >= topology->cpuMax) {
+        return SCHEDULE_TOPOLOGY_REMOTE;
+    }
+    a = &topology->cpus[cpuA];
+    b = &topology->cpus[cpuB];
+    if (cpuA == cpuB || (a->core >= 0 && a->core == b->core)) {
+        return SCHEDULE_TOPOLOGY_SMT;
+    }
+    if (a->cache >= 0 && a->cache == b->cache) {
+        return SCHEDULE_TOPOLOGY_CACHE;
+    }
+    if (a->node >= 0 && a->node == b->node) {
+        return SCHEDULE_TOPOLOGY_NODE;
+    }
+    return SCHEDULE_TOPOLOGY_REMOTE;
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif
+#endif /* MRT_TOPOLOGY_H */
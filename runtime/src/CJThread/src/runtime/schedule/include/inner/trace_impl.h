@@ -44,6 +44,7 @@ extern "C" {
 #define TRACE_UNBLOCK_STRING "CJ_CJThreadReady"
 #define TRACE_UNKNOWN_STRING "?"
 #define TRACE_RUNTIME_STRING "libcangjie-runtime.so"    /* string id is 1 */
+#define TRACE_PAUSE_TIMEOUT_NS (100 * 1000 * 1000)       /* wait of a flight recorder dump for in-flight events */
 
 #ifdef MRT_WINDOWS
 typedef HMODULE DlHandle ;
@@ -82,6 +83,18 @@ typedef unsigned char *(*TraceDumpFunc)(int *len);
  */
 typedef struct CJThread *(*TraceReaderGetFunc)(void);
 
+/**
+ * arg: trace type, window in milliseconds, traceBufs kept per processor
+ * ret: true or false
+ */
+typedef bool (*TraceFlightRecorderStartFunc)(unsigned short traceType, unsigned int windowMs, unsigned int bufNum);
+
+/**
+ * arg: file descriptor
+ * ret: true or false
+ */
+typedef bool (*TraceFlightRecorderDumpFunc)(int fd);
+
 struct TraceHooks {
     TraceDeregisterFunc traceDeregister;
     TraceStartFunc traceStart;
@@ -89,14 +102,26 @@ struct TraceHooks {
     TraceEventFunc traceRecordEvent;
     TraceDumpFunc traceDump;
     TraceReaderGetFunc traceReaderGet;
+    TraceFlightRecorderStartFunc flightRecorderStart;
+    TraceFlightRecorderDumpFunc flightRecorderDump;
 };
 
 struct TraceBufHeader {
     struct Dulink dulink;
     unsigned long long lastTicks;               /* last Event Occurred Event */
+    unsigned long long fullTime;                /* time the traceBuf filled up, ns, flight recorder only */
     int pos;                                    /* array offset */
 };
 
+/**
+ * @brief Filled traceBufs kept by the flight recorder for one processor, oldest first. A zeroed
+ * ring is empty and is initialized by its first push.
+ */
+struct TraceRing {
+    struct Dulink bufHead;
+    unsigned int bufNum;
+};
+
 struct TraceBuf {
     struct TraceBufHeader header;
     unsigned char arr[TRACE_BUF_LENGTH];        /* Path for storing trace events */
@@ -122,10 +147,15 @@ struct Trace {
     struct TraceBuf *reading;                   /* traceBuf of trace data being output */
     struct CJThread *reader;                    /* cjthread for outputting trace data */
     struct CJThread *stopCJThread;              /* cjthread for stop trace */
+    bool flightRecorder;                        /* keep the recent window instead of streaming it */
+    unsigned long long windowNs;                /* window kept by the flight recorder */
+    unsigned int ringBufNum;                    /* filled traceBufs kept per processor */
     /* ------------------------lock protection range-------------------- */
+    std::atomic<bool> paused;                   /* events are dropped while the flight recorder dumps */
     std::atomic<int> eventCount;                /* event count */
     pthread_mutex_t bufLock;                    /* lock that protects the buf */
     struct TraceBuf *buf;                       /* global traceBuf */
+    struct TraceRing bufRing;                   /* filled global traceBufs kept by the flight recorder */
     struct TraceHooks hooks;                    /* trace hooks */
     std::atomic<unsigned long long> stringId;   /* string event id */
     std::atomic<unsigned long long> stackId;    /* stack event id */
@@ -251,6 +251,16 @@ extern "C" {
 */
 #define ERRNO_SCHD_CJTHREAD_PARK_FAILED ((MID_SCHEDULE) | 0x506)
 
+/**
+* @brief 0x10040507 cpu topology is unavailable
+*/
+#define ERRNO_SCHD_TOPOLOGY_UNKNOWN ((MID_SCHEDULE) | 0x507)
+
+/**
+* @brief 0x10040508 cgroup cpu quota is unavailable
+*/
+#define ERRNO_SCHD_CPU_QUOTA_UNKNOWN ((MID_SCHEDULE) | 0x508)
+
 /**
 * @brief The flag bit is set to - 1 when preemption is triggered.
 */
@@ -303,6 +313,23 @@ typedef uintptr_t (*SchdCJThreadHookFunc)(void);
 */
 typedef uintptr_t (*SchdCJThreadStateHookFunc)(void*);
 
+/**
+* @brief What a cjthread parked for, passed to the park hook.
+*/
+enum CJThreadParkKind {
+    CJTHREAD_PARK_OTHER = 0,
+    CJTHREAD_PARK_SYNC = 1,                     /* waitqueues and semaphores */
+    CJTHREAD_PARK_SLEEP = 2,                    /* timer sleeps */
+    CJTHREAD_PARK_NET = 3,                      /* fd events of the netpoll */
+    CJTHREAD_PARK_FILE = 4,                     /* file io of the fileio engine */
+};
+
+/**
+* @brief Hook function called by a cjthread that was parked for long.
+* For details about the registration, see #CJThreadParkHookSet.
+*/
+typedef void (*SchdParkHookFunc)(int kind, unsigned long long parkNs);
+
 /**
 * @brief Hook function for mutator destructor (dedicated to Cangjie GC).
 * For details about the registration, see #CJThreadDestructorHookRegister.
@@ -385,6 +412,18 @@ struct CJThreadInfo {
  */
 #define ATTR_MAX_SIZE 128
 
+/**
+ * @brief Priority class of a cjthread. Each processor keeps one running queue per class and
+ * picks the higher classes first. A lower class that keeps being passed over is served after
+ * PROCESSOR_PRIORITY_AGING picks, so it is never starved.
+ */
+enum CJThreadPriority {
+    CJTHREAD_PRIORITY_HIGH = 0,         /* latency-critical work, such as request handlers */
+    CJTHREAD_PRIORITY_NORMAL,           /* default class */
+    CJTHREAD_PRIORITY_LOW,              /* background work, such as compaction or bulk export */
+    CJTHREAD_PRIORITY_NUM
+};
+
 /**
  * @brief CJThread attribute structure
  */
@@ -419,6 +458,156 @@ enum LuaCJThreadState {
     LUA_CJTHREAD_DONE,
 };
 
+/**
+ * @brief Busy-poll statistics of the schdfd module
+ */
+struct ScheduleBusyPollStats {
+    unsigned long long spinHitCnt;  /* number of fd waits satisfied while busy-polling */
+    unsigned long long spinNs;      /* total time spent busy-polling, in ns */
+    unsigned long long parkCnt;     /* number of fd waits that parked the cjthread */
+    unsigned long long parkNs;      /* total time spent parked on fd waits, in ns */
+};
+
+/**
+ * @brief Topology distance between two CPUs, closest first
+ */
+enum ScheduleTopologyLevel {
+    SCHEDULE_TOPOLOGY_SMT = 0,          /* same physical core */
+    SCHEDULE_TOPOLOGY_CACHE,            /* same last level cache */
+    SCHEDULE_TOPOLOGY_NODE,             /* same NUMA node */
+    SCHEDULE_TOPOLOGY_REMOTE,           /* other NUMA node, or unknown */
+    SCHEDULE_TOPOLOGY_LEVEL_NUM
+};
+
+/**
+ * @brief Work-stealing statistics of the default scheduler
+ */
+struct ScheduleStealStats {
+    unsigned long long stealCnt[SCHEDULE_TOPOLOGY_LEVEL_NUM];   /* steals by distance to the victim */
+    unsigned long long localCnt;    /* steals from victims on the same NUMA node */
+    unsigned long long remoteCnt;   /* steals from victims on other NUMA nodes or at an unknown distance */
+    unsigned int cpuNum;            /* number of CPUs in the topology, 0 if it is unknown */
+    unsigned int nodeNum;           /* number of NUMA nodes in the topology */
+    bool pinned;                    /* whether the processor threads are pinned to CPUs */
+};
+
+/* Number of buckets of the time-slice overrun histogram */
+#define SCHEDULE_PREEMPT_OVERRUN_BUCKETS 20
+
+/**
+ * @brief Time-slice preemption statistics of the default scheduler
+ */
+struct SchedulePreemptStats {
+    unsigned long long sliceNs;     /* time slice of timer-driven preemption, in ns. 0 means schmon-driven */
+    unsigned long long requestCnt;  /* number of preemption requests */
+    unsigned long long signalCnt;   /* number of time-slice timer signals received */
+    /* Overrun is the delay from a preemption request to the next schedule of the processor.
+     * Bucket i counts overruns in [2^i - 1, 2^(i+1) - 1) us, and the last bucket is unbounded. */
+    unsigned long long overrunHist[SCHEDULE_PREEMPT_OVERRUN_BUCKETS];
+};
+
+/* One in this many wakes of a cjthread is timed for the wake-to-run latency histogram, see
+ * SCHEDULE_LATENCY_WAKE_TO_RUN */
+#define SCHEDULE_WAKE_SAMPLE_PERIOD 8
+
+/**
+ * @brief Wake statistics of the default scheduler
+ */
+struct ScheduleWakeStats {
+    unsigned long long affineCnt;   /* wakes placed in the cjthreadNext slot of the waker's processor */
+    unsigned long long handoffCnt;  /* wakes where the waker handed its time slice to the wakee */
+    bool handoff;                   /* whether direct handoff is enabled */
+};
+
+/* Every power of 2 of the latency histograms is split in 2^SCHEDULE_LATENCY_SUB_BITS buckets, so a
+ * bucket is at most 1/8 of its values wide. Latencies of 2^SCHEDULE_LATENCY_MAX_BITS ns and above
+ * fall into the last bucket. */
+#define SCHEDULE_LATENCY_SUB_BITS 3
+#define SCHEDULE_LATENCY_MAX_BITS 40
+#define SCHEDULE_LATENCY_BUCKETS ((SCHEDULE_LATENCY_MAX_BITS - SCHEDULE_LATENCY_SUB_BITS + 1) << \
+                                  SCHEDULE_LATENCY_SUB_BITS)
+
+/**
+ * @brief Latencies recorded by the scheduler latency statistics
+ */
+enum ScheduleLatencyKind {
+    SCHEDULE_LATENCY_RUNQ_WAIT = 0,     /* from a cjthread entering a running queue to it being picked */
+    SCHEDULE_LATENCY_WAKE_TO_RUN,       /* from CJThreadReady to the wakee being picked, sampled once
+                                         * every SCHEDULE_WAKE_SAMPLE_PERIOD wakes at all times */
+    SCHEDULE_LATENCY_SLICE,             /* from a cjthread being picked to it switching out */
+    SCHEDULE_LATENCY_KIND_NUM
+};
+
+/**
+ * @brief Histogram of one latency, see ScheduleLatencyBucketLower for the bounds of the buckets
+ */
+struct ScheduleLatencyHist {
+    unsigned long long count;           /* latencies recorded */
+    unsigned long long sumNs;           /* sum of the latencies, ns */
+    unsigned long long maxNs;           /* largest latency, ns */
+    unsigned long long buckets[SCHEDULE_LATENCY_BUCKETS];
+};
+
+/**
+ * @brief Processor statistics of the default scheduler
+ */
+struct ScheduleProcessorStats {
+    unsigned int activeNum;         /* processors that may run cjthreads */
+    unsigned int capacity;          /* processors allocated, the upper bound of activeNum */
+    unsigned int quotaCpus;         /* CPUs granted by the cgroup quota, rounded up. 0 if unlimited or not followed */
+    bool cpuQuota;                  /* whether activeNum follows the cgroup cpu quota */
+    unsigned long long growCnt;     /* times activeNum was raised */
+    unsigned long long shrinkCnt;   /* times activeNum was lowered */
+};
+
+/**
+ * @brief Park statistics of the idle threads of the default scheduler
+ */
+struct ScheduleParkStats {
+    unsigned long long spinMax;         /* max spin of an idle thread before it sleeps, ns. 0 if disabled */
+    unsigned long long spinBudget;      /* current learned spin, ns */
+    unsigned long long spinHitCnt;      /* idle periods ended while spinning */
+    unsigned long long spinSkipCnt;     /* spins skipped because enough threads were spinning or searching */
+    unsigned long long spinNs;          /* time spent spinning */
+    unsigned long long parkCnt;         /* idle periods ended in a sleep */
+    unsigned long long wakeBatchCnt;    /* wakes of processors for a batch of ready cjthreads */
+    unsigned long long wakeBatchNum;    /* processors woken by these wakes */
+};
+
+/**
+ * @brief How the stacks of pooled and long-parked cjthreads are returned to the OS
+ */
+enum ScheduleStackReclaimMode {
+    SCHEDULE_STACK_RECLAIM_OFF = 0,     /* stacks keep their pages */
+    SCHEDULE_STACK_RECLAIM_FREE,        /* MADV_FREE, the pages are taken back under memory pressure */
+    SCHEDULE_STACK_RECLAIM_DONTNEED,    /* MADV_DONTNEED, the pages are released at once */
+};
+
+/**
+ * @brief Stack memory statistics of all cjthreads
+ */
+struct ScheduleStackStats {
+    int reclaimMode;                    /* ScheduleStackReclaimMode in effect */
+    unsigned long long keepSize;        /* bytes kept at the base of a reclaimed stack */
+    unsigned long long stackNum;        /* cjthreads with a stack, pooled ones included */
+    unsigned long long pooledNum;       /* finished cjthreads kept in the free lists */
+    unsigned long long stackBytes;      /* stack memory allocated */
+    unsigned long long residentBytes;   /* stack memory resident, equal to stackBytes if unknown */
+    unsigned long long pooledReclaimCnt; /* pooled stacks reclaimed */
+    unsigned long long parkedReclaimCnt; /* stacks of long-parked cjthreads reclaimed */
+    unsigned long long releasedBytes;   /* bytes given back by these reclaims */
+};
+
+/**
+ * @brief Load of one processor of the default scheduler
+ */
+struct ScheduleProcessorLoad {
+    unsigned int processorId;           /* processor id */
+    int state;                          /* processor state, 1 is running */
+    unsigned int runqCnt;               /* cjthreads in the running queues of all classes */
+    unsigned long long schedCnt;        /* schedule count */
+};
+
 /**
  * @brief Schedule type
  */
@@ -470,7 +659,10 @@ enum TraceEvent {
     TRACE_EV_CJTHREAD_SYSEXIT = 0x0111,       // 0000 0001 0001 0001 cjthread syscall end [timestamp, CJThreadId]
     TRACE_EV_GC_START = 0x0212,               // 0000 0010 0001 0010 GC start [timestamp]
     TRACE_EV_GC_DONE = 0x0213,                // 0000 0010 0001 0011 GC end [timestamp]
-    TRACE_EV_COUNT = 0x0014,                  // 0000 0000 0001 0100 count evnet
+    TRACE_EV_GC_PHASE = 0x0214,               // 0000 0010 0001 0100 GC phase transition [timestamp, GCPhase]
+    TRACE_EV_GC_STW_START = 0x0215,           // 0000 0010 0001 0101 mutators stop [timestamp, 0 stw / 1 light sync]
+    TRACE_EV_GC_STW_DONE = 0x0216,            // 0000 0010 0001 0110 mutators restart [timestamp]
+    TRACE_EV_COUNT = 0x0017,                  // 0000 0000 0001 0111 count evnet
 };
 
 enum TraceStackFrames {
@@ -578,6 +770,16 @@ void CJThreadAttrStackSizeSet(struct CJThreadAttr *attrUser, unsigned int size);
  */
 void CJThreadAttrCjFromCSet(struct CJThreadAttr *attrUser, bool flag);
 
+/**
+ * @brief set cjthread priority class
+ * @par Cjthreads are created in CJTHREAD_PRIORITY_NORMAL by default. The class only orders the
+ * local running queues of a processor, the global queue stays first in first out.
+ * @param  attrUser   [IN]  cjthread attr
+ * @param  priority   [IN]  priority class, see CJThreadPriority
+ * @retval 0 or error code
+ */
+int CJThreadAttrPrioritySet(struct CJThreadAttr *attrUser, unsigned int priority);
+
 /**
  * @brief Sets the key pair value of the cjthread local variable.
  * @par Description: Sets the key pair value of the cjthread local variable (local_data)
@@ -809,6 +1011,118 @@ int ScheduleAttrStackProtectSet(struct ScheduleAttr *usrAttr, bool open);
  */
 int ScheduleAttrStackGrowSet(struct ScheduleAttr *usrAttr, bool open);
 
+/**
+ * @brief Set the scheduler attribute, that is, the maximum busy-poll budget of fd waits.
+ * @par Description: Before parking a cjthread in SchdfdWait, the fd is polled without blocking
+ * for a budget learned from its recent wait times. The learned budget never exceeds maxNs, and
+ * fds whose waits take much longer than maxNs do not spin at all.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param maxNs   [IN] Maximum budget, in ns. 0 disables busy-poll, which is the default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrBusyPollSet(struct ScheduleAttr *usrAttr, unsigned long long maxNs);
+
+/**
+ * @brief Set the time slice of timer-driven preemption.
+ * @par Description: By default, the schmon thread preempts cjthreads that run for more than 10ms,
+ * which it notices only at its 10ms cycle. With a time slice, each processor of the default
+ * scheduler arms a per-thread timer whose signal requests preemption once the running cjthread
+ * has used up its slice. Only supported on Linux, ignored elsewhere.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param sliceNs [IN] Time slice, in ns. 0 keeps the schmon-driven preemption, which is the default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrPreemptSliceSet(struct ScheduleAttr *usrAttr, unsigned long long sliceNs);
+
+/**
+ * @brief Set whether the processor threads of the default scheduler are pinned to CPUs.
+ * @par Description: Each processor gets a CPU from the affinity mask of the process, one core
+ * after another, and the thread running the processor is moved to that CPU. Stealing always
+ * prefers victims close in the CPU topology, pinning makes their distance stable. Only
+ * supported on Linux, ignored elsewhere.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param pin     [IN] Whether to pin, false by default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrCpuPinSet(struct ScheduleAttr *usrAttr, bool pin);
+
+/**
+ * @brief Set whether a waker hands its time slice to the cjthread it woke.
+ * @par Description: A cjthread woken by a cjthread of the same scheduler is placed in the
+ * cjthreadNext slot of the waker's processor. With direct handoff, the waker also yields once it
+ * releases a mutex, and the wakee runs at once on the rest of the waker's time slice. This helps
+ * ping-pong patterns such as request and response over a blocking queue, at the cost of an extra
+ * switch when the waker had more work to do.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param handoff [IN] Whether to hand off, false by default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrWakeHandoffSet(struct ScheduleAttr *usrAttr, bool handoff);
+
+/**
+ * @brief Set whether the schmon cycle of the default scheduler backs off while all processors are idle.
+ * @par Description: With backoff, the 10ms schmon cycle doubles up to 160ms while all processors
+ * are idle, bounded by the earliest timer deadline, and a processor allocation wakes schmon at
+ * once. This saves wakeups of idle processes at the cost of an eventfd write on the first
+ * processor allocation after an idle period. Only supported on Linux, ignored elsewhere.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param backoff [IN] Whether to back off, false by default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrSchmonBackoffSet(struct ScheduleAttr *usrAttr, bool backoff);
+
+/**
+ * @brief Set the number of processors allocated for the default scheduler.
+ * @par Description: The processor number set by ScheduleAttrProcessorNumSet is the number of
+ * active processors at start. The active processors can later be changed by ScheduleProcessorNumSet
+ * or by the cgroup cpu quota, up to this number. The processors above the active ones stay offline
+ * and cost only their control blocks.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param num     [IN] Number of processors allocated. 0 by default, which means the processor number.
+ * @retval 0 or error code
+ */
+int ScheduleAttrProcessorMaxSet(struct ScheduleAttr *usrAttr, unsigned int num);
+
+/**
+ * @brief Set the max spin of an idle processor thread before it sleeps.
+ * @par Description: A thread whose processor runs out of cjthreads spins on its wake word before it
+ * sleeps, so that a processor handed to it soon does not pay for the sleep and the wakeup. The spin
+ * is learned from the recent idle periods within this bound, and it is skipped while a quarter of
+ * the active processors are already spinning or searching. Only supported on Linux.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param maxNs   [IN] Max spin, in nanoseconds. 0 by default, which disables spinning.
+ * @retval 0 or error code
+ */
+int ScheduleAttrParkSpinSet(struct ScheduleAttr *usrAttr, unsigned long long maxNs);
+
+/**
+ * @brief Set how the stacks of pooled and long-parked cjthreads are returned to the OS.
+ * @par Description: Finished cjthreads are kept in the free lists with their stacks, and parked
+ * cjthreads keep the pages their deepest calls touched. Once a second schmon runs a reclaim epoch.
+ * It releases the pages of the stacks in the global free lists, and of the stacks of cjthreads
+ * that are still parked STACK_RECLAIM_PARK_EPOCHS (2) epochs after the epoch they parked in, that
+ * is after one to two seconds. The keepSize bytes at the base of the stack and, for parked
+ * cjthreads, the pages in use are kept. Parked stacks are only shrunk once per park and when this
+ * releases at least 64KB. Only supported on Linux.
+ * @param usrAttr  [IN] Scheduler attribute.
+ * @param mode     [IN] ScheduleStackReclaimMode. SCHEDULE_STACK_RECLAIM_OFF by default.
+ * @param keepSize [IN] Bytes kept at the base of a stack, rounded up to pages. 16KB by default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrStackReclaimSet(struct ScheduleAttr *usrAttr, int mode, size_t keepSize);
+
+/**
+ * @brief Set whether the active processors of the default scheduler follow the cgroup cpu quota.
+ * @par Description: Schmon reads the quota of the cgroup of the process every second, cpu.max on
+ * cgroup v2 or cpu.cfs_quota_us on v1, and sets the active processors to the granted CPUs rounded
+ * up, within the processors allocated. Without a quota the processor number is used. Only supported
+ * on Linux, ignored elsewhere.
+ * @param usrAttr [IN] Scheduler attribute.
+ * @param follow  [IN] Whether to follow the quota, false by default.
+ * @retval 0 or error code
+ */
+int ScheduleAttrCpuQuotaSet(struct ScheduleAttr *usrAttr, bool follow);
+
 /**
  * @brief Initialize a scheduler.
  * @par Description: Creates a scheduler instance and initializes the cjthread control block,
@@ -1197,6 +1511,16 @@ int CJThreadDestructorHookRegister(SchdDestructorHookFunc func);
  */
 int CJThreadGetMutatorStatusHookRegister(SchdMutatorStatusHookFunc func);
 
+/**
+ * @brief Set the hook called by cjthreads parked for at least thresholdNs.
+ * @par The hook runs on the cjthread once it is running again, within the park call, so it can
+ * take the stack of the park site. Parks are only timed while a hook is set, and the hook can be
+ * set or cleared while the scheduler runs.
+ * @param func    [IN] hook, nullptr to stop timing parks
+ * @param thresholdNs    [IN] shortest park passed to the hook
+ */
+void CJThreadParkHookSet(SchdParkHookFunc func, unsigned long long thresholdNs);
+
 /**
  * @brief Get the mutator of the current cjthread.
  * @par Get the mutator of the current cjthread.
@@ -1319,13 +1643,42 @@ void *CJThreadResultGet(CJThreadHandle cjthread);
  */
 unsigned int ProcessorId(void);
 
+/**
+ * @brief get the id of the processor running the current cjthread without logging, so that it
+ * can be called in signal handlers.
+ * @retval processor id, or -1 if the current thread runs no cjthread on a processor
+ */
+int ProcessorIdTry(void);
+
 /**
  * @brief Check whether the current processor can spin.
  */
 bool ProcessorCanSpin(void);
 
 /**
- * @brief Obtains the number of processors in all existing schedulers.
+ * @brief Get the slot of the processor running the current cjthread, used to tell later whether a
+ * cjthread is still running on it.
+ * @retval Processor id + 1, or 0 if the current thread has no processor.
+ */
+unsigned int ProcessorSlotGet(void);
+
+/**
+ * @brief Check whether a cjthread is running on a processor of the scheduler of the current cjthread.
+ * @param slot        [IN] Processor slot, see ProcessorSlotGet.
+ * @param cjthreadId  [IN] cjthread id.
+ * @retval true if the processor is running the cjthread.
+ */
+bool ProcessorSlotRunning(unsigned int slot, unsigned long long cjthreadId);
+
+/**
+ * @brief Find the active processor of the scheduler of the current cjthread that runs a cjthread.
+ * @param cjthreadId  [IN] cjthread id.
+ * @retval Processor slot, or 0 if the cjthread is not running on any of them.
+ */
+unsigned int ProcessorSlotFind(unsigned long long cjthreadId);
+
+/**
+ * @brief Obtains the number of active processors in all existing schedulers.
  */
 unsigned int ScheduleGetProcessorNum(void);
 
@@ -1345,6 +1698,52 @@ int CJThreadResched(void);
  */
 int CJThreadTryResched(void);
 
+/**
+ * @brief Hands the time slice of the current cjthread to the cjthread it last woke.
+ * @par Description: Only takes effect when direct handoff is enabled, see ScheduleAttrWakeHandoffSet,
+ * and the wakee is still in the cjthreadNext slot of the current processor. The current cjthread is
+ * put back to the running queue and the wakee runs on the rest of its time slice. Call it only
+ * when the current cjthread holds no lock the wakee may need.
+ */
+int CJThreadWakeHandoff(void);
+
+/**
+ * @brief Create cjthreads in bulk with the same attribute and function.
+ * @par Description: In the context of a cjthread of the default scheduler, the control blocks are
+ * taken from the free lists in bulk, and the cjthreads are put into the running queues in one
+ * operation when all of them are created, waking only as many idle processors as needed.
+ * Elsewhere they are created one by one as by CJThreadNew.
+ * @param schedule  [IN] Scheduler to which the cjthreads belong.
+ * @param attrUser  [IN] Startup attribute of the cjthreads, NULL for the default one.
+ * @param func      [IN] Execution function of the cjthreads.
+ * @param argStart  [IN] num parameters of argSize bytes each, one for each cjthread.
+ * @param argSize   [IN] Parameter length of each cjthread.
+ * @param num       [IN] Number of cjthreads.
+ * @param list      [OUT] Handles of the cjthreads created, at least num of them.
+ * @retval Number of cjthreads created. If it is less than num, creating the next one failed.
+ */
+unsigned int CJThreadNewBatch(ScheduleHandle schedule, const struct CJThreadAttr *attrUser, CJThreadFunc func,
+                              const void *argStart, unsigned int argSize, unsigned int num, CJThreadHandle *list);
+
+/**
+ * @brief Defer the cjthreads created by the current cjthread until CJThreadSpawnBatchEnd.
+ * @par Description: Cjthreads created by CJThreadNew for the default scheduler from the current
+ * cjthread are kept in a batch instead of being put into the running queue one by one. Their
+ * control blocks are taken from the free lists in bulk, as many as the expected number. The batch
+ * is submitted when it is full and at CJThreadSpawnBatchEnd, with a single wake of the processors.
+ * Calls can be nested, the outermost pair submits the batch.
+ * @attention Only callable in the context of a cjthread of the default scheduler.
+ * @param num       [IN] Expected number of cjthreads, up to CJTHREAD_SPAWN_BATCH_MAX are held.
+ * @retval 0 or error code
+ */
+int CJThreadSpawnBatchBegin(unsigned int num);
+
+/**
+ * @brief Submit the cjthreads deferred since CJThreadSpawnBatchBegin.
+ * @retval 0 or error code
+ */
+int CJThreadSpawnBatchEnd(void);
+
 /**
  * @brief Enables or disables the scaling function of the current cjthread stack.
  * (This function is dedicated for C.)
@@ -1433,6 +1832,134 @@ unsigned long long ScheduleCJThreadCountPublic(CJthreadStatePublic state);
  */
 unsigned int ScheduleRunningOSThreadCount(void);
 
+/**
+ * @ingroup schedule
+ * @brief Obtain the busy-poll statistics of fd waits.
+ * @param stats     [OUT] Time spent busy-polling versus parking and the number of each.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleBusyPollStatsGet(struct ScheduleBusyPollStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the number of processor handoffs made when cjthreads enter blocking regions.
+ * @retval The sum of the handoff numbers of all existing schedulers.
+ */
+unsigned long long ScheduleBlockingHandoffCount(void);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the time-slice preemption statistics of the default scheduler.
+ * @param stats     [OUT] Preemption requests and the distribution of their overruns.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int SchedulePreemptStatsGet(struct SchedulePreemptStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the work-stealing statistics of the default scheduler.
+ * @param stats     [OUT] Steals by topology distance and the discovered topology.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleStealStatsGet(struct ScheduleStealStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the wake statistics of the default scheduler.
+ * @param stats     [OUT] Affine and handoff wakes, see SCHEDULE_LATENCY_WAKE_TO_RUN for their latency.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleWakeStatsGet(struct ScheduleWakeStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Set the number of active processors of the default scheduler.
+ * @par Description: New processors are brought online at once. A processor taken offline while it
+ * runs a cjthread is preempted, moves its ready cjthreads to the global queue at its next schedule
+ * point and then stops. Its timers are fired by the remaining processors.
+ * @param num       [IN] Number of active processors, in [1, processors allocated].
+ * @retval 0 or error code
+ */
+int ScheduleProcessorNumSet(unsigned int num);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the number of active processors of the default scheduler.
+ * @retval Number of active processors, 0 if the default scheduler is not initialized.
+ */
+unsigned int ScheduleProcessorNumGet(void);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the processor statistics of the default scheduler.
+ * @param stats     [OUT] Active and allocated processors, the cgroup quota and resize counts.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleProcessorStatsGet(struct ScheduleProcessorStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the park statistics of the idle threads of the default scheduler.
+ * @param stats     [OUT] Spins before sleeping, sleeps and batched processor wakes.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleParkStatsGet(struct ScheduleParkStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the stack memory statistics of all cjthreads.
+ * @par Description: The resident bytes are found with mincore on every stack, so the cost grows
+ * with the number of cjthreads.
+ * @param stats     [OUT] Stacks, their resident bytes and the reclaims done.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleStackStatsGet(struct ScheduleStackStats *stats);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the load of the processors of the default scheduler that are not idle or offline.
+ * @param loads     [OUT] Load of each processor.
+ * @param num       [IN] Length of loads.
+ * @retval Number of processors filled in.
+ */
+unsigned int ScheduleProcessorLoadGet(struct ScheduleProcessorLoad loads[], unsigned int num);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the number of timers of all processors, sleeps and timeouts included.
+ * @retval Number of timers, 0 if the timer module is not loaded.
+ */
+unsigned int ScheduleTimerNumGet(void);
+
+/**
+ * @ingroup schedule
+ * @brief Start or stop the latency statistics of the default scheduler.
+ * @par Description: While they run, every processor records the run-queue wait and the time slice
+ * of the cjthreads it runs into histograms of its own, which costs two clock reads per schedule.
+ * The histograms are kept when the statistics stop. The wake-to-run histogram does not depend on
+ * them, it is sampled at all times.
+ * @param enable    [IN] Whether to record.
+ * @retval If g_scheduleManager is not initialized, an error code is returned. Otherwise 0.
+ */
+int ScheduleLatencyStatsSet(bool enable);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain a latency histogram of the default scheduler.
+ * @param kind          [IN] ScheduleLatencyKind.
+ * @param processorId   [IN] Processor whose histogram is read, or -1 for the sum of all processors.
+ * @param hist          [OUT] Histogram.
+ * @retval If g_scheduleManager is not initialized or the processor does not exist, an error code
+ * is returned. Otherwise 0.
+ */
+int ScheduleLatencyStatsGet(int kind, int processorId, struct ScheduleLatencyHist *hist);
+
+/**
+ * @ingroup schedule
+ * @brief Obtain the lower bound of a bucket of the latency histograms, in ns.
+ */
+unsigned long long ScheduleLatencyBucketLower(unsigned int index);
+
 /**
  * @ingroup The scheduler provides the trace enable method for external systems.
  * @brief The trace is loaded as a dynamic library on demand. This method is provided for
@@ -1458,6 +1985,26 @@ bool ScheduleStopTrace(void);
  */
 unsigned char *ScheduleDumpTrace(int *len);
 
+/**
+ * @ingroup The scheduler provides the flight recorder enable method for external systems.
+ * @brief The flight recorder is the trace kept in a ring of trace buffers per processor
+ * instead of being streamed, so that the latest window of events can be dumped at any time.
+ * It is loaded as the trace dynamic library and disabled by ScheduleStopTrace.
+ * @param traceType    [IN] Trace type. Enable one or more types of collection.
+ * @param windowMs     [IN] Trace buffers filled earlier than the window are dropped.
+ * @param bufNum       [IN] Filled trace buffers of 64 KB kept per processor at most.
+ */
+bool ScheduleStartFlightRecorder(unsigned short traceType, unsigned int windowMs, unsigned int bufNum);
+
+/**
+ * @ingroup The scheduler provides the flight recorder output interface for external systems.
+ * @brief Write the window of the flight recorder to fd, in the format of ScheduleDumpTrace.
+ * Events are dropped while it is written.
+ * @param fd      [IN] File descriptor
+ * @retval true or false
+ */
+bool ScheduleDumpFlightRecorder(int fd);
+
 /**
  * @ingroup The scheduler provides an interface for recording trace events externally.
  * @brief The scheduler provides the interface for recording trace events externally.
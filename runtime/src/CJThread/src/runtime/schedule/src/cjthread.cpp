@@ -15,6 +15,7 @@
 #include "thread.h"
 #include "log.h"
 #include "securec.h"
+#include "basetime.h"
 
 #include "Mutator/Mutator.inline.h"
 
@@ -178,6 +179,13 @@ MRT_STATIC_INLINE int CJThreadInit(struct CJThread *newCJThread, struct ArgAttr
     DulinkInit(&(newCJThread->schdDulink));
     atomic_store_explicit(&newCJThread->state, CJTHREAD_IDLE, std::memory_order_relaxed);
     newCJThread->name[0] = '\0';
+    newCJThread->priority = CJTHREAD_PRIORITY_NORMAL;
+    newCJThread->wakeSeq = 0;
+    newCJThread->readyTime = 0;
+    newCJThread->runqTime = 0;
+    newCJThread->spawnBatch = nullptr;
+    newCJThread->parkEpoch = 0;
+    atomic_store_explicit(&newCJThread->stackReclaiming, STACK_RECLAIM_IDLE, std::memory_order_relaxed);
 
     return 0;
 }
@@ -429,17 +437,20 @@ struct CJThread *CJThreadMemAlloc(struct Schedule *schedule, struct StackAttr *s
     return cjthread;
 }
 
-/* Alloc CJThread. */
-struct CJThread *CJThreadAlloc(struct Schedule *schedule, struct ArgAttr *argAttr,
-                               struct StackAttr *stackAttr, CJThreadBuf coBuf,
-                               CJThreadCreateSource createSource)
+/* Alloc CJThread. A spawn batch provides control blocks taken from the free lists in bulk. */
+static struct CJThread *CJThreadAllocCached(struct Schedule *schedule, struct ArgAttr *argAttr,
+                                            struct StackAttr *stackAttr, CJThreadBuf coBuf,
+                                            CJThreadCreateSource createSource, struct CJThreadSpawnBatch *batch)
 {
     int error;
     struct CJThread *newCJThread = nullptr;
     struct ScheduleCJThread *scheduleCJThread = &(schedule->schdCJThread);
     bool addToList = false;
 
-    if (stackAttr->stackSizeAlign == schedule->schdCJThread.stackSize && coBuf == LOCAL_BUF) {
+    if (stackAttr->stackSizeAlign == schedule->schdCJThread.stackSize && coBuf == LOCAL_BUF &&
+        batch != nullptr && batch->cachedNum != 0) {
+        newCJThread = batch->cached[--batch->cachedNum];
+    } else if (stackAttr->stackSizeAlign == schedule->schdCJThread.stackSize && coBuf == LOCAL_BUF) {
         newCJThread = ProcessorFreelistGet(ProcessorGet());
     } else if (stackAttr->stackSizeAlign == schedule->schdCJThread.stackSize && coBuf == GLOBAL_BUF) {
         newCJThread = ScheduleGfreelistGet(&scheduleCJThread->gfreelist);
@@ -480,6 +491,13 @@ struct CJThread *CJThreadAlloc(struct Schedule *schedule, struct ArgAttr *argAtt
     return newCJThread;
 }
 
+struct CJThread *CJThreadAlloc(struct Schedule *schedule, struct ArgAttr *argAttr,
+                               struct StackAttr *stackAttr, CJThreadBuf coBuf,
+                               CJThreadCreateSource createSource)
+{
+    return CJThreadAllocCached(schedule, argAttr, stackAttr, coBuf, createSource, nullptr);
+}
+
 /* CJThreadMexit */
 void *CJThreadMexit(struct CJThread *delCJThread)
 {
@@ -542,6 +560,11 @@ void *CJThreadEntry(struct CJThread *cjthread)
 #ifdef __OHOS__
     PopUIThreadStackTop();
 #endif
+    // Submit the spawns deferred by an unbalanced CJThreadSpawnBatchBegin.
+    if (cjthread->spawnBatch != nullptr) {
+        cjthread->spawnBatch->depth = 1;
+        (void)CJThreadSpawnBatchEnd();
+    }
     // cjthread exit. Switch cjthread to cjthread0, release cjthread and switch the next
     CJThreadExit();
 
@@ -711,6 +734,7 @@ void CJThreadAttrInit(struct CJThreadAttr *attrUser)
     attr->named = false;
 
     attr->cjFromC = false;
+    attr->priority = CJTHREAD_PRIORITY_NORMAL;
     attr->hasSpecificData = false;
 }
 
@@ -749,6 +773,16 @@ void CJThreadAttrCjFromCSet(struct CJThreadAttr *attrUser, bool flag)
     attr->cjFromC = flag;
 }
 
+int CJThreadAttrPrioritySet(struct CJThreadAttr *attrUser, unsigned int priority)
+{
+    struct CJThreadAttrInner *attr = reinterpret_cast<struct CJThreadAttrInner *>(attrUser);
+    if (attrUser == nullptr || priority >= CJTHREAD_PRIORITY_NUM) {
+        return ERRNO_SCHD_CJTHREAD_ARG_INVALID;
+    }
+    attr->priority = priority;
+    return 0;
+}
+
 /* Set the relevant parameters of the cjthread local variable. */
 int CJThreadAttrSpecificSet(struct CJThreadAttr *attrUser, unsigned int num,
                             struct CJThreadSpecificDataInner *data)
@@ -832,8 +866,9 @@ MRT_INLINE static void CJThreadNewSetAttr(const struct CJThreadAttrInner *attr,
     }
 }
 
-struct CJThread* CJThreadBuild(ScheduleHandle schedule, const struct CJThreadAttr *attrUser, CJThreadFunc func,
-                               const void *argStart, unsigned int argSize, CJThreadCreateSource createSource)
+static struct CJThread *CJThreadBuildCached(ScheduleHandle schedule, const struct CJThreadAttr *attrUser,
+                                            CJThreadFunc func, const void *argStart, unsigned int argSize,
+                                            CJThreadCreateSource createSource, struct CJThreadSpawnBatch *batch)
 {
     struct StackAttr stackAttr;
     struct CJThread *newCJThread;
@@ -869,7 +904,7 @@ struct CJThread* CJThreadBuild(ScheduleHandle schedule, const struct CJThreadAtt
     if (targetSchedule->scheduleType != SCHEDULE_DEFAULT) {
         atomic_fetch_add(&scheduleCJThread->cjthreadNum, 1ULL);
     }
-    newCJThread = CJThreadAlloc(targetSchedule, &argAttr, &stackAttr, buf, createSource);
+    newCJThread = CJThreadAllocCached(targetSchedule, &argAttr, &stackAttr, buf, createSource, batch);
     if (newCJThread == nullptr) {
         if (targetSchedule->scheduleType != SCHEDULE_DEFAULT) {
             atomic_fetch_sub(&scheduleCJThread->cjthreadNum, 1ULL);
@@ -878,6 +913,9 @@ struct CJThread* CJThreadBuild(ScheduleHandle schedule, const struct CJThreadAtt
     }
 
     CJThreadNewSetLocalData(newCJThread, attr);
+    if (attr != nullptr && attr->priority < CJTHREAD_PRIORITY_NUM) {
+        newCJThread->priority = attr->priority;
+    }
 
 #if defined(CANGJIE_TSAN_SUPPORT)
     MapleRuntime::Sanitizer::TsanNewRaceState(newCJThread, CJThreadGet(), __builtin_return_address(0));
@@ -891,6 +929,12 @@ struct CJThread* CJThreadBuild(ScheduleHandle schedule, const struct CJThreadAtt
     return newCJThread;
 }
 
+struct CJThread* CJThreadBuild(ScheduleHandle schedule, const struct CJThreadAttr *attrUser, CJThreadFunc func,
+                               const void *argStart, unsigned int argSize, CJThreadCreateSource createSource)
+{
+    return CJThreadBuildCached(schedule, attrUser, func, argStart, argSize, createSource, nullptr);
+}
+
 void ExclusiveExecutor(struct Thread* thread, struct CJThread* newCJThread)
 {
     // Save old scheduler and processor before switching
@@ -1014,6 +1058,29 @@ CJThreadHandle ExclusiveCJThreadNew(CJThreadFunc func,
     return newCJThread;
 }
 
+/* Put the cjthreads of a spawn batch into the running queues and wake the processors. */
+static void CJThreadSpawnBatchFlush(struct CJThreadSpawnBatch *batch)
+{
+    int error;
+
+    if (batch->num == 0) {
+        return;
+    }
+    error = CJThreadAddBatch(reinterpret_cast<CJThreadHandle *>(batch->list), batch->num);
+    if (error) {
+        LOG_ERROR(error, "CJThreadAddBatch failed");
+    }
+    batch->num = 0;
+}
+
+MRT_STATIC_INLINE void CJThreadSpawnBatchAdd(struct CJThreadSpawnBatch *batch, struct CJThread *cjthread)
+{
+    if (batch->num == batch->capacity) {
+        CJThreadSpawnBatchFlush(batch);
+    }
+    batch->list[batch->num++] = cjthread;
+}
+
 /* Create a cjthread in the cjthread context. */
 CJThreadHandle CJThreadNew(ScheduleHandle schedule, const struct CJThreadAttr *attrUser, CJThreadFunc func,
                            const void *argStart, unsigned int argSize, CJThreadCreateSource createSource)
@@ -1028,16 +1095,21 @@ CJThreadHandle CJThreadNew(ScheduleHandle schedule, const struct CJThreadAttr *a
     struct Schedule *currentSchedule;
     struct Schedule *targetSchedule = (struct Schedule *)schedule;
     struct ScheduleCJThread *scheduleCJThread = &targetSchedule->schdCJThread;
+    struct CJThreadSpawnBatch *batch = nullptr;
     currentSchedule = ScheduleGet();
-    struct CJThread* newCJThread = CJThreadBuild(schedule, attrUser, func, argStart, argSize, createSource);
+    CJThreadBuf buf = (CJThreadGet() == nullptr || currentSchedule != targetSchedule ||
+                       createSource == CJTHREAD_CREATE_SOURCE_SIGNAL) ? GLOBAL_BUF : LOCAL_BUF;
+    if (buf == LOCAL_BUF && targetSchedule->scheduleType == SCHEDULE_DEFAULT) {
+        batch = CJThreadGet()->spawnBatch;
+    }
+    struct CJThread* newCJThread = CJThreadBuildCached(schedule, attrUser, func, argStart, argSize, createSource,
+                                                       batch);
     if (newCJThread == nullptr) {
         HILOG_ERROR(ERRNO_SCHD_CJTHREAD_NULL, "build cjthread failed");
         return nullptr;
     }
     // Set cjthread id in CJThreadNew
     CJThreadSetId(newCJThread, cjthreadId);
-    CJThreadBuf buf = (CJThreadGet() == nullptr || currentSchedule != targetSchedule ||
-                       createSource == CJTHREAD_CREATE_SOURCE_SIGNAL) ? GLOBAL_BUF : LOCAL_BUF;
 #ifdef __OHOS__
     TRACE_FINISH_ASYNC(TRACE_CJTHREAD_NEW, cjthreadId);
 #elif defined(__ANDROID__)
@@ -1052,6 +1124,8 @@ CJThreadHandle CJThreadNew(ScheduleHandle schedule, const struct CJThreadAttr *a
         error = 0;
     } else if (buf == GLOBAL_BUF) {
         error = ScheduleGlobalWrite(&newCJThread, 1);
+    } else if (batch != nullptr) {
+        CJThreadSpawnBatchAdd(batch, newCJThread);
     } else {
         error = ProcessorLocalWrite(newCJThread);
     }
@@ -1073,6 +1147,10 @@ CJThreadHandle CJThreadNew(ScheduleHandle schedule, const struct CJThreadAttr *a
         g_scheduleManager.postTaskFunc != nullptr) {
         return newCJThread;
     }
+    // Processors are woken when the batch is submitted.
+    if (batch != nullptr) {
+        return newCJThread;
+    }
     
     // Attempt to start a thread to perform scheduling.
     ProcessorWake(targetSchedule, nullptr);
@@ -1140,6 +1218,12 @@ int CJThreadStateHookRegister(SchdCJThreadStateHookFunc func, CJThreadStateHook
     return 0;
 }
 
+/* Record the park for the stack reclaim of schmon, see StackReclaimParked. */
+MRT_STATIC_INLINE void CJThreadParkEpochSet(struct CJThread *parkCJThread)
+{
+    parkCJThread->parkEpoch = atomic_load_explicit(&g_scheduleManager.stackReclaim.epoch, std::memory_order_relaxed);
+}
+
 void *CJThreadMpark(struct CJThread *parkCJThread)
 {
     int error;
@@ -1152,6 +1236,7 @@ void *CJThreadMpark(struct CJThread *parkCJThread)
     }
     auto& context = parkCJThread->context;
     mutator->PreparedToPark((void*)context.GetPC(), (void*)context.GetFrameAddress());
+    CJThreadParkEpochSet(parkCJThread);
     atomic_store_explicit(&parkCJThread->state, CJTHREAD_PENDING, std::memory_order_relaxed);
     cjthread0 = CJThreadGet();
 #ifdef CANGJIE_ASAN_SUPPORT
@@ -1165,7 +1250,8 @@ void *CJThreadMpark(struct CJThread *parkCJThread)
         error = callbackFunc(cjthread0->argStart, (CJThreadHandle)parkCJThread);
         if (error != 0) {
             // If the callback function fails, roll back to park_cjthread.
-            atomic_store_explicit(&parkCJThread->state, CJTHREAD_RUNNING, std::memory_order_relaxed);
+            atomic_store(&parkCJThread->state, CJTHREAD_RUNNING);
+            StackReclaimWait(parkCJThread);
             parkCJThread->result = error;
             MapleRuntime::ThreadLocalData* tlData = MapleRuntime::ThreadLocal::GetThreadLocalData();
             tlData->mutator = mutator;
@@ -1243,7 +1329,7 @@ int CJThreadParkInForeignThread(CJThread* cjthread, ParkCallbackFunc func, void
 }
 
 /* Park the current cjthread and schedule the next cjthread. */
-int CJThreadPark(ParkCallbackFunc func, TraceEvent waitReason, void *arg)
+static int CJThreadParkInner(ParkCallbackFunc func, TraceEvent waitReason, void *arg)
 {
     struct CJThread *cjthread0;
     struct CJThread *cjthread;
@@ -1300,6 +1386,55 @@ int CJThreadPark(ParkCallbackFunc func, TraceEvent waitReason, void *arg)
     return cjthread->result;
 }
 
+int CJThreadParkFor(ParkCallbackFunc func, TraceEvent waitReason, CJThreadParkKind kind, void *arg)
+{
+    SchdParkHookFunc hook = atomic_load_explicit(&g_scheduleManager.parkHook, std::memory_order_acquire);
+    unsigned long long start;
+    unsigned long long parkNs;
+    int ret;
+
+    if (LIKELY(hook == nullptr)) {
+        return CJThreadParkInner(func, waitReason, arg);
+    }
+    start = CurrentNanotimeGet();
+    ret = CJThreadParkInner(func, waitReason, arg);
+    parkNs = CurrentNanotimeGet() - start;
+    // The hook may have been cleared while the cjthread was parked.
+    hook = atomic_load_explicit(&g_scheduleManager.parkHook, std::memory_order_acquire);
+    if (hook != nullptr &&
+        parkNs >= atomic_load_explicit(&g_scheduleManager.parkHookThreshold, std::memory_order_relaxed)) {
+        hook(static_cast<int>(kind), parkNs);
+    }
+    return ret;
+}
+
+int CJThreadPark(ParkCallbackFunc func, TraceEvent waitReason, void *arg)
+{
+    CJThreadParkKind kind;
+
+    switch (waitReason) {
+        case TRACE_EV_CJTHREAD_BLOCK_SYNC:
+            kind = CJTHREAD_PARK_SYNC;
+            break;
+        case TRACE_EV_CJTHREAD_SLEEP:
+            kind = CJTHREAD_PARK_SLEEP;
+            break;
+        case TRACE_EV_CJTHREAD_BLOCK_NET:
+            kind = CJTHREAD_PARK_NET;
+            break;
+        default:
+            kind = CJTHREAD_PARK_OTHER;
+            break;
+    }
+    return CJThreadParkFor(func, waitReason, kind, arg);
+}
+
+void CJThreadParkHookSet(SchdParkHookFunc func, unsigned long long thresholdNs)
+{
+    atomic_store_explicit(&g_scheduleManager.parkHookThreshold, thresholdNs, std::memory_order_relaxed);
+    atomic_store_explicit(&g_scheduleManager.parkHook, func, std::memory_order_release);
+}
+
 void CJThreadWait()
 {
     CJThreadPark(NULL, TRACE_EV_CJTHREAD_BLOCK, NULL);
@@ -1321,6 +1456,7 @@ void *CJThreadMRAW(struct CJThread *parkCJThread)
         MapleRuntime::Mutator* mutator = parkCJThread->mutator;
         auto& context = parkCJThread->context;
         mutator->PreparedToPark((void*)context.GetPC(), (void*)context.GetFrameAddress());
+        CJThreadParkEpochSet(parkCJThread);
         atomic_store_explicit(&parkCJThread->state, CJTHREAD_PENDING, std::memory_order_relaxed);
     }
     /* END COPY */
@@ -1332,7 +1468,9 @@ void *CJThreadMRAW(struct CJThread *parkCJThread)
 
     /* COPIED AND MODIFIED FROM ProcessorSchedule() */
     {
-        atomic_store_explicit(&nextCJThread->state, CJTHREAD_RUNNING, std::memory_order_relaxed);
+        atomic_store(&nextCJThread->state, CJTHREAD_RUNNING);
+        StackReclaimWait(nextCJThread);
+        atomic_store_explicit(&ProcessorGet()->runningId, nextCJThread->id, std::memory_order_relaxed);
         ProtectAddrSet((uintptr_t)nextCJThread->stack.stackGuard);
         if (nextCJThread->boundThread != nullptr) {
             LOG_ERROR(-1, "BOUND THREADS NOT SUPPORTED WITH EFFECTS");
@@ -1385,6 +1523,9 @@ void *CJThreadMresched(struct CJThread *reCJThread)
     mutator->PreparedToPark((void*)context.GetPC(), (void*)context.GetFrameAddress());
     struct CJThread *lastCJThread;
     atomic_store_explicit(&reCJThread->state, CJTHREAD_READY, std::memory_order_relaxed);
+    if (ScheduleLatencyStatsOn()) {
+        ProcessorLatencyRunqStamp(&reCJThread, 1);
+    }
     // If the global queue is not empty, the cjthread is added into the global queue.
     // Otherwise, the cjthread is recorded in lastCJThread of the scheduler and the last
     // reschedule cjthread is added to the local queue. Minimize access to global queues
@@ -1466,6 +1607,37 @@ void CJThreadPreemptResched(void)
     CJThreadResched();
 }
 
+int CJThreadWakeHandoff(void)
+{
+    struct CJThread *cjthread;
+    struct Processor *processor;
+    struct CJThread *wakee;
+
+    if (!g_scheduleManager.wakeHandoff) {
+        return 0;
+    }
+    cjthread = CJThreadGet();
+    if (cjthread == nullptr || cjthread->isCJThread0 || cjthread->preemptOffCnt != 0 ||
+        cjthread->schedule->scheduleType != SCHEDULE_DEFAULT) {
+        return 0;
+    }
+    processor = ProcessorGet();
+    wakee = processor->wake.handoff;
+    if (wakee == nullptr) {
+        return 0;
+    }
+    processor->wake.handoff = nullptr;
+    // The wakee may have been stolen or pushed out of cjthreadNext by a later wake.
+    if (atomic_load_explicit(&processor->cjthreadNext, std::memory_order_relaxed) != wakee) {
+        return 0;
+    }
+    atomic_store_explicit(&processor->wake.handoffCnt,
+                          atomic_load_explicit(&processor->wake.handoffCnt, std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+    // cjthreadNext is picked before the running queue and inherits the time slice.
+    return CJThreadResched();
+}
+
 bool ShouldWakeDirectly(Schedule* schedule, CJThread* cjthread)
 {
     // If cj thread is in foreign or exclusive thread schedule, just wake this schedule.
@@ -1487,6 +1659,22 @@ bool ShouldWakeDirectly(Schedule* schedule, CJThread* cjthread)
     return false;
 }
 
+/* Account a wake placed in cjthreadNext of the current processor. Only the processor's own
+ * thread writes the counters, the readers accept a relaxed view. */
+MRT_STATIC_INLINE void CJThreadWakeAffineRecord(struct CJThread *wakee)
+{
+    struct Processor *processor = ProcessorGet();
+    struct CJThread *waker = CJThreadGet();
+
+    atomic_store_explicit(&processor->wake.affineCnt,
+                          atomic_load_explicit(&processor->wake.affineCnt, std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+    // Wakes from cjthread0, such as expired timers, have no time slice to hand off.
+    if (g_scheduleManager.wakeHandoff && !waker->isCJThread0) {
+        processor->wake.handoff = wakee;
+    }
+}
+
 /* CJThread ready, adds the specified cjthread to the running queue. */
 void CJThreadReady(CJThreadHandle readyCJThread)
 {
@@ -1511,6 +1699,7 @@ void CJThreadReady(CJThreadHandle readyCJThread)
     schedule = cjthread->schedule;
     // Use CAS to prevent CJThreadReady concurrency. CAS may fail, which is normal.
     if (atomic_compare_exchange_strong(&cjthread->state, &expected, CJTHREAD_READY)) {
+        StackReclaimWait(cjthread);
         // If cj thread is in foreign thread schedule, just wake this schedule,
         // do not push cjthread to global or local list.
         if (ShouldWakeDirectly(schedule, cjthread)) {
@@ -1523,10 +1712,17 @@ void CJThreadReady(CJThreadHandle readyCJThread)
             AddToCJSingleModeThreadList(cjthread);
             return;
         }
+        // The wakee is timed before it is published to a queue, where it may run at once.
+        if (schedule->scheduleType == SCHEDULE_DEFAULT &&
+            (++cjthread->wakeSeq & (SCHEDULE_WAKE_SAMPLE_PERIOD - 1)) == 0) {
+            cjthread->readyTime = CurrentNanotimeGet();
+        }
         if (ScheduleGet() != schedule || CJThreadGet() == nullptr) {
             ScheduleGlobalWrite(&cjthread, 1);
         } else {
+            // Wake-affine: the wakee runs next on the waker's processor, which has its data in cache.
             ProcessorLocalWrite(cjthread);
+            CJThreadWakeAffineRecord(cjthread);
         }
         ProcessorWake(schedule, nullptr);
     }
@@ -1540,7 +1736,6 @@ int CJThreadAddBatch(CJThreadHandle *list, unsigned int num)
     struct CJThread *cjthread;
     struct Schedule *schedule;
     unsigned int proNum;
-    unsigned int i;
 
     if (num == 0) {
         return 0;
@@ -1554,9 +1749,7 @@ int CJThreadAddBatch(CJThreadHandle *list, unsigned int num)
             LOG_ERROR(error, "ScheduleGlobalWrite failed");
             return error;
         }
-        for (i = 0; i < num; i++) {
-            ProcessorWake(schedule, nullptr);
-        }
+        ProcessorWakeBatch(schedule, num);
     } else {
         proNum = schedule->schdProcessor.freeNum;
         if (proNum >= num) {
@@ -1567,9 +1760,7 @@ int CJThreadAddBatch(CJThreadHandle *list, unsigned int num)
                 LOG_ERROR(error, "ScheduleGlobalWrite failed");
                 return error;
             }
-            for (i = 0; i < num; i++) {
-                ProcessorWake(schedule, nullptr);
-            }
+            ProcessorWakeBatch(schedule, num);
         } else {
             // If the number of free processors is less than the number of cjthreads, n cjthreads
             // are selected to enter the global queue (n indicates the number of idle processors
@@ -1584,14 +1775,95 @@ int CJThreadAddBatch(CJThreadHandle *list, unsigned int num)
                 LOG_ERROR(error, "ProcessorLocalWriteBatch failed");
                 return error;
             }
-            for (i = 0; i < proNum; i++) {
-                ProcessorWake(schedule, nullptr);
-            }
+            ProcessorWakeBatch(schedule, proNum);
         }
     }
     return 0;
 }
 
+int CJThreadSpawnBatchBegin(unsigned int num)
+{
+    struct CJThread *cjthread = CJThreadGet();
+    struct Schedule *schedule = ScheduleGet();
+    struct CJThreadSpawnBatch *batch;
+    unsigned int capacity;
+
+    if (cjthread == nullptr || schedule == nullptr || schedule->scheduleType != SCHEDULE_DEFAULT ||
+        cjthread->isCJThread0) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (cjthread->spawnBatch != nullptr) {
+        cjthread->spawnBatch->depth++;
+        return 0;
+    }
+    capacity = num == 0 ? 1 : (num > CJTHREAD_SPAWN_BATCH_MAX ? CJTHREAD_SPAWN_BATCH_MAX : num);
+    // The batch and its two arrays are allocated at once.
+    batch = static_cast<struct CJThreadSpawnBatch *>(
+        malloc(sizeof(struct CJThreadSpawnBatch) + sizeof(struct CJThread *) * capacity * 2));
+    if (batch == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_MALLOC_FAILED, "spawn batch malloc failed");
+        return ERRNO_SCHD_MALLOC_FAILED;
+    }
+    batch->depth = 1;
+    batch->capacity = capacity;
+    batch->num = 0;
+    batch->list = reinterpret_cast<struct CJThread **>(batch + 1);
+    batch->cached = batch->list + capacity;
+    // Only cjthreads with the default stack size reuse control blocks.
+    batch->cachedNum = ProcessorFreelistGetBatch(ProcessorGet(), batch->cached, capacity);
+    cjthread->spawnBatch = batch;
+    return 0;
+}
+
+int CJThreadSpawnBatchEnd(void)
+{
+    struct CJThread *cjthread = CJThreadGet();
+    struct CJThreadSpawnBatch *batch;
+    unsigned int i;
+
+    if (cjthread == nullptr || cjthread->spawnBatch == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    batch = cjthread->spawnBatch;
+    if (--batch->depth != 0) {
+        return 0;
+    }
+    cjthread->spawnBatch = nullptr;
+    CJThreadSpawnBatchFlush(batch);
+    // Return the control blocks not used.
+    for (i = 0; i < batch->cachedNum; i++) {
+        ProcessorFreelistPut(ProcessorGet(), batch->cached[i]);
+    }
+    free(batch);
+    return 0;
+}
+
+unsigned int CJThreadNewBatch(ScheduleHandle schedule, const struct CJThreadAttr *attrUser, CJThreadFunc func,
+                              const void *argStart, unsigned int argSize, unsigned int num, CJThreadHandle *list)
+{
+    const char *arg = static_cast<const char *>(argStart);
+    bool batched;
+    unsigned int i;
+
+    if (schedule == nullptr || list == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INVALID, "schedule or list null invalid");
+        return 0;
+    }
+    // Outside a cjthread of the default scheduler, the cjthreads are created one by one.
+    batched = schedule == ScheduleGet() && CJThreadSpawnBatchBegin(num) == 0;
+    for (i = 0; i < num; i++) {
+        list[i] = CJThreadNew(schedule, attrUser, func,
+                              arg == nullptr ? nullptr : arg + static_cast<size_t>(i) * argSize, argSize);
+        if (list[i] == nullptr) {
+            break;
+        }
+    }
+    if (batched) {
+        (void)CJThreadSpawnBatchEnd();
+    }
+    return i;
+}
+
 unsigned long long int CJThreadId(void)
 {
     struct CJThread *cjthread = CJThreadGet();
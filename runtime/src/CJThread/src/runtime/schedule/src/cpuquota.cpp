@@ -0,0 +1,229 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "cpuquota.h"
+#include "securec.h"
+#include "log.h"
+
+#ifdef MRT_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef MRT_LINUX
+/* cgroup membership of the process, one hierarchy per line */
+#define CPU_QUOTA_PROC_CGROUP "/proc/self/cgroup"
+
+/* Mount point of the unified hierarchy of cgroup v2 */
+#define CPU_QUOTA_V2_ROOT "/sys/fs/cgroup"
+
+/* Length of /proc/self/cgroup read. Only the cpu hierarchy is looked for, so it is enough. */
+const int CPU_QUOTA_CGROUP_LEN = 4096;
+
+/* Length of the contents of the quota files */
+const int CPU_QUOTA_BUF_LEN = 64;
+
+/* Mount points of the cpu controller of cgroup v1, the joint one first */
+static const char *g_cpuQuotaV1Roots[] = {
+    "/sys/fs/cgroup/cpu,cpuacct",
+    "/sys/fs/cgroup/cpu",
+};
+
+/* Read a small file into buf as a string. */
+static int CpuQuotaFileRead(const char *path, char *buf, int len)
+{
+    ssize_t readLen;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    readLen = read(fd, buf, static_cast<size_t>(len - 1));
+    close(fd);
+    if (readLen <= 0) {
+        return -1;
+    }
+    buf[readLen] = '\0';
+    return 0;
+}
+
+/* Whether a comma separated controller list holds "cpu". */
+static bool CpuQuotaHasCpuController(const char *controllers, size_t len)
+{
+    const char *token = controllers;
+    const char *end = controllers + len;
+    const char *comma;
+    const size_t cpuLen = 3; // 3: length of "cpu"
+
+    while (token < end) {
+        comma = static_cast<const char *>(memchr(token, ',', static_cast<size_t>(end - token)));
+        if (comma == nullptr) {
+            comma = end;
+        }
+        if (static_cast<size_t>(comma - token) == cpuLen && strncmp(token, "cpu", cpuLen) == 0) {
+            return true;
+        }
+        token = comma + 1;
+    }
+    return false;
+}
+
+/* Use root + cgroup + file if it exists. In a cgroup namespace the cgroup of the process is the
+ * root of the mount, so root + file is tried as well. */
+static bool CpuQuotaPathSet(char *path, const char *root, const char *cgroup, const char *file)
+{
+    if (snprintf_s(path, CPU_QUOTA_PATH_LEN, CPU_QUOTA_PATH_LEN - 1, "%s%s/%s", root, cgroup, file) >= 0 &&
+        access(path, R_OK) == 0) {
+        return true;
+    }
+    if (snprintf_s(path, CPU_QUOTA_PATH_LEN, CPU_QUOTA_PATH_LEN - 1, "%s/%s", root, file) >= 0 &&
+        access(path, R_OK) == 0) {
+        return true;
+    }
+    path[0] = '\0';
+    return false;
+}
+
+/* Find the quota files from a line of /proc/self/cgroup, "id:controllers:path". */
+static bool CpuQuotaLineParse(struct ScheduleCpuQuota *quota, char *line)
+{
+    char quotaPath[CPU_QUOTA_PATH_LEN];
+    char periodPath[CPU_QUOTA_PATH_LEN];
+    char *controllers;
+    char *cgroup;
+    unsigned int i;
+
+    controllers = strchr(line, ':');
+    if (controllers == nullptr) {
+        return false;
+    }
+    controllers++;
+    cgroup = strchr(controllers, ':');
+    if (cgroup == nullptr) {
+        return false;
+    }
+    // The root cgroup is "/", drop it so that the paths do not get a double slash.
+    if (strcmp(cgroup + 1, "/") == 0) {
+        cgroup[1] = '\0';
+    }
+    if (cgroup == controllers) {
+        if (CpuQuotaPathSet(quotaPath, CPU_QUOTA_V2_ROOT, cgroup + 1, "cpu.max")) {
+            (void)memcpy_s(quota->quotaPath, CPU_QUOTA_PATH_LEN, quotaPath, CPU_QUOTA_PATH_LEN);
+            quota->version = 2; // 2: cgroup v2
+            return true;
+        }
+        return false;
+    }
+    if (!CpuQuotaHasCpuController(controllers, static_cast<size_t>(cgroup - controllers))) {
+        return false;
+    }
+    for (i = 0; i < sizeof(g_cpuQuotaV1Roots) / sizeof(g_cpuQuotaV1Roots[0]); i++) {
+        if (CpuQuotaPathSet(quotaPath, g_cpuQuotaV1Roots[i], cgroup + 1, "cpu.cfs_quota_us") &&
+            CpuQuotaPathSet(periodPath, g_cpuQuotaV1Roots[i], cgroup + 1, "cpu.cfs_period_us")) {
+            (void)memcpy_s(quota->quotaPath, CPU_QUOTA_PATH_LEN, quotaPath, CPU_QUOTA_PATH_LEN);
+            (void)memcpy_s(quota->periodPath, CPU_QUOTA_PATH_LEN, periodPath, CPU_QUOTA_PATH_LEN);
+            quota->version = 1;
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+int CpuQuotaInit(struct ScheduleCpuQuota *quota)
+{
+#ifdef MRT_LINUX
+    char buf[CPU_QUOTA_CGROUP_LEN];
+    char *line;
+    char *next;
+
+    quota->version = 0;
+    quota->quotaPath[0] = '\0';
+    quota->periodPath[0] = '\0';
+    if (CpuQuotaFileRead(CPU_QUOTA_PROC_CGROUP, buf, sizeof(buf)) != 0) {
+        return ERRNO_SCHD_CPU_QUOTA_UNKNOWN;
+    }
+    // A v1 cpu hierarchy takes precedence, the v2 line of a hybrid setup has no cpu controller.
+    for (line = buf; line != nullptr && *line != '\0'; line = next) {
+        next = strchr(line, '\n');
+        if (next != nullptr) {
+            *next++ = '\0';
+        }
+        if (CpuQuotaLineParse(quota, line) && quota->version == 1) {
+            break;
+        }
+    }
+    return quota->version == 0 ? ERRNO_SCHD_CPU_QUOTA_UNKNOWN : 0;
+#else
+    quota->version = 0;
+    return ERRNO_SCHD_CPU_QUOTA_UNKNOWN;
+#endif
+}
+
+int CpuQuotaRead(const struct ScheduleCpuQuota *quota, unsigned int *cpus)
+{
+#ifdef MRT_LINUX
+    char buf[CPU_QUOTA_BUF_LEN];
+    char *end;
+    long long quotaUs;
+    long long periodUs;
+
+    if (quota->version == 0 || CpuQuotaFileRead(quota->quotaPath, buf, sizeof(buf)) != 0) {
+        return ERRNO_SCHD_CPU_QUOTA_UNKNOWN;
+    }
+    // v2: "max 100000" or "200000 100000". v1: the quota alone, -1 if unlimited.
+    if (strncmp(buf, "max", strlen("max")) == 0) {
+        *cpus = 0;
+        return 0;
+    }
+    quotaUs = strtoll(buf, &end, 10); // 10: decimal
+    if (quota->version == 1) {
+        if (CpuQuotaFileRead(quota->periodPath, buf, sizeof(buf)) != 0) {
+            return ERRNO_SCHD_CPU_QUOTA_UNKNOWN;
+        }
+        end = buf;
+    }
+    periodUs = strtoll(end, nullptr, 10); // 10: decimal
+    if (quotaUs <= 0 || periodUs <= 0) {
+        *cpus = 0;
+        return 0;
+    }
+    *cpus = static_cast<unsigned int>((quotaUs + periodUs - 1) / periodUs);
+    return 0;
+#else
+    (void)quota;
+    (void)cpus;
+    return ERRNO_SCHD_CPU_QUOTA_UNKNOWN;
+#endif
+}
+
+unsigned int CpuQuotaProcessorNum(struct ScheduleCpuQuota *quota, unsigned int capacity)
+{
+    unsigned int cpus = 0;
+    unsigned int num;
+
+    // If the quota files are gone, fall back as if there were no quota.
+    if (CpuQuotaRead(quota, &cpus) != 0) {
+        cpus = 0;
+    }
+    atomic_store_explicit(&quota->cpus, cpus, std::memory_order_relaxed);
+    num = cpus == 0 ? quota->baseNum : cpus;
+    num = num > capacity ? capacity : num;
+    return num == 0 ? 1 : num;
+}
+
+#ifdef __cplusplus
+}
+#endif
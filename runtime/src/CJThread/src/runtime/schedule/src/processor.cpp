@@ -14,6 +14,7 @@
 #include "schdpoll.h"
 #include "basetime.h"
 #include "log.h"
+#include "schmon.h"
 #if defined(CANGJIE_SANITIZER_SUPPORT)
 #include "Sanitizer/SanitizerInterface.h"
 #endif
@@ -29,6 +30,15 @@ const int PROCESSOR_CJTHREAD_GET_ROUND_NUM = 20;
 
 unsigned int g_randSeed = 0;
 
+/* Whether a processor is beyond the active processors of its scheduler, see ScheduleProcessorNumSet. */
+MRT_STATIC_INLINE bool ProcessorRetired(struct Schedule *schedule, const struct Processor *processor)
+{
+    struct ScheduleProcessor *schdProcessor = &schedule->schdProcessor;
+
+    return static_cast<unsigned int>(processor - schdProcessor->processorGroup) >=
+        atomic_load(&schdProcessor->activeNum);
+}
+
 int ProcessorGlobalWrite(struct CJThread *cjthreadList[], unsigned int num)
 {
     struct Dulink tempDulink;
@@ -37,15 +47,17 @@ int ProcessorGlobalWrite(struct CJThread *cjthreadList[], unsigned int num)
     unsigned long i;
     void *buf[PROCESSOR_QUEUE_CAPACITY] = {nullptr};
     struct Processor *processor;
+    struct Queue *runq;
 
     processor = ProcessorGet();
     sch = static_cast<struct Schedule *>(processor->schedule);
     DulinkInit(&tempDulink);
 
-    // Get 1/4 from the local queue and put it into the global queue.
-    length = QueueLength(&processor->runq) / GLOBAL_ADD_RATIO;
+    // Get 1/4 from the local queue that overflowed and put it into the global queue.
+    runq = num != 0 ? ProcessorRunqGet(processor, cjthreadList[0]->priority) : &processor->runq;
+    length = QueueLength(runq) / GLOBAL_ADD_RATIO;
     if (length != 0) {
-        length = QueuePopHeadBatch(&processor->runq, buf, length);
+        length = QueuePopHeadBatch(runq, buf, length);
     }
 
     // To reduce the occupation time of schdCJThread.mutex, use tempDulink to temporarily
@@ -67,29 +79,68 @@ int ProcessorGlobalWrite(struct CJThread *cjthreadList[], unsigned int num)
     return 0;
 }
 
+/* Add a cjthread to the running queue of its class. If the queue is full, add it to the global queue. */
+MRT_STATIC_INLINE int ProcessorRunqPush(struct Processor *processor, struct CJThread *cjthread)
+{
+    int error;
+
+    error = QueuePushTail(ProcessorRunqGet(processor, cjthread->priority), cjthread);
+    if (error == 0) {
+        return 0;
+    }
+    error = ProcessorGlobalWrite(&cjthread, 1);
+    if (error) {
+        LOG_ERROR(error, "write global queue failed!");
+    }
+    return error;
+}
+
 /* Add the cjthread to the processor's run queue. */
 int ProcessorLocalWriteBatch(struct CJThread **cjthread, unsigned int num)
 {
-    int ret;
+    int ret = 0;
+    int error;
     struct Queue *runq;
     unsigned int pushNum;
+    unsigned int normalNum = 0;
+    unsigned int i;
     struct Processor *processor;
 
     processor = ProcessorGet();
+    if (ScheduleLatencyStatsOn()) {
+        ProcessorLatencyRunqStamp(cjthread, num);
+    }
+    // Cjthreads of the other classes are pushed one by one, the normal class is pushed in a batch.
+    for (i = 0; i < num; i++) {
+        if (cjthread[i]->priority == CJTHREAD_PRIORITY_NORMAL) {
+            cjthread[normalNum++] = cjthread[i];
+            continue;
+        }
+        if (QueuePushTail(ProcessorRunqGet(processor, cjthread[i]->priority), cjthread[i]) != 0) {
+            // The queue of this class is full, so it and the rest go to the global queue. The
+            // normal cjthreads already collected are before i and still pushed below.
+            ret = ProcessorGlobalWrite(cjthread + i, num - i);
+            if (ret) {
+                LOG_ERROR(ret, "write global queue failed!");
+            }
+            break;
+        }
+    }
+    num = normalNum;
     runq = &processor->runq;
     pushNum = QueuePushTailBatch(runq, reinterpret_cast<void **>(cjthread), num);
     if (pushNum == num) {
-        return 0;
+        return ret;
     }
 
     // If add to local queue fail, add to global queue
-    ret = ProcessorGlobalWrite(cjthread + pushNum, num - pushNum);
-    if (ret) {
-        LOG_ERROR(ret, "write global queue failed!");
-        return ret;
+    error = ProcessorGlobalWrite(cjthread + pushNum, num - pushNum);
+    if (error) {
+        LOG_ERROR(error, "write global queue failed!");
+        return error;
     }
 
-    return 0;
+    return ret;
 }
 
 /* Bulk fetching schedulable cjthreads from the global queue */
@@ -104,7 +155,8 @@ struct CJThread *ProcessorGlobalRead(void *schedule, bool batch)
     unsigned int i;
     unsigned int readNum = 1;
     struct Processor *processor;
-    unsigned int processorNum = ((struct Schedule *)schedule)->schdProcessor.processorNum;
+    unsigned int processorNum = atomic_load_explicit(&((struct Schedule *)schedule)->schdProcessor.activeNum,
+                                                     std::memory_order_relaxed);
 
     schdCJThread = &((struct Schedule *)schedule)->schdCJThread;
     if (schdCJThread->num == 0) {
@@ -150,7 +202,7 @@ struct CJThread *ProcessorGlobalRead(void *schedule, bool batch)
         buf[i] = (void *)cjthreadTemp;
     }
 
-    QueuePushTailBatch(&processor->runq, buf, readNum);
+    (void)ProcessorLocalWriteBatch(reinterpret_cast<struct CJThread **>(buf), readNum);
 
     return cjthreadNext;
 }
@@ -158,53 +210,34 @@ struct CJThread *ProcessorGlobalRead(void *schedule, bool batch)
 /* Add a single cjthread to the local queue */
 int ProcessorLocalWrite(struct CJThread *cjthread, bool isReschd)
 {
-    int error;
-    struct Queue *runq;
     struct Processor *processor;
 
     processor = ProcessorGet();
-    runq = &processor->runq;
+    if (ScheduleLatencyStatsOn()) {
+        ProcessorLatencyRunqStamp(&cjthread, 1);
+    }
+    // A low class cjthread in cjthreadNext would run before the higher classes.
+    if (isReschd || cjthread->priority == CJTHREAD_PRIORITY_LOW) {
+        return ProcessorRunqPush(processor, cjthread);
+    }
 
     while (true) {
-        if (isReschd) {
-            error = QueuePushTail(runq, cjthread);
-            if (error == 0) {
-                return 0;
-            }
-            error = ProcessorGlobalWrite(&cjthread, 1);
-            if (error) {
-                LOG_ERROR(error, "write global queue failed!");
-            }
-            return error;
-        }
-
         struct CJThread *obj = atomic_load_explicit(&processor->cjthreadNext, std::memory_order_relaxed);
         if (atomic_compare_exchange_weak(&processor->cjthreadNext, &obj, cjthread)) {
             if (obj == nullptr) {
                 return 0;
             }
-            error = QueuePushTail(runq, obj);
-            if (error == 0) {
-                return 0;
-            }
-            // If add cjthread to local queue fail, add it to global queue
-            error = ProcessorGlobalWrite(&obj, 1);
-            if (error) {
-                LOG_ERROR(error, "write global queue failed!");
-            }
-            return error;
+            return ProcessorRunqPush(processor, obj);
         }
     }
     return 0;
 }
 
-MRT_STATIC_INLINE unsigned long ProcessorQueueSteal(struct Processor *processor,
+MRT_STATIC_INLINE unsigned long ProcessorQueueSteal(struct Queue *stealRunq,
                                                     void *buf[], unsigned long bufLen)
 {
-    struct Queue *stealRunq;
     unsigned long length;
 
-    stealRunq = &processor->runq;
     length = (QueueLength(stealRunq) + PROCESSOR_STEAL_RATIO - 1) / PROCESSOR_STEAL_RATIO;
     if (length == 0) {
         return 0;
@@ -222,15 +255,21 @@ struct CJThread *ProcessorCJThreadSteal(struct Processor *localProcessor, struct
     unsigned long pushNum;
     void *buf[PROCESSOR_QUEUE_CAPACITY] = {nullptr};
     struct Queue *localRunq;
+    unsigned int priority;
 
-    // Stealing cjthreads from other processor queues.
-    stealNum = ProcessorQueueSteal(stealProcessor, buf, PROCESSOR_QUEUE_CAPACITY);
+    // Stealing cjthreads from other processor queues, the higher classes first.
+    for (priority = CJTHREAD_PRIORITY_HIGH; priority < CJTHREAD_PRIORITY_NUM; priority++) {
+        stealNum = ProcessorQueueSteal(ProcessorRunqGet(stealProcessor, priority), buf, PROCESSOR_QUEUE_CAPACITY);
+        if (stealNum != 0) {
+            break;
+        }
+    }
     if (stealNum == 0) {
         return nullptr;
     }
 
-    // Put the stolen cjthread into the local queue.
-    localRunq = &localProcessor->runq;
+    // Put the stolen cjthread into the local queue of the same class.
+    localRunq = ProcessorRunqGet(localProcessor, priority);
     pushNum = QueuePushTailBatch(localRunq, buf + 1, stealNum - 1);
     if (pushNum != stealNum - 1) {
         LOG_ERROR(ERRNO_SCHD_LOCAL_QUEUE_PUSH_FAILED,
@@ -272,8 +311,7 @@ int ProcessorRelease(void)
     if (schedule->state == SCHEDULE_EXITING) {
         atomic_store(&curProcessor->state, PROCESSOR_EXITING);
     } else {
-        atomic_store(&curProcessor->state, PROCESSOR_IDLE);
-        atomic_fetch_add(&schedule->schdProcessor.freeNum, 1u);
+        ProcessorFree(schedule, curProcessor);
     }
     return 0;
 }
@@ -286,6 +324,7 @@ int ProcessorStopWithLastCheck(void)
     struct Processor *newProcessor;
     struct Schedule *schedule = static_cast<struct Schedule *>(oldProcessor->schedule);
 
+    SchmonPreemptTimerDisarm(oldProcessor);
     // release current processor
     ret = ProcessorRelease();
     if (ret != 0) {
@@ -328,6 +367,132 @@ int ProcessorStopWithLastCheck(void)
     return 0;
 }
 
+/* Record the CPU running the processor for the thieves, or move the thread to the CPU the
+ * processor is pinned to. Threads rarely change CPU while they run, so an unpinned processor
+ * records the CPU when it moves to another thread, and ProcessorSteal refreshes it. */
+MRT_INLINE static void ProcessorCpuUpdate(struct Processor *processor)
+{
+    struct ScheduleTopology *topology = &g_scheduleManager.topology;
+    struct Thread *thread = processor->thread;
+
+    if (!topology->pin) {
+        if (processor->cpuThread != thread) {
+            processor->cpuThread = thread;
+            processor->cpu = TopologyCurrentCpu();
+        }
+        return;
+    }
+    if (!thread->cpuPinned || thread->pinnedCpu != processor->cpu) {
+        // A failure is logged once per processor change and not retried.
+        (void)TopologyThreadPin(processor->cpu);
+        thread->cpuPinned = true;
+        thread->pinnedCpu = processor->cpu;
+    }
+}
+
+/* Index of the histogram bucket of a latency, see SCHEDULE_LATENCY_SUB_BITS. */
+MRT_INLINE static unsigned int ProcessorLatencyBucket(unsigned long long ns)
+{
+    const unsigned long long subNum = 1ULL << SCHEDULE_LATENCY_SUB_BITS;
+    const unsigned int highBit = 63; // 63: bit index of the highest bit of 64-bit integer
+    unsigned int magnitude;
+    unsigned int shift;
+
+    if (ns < subNum) {
+        return static_cast<unsigned int>(ns);
+    }
+    magnitude = highBit - static_cast<unsigned int>(__builtin_clzll(ns));
+    if (magnitude >= SCHEDULE_LATENCY_MAX_BITS) {
+        return SCHEDULE_LATENCY_BUCKETS - 1;
+    }
+    shift = magnitude - SCHEDULE_LATENCY_SUB_BITS;
+    return ((shift + 1) << SCHEDULE_LATENCY_SUB_BITS) + static_cast<unsigned int>((ns >> shift) & (subNum - 1));
+}
+
+/* Only the thread running the processor writes its histograms, readers may see them half updated. */
+MRT_INLINE static void ProcessorLatencyRecord(struct ProcessorLatencyHist *hist, unsigned long long ns)
+{
+    unsigned int idx = ProcessorLatencyBucket(ns);
+
+    atomic_store_explicit(&hist->buckets[idx],
+                          atomic_load_explicit(&hist->buckets[idx], std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+    atomic_store_explicit(&hist->count, atomic_load_explicit(&hist->count, std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+    atomic_store_explicit(&hist->sumNs, atomic_load_explicit(&hist->sumNs, std::memory_order_relaxed) + ns,
+                          std::memory_order_relaxed);
+    if (ns > atomic_load_explicit(&hist->maxNs, std::memory_order_relaxed)) {
+        atomic_store_explicit(&hist->maxNs, ns, std::memory_order_relaxed);
+    }
+}
+
+/* Called when the processor switches to a cjthread. Records the wake-to-run latency of a sampled
+ * wake, and drops the handoff target of the previous cjthread. */
+MRT_INLINE static void ProcessorWakeUpdate(struct Processor *processor, struct CJThread *cjthread)
+{
+    unsigned long long now;
+
+    processor->wake.handoff = nullptr;
+    if (cjthread->readyTime == 0) {
+        return;
+    }
+    now = CurrentNanotimeGet();
+    ProcessorLatencyRecord(&processor->latency.hist[SCHEDULE_LATENCY_WAKE_TO_RUN],
+                           now > cjthread->readyTime ? now - cjthread->readyTime : 0);
+    cjthread->readyTime = 0;
+}
+
+void ProcessorLatencyRunqStamp(struct CJThread *cjthreadList[], unsigned int num)
+{
+    unsigned long long now = CurrentNanotimeGet();
+
+    for (unsigned int i = 0; i < num; i++) {
+        if (cjthreadList[i]->runqTime == 0) {
+            cjthreadList[i]->runqTime = now;
+        }
+    }
+}
+
+/* Called when the processor switches to a cjthread. Records how long it waited to run, and starts
+ * its slice. */
+MRT_INLINE static void ProcessorLatencyUpdate(struct Processor *processor, struct CJThread *cjthread)
+{
+    struct ProcessorLatency *latency = &processor->latency;
+    unsigned long long now;
+
+    if (!ScheduleLatencyStatsOn()) {
+        // Times left from before the statistics stopped would be taken for waits later.
+        if (UNLIKELY(cjthread->runqTime != 0)) {
+            cjthread->runqTime = 0;
+        }
+        return;
+    }
+    now = CurrentNanotimeGet();
+    if (cjthread->runqTime != 0) {
+        ProcessorLatencyRecord(&latency->hist[SCHEDULE_LATENCY_RUNQ_WAIT],
+                               now > cjthread->runqTime ? now - cjthread->runqTime : 0);
+        cjthread->runqTime = 0;
+    }
+    latency->sliceStart = now;
+}
+
+/* Called when the running cjthread has switched out of the processor. */
+MRT_INLINE static void ProcessorLatencySliceEnd(struct Processor *processor)
+{
+    struct ProcessorLatency *latency = &processor->latency;
+    unsigned long long now;
+
+    if (latency->sliceStart == 0) {
+        return;
+    }
+    if (ScheduleLatencyStatsOn()) {
+        now = CurrentNanotimeGet();
+        ProcessorLatencyRecord(&latency->hist[SCHEDULE_LATENCY_SLICE],
+                               now > latency->sliceStart ? now - latency->sliceStart : 0);
+    }
+    latency->sliceStart = 0;
+}
+
 void RandSeedInit(void)
 {
     g_randSeed = CurrentNanotimeGet();
@@ -382,6 +547,32 @@ MRT_STATIC_INLINE struct CJThread *ProcessorTimerSteal(struct Processor *stealPr
     return nullptr;
 }
 
+/* Try one victim. Timers and the next cjthread are stolen only in the last round. */
+MRT_STATIC_INLINE struct CJThread *ProcessorStealFrom(struct Processor *localProcessor,
+                                                      struct Processor *stealProcessor,
+                                                      unsigned long long now, bool stealTimersOrRunNext)
+{
+    struct CJThread *stealCJThread;
+
+    // Trying to steal cjthreads from other processors
+    stealCJThread = ProcessorCJThreadSteal(localProcessor, stealProcessor);
+    if (stealCJThread != nullptr) {
+        return stealCJThread;
+    }
+
+    // Determine whether to steal the timer or nextCJthread
+    if (!stealTimersOrRunNext) {
+        return nullptr;
+    }
+    stealCJThread = ProcessorTimerSteal(stealProcessor, now);
+    if (stealCJThread != nullptr) {
+        return stealCJThread;
+    }
+    return ProcessorCJhreadNextRead(stealProcessor);
+}
+
+/* Victims are tried from the closest topology level outwards, starting at a random processor
+ * in each level. Without a topology all victims are in one level and counted as remote. */
 struct CJThread *ProcessorSteal(unsigned long long now)
 {
     unsigned long stealNum;
@@ -391,35 +582,39 @@ struct CJThread *ProcessorSteal(unsigned long long now)
     struct Processor *stealProcessor;
     struct CJThread *stealCJThread;
     struct ScheduleProcessor *schdProcessor = &schedule->schdProcessor;
+    struct ScheduleTopology *topology = &g_scheduleManager.topology;
     unsigned long processorNum = schdProcessor->processorNum;
     bool stealTimersOrRunNext;
+    bool byTopology = topology->valid && schedule->scheduleType == SCHEDULE_DEFAULT;
+    unsigned int levelNum = byTopology ? SCHEDULE_TOPOLOGY_LEVEL_NUM : 1;
+    unsigned int level;
+    int localCpu = -1;
+
+    if (byTopology && !topology->pin) {
+        localProcessor->cpu = TopologyCurrentCpu();
+    }
+    if (byTopology) {
+        localCpu = localProcessor->cpu;
+    }
     processorId = RandomPseudo(processorNum);
     for (unsigned int i = 0; i < PROCESSOR_STEAL_ROUNDS; ++i) {
         stealTimersOrRunNext = (i == (PROCESSOR_STEAL_ROUNDS - 1));
-        for (stealNum = 0; stealNum < processorNum; stealNum++) {
-            // get steal processor
-            stealProcessor = &schdProcessor->processorGroup[((stealNum + processorId) % processorNum)];
-            if (stealProcessor == localProcessor) {
-                continue;
-            }
-
-            // Trying to steal cjthreads from other processors
-            stealCJThread = ProcessorCJThreadSteal(localProcessor, stealProcessor);
-            if (stealCJThread != nullptr) {
-                return stealCJThread;
-            }
-
-            // Determine whether to steal the timer or nextCJthread
-            if (!stealTimersOrRunNext) {
-                continue;
-            }
-            stealCJThread = ProcessorTimerSteal(stealProcessor, now);
-            if (stealCJThread != nullptr) {
-                return stealCJThread;
-            }
-            stealCJThread = ProcessorCJhreadNextRead(stealProcessor);
-            if (stealCJThread != nullptr) {
-                return stealCJThread;
+        for (level = 0; level < levelNum; level++) {
+            for (stealNum = 0; stealNum < processorNum; stealNum++) {
+                // get steal processor
+                stealProcessor = &schdProcessor->processorGroup[((stealNum + processorId) % processorNum)];
+                if (stealProcessor == localProcessor) {
+                    continue;
+                }
+                if (byTopology && TopologyLevelGet(topology, localCpu, stealProcessor->cpu) != level) {
+                    continue;
+                }
+                stealCJThread = ProcessorStealFrom(localProcessor, stealProcessor, now, stealTimersOrRunNext);
+                if (stealCJThread != nullptr) {
+                    atomic_fetch_add_explicit(&localProcessor->stealCnt[byTopology ? level : SCHEDULE_TOPOLOGY_REMOTE],
+                                              1ULL, std::memory_order_relaxed);
+                    return stealCJThread;
+                }
             }
         }
         // In multi-thread scenario, the competition caused by theft of processors need be reduced.
@@ -443,7 +638,7 @@ struct CJThread *ProcessorSearchingSteal(unsigned long long now)
     // The total number of search threads is less than or equal to half of the number of
     // running processors. However, if the current thread is assigned the search state,
     // the system directly enters the search process regardless of the number of threads.
-    processorNum = schdProcessor->processorNum;
+    processorNum = atomic_load_explicit(&schdProcessor->activeNum, std::memory_order_relaxed);
     if (thread->isSearching == false &&
         RUNNING_PROCESSOR_SEARCHING_NUM_MULTIPLE * schedule->schdThread.searchingNum
         > processorNum - schdProcessor->freeNum) {
@@ -525,6 +720,40 @@ MRT_INLINE static void ProcessorSearchingMore(void)
     }
 }
 
+/* Move the ready cjthreads of a retired processor to the global queue, then stop it. The
+ * processor goes offline in ProcessorRelease. Its timers stay in place, they are stolen by
+ * the active processors or woken up by schmon. */
+static void ProcessorRetire(struct Schedule *schedule, struct Processor *processor)
+{
+    struct CJThread *buf[PROCESSOR_QUEUE_CAPACITY];
+    struct CJThread *cjthread;
+    struct Thread *thread = ThreadGet();
+    unsigned int num = 0;
+    int ret;
+
+    cjthread = ProcessorCJhreadNextRead(processor);
+    if (cjthread != nullptr) {
+        buf[num++] = cjthread;
+    }
+    while ((cjthread = ProcessorLocalRead(processor)) != nullptr) {
+        buf[num++] = cjthread;
+        if (num == PROCESSOR_QUEUE_CAPACITY) {
+            (void)ScheduleGlobalWrite(buf, num);
+            num = 0;
+        }
+    }
+    (void)ScheduleGlobalWrite(buf, num);
+    if (thread->isSearching) {
+        thread->isSearching = false;
+        atomic_fetch_sub(&schedule->schdThread.searchingNum, 1u);
+    }
+    // The last check of the stop binds an idle processor if cjthreads were moved.
+    ret = ProcessorStopWithLastCheck();
+    if (ret) {
+        LOG_ERROR(-1, "ProcessorStopWithLastCheck failed");
+    }
+}
+
 /* Find the next cjthread to be scheduled. */
 struct CJThread *ProcessorCJThreadGet(void)
 {
@@ -564,6 +793,10 @@ struct CJThread *ProcessorCJThreadGet(void)
 #endif
             CJThreadContextSet(&thread->context);
         }
+        if (schedule->scheduleType == SCHEDULE_DEFAULT && ProcessorRetired(schedule, curProcessor)) {
+            ProcessorRetire(schedule, curProcessor);
+            continue;
+        }
 
         // check timer first
         now = ProcessorTimerCheck();
@@ -586,7 +819,7 @@ struct CJThread *ProcessorCJThreadGet(void)
             }
             // Obtain the cjthread to be scheduled from the local queue to prevent tasks in
             // the local queue from being executed due to continuous next invoking.
-            nextCJThread = reinterpret_cast<struct CJThread *>(QueuePopHead(&curProcessor->runq));
+            nextCJThread = ProcessorLocalRead(curProcessor);
             if (nextCJThread != nullptr) {
                 break;
             }
@@ -594,9 +827,16 @@ struct CJThread *ProcessorCJThreadGet(void)
 
         // Check the CJthreadNext corresponding to the current processor. Do not need to execute
         // the cnt+1 because the processor does not need to be switched.
-        nextCJThread = ProcessorCJhreadNextRead(curProcessor);
+        // A high class cjthread in the local queue goes before cjthreadNext.
+        nextCJThread = QueueLength(&curProcessor->highRunq) == 0 ? ProcessorCJhreadNextRead(curProcessor) : nullptr;
         if (nextCJThread != nullptr) {
             ProcessorSearchingMore();
+            // The next cjthread inherits the time slice.
+            if (atomic_load_explicit(&curProcessor->preempt.requestTime, std::memory_order_relaxed) != 0) {
+                SchmonPreemptOverrunRecord(curProcessor);
+            }
+            ProcessorWakeUpdate(curProcessor, nextCJThread);
+            ProcessorLatencyUpdate(curProcessor, nextCJThread);
             return nextCJThread;
         }
 
@@ -662,6 +902,18 @@ struct CJThread *ProcessorCJThreadGet(void)
     // Update the number of processor switchover times.
     curProcessor->schedCnt++;
 
+    if (atomic_load_explicit(&curProcessor->preempt.requestTime, std::memory_order_relaxed) != 0) {
+        SchmonPreemptOverrunRecord(curProcessor);
+    }
+    if (g_scheduleManager.schmon.preemptSlice != 0 && schedule->scheduleType == SCHEDULE_DEFAULT) {
+        SchmonPreemptSliceBegin(curProcessor);
+    }
+    if (g_scheduleManager.topology.valid && schedule->scheduleType == SCHEDULE_DEFAULT) {
+        ProcessorCpuUpdate(curProcessor);
+    }
+    ProcessorWakeUpdate(curProcessor, nextCJThread);
+    ProcessorLatencyUpdate(curProcessor, nextCJThread);
+
     // nextCJThread cannont be null.
     return nextCJThread;
 }
@@ -744,10 +996,12 @@ void ProcessorSchedule(void)
     struct Schedule *schedule;
     struct Processor *processor;
     struct Thread *thread;
+    ProcessorLatencySliceEnd(ProcessorGet());
     do {
         processor = ProcessorGet();
         schedule = static_cast<struct Schedule *>(processor->schedule);
         thread = processor->thread;
+        atomic_store_explicit(&processor->runningId, 0ull, std::memory_order_relaxed);
         if (schedule->scheduleType == SCHEDULE_DEFAULT &&
             atomic_load_explicit(&schedule->state, std::memory_order_relaxed) == SCHEDULE_EXITING) {
             ProcessorThreadExit();
@@ -788,6 +1042,7 @@ void ProcessorSchedule(void)
         // Finds a dispatchable cjthread and switches its state to RUNNING.
         nextCJThread = ProcessorCJThreadGet();
         atomic_store_explicit(&nextCJThread->state, CJTHREAD_RUNNING, std::memory_order_relaxed);
+        atomic_store_explicit(&processor->runningId, nextCJThread->id, std::memory_order_relaxed);
         ProtectAddrSet((uintptr_t)nextCJThread->stack.stackGuard);
         if (nextCJThread->boundThread != nullptr) {
             ProcessorStartBoundCJThread(nextCJThread);
@@ -831,10 +1086,14 @@ int ProcessorInit(void *schedule, struct Processor *processor, unsigned int proc
     processor->processorId = processorId;
     processor->state = PROCESSOR_IDLE;
     processor->schedule = schedule;
+    processor->cpu = -1;
+    processor->cpuThread = nullptr;
     std::atomic_store_explicit(&processor->cjthreadNext, (CJThread *)nullptr, std::memory_order_relaxed);
 
-    // Init processor running queue
+    // Init processor running queues, one per priority class
     QueueInit(&processor->runq, PROCESSOR_QUEUE_CAPACITY);
+    QueueInit(&processor->highRunq, PROCESSOR_QUEUE_CAPACITY);
+    QueueInit(&processor->lowRunq, PROCESSOR_QUEUE_CAPACITY);
 
     // Init local cjthread free list
     processor->freelist.cjthreadNum = 0;
@@ -848,15 +1107,32 @@ int ProcessorInit(void *schedule, struct Processor *processor, unsigned int proc
     return 0;
 }
 
-/* Free a processor */
+/* Free a processor. A retired processor goes offline instead of idle. activeNum may change
+ * while the state is set, so it is checked again afterwards and the state is fixed up if it
+ * was missed by ScheduleProcessorNumSet. */
 void ProcessorFree(struct Schedule *schedule, struct Processor *processor)
 {
     struct ScheduleProcessor *schdProcessor;
+    ProcessorState expected;
 
     schdProcessor = &(schedule->schdProcessor);
 
-    atomic_store(&processor->state, PROCESSOR_IDLE);
-    atomic_fetch_add(&schdProcessor->freeNum, 1u);
+    if (!ProcessorRetired(schedule, processor)) {
+        atomic_store(&processor->state, PROCESSOR_IDLE);
+        atomic_fetch_add(&schdProcessor->freeNum, 1u);
+        expected = PROCESSOR_IDLE;
+        if (ProcessorRetired(schedule, processor) &&
+            atomic_compare_exchange_strong(&processor->state, &expected, PROCESSOR_OFFLINE)) {
+            atomic_fetch_sub(&schdProcessor->freeNum, 1u);
+        }
+        return;
+    }
+    atomic_store(&processor->state, PROCESSOR_OFFLINE);
+    expected = PROCESSOR_OFFLINE;
+    if (!ProcessorRetired(schedule, processor) &&
+        atomic_compare_exchange_strong(&processor->state, &expected, PROCESSOR_IDLE)) {
+        atomic_fetch_add(&schdProcessor->freeNum, 1u);
+    }
 }
 
 void ProcessorNonDefaultScheduleWake(struct Schedule *schedule)
@@ -914,6 +1190,71 @@ void ProcessorWake(struct Schedule *schedule, void *specPro)
     }
 }
 
+unsigned int ProcessorSpinCap(struct Schedule *schedule)
+{
+    unsigned int cap = atomic_load_explicit(&schedule->schdProcessor.activeNum, std::memory_order_relaxed) /
+        PROCESSOR_SPIN_CAP_DIVISOR;
+
+    return cap == 0 ? 1 : cap;
+}
+
+void ProcessorWakeBatch(struct Schedule *schedule, unsigned int num)
+{
+    struct ScheduleThread *schdThread = &schedule->schdThread;
+    struct Processor *processor;
+    unsigned int searching;
+    unsigned int freeNum;
+    unsigned int wakeNum;
+    unsigned int cap;
+    unsigned int i;
+
+    if (num <= 1 || schedule->scheduleType != SCHEDULE_DEFAULT || schedule->state != SCHEDULE_RUNNING) {
+        ProcessorWake(schedule, nullptr);
+        return;
+    }
+    cap = ProcessorSpinCap(schedule);
+    searching = atomic_load(&schdThread->searchingNum);
+    wakeNum = cap > searching ? cap - searching : 0;
+    wakeNum = wakeNum < num ? wakeNum : num;
+    freeNum = atomic_load(&schedule->schdProcessor.freeNum);
+    wakeNum = wakeNum < freeNum ? wakeNum : freeNum;
+    if (wakeNum <= 1) {
+        ProcessorWake(schedule, nullptr);
+        return;
+    }
+
+    // Each woken processor counts as searching until it finds a cjthread, as in ProcessorWake.
+    for (i = 0; i < wakeNum; i++) {
+        atomic_fetch_add(&schdThread->searchingNum, 1u);
+        processor = ProcessorAlloc(schedule, nullptr);
+        if (processor == nullptr) {
+            atomic_fetch_sub(&schdThread->searchingNum, 1u);
+            break;
+        }
+        if (processor->thread == nullptr) {
+            ThreadAllocBindProcessor(processor, true);
+        } else {
+            LOG_ERROR(ERRNO_SCHD_PROCESSOR_INVALID, "Processor's thread is not null");
+        }
+    }
+    if (i != 0) {
+        atomic_fetch_add_explicit(&schdThread->wakeBatchCnt, 1ULL, std::memory_order_relaxed);
+        atomic_fetch_add_explicit(&schdThread->wakeBatchNum, static_cast<unsigned long long>(i),
+                                  std::memory_order_relaxed);
+    }
+}
+
+/* Schmon backs off while all processors are idle, end it once one of them runs. The state
+ * change above is sequentially consistent with the backoff flag, see SchmonCycleDelay. */
+MRT_INLINE static void ProcessorAllocKick(void)
+{
+    struct Schmon *schmon = &g_scheduleManager.schmon;
+
+    if (atomic_load(&schmon->backoff) && atomic_exchange(&schmon->backoff, false)) {
+        SchmonKick();
+    }
+}
+
 /* Randomly allocate an idle processor. or assign a processor. */
 struct Processor *ProcessorAlloc(struct Schedule *schedule, struct Processor *specPro)
 {
@@ -930,6 +1271,7 @@ struct Processor *ProcessorAlloc(struct Schedule *schedule, struct Processor *sp
     if (specPro != nullptr && atomic_compare_exchange_strong(&specPro->state, &pidle, PROCESSOR_RUNNING)) {
         // Specify to retrieve a certain processor
         atomic_fetch_sub(&schdProcessor->freeNum, 1u);
+        ProcessorAllocKick();
         return specPro;
     }
 
@@ -939,6 +1281,7 @@ struct Processor *ProcessorAlloc(struct Schedule *schedule, struct Processor *sp
         pidle = PROCESSOR_IDLE;
         if (atomic_compare_exchange_strong(&newProcessor->state, &pidle, PROCESSOR_RUNNING)) {
             atomic_fetch_sub(&schdProcessor->freeNum, 1u);
+            ProcessorAllocKick();
             return newProcessor;
         }
     }
@@ -997,7 +1340,7 @@ int ProcessorGetInfoAll(struct ProcessorInfo *processorBuf, unsigned int num)
     while (count < num && index < schdProcessor->processorNum) {
         processor = &(schdProcessor->processorGroup[index]);
         index++;
-        if (processor->state == PROCESSOR_IDLE) {
+        if (processor->state == PROCESSOR_IDLE || processor->state == PROCESSOR_OFFLINE) {
             continue;
         }
         info = &processorBuf[count];
@@ -1013,7 +1356,10 @@ int ProcessorGetInfoAll(struct ProcessorInfo *processorBuf, unsigned int num)
             info->threadId = 0;
         }
         info->state = processor->state;
-        info->runqCnt = static_cast<int>(QueueLength(&processor->runq));
+        info->runqCnt = static_cast<int>(ProcessorRunqLength(processor));
+        for (unsigned int priority = 0; priority < CJTHREAD_PRIORITY_NUM; priority++) {
+            info->classRunqCnt[priority] = static_cast<int>(QueueLength(ProcessorRunqGet(processor, priority)));
+        }
         count++;
     }
 
@@ -1076,20 +1422,22 @@ struct CJThread *ProcessorFreelistGet(struct Processor *processor)
     unsigned int count;
     unsigned int rest = 0;
 
-    if (pfreelist->cjthreadNum == 0 && gfreelist->freeCJThreadNum == 0) {
+    if (pfreelist->cjthreadNum == 0 && gfreelist->freeCJThreadNum == 0 && gfreelist->cleanCJThreadNum == 0) {
         return nullptr;
     }
 
     PthreadSpinLock(&processor->lock);
 
-    if (pfreelist->cjthreadNum == 0 && gfreelist->freeCJThreadNum != 0) {
+    if (pfreelist->cjthreadNum == 0 && (gfreelist->freeCJThreadNum != 0 || gfreelist->cleanCJThreadNum != 0)) {
         pthread_mutex_lock(&gfreelist->gfreeLock);
         count = gfreelist->freeCJThreadNum;
-        // Local/global resource pools are both empty, return directly
+        // Only stacks with reclaimed pages are left. They are taken one at a time, so that the
+        // local pool does not hold them.
         if (count == 0) {
+            cjthread = ScheduleGfreelistPop(gfreelist);
             pthread_mutex_unlock(&gfreelist->gfreeLock);
             PthreadSpinUnlock(&processor->lock);
-            return nullptr;
+            return cjthread;
         }
         if (count > PROCESSOR_FREE_LIST_HALF_CAPACITY) {
             count = PROCESSOR_FREE_LIST_HALF_CAPACITY;
@@ -1111,6 +1459,30 @@ struct CJThread *ProcessorFreelistGet(struct Processor *processor)
     return cjthread;
 }
 
+unsigned int ProcessorFreelistGetBatch(struct Processor *processor, struct CJThread **list, unsigned int num)
+{
+    struct Schedule *schedule = static_cast<struct Schedule *>(processor->schedule);
+    struct ScheduleGfreeList *gfreelist = &schedule->schdCJThread.gfreelist;
+    struct ProcessorFreelist *pfreelist = &processor->freelist;
+    unsigned int count = 0;
+
+    if (pfreelist->cjthreadNum != 0) {
+        PthreadSpinLock(&processor->lock);
+        while (count < num && pfreelist->cjthreadNum != 0) {
+            list[count++] = ProcessorFreelistPop(pfreelist);
+        }
+        PthreadSpinUnlock(&processor->lock);
+    }
+    if (count < num && (gfreelist->freeCJThreadNum != 0 || gfreelist->cleanCJThreadNum != 0)) {
+        pthread_mutex_lock(&gfreelist->gfreeLock);
+        while (count < num && (list[count] = ScheduleGfreelistPop(gfreelist)) != nullptr) {
+            count++;
+        }
+        pthread_mutex_unlock(&gfreelist->gfreeLock);
+    }
+    return count;
+}
+
 /* Atomic method to obtain the ID of the processor, using a unified global variable to obtain
  * the processorId under multiple schedulers. */
 unsigned int ProcessorNewId(void)
@@ -1140,6 +1512,18 @@ unsigned int ProcessorId(void)
     return processor->processorId;
 }
 
+int ProcessorIdTry(void)
+{
+    struct CJThread *cjthread = CJThreadGet();
+    struct Processor *processor;
+
+    if (cjthread == nullptr || cjthread->thread == nullptr) {
+        return -1;
+    }
+    processor = static_cast<struct Processor *>(cjthread->thread->processor);
+    return processor == nullptr ? -1 : static_cast<int>(processor->processorId);
+}
+
 #if defined(CANGJIE_TSAN_SUPPORT)
 
 void* ProcessorGetHandle(void)
@@ -1161,7 +1545,8 @@ bool ProcessorCanSpin(void)
         return false;
     }
     schedule = cjthread->schedule;
-    unsigned int totalProcessorNum = schedule->schdProcessor.processorNum;
+    unsigned int totalProcessorNum = atomic_load_explicit(&schedule->schdProcessor.activeNum,
+                                                          std::memory_order_relaxed);
     unsigned int freeProcessorNum =
         atomic_load(&schedule->schdProcessor.freeNum) + atomic_load(&schedule->schdThread.searchingNum);
     if (totalProcessorNum <= 1 || // Single processor shuold not spin
@@ -1181,12 +1566,66 @@ bool ProcessorCanSpin(void)
     }
     // If the current processor has other cjthreads to run,
     // there is no need to spin.
-    if (QueueLength(&processor->runq) != 0) {
+    if (ProcessorRunqLength(processor) != 0) {
         return false;
     }
     return true;
 }
 
+unsigned int ProcessorSlotGet(void)
+{
+    struct CJThread *cjthread = CJThreadGet();
+    struct Thread *thread;
+    struct Processor *processor;
+
+    if (cjthread == nullptr || cjthread->thread == nullptr) {
+        return 0;
+    }
+    thread = cjthread->thread;
+    processor = static_cast<struct Processor *>(thread->processor);
+    if (processor == nullptr) {
+        return 0;
+    }
+    return processor->processorId + 1;
+}
+
+bool ProcessorSlotRunning(unsigned int slot, unsigned long long cjthreadId)
+{
+    struct CJThread *cjthread = CJThreadGet();
+    struct Schedule *schedule;
+
+    if (cjthread == nullptr || slot == 0) {
+        return false;
+    }
+    schedule = cjthread->schedule;
+    if (slot > schedule->schdProcessor.processorNum) {
+        return false;
+    }
+    return atomic_load_explicit(&schedule->schdProcessor.processorGroup[slot - 1].runningId,
+                                std::memory_order_relaxed) == cjthreadId;
+}
+
+unsigned int ProcessorSlotFind(unsigned long long cjthreadId)
+{
+    struct CJThread *cjthread = CJThreadGet();
+    struct Schedule *schedule;
+    unsigned int num;
+    unsigned int i;
+
+    if (cjthread == nullptr) {
+        return 0;
+    }
+    schedule = cjthread->schedule;
+    num = atomic_load_explicit(&schedule->schdProcessor.activeNum, std::memory_order_relaxed);
+    for (i = 0; i < num; i++) {
+        if (atomic_load_explicit(&schedule->schdProcessor.processorGroup[i].runningId,
+                                 std::memory_order_relaxed) == cjthreadId) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -58,6 +58,16 @@ struct ScheduleAttrInner g_schdAttr = {
     .stackProtect = false,
     .stackGrow = true,
     .processorNum = PROCESSOR_NUM_DEFAULT,
+    .busyPollMax = 0,
+    .preemptSlice = 0,
+    .cpuPin = false,
+    .wakeHandoff = false,
+    .processorMax = 0,
+    .cpuQuota = false,
+    .parkSpinMax = 0,
+    .stackReclaim = SCHEDULE_STACK_RECLAIM_OFF,
+    .stackReclaimKeep = STACK_RECLAIM_KEEP_DEFAULT,
+    .schmonBackoff = false,
 };
 
 struct ScheduleManager g_scheduleManager;
@@ -100,6 +110,16 @@ int ScheduleAttrInit(struct ScheduleAttr *usrAttr)
     attr->costackSize = COSTACK_SIZE_DEFAULT;
     attr->stackProtect = false;
     attr->stackGrow = true;
+    attr->busyPollMax = 0;
+    attr->preemptSlice = 0;
+    attr->cpuPin = false;
+    attr->wakeHandoff = false;
+    attr->processorMax = 0;
+    attr->cpuQuota = false;
+    attr->parkSpinMax = 0;
+    attr->stackReclaim = SCHEDULE_STACK_RECLAIM_OFF;
+    attr->stackReclaimKeep = STACK_RECLAIM_KEEP_DEFAULT;
+    attr->schmonBackoff = false;
     res = static_cast<int>(GetSystemProcessorsNums());
     if (res == -1) {
         res = errno;
@@ -170,6 +190,115 @@ int ScheduleAttrStackGrowSet(struct ScheduleAttr *usrAttr, bool open)
     return 0;
 }
 
+int ScheduleAttrBusyPollSet(struct ScheduleAttr *usrAttr, unsigned long long maxNs)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->busyPollMax = maxNs;
+
+    return 0;
+}
+
+int ScheduleAttrPreemptSliceSet(struct ScheduleAttr *usrAttr, unsigned long long sliceNs)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->preemptSlice = sliceNs;
+
+    return 0;
+}
+
+int ScheduleAttrCpuPinSet(struct ScheduleAttr *usrAttr, bool pin)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->cpuPin = pin;
+
+    return 0;
+}
+
+int ScheduleAttrWakeHandoffSet(struct ScheduleAttr *usrAttr, bool handoff)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->wakeHandoff = handoff;
+
+    return 0;
+}
+
+int ScheduleAttrSchmonBackoffSet(struct ScheduleAttr *usrAttr, bool backoff)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->schmonBackoff = backoff;
+
+    return 0;
+}
+
+int ScheduleAttrProcessorMaxSet(struct ScheduleAttr *usrAttr, unsigned int num)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->processorMax = num;
+
+    return 0;
+}
+
+int ScheduleAttrCpuQuotaSet(struct ScheduleAttr *usrAttr, bool follow)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->cpuQuota = follow;
+
+    return 0;
+}
+
+int ScheduleAttrParkSpinSet(struct ScheduleAttr *usrAttr, unsigned long long maxNs)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->parkSpinMax = maxNs;
+
+    return 0;
+}
+
+int ScheduleAttrStackReclaimSet(struct ScheduleAttr *usrAttr, int mode, size_t keepSize)
+{
+    struct ScheduleAttrInner *attr = reinterpret_cast<struct ScheduleAttrInner *>(usrAttr);
+
+    if (attr == nullptr || mode < SCHEDULE_STACK_RECLAIM_OFF || mode > SCHEDULE_STACK_RECLAIM_DONTNEED) {
+        return ERRNO_SCHD_ATTR_INVALID;
+    }
+    attr->stackReclaim = mode;
+    attr->stackReclaimKeep = keepSize;
+
+    return 0;
+}
+
 int ScheduleRecursiveLockCreate(pthread_mutex_t *mutex)
 {
     int error;
@@ -200,9 +329,10 @@ int ScheduleRecursiveLockCreate(pthread_mutex_t *mutex)
  * @attention
  * @param schedule     [IN] Scheduler of the processor to be initialized
  * @param processorNum [IN] Number of initialized processors
+ * @param activeNum    [IN] Number of active processors, the others start offline
  * @see
  */
-int ScheduleProcessorInit(struct Schedule *schedule, unsigned int processorNum)
+int ScheduleProcessorInit(struct Schedule *schedule, unsigned int processorNum, unsigned int activeNum)
 {
     int error;
     size_t mallocSize;
@@ -214,6 +344,8 @@ int ScheduleProcessorInit(struct Schedule *schedule, unsigned int processorNum)
     if (schedule->scheduleType != SCHEDULE_DEFAULT) {
         processorNum = PROCESSOR_NUM_SINGLE_THREAD;
     }
+    activeNum = activeNum > processorNum ? processorNum : activeNum;
+    activeNum = activeNum == 0 ? 1 : activeNum;
     // Allocating processor control blocks
     schdProcessor = &(schedule->schdProcessor);
     mallocSize = processorNum * sizeof(struct Processor);
@@ -232,7 +364,17 @@ int ScheduleProcessorInit(struct Schedule *schedule, unsigned int processorNum)
             MapleRuntime::NativeAllocator::NativeFree(processorGroup, mallocSize);
             return error;
         }
+        if (schedule->scheduleType == SCHEDULE_DEFAULT) {
+            processorGroup[id].cpu = TopologyPinCpu(&g_scheduleManager.topology, id);
+        }
+        if (id >= activeNum) {
+            processorGroup[id].state = PROCESSOR_OFFLINE;
+        }
     }
+    schdProcessor->activeNum = activeNum;
+    schdProcessor->growCnt = 0;
+    schdProcessor->shrinkCnt = 0;
+    pthread_mutex_init(&schdProcessor->resizeLock, nullptr);
 
     // Exclusive scheduler just bind thread to thread0
     if (schedule->scheduleType == SCHEDULE_EXCLUSIVE) {
@@ -245,8 +387,8 @@ int ScheduleProcessorInit(struct Schedule *schedule, unsigned int processorNum)
     }
     processorGroup[0].thread = thread;
     processorGroup[0].state = PROCESSOR_RUNNING;
-    // free num is processor_num - 1, because processor0 is running.
-    schdProcessor->freeNum = processorNum - 1;
+    // free num is active_num - 1, because processor0 is running.
+    schdProcessor->freeNum = activeNum - 1;
 
     return 0;
 }
@@ -268,6 +410,19 @@ int ScheduleThreadInit(struct ScheduleThread *schdThread, const struct ScheduleA
     DulinkInit(&(schdThread->threadHead));
     DulinkInit(&schdThread->allThreadList);
     schdThread->stackSize = attr->thstackSize;
+#ifdef MRT_LINUX
+    schdThread->parkSpinMax = attr->parkSpinMax;
+#else
+    schdThread->parkSpinMax = 0;
+#endif
+    schdThread->parkSpinBudget.store(0);
+    schdThread->parkSpinNum.store(0);
+    schdThread->parkSpinHitCnt.store(0);
+    schdThread->parkSpinSkipCnt.store(0);
+    schdThread->parkSpinNs.store(0);
+    schdThread->parkCnt.store(0);
+    schdThread->wakeBatchCnt.store(0);
+    schdThread->wakeBatchNum.store(0);
 
     // init lock
     error = ScheduleRecursiveLockCreate(&(schdThread->mutex));
@@ -300,6 +455,8 @@ int ScheduleGfreelistInit(struct ScheduleCJThread *schdCJThread)
     }
     DulinkInit(&schGfreelist->gfreeList);
     schGfreelist->freeCJThreadNum = 0;
+    DulinkInit(&schGfreelist->cleanList);
+    schGfreelist->cleanCJThreadNum = 0;
 
     return 0;
 }
@@ -528,6 +685,7 @@ void ScheduleManagerDestroy(void)
         pthread_mutex_destroy(&g_scheduleManager.allCJThreadListLock);
         pthread_mutex_destroy(&g_scheduleManager.allScheduleListLock);
         FreeSchdfdManager(g_scheduleManager.schdfdManager);
+        TopologyFini(&g_scheduleManager.topology);
         if (g_scheduleManager.trace.mutexInitFlag) {
             pthread_mutex_destroy(&g_scheduleManager.trace.lock);
             pthread_mutex_destroy(&g_scheduleManager.trace.bufLock);
@@ -541,6 +699,8 @@ ScheduleHandle ScheduleNew(ScheduleType scheduleType, const struct ScheduleAttr
     int error;
     struct Schedule *schedule;
     const struct ScheduleAttrInner *schedAttr;
+    unsigned int processorNum;
+    unsigned int activeNum;
 
     // When the scheduler is initialized, the created thread is bound to thread0. It is
     // convenient to use CJThreadGet() to obtain the cjthread. Therefore, only one scheduler
@@ -570,6 +730,22 @@ ScheduleHandle ScheduleNew(ScheduleType scheduleType, const struct ScheduleAttr
             MapleRuntime::NativeAllocator::NativeFree(schedule, sizeof(struct Schedule));
             return nullptr;
         }
+        g_scheduleManager.schdfdManager->busyPollMax = schedAttr->busyPollMax;
+#ifdef MRT_LINUX
+        g_scheduleManager.schmon.preemptSlice = schedAttr->preemptSlice;
+#endif
+        g_scheduleManager.schmon.backoffEnable = schedAttr->schmonBackoff;
+        g_scheduleManager.schmon.kickFd = -1;
+        // Stealing falls back to random victims without the topology.
+        (void)TopologyInit(&g_scheduleManager.topology, schedAttr->cpuPin);
+        g_scheduleManager.wakeHandoff = schedAttr->wakeHandoff;
+        g_scheduleManager.cpuQuota.enable = schedAttr->cpuQuota;
+        g_scheduleManager.cpuQuota.baseNum = schedAttr->processorNum;
+        if (schedAttr->cpuQuota && CpuQuotaInit(&g_scheduleManager.cpuQuota) != 0) {
+            LOG_ERROR(ERRNO_SCHD_CPU_QUOTA_UNKNOWN, "cgroup cpu quota not found, processors do not follow it");
+            g_scheduleManager.cpuQuota.enable = false;
+        }
+        StackReclaimInit(&g_scheduleManager.stackReclaim, schedAttr->stackReclaim, schedAttr->stackReclaimKeep);
     } else if (scheduleType != SCHEDULE_DEFAULT && !g_scheduleManager.initFlag) {
         LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "default schedule hasn't been inited");
         MapleRuntime::NativeAllocator::NativeFree(schedule, sizeof(struct Schedule));
@@ -608,8 +784,15 @@ ScheduleHandle ScheduleNew(ScheduleType scheduleType, const struct ScheduleAttr
         }
     }
 
-    // Init processor group
-    error = ScheduleProcessorInit(schedule, schedAttr->processorNum);
+    // Init processor group. The default scheduler allocates up to processorMax processors, so that
+    // the active ones can grow later.
+    processorNum = schedAttr->processorMax > schedAttr->processorNum ? schedAttr->processorMax :
+        schedAttr->processorNum;
+    activeNum = schedAttr->processorNum;
+    if (scheduleType == SCHEDULE_DEFAULT && g_scheduleManager.cpuQuota.enable) {
+        activeNum = CpuQuotaProcessorNum(&g_scheduleManager.cpuQuota, processorNum);
+    }
+    error = ScheduleProcessorInit(schedule, processorNum, activeNum);
     if (error) {
         LOG_ERROR(error, "schedule processor control block init failed");
         ScheduleFini(schedule, FINI_PROCESSOR);
@@ -851,6 +1034,8 @@ void ScheduleProcessorFree(struct Schedule *schedule)
             CJThreadFree(cjthread, false);
         }
         free(processor->runq.buf);
+        free(processor->highRunq.buf);
+        free(processor->lowRunq.buf);
 
         // Release the timer of processors.
         for (j = 0; j < PROCESSOR_PARRAY_NUM; ++j) {
@@ -862,6 +1047,7 @@ void ScheduleProcessorFree(struct Schedule *schedule)
     }
 
     // Release processor.
+    pthread_mutex_destroy(&schedule->schdProcessor.resizeLock);
     MapleRuntime::NativeAllocator::NativeFree(schedule->schdProcessor.processorGroup,
         schedule->schdProcessor.processorNum * sizeof(struct Processor));
 }
@@ -869,8 +1055,11 @@ void ScheduleProcessorFree(struct Schedule *schedule)
 void ScheduleSchmonExit(void)
 {
     if (g_scheduleManager.schmon.schmonId != 0) {
+        // Schmon may be in a long backoff wait.
+        SchmonKick();
         pthread_join(g_scheduleManager.schmon.schmonId, nullptr);
         g_scheduleManager.schmon.schmonId = 0;
+        SchmonKickFini();
     }
 }
 
@@ -1084,7 +1273,7 @@ void ScheduleProcessorExit(struct Schedule *schedule)
         // finishes executing from the syscall, it searches for an idle processor. If it cannot
         // find an idle processor, it sleeps itself.
         pstate = processor->state;
-        if (pstate == PROCESSOR_IDLE || pstate == PROCESSOR_SYSCALL) {
+        if (pstate == PROCESSOR_IDLE || pstate == PROCESSOR_SYSCALL || pstate == PROCESSOR_OFFLINE) {
             atomic_compare_exchange_strong(&processor->state, &pstate, PROCESSOR_EXITING);
         } else if (pstate == PROCESSOR_RUNNING) {
             SchmonPreemptRunning(processor);
@@ -1101,7 +1290,7 @@ void ScheduleProcessorExit(struct Schedule *schedule)
 
         while (atomic_load(&processor->state) != PROCESSOR_EXITING || processor->thread != nullptr) {
             pstate = processor->state;
-            if (pstate == PROCESSOR_IDLE || pstate == PROCESSOR_SYSCALL) {
+            if (pstate == PROCESSOR_IDLE || pstate == PROCESSOR_SYSCALL || pstate == PROCESSOR_OFFLINE) {
                 atomic_compare_exchange_strong(&processor->state, &pstate, PROCESSOR_EXITING);
             } else if (pstate == PROCESSOR_RUNNING) {
                 SchmonPreemptRunning(processor);
@@ -1312,6 +1501,9 @@ int ScheduleGlobalWrite(struct CJThread *cjthreadList[], unsigned int num)
 
     schedule = cjthreadList[0]->schedule;
     globalQueue = &schedule->schdCJThread.runq;
+    if (ScheduleLatencyStatsOn()) {
+        ProcessorLatencyRunqStamp(cjthreadList, num);
+    }
 
     pthread_mutex_lock(&schedule->schdCJThread.mutex);
     for (i = 0; i < num; i++) {
@@ -1332,7 +1524,7 @@ bool ScheduleAnyCJThread(ScheduleHandle scheduleHandle)
 
     for (i = 0; i < schedule->schdProcessor.processorNum; ++i) {
         processor = &schedule->schdProcessor.processorGroup[i];
-        if (QueueLength(&processor->runq) != 0) {
+        if (ProcessorRunqLength(processor) != 0) {
             return true;
         }
     }
@@ -1382,6 +1574,15 @@ int SchdSchmonHookRegister(SchmonCheckFunc func, unsigned int key)
     return 0;
 }
 
+int SchdSchmonDeadlineHookRegister(SchmonDeadlineFunc func)
+{
+    if (g_scheduleManager.schmon.deadlineFunc != nullptr) {
+        return ERRNO_SCHD_HOOK_REGISTED;
+    }
+    g_scheduleManager.schmon.deadlineFunc = func;
+    return 0;
+}
+
 int SchdExitHookRegister(ProcessorExitFunc func, unsigned int key)
 {
     if (g_scheduleManager.exit[key] != nullptr) {
@@ -1435,6 +1636,15 @@ struct CJThread *ScheduleGfreelistPop(struct ScheduleGfreeList *gfreelist)
 
         return cjthread;
     }
+    // Stacks whose pages are reclaimed fault them in again, so they are used last.
+    if (gfreelist->cleanCJThreadNum != 0) {
+        cjthread = DULINK_ENTRY(gfreelist->cleanList.next,
+                                 struct CJThread, schdDulink);
+        DulinkRemove(&(cjthread->schdDulink));
+        gfreelist->cleanCJThreadNum--;
+
+        return cjthread;
+    }
     return nullptr;
 }
 
@@ -1680,6 +1890,368 @@ unsigned int ScheduleRunningOSThreadCount(void)
     return processorNum;
 }
 
+unsigned long long ScheduleBlockingHandoffCount(void)
+{
+    struct Dulink *scheduleNode;
+    struct Schedule *schedule;
+    unsigned long long handoffCnt = 0;
+
+    if (!g_scheduleManager.initFlag) {
+        return 0;
+    }
+    pthread_mutex_lock(&g_scheduleManager.allScheduleListLock);
+    DULINK_FOR_EACH_ITEM(scheduleNode, &g_scheduleManager.allScheduleList) {
+        schedule = DULINK_ENTRY(scheduleNode, struct Schedule, allScheduleDulink);
+        handoffCnt += atomic_load(&schedule->schdCJThread.handoffCnt);
+    }
+    pthread_mutex_unlock(&g_scheduleManager.allScheduleListLock);
+    return handoffCnt;
+}
+
+int SchedulePreemptStatsGet(struct SchedulePreemptStats *stats)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ProcessorPreempt *preempt;
+    unsigned int i;
+    unsigned int j;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    (void)memset_s(stats, sizeof(struct SchedulePreemptStats), 0, sizeof(struct SchedulePreemptStats));
+    stats->sliceNs = g_scheduleManager.schmon.preemptSlice;
+    for (i = 0; i < schedule->schdProcessor.processorNum; i++) {
+        preempt = &schedule->schdProcessor.processorGroup[i].preempt;
+        stats->requestCnt += atomic_load_explicit(&preempt->requestCnt, std::memory_order_relaxed);
+        stats->signalCnt += atomic_load_explicit(&preempt->signalCnt, std::memory_order_relaxed);
+        for (j = 0; j < SCHEDULE_PREEMPT_OVERRUN_BUCKETS; j++) {
+            stats->overrunHist[j] += atomic_load_explicit(&preempt->overrunHist[j], std::memory_order_relaxed);
+        }
+    }
+    return 0;
+}
+
+int ScheduleStealStatsGet(struct ScheduleStealStats *stats)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ScheduleTopology *topology = &g_scheduleManager.topology;
+    struct Processor *processor;
+    unsigned int i;
+    unsigned int level;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    (void)memset_s(stats, sizeof(struct ScheduleStealStats), 0, sizeof(struct ScheduleStealStats));
+    for (i = 0; i < schedule->schdProcessor.processorNum; i++) {
+        processor = &schedule->schdProcessor.processorGroup[i];
+        for (level = 0; level < SCHEDULE_TOPOLOGY_LEVEL_NUM; level++) {
+            stats->stealCnt[level] += atomic_load_explicit(&processor->stealCnt[level], std::memory_order_relaxed);
+        }
+    }
+    for (level = 0; level < SCHEDULE_TOPOLOGY_REMOTE; level++) {
+        stats->localCnt += stats->stealCnt[level];
+    }
+    stats->remoteCnt = stats->stealCnt[SCHEDULE_TOPOLOGY_REMOTE];
+    stats->cpuNum = topology->valid ? static_cast<unsigned int>(topology->cpuMax) : 0;
+    stats->nodeNum = topology->nodeNum;
+    stats->pinned = topology->pin;
+    return 0;
+}
+
+int ScheduleWakeStatsGet(struct ScheduleWakeStats *stats)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ProcessorWakeInfo *wake;
+    unsigned int i;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    (void)memset_s(stats, sizeof(struct ScheduleWakeStats), 0, sizeof(struct ScheduleWakeStats));
+    stats->handoff = g_scheduleManager.wakeHandoff;
+    for (i = 0; i < schedule->schdProcessor.processorNum; i++) {
+        wake = &schedule->schdProcessor.processorGroup[i].wake;
+        stats->affineCnt += atomic_load_explicit(&wake->affineCnt, std::memory_order_relaxed);
+        stats->handoffCnt += atomic_load_explicit(&wake->handoffCnt, std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+int ScheduleParkStatsGet(struct ScheduleParkStats *stats)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ScheduleThread *schdThread;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    schdThread = &schedule->schdThread;
+    stats->spinMax = schdThread->parkSpinMax;
+    stats->spinBudget = atomic_load_explicit(&schdThread->parkSpinBudget, std::memory_order_relaxed);
+    stats->spinHitCnt = atomic_load_explicit(&schdThread->parkSpinHitCnt, std::memory_order_relaxed);
+    stats->spinSkipCnt = atomic_load_explicit(&schdThread->parkSpinSkipCnt, std::memory_order_relaxed);
+    stats->spinNs = atomic_load_explicit(&schdThread->parkSpinNs, std::memory_order_relaxed);
+    stats->parkCnt = atomic_load_explicit(&schdThread->parkCnt, std::memory_order_relaxed);
+    stats->wakeBatchCnt = atomic_load_explicit(&schdThread->wakeBatchCnt, std::memory_order_relaxed);
+    stats->wakeBatchNum = atomic_load_explicit(&schdThread->wakeBatchNum, std::memory_order_relaxed);
+    return 0;
+}
+
+int ScheduleStackStatsGet(struct ScheduleStackStats *stats)
+{
+    struct ScheduleStackReclaim *reclaim = &g_scheduleManager.stackReclaim;
+    struct Dulink *scheduleCJThreadNode;
+    struct CJThread *cjthread;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    (void)memset_s(stats, sizeof(struct ScheduleStackStats), 0, sizeof(struct ScheduleStackStats));
+    stats->reclaimMode = atomic_load_explicit(&reclaim->mode, std::memory_order_relaxed);
+    stats->keepSize = reclaim->keepSize;
+    pthread_mutex_lock(&g_scheduleManager.allCJThreadListLock);
+    DULINK_FOR_EACH_ITEM(scheduleCJThreadNode, &g_scheduleManager.allCJThreadList) {
+        cjthread = DULINK_ENTRY(scheduleCJThreadNode, struct CJThread, allCJThreadDulink);
+        if (cjthread->stack.stackTopAddr == nullptr) {
+            continue;
+        }
+        stats->stackNum++;
+        if (cjthread->state == CJTHREAD_IDLE) {
+            stats->pooledNum++;
+        }
+        stats->stackBytes += cjthread->stack.stackSize;
+        stats->residentBytes += StackResidentSize(cjthread->stack.stackTopAddr, cjthread->stack.stackSize);
+    }
+    pthread_mutex_unlock(&g_scheduleManager.allCJThreadListLock);
+    stats->pooledReclaimCnt = atomic_load_explicit(&reclaim->pooledCnt, std::memory_order_relaxed);
+    stats->parkedReclaimCnt = atomic_load_explicit(&reclaim->parkedCnt, std::memory_order_relaxed);
+    stats->releasedBytes = atomic_load_explicit(&reclaim->releasedBytes, std::memory_order_relaxed);
+    return 0;
+}
+
+unsigned int ScheduleProcessorLoadGet(struct ScheduleProcessorLoad loads[], unsigned int num)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ScheduleProcessor *schdProcessor;
+    struct Processor *processor;
+    unsigned int count = 0;
+
+    if (loads == nullptr || !g_scheduleManager.initFlag || schedule == nullptr) {
+        return 0;
+    }
+    schdProcessor = &schedule->schdProcessor;
+    for (unsigned int index = 0; index < schdProcessor->processorNum && count < num; index++) {
+        processor = &schdProcessor->processorGroup[index];
+        ProcessorState state = processor->state.load(std::memory_order_relaxed);
+        if (state == PROCESSOR_IDLE || state == PROCESSOR_OFFLINE) {
+            continue;
+        }
+        loads[count].processorId = processor->processorId;
+        loads[count].state = state;
+        loads[count].runqCnt = ProcessorRunqLength(processor);
+        loads[count].schedCnt = processor->schedCnt;
+        count++;
+    }
+    return count;
+}
+
+unsigned int ScheduleTimerNumGet(void)
+{
+    TimerControlFunc timerNum = g_timerHookFunc[ANY_TIMER_HOOK];
+    if (timerNum == nullptr) {
+        return 0;
+    }
+    int num = timerNum();
+    return num > 0 ? static_cast<unsigned int>(num) : 0;
+}
+
+int ScheduleLatencyStatsSet(bool enable)
+{
+    if (!g_scheduleManager.initFlag || g_scheduleManager.defaultSchedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    atomic_store_explicit(&g_scheduleManager.latencyStats, enable, std::memory_order_relaxed);
+    return 0;
+}
+
+int ScheduleLatencyStatsGet(int kind, int processorId, struct ScheduleLatencyHist *hist)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ScheduleProcessor *schdProcessor;
+    struct ProcessorLatencyHist *processorHist;
+    bool found = false;
+
+    if (hist == nullptr || kind < 0 || kind >= SCHEDULE_LATENCY_KIND_NUM) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    (void)memset_s(hist, sizeof(struct ScheduleLatencyHist), 0, sizeof(struct ScheduleLatencyHist));
+    schdProcessor = &schedule->schdProcessor;
+    for (unsigned int i = 0; i < schdProcessor->processorNum; i++) {
+        struct Processor *processor = &schdProcessor->processorGroup[i];
+        if (processorId >= 0 && processor->processorId != static_cast<unsigned int>(processorId)) {
+            continue;
+        }
+        found = true;
+        processorHist = &processor->latency.hist[kind];
+        hist->count += atomic_load_explicit(&processorHist->count, std::memory_order_relaxed);
+        hist->sumNs += atomic_load_explicit(&processorHist->sumNs, std::memory_order_relaxed);
+        unsigned long long maxNs = atomic_load_explicit(&processorHist->maxNs, std::memory_order_relaxed);
+        hist->maxNs = maxNs > hist->maxNs ? maxNs : hist->maxNs;
+        for (unsigned int j = 0; j < SCHEDULE_LATENCY_BUCKETS; j++) {
+            hist->buckets[j] += atomic_load_explicit(&processorHist->buckets[j], std::memory_order_relaxed);
+        }
+    }
+    return found ? 0 : ERRNO_SCHD_INVALID;
+}
+
+unsigned long long ScheduleLatencyBucketLower(unsigned int index)
+{
+    const unsigned int subNum = 1U << SCHEDULE_LATENCY_SUB_BITS;
+    unsigned int group;
+
+    if (index < subNum) {
+        return index;
+    }
+    if (index >= SCHEDULE_LATENCY_BUCKETS) {
+        index = SCHEDULE_LATENCY_BUCKETS - 1;
+    }
+    group = index >> SCHEDULE_LATENCY_SUB_BITS;
+    return static_cast<unsigned long long>(subNum + (index & (subNum - 1))) << (group - 1);
+}
+
+int ScheduleProcessorNumSet(unsigned int num)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ScheduleProcessor *schdProcessor;
+    struct Processor *processor;
+    unsigned int activeNum;
+    unsigned int i;
+    ProcessorState expected;
+
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    schdProcessor = &schedule->schdProcessor;
+    if (num == 0 || num > schdProcessor->processorNum) {
+        LOG_ERROR(ERRNO_SCHD_ARG_INVALID, "processor num %u is out of [1, %u]", num, schdProcessor->processorNum);
+        return ERRNO_SCHD_ARG_INVALID;
+    }
+    pthread_mutex_lock(&schdProcessor->resizeLock);
+    if (schedule->state == SCHEDULE_EXITING) {
+        pthread_mutex_unlock(&schdProcessor->resizeLock);
+        return ERRNO_SCHD_INVALID;
+    }
+    // Publish activeNum before changing the states. A processor released in between checks
+    // activeNum again after its own state change, see ProcessorFree.
+    activeNum = atomic_load(&schdProcessor->activeNum);
+    atomic_store(&schdProcessor->activeNum, num);
+    for (i = activeNum; i < num; i++) {
+        processor = &schdProcessor->processorGroup[i];
+        expected = PROCESSOR_OFFLINE;
+        if (atomic_compare_exchange_strong(&processor->state, &expected, PROCESSOR_IDLE)) {
+            atomic_fetch_add(&schdProcessor->freeNum, 1u);
+        }
+    }
+    for (i = num; i < activeNum; i++) {
+        processor = &schdProcessor->processorGroup[i];
+        expected = PROCESSOR_IDLE;
+        if (atomic_compare_exchange_strong(&processor->state, &expected, PROCESSOR_OFFLINE)) {
+            atomic_fetch_sub(&schdProcessor->freeNum, 1u);
+        } else if (expected == PROCESSOR_RUNNING) {
+            // Preempt the running cjthread, so that the processor retires at its next schedule point.
+            SchmonPreemptRunning(processor);
+        }
+    }
+    if (num > activeNum) {
+        atomic_fetch_add_explicit(&schdProcessor->growCnt, 1ULL, std::memory_order_relaxed);
+        // The new processors take over the cjthreads queued so far.
+        if (ScheduleAnyCJThread(schedule)) {
+            ProcessorWakeBatch(schedule, num - activeNum);
+        }
+    } else if (num < activeNum) {
+        atomic_fetch_add_explicit(&schdProcessor->shrinkCnt, 1ULL, std::memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&schdProcessor->resizeLock);
+    return 0;
+}
+
+unsigned int ScheduleProcessorNumGet(void)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        return 0;
+    }
+    return atomic_load_explicit(&schedule->schdProcessor.activeNum, std::memory_order_relaxed);
+}
+
+int ScheduleProcessorStatsGet(struct ScheduleProcessorStats *stats)
+{
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    struct ScheduleProcessor *schdProcessor;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schedule == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    schdProcessor = &schedule->schdProcessor;
+    stats->activeNum = atomic_load_explicit(&schdProcessor->activeNum, std::memory_order_relaxed);
+    stats->capacity = schdProcessor->processorNum;
+    stats->cpuQuota = g_scheduleManager.cpuQuota.enable;
+    stats->quotaCpus = atomic_load_explicit(&g_scheduleManager.cpuQuota.cpus, std::memory_order_relaxed);
+    stats->growCnt = atomic_load_explicit(&schdProcessor->growCnt, std::memory_order_relaxed);
+    stats->shrinkCnt = atomic_load_explicit(&schdProcessor->shrinkCnt, std::memory_order_relaxed);
+    return 0;
+}
+
+int ScheduleBusyPollStatsGet(struct ScheduleBusyPollStats *stats)
+{
+    struct SchdfdManager *schdfdManager = g_scheduleManager.schdfdManager;
+
+    if (stats == nullptr) {
+        return ERRNO_SCHD_INVALID;
+    }
+    if (!g_scheduleManager.initFlag || schdfdManager == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "schedule manager is not init");
+        return ERRNO_SCHD_INIT_FAILED;
+    }
+    stats->spinHitCnt = atomic_load_explicit(&schdfdManager->spinHitCnt, std::memory_order_relaxed);
+    stats->spinNs = atomic_load_explicit(&schdfdManager->spinNs, std::memory_order_relaxed);
+    stats->parkCnt = atomic_load_explicit(&schdfdManager->parkCnt, std::memory_order_relaxed);
+    stats->parkNs = atomic_load_explicit(&schdfdManager->parkNs, std::memory_order_relaxed);
+    return 0;
+}
+
 void ScheduleAllCJThreadVisit(AllCJThreadListProcFunc visitor, void *handle)
 {
     ScheduleAllCJThreadVisitImpl(visitor, handle, 1);
@@ -1925,7 +2497,7 @@ unsigned int ScheduleGetProcessorNum(void)
     pthread_mutex_lock(&g_scheduleManager.allScheduleListLock);
     DULINK_FOR_EACH_ITEM(scheduleNode, &g_scheduleManager.allScheduleList) {
         schedule = DULINK_ENTRY(scheduleNode, struct Schedule, allScheduleDulink);
-        processorNum += schedule->schdProcessor.processorNum;
+        processorNum += atomic_load_explicit(&schedule->schdProcessor.activeNum, std::memory_order_relaxed);
     }
     pthread_mutex_unlock(&g_scheduleManager.allScheduleListLock);
     return processorNum;
@@ -1981,7 +2553,8 @@ TraceRegisterFunc ScheduleLoadTrace(char* dlPath, DlHandle *dlHandlePtr)
 }
 #endif
 
-bool ScheduleStartTrace(unsigned short traceType)
+/* Load the trace dynamic library and register its hooks. */
+static bool ScheduleTraceOpen(DlHandle *dlHandlePtr)
 {
     DlHandle dlHandle = nullptr;
     char dlPath[TRACE_PATH_LENGTH];
@@ -2019,6 +2592,16 @@ bool ScheduleStartTrace(unsigned short traceType)
         ScheduleTraceDlclose(dlHandle);
         return false;
     }
+    *dlHandlePtr = dlHandle;
+    return true;
+}
+
+bool ScheduleStartTrace(unsigned short traceType)
+{
+    DlHandle dlHandle = nullptr;
+    if (!ScheduleTraceOpen(&dlHandle)) {
+        return false;
+    }
     bool result = g_scheduleManager.trace.hooks.traceStart(traceType);
     if (!result) {
         g_scheduleManager.trace.hooks.traceDeregister();
@@ -2029,6 +2612,23 @@ bool ScheduleStartTrace(unsigned short traceType)
     return true;
 }
 
+bool ScheduleStartFlightRecorder(unsigned short traceType, unsigned int windowMs, unsigned int bufNum)
+{
+    DlHandle dlHandle = nullptr;
+    if (!ScheduleTraceOpen(&dlHandle)) {
+        return false;
+    }
+    bool result = g_scheduleManager.trace.hooks.flightRecorderStart != nullptr &&
+        g_scheduleManager.trace.hooks.flightRecorderStart(traceType, windowMs, bufNum);
+    if (!result) {
+        g_scheduleManager.trace.hooks.traceDeregister();
+        ScheduleTraceDlclose(dlHandle);
+        return false;
+    }
+    g_scheduleManager.trace.dlHandle = dlHandle;
+    return true;
+}
+
 bool ScheduleStopTrace()
 {
     bool result;
@@ -2054,6 +2654,15 @@ unsigned char *ScheduleDumpTrace(int *len)
     return g_scheduleManager.trace.hooks.traceDump(len);
 }
 
+bool ScheduleDumpFlightRecorder(int fd)
+{
+    if (g_scheduleManager.trace.hooks.flightRecorderDump == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_TRACE_DL_FAILED, "func not register");
+        return false;
+    }
+    return g_scheduleManager.trace.hooks.flightRecorderDump(fd);
+}
+
 #else
 bool ScheduleStartTrace(unsigned short traceType)
 {
@@ -2061,6 +2670,20 @@ bool ScheduleStartTrace(unsigned short traceType)
     return false;
 }
 
+bool ScheduleStartFlightRecorder(unsigned short traceType, unsigned int windowMs, unsigned int bufNum)
+{
+    (void)traceType;
+    (void)windowMs;
+    (void)bufNum;
+    return false;
+}
+
+bool ScheduleDumpFlightRecorder(int fd)
+{
+    (void)fd;
+    return false;
+}
+
 bool ScheduleStopTrace()
 {
     return false;
@@ -12,9 +12,19 @@
 #include "basetime.h"
 #include "log.h"
 #include "schmon.h"
+#include "securec.h"
 
 #if defined (MRT_LINUX)
 #include <malloc.h>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include "SignalManager.h"
+#include "Signal/SignalStack.h"
 #endif
 
 #ifdef __cplusplus
@@ -32,6 +42,58 @@ const unsigned long long POOL_CLEAN_TIME = 5000000000ULL;
 /* The preemption check is performed every 10 ms. */
 const int PROCESSORS_CHECK_TIME = 10000;
 
+#ifdef MRT_LINUX
+#ifndef SIGEV_THREAD_ID
+#define SIGEV_THREAD_ID 4
+#endif
+#if defined(__GLIBC__) && !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/* Signal of the time-slice timers. It is ignored by default and unused by the runtime. */
+#define SCHMON_PREEMPT_SIGNAL SIGURG
+
+/* The time-slice timer fires twice per slice, so a cjthread runs for at most 1.5 slices. */
+const unsigned long long PREEMPT_TIMER_TICKS_PER_SLICE = 2;
+
+/* Upper limit of the schmon cycle when all processors are idle, 160ms */
+const unsigned int SCHMON_IDLE_MAX_DELAY = 160000;
+
+/* Lower limit of the schmon cycle when waiting for a timer deadline, 1ms */
+const unsigned int SCHMON_IDLE_MIN_DELAY = 1000;
+
+#endif
+
+/* Bucket of the overrun histogram, see SchedulePreemptStats. */
+MRT_INLINE static unsigned int SchmonOverrunBucket(unsigned long long overrunNs)
+{
+    const unsigned long long nsPerUs = 1000;
+    unsigned long long us = overrunNs / nsPerUs + 1;
+    unsigned int idx = 0;
+
+    while (us > 1 && idx < SCHEDULE_PREEMPT_OVERRUN_BUCKETS - 1) {
+        us >>= 1;
+        idx++;
+    }
+    return idx;
+}
+
+/* Called when the processor schedules again, closes the pending preemption request. */
+void SchmonPreemptOverrunRecord(struct Processor *processor)
+{
+    struct ProcessorPreempt *preempt = &processor->preempt;
+    unsigned long long requestTime;
+    unsigned long long now;
+
+    requestTime = atomic_exchange_explicit(&preempt->requestTime, 0ULL, std::memory_order_relaxed);
+    if (requestTime == 0) {
+        return;
+    }
+    now = CurrentNanotimeGet();
+    now = now > requestTime ? now - requestTime : 0;
+    atomic_fetch_add_explicit(&preempt->overrunHist[SchmonOverrunBucket(now)], 1ULL, std::memory_order_relaxed);
+}
+
 /* Preempts the processor in the syscall state.
  * This function affects the thread bound to the processor. Therefore, the scheduling
  * framework of a single processor does not execute this logic.
@@ -80,21 +142,208 @@ void SchmonPreemptRunning(struct Processor *processor)
         request = func();
         atomic_store(reinterpret_cast<std::atomic<uintptr_t> *>(thread->preemptRequest), request);
     }
+
+    // Only the first request of a slice is timed, repeated requests extend its overrun.
+    unsigned long long noRequest = 0;
+    atomic_compare_exchange_strong(&processor->preempt.requestTime, &noRequest, CurrentNanotimeGet());
+    atomic_fetch_add_explicit(&processor->preempt.requestCnt, 1ULL, std::memory_order_relaxed);
 }
 
-// Check processor whether has ready cjthread.
-bool FastSchmonProcessorPreemptCheck(struct Processor *processor)
+#ifdef MRT_LINUX
+MRT_INLINE static int SchmonPreemptTimerSet(int timerId, unsigned long long intervalNs)
 {
-    if (atomic_load_explicit(&processor->state, std::memory_order_relaxed) == PROCESSOR_IDLE) {
+    struct itimerspec spec;
+    const unsigned long long nsPerSec = 1000000000ULL;
+
+    spec.it_interval.tv_sec = static_cast<time_t>(intervalNs / nsPerSec);
+    spec.it_interval.tv_nsec = static_cast<long>(intervalNs % nsPerSec);
+    spec.it_value = spec.it_interval;
+    return static_cast<int>(syscall(SYS_timer_settime, timerId, 0, &spec, nullptr));
+}
+
+MRT_INLINE static void SchmonPreemptTimerLock(struct ProcessorPreempt *preempt)
+{
+    while (atomic_exchange_explicit(&preempt->timerLock, true, std::memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+/* The signal handler may interrupt the owner of the lock on the same thread, so it never waits. */
+MRT_INLINE static bool SchmonPreemptTimerTryLock(struct ProcessorPreempt *preempt)
+{
+    return !atomic_exchange_explicit(&preempt->timerLock, true, std::memory_order_acquire);
+}
+
+MRT_INLINE static void SchmonPreemptTimerUnlock(struct ProcessorPreempt *preempt)
+{
+    atomic_store_explicit(&preempt->timerLock, false, std::memory_order_release);
+}
+
+/* Timer signal handler, called synchronously by the runtime signal stack on the thread the
+ * timer was created for. It must stay async-signal-safe. Returns false for signals that are
+ * not ours, e.g. SIGURG of out-of-band socket data, so that the next handler gets them. */
+static bool SchmonPreemptSignalHandler(int sig, siginfo_t *info, void *context)
+{
+    struct Processor *processor;
+    struct ProcessorPreempt *preempt;
+    struct Thread *thread;
+    unsigned long long tid;
+    unsigned long long start;
+    (void)sig;
+    (void)context;
+
+    if (info == nullptr || info->si_code != SI_TIMER) {
         return false;
     }
-    if (processor->cjthreadNext.load() != nullptr) {
+
+    processor = static_cast<struct Processor *>(info->si_value.sival_ptr);
+    preempt = &processor->preempt;
+    atomic_fetch_add_explicit(&preempt->signalCnt, 1ULL, std::memory_order_relaxed);
+    if (!SchmonPreemptTimerTryLock(preempt)) {
+        // The timer is being changed, skip this tick.
+        return true;
+    }
+    tid = static_cast<unsigned long long>(syscall(SYS_gettid));
+    if (preempt->timerTid != tid) {
+        // A signal of a timer deleted since, the timer of the processor belongs to another thread.
+        SchmonPreemptTimerUnlock(preempt);
         return true;
     }
-    if (QueueLength(&processor->runq) != 0) {
+    thread = processor->thread;
+    if (atomic_load(&processor->state) != PROCESSOR_RUNNING || thread == nullptr ||
+        static_cast<unsigned long long>(thread->tid) != tid) {
+        // The processor was handed off during a syscall. Stop interrupting this thread and let
+        // schmon watch the processor until it schedules again.
+        (void)SchmonPreemptTimerSet(preempt->timerId, 0);
+        atomic_store(&preempt->timerArmed, false);
+        SchmonPreemptTimerUnlock(preempt);
         return true;
     }
-    return false;
+    SchmonPreemptTimerUnlock(preempt);
+    start = atomic_load_explicit(&preempt->sliceStart, std::memory_order_relaxed);
+    if (CurrentNanotimeGet() - start >= g_scheduleManager.schmon.preemptSlice) {
+        SchmonPreemptRunning(processor);
+    }
+    return true;
+}
+
+/* Add the timer handler to the runtime signal stack. It runs on the alternate signal stack of
+ * the processor thread, see ThreadEntry. */
+static void SchmonPreemptSignalInit(void)
+{
+    SignalAction action;
+
+    sigemptyset(&action.scMask);
+    action.saSignalAction = SchmonPreemptSignalHandler;
+    action.scFlags = SA_SIGINFO | SA_ONSTACK | MapleRuntime::SIGNAL_STACK_SYNC;
+    MapleRuntime::SignalManager::AddHandlerToSignalStack(SCHMON_PREEMPT_SIGNAL, &action);
+}
+#endif
+
+/* Start a new time slice on the current thread of the processor. The timer measures the CPU
+ * time of the thread, so it does not fire while the thread is blocked. */
+void SchmonPreemptSliceBegin(struct Processor *processor)
+{
+#ifdef MRT_LINUX
+    struct ProcessorPreempt *preempt = &processor->preempt;
+    unsigned long long tid = static_cast<unsigned long long>(processor->thread->tid);
+    struct sigevent sev;
+    int timerId;
+
+    atomic_store_explicit(&preempt->sliceStart, CurrentNanotimeGet(), std::memory_order_relaxed);
+    if (preempt->timerTid == tid && atomic_load_explicit(&preempt->timerArmed, std::memory_order_relaxed)) {
+        return;
+    }
+    SchmonPreemptTimerLock(preempt);
+    if (preempt->timerTid != tid) {
+        if (preempt->timerTid != 0) {
+            (void)syscall(SYS_timer_delete, preempt->timerId);
+            preempt->timerTid = 0;
+        }
+        (void)memset_s(&sev, sizeof(sev), 0, sizeof(sev));
+        sev.sigev_notify = SIGEV_THREAD_ID;
+        sev.sigev_signo = SCHMON_PREEMPT_SIGNAL;
+        sev.sigev_value.sival_ptr = processor;
+        sev.sigev_notify_thread_id = static_cast<pid_t>(tid);
+        if (syscall(SYS_timer_create, CLOCK_THREAD_CPUTIME_ID, &sev, &timerId) != 0) {
+            SchmonPreemptTimerUnlock(preempt);
+            LOG_ERROR(ERRNO_SCHMON_INIT_FAILED, "timer_create failed, errno: %d, use schmon-driven preemption",
+                      errno);
+            g_scheduleManager.schmon.preemptSlice = 0;
+            return;
+        }
+        preempt->timerId = timerId;
+        preempt->timerTid = tid;
+    }
+    if (SchmonPreemptTimerSet(preempt->timerId,
+                              g_scheduleManager.schmon.preemptSlice / PREEMPT_TIMER_TICKS_PER_SLICE) == 0) {
+        atomic_store(&preempt->timerArmed, true);
+    }
+    SchmonPreemptTimerUnlock(preempt);
+#else
+    (void)processor;
+#endif
+}
+
+/* Stop the time-slice timer before the processor is released. */
+void SchmonPreemptTimerDisarm(struct Processor *processor)
+{
+#ifdef MRT_LINUX
+    struct ProcessorPreempt *preempt = &processor->preempt;
+
+    if (!atomic_load_explicit(&preempt->timerArmed, std::memory_order_relaxed)) {
+        return;
+    }
+    SchmonPreemptTimerLock(preempt);
+    if (atomic_load_explicit(&preempt->timerArmed, std::memory_order_relaxed)) {
+        (void)SchmonPreemptTimerSet(preempt->timerId, 0);
+        atomic_store(&preempt->timerArmed, false);
+    }
+    SchmonPreemptTimerUnlock(preempt);
+#else
+    (void)processor;
+#endif
+}
+
+/* Interrupt the backoff wait of schmon. */
+void SchmonKick(void)
+{
+#ifdef MRT_LINUX
+    struct Schmon *schmon = &g_scheduleManager.schmon;
+
+    if (schmon->kickFd >= 0) {
+        atomic_store(&schmon->backoff, false);
+        (void)eventfd_write(schmon->kickFd, 1);
+    }
+#endif
+}
+
+void SchmonKickFini(void)
+{
+#ifdef MRT_LINUX
+    struct Schmon *schmon = &g_scheduleManager.schmon;
+    int kickFd = schmon->kickFd;
+
+    if (kickFd >= 0) {
+        // Closing the fd also removes it from netpoll.
+        schmon->kickFd = -1;
+        close(kickFd);
+    }
+    if (schmon->kickPd != nullptr) {
+        free(schmon->kickPd);
+        schmon->kickPd = nullptr;
+    }
+#endif
+}
+
+// Check processor whether has ready cjthread.
+bool FastSchmonProcessorPreemptCheck(struct Processor *processor)
+{
+    ProcessorState state = atomic_load_explicit(&processor->state, std::memory_order_relaxed);
+    if (state == PROCESSOR_IDLE || state == PROCESSOR_OFFLINE) {
+        return false;
+    }
+    return ProcessorHasReady(processor);
 }
 
 /* Check whether a processor requires preemption. */
@@ -103,7 +352,8 @@ void SchmonProcessorPreemptCheck(struct Processor *processor, unsigned long long
     unsigned long schedcnt;
     int state;
 
-    if (atomic_load_explicit(&processor->state, std::memory_order_relaxed) == PROCESSOR_IDLE) {
+    state = atomic_load_explicit(&processor->state, std::memory_order_relaxed);
+    if (state == PROCESSOR_IDLE || state == PROCESSOR_OFFLINE) {
         return;
     }
 
@@ -116,7 +366,9 @@ void SchmonProcessorPreemptCheck(struct Processor *processor, unsigned long long
             state = atomic_load(&processor->state);
             if (state == PROCESSOR_SYSCALL && ScheduleGet()->scheduleType == SCHEDULE_DEFAULT) {
                 SchmonPreemptSyscall(processor);
-            } else if (state == PROCESSOR_RUNNING) {
+            } else if (state == PROCESSOR_RUNNING &&
+                       !atomic_load_explicit(&processor->preempt.timerArmed, std::memory_order_relaxed)) {
+                // A processor with an armed time-slice timer preempts itself.
                 SchmonPreemptRunning(processor);
             }
         }
@@ -186,6 +438,23 @@ void SchmonCheckAllprocessors(unsigned long long now)
     }
 }
 
+/* Follow the cgroup cpu quota with the active processors of the default scheduler. */
+void SchmonCpuQuotaCheck(unsigned long long now)
+{
+    struct ScheduleCpuQuota *quota = &g_scheduleManager.cpuQuota;
+    struct Schedule *schedule = g_scheduleManager.defaultSchedule;
+    unsigned int num;
+
+    if (!quota->enable || schedule == nullptr || quota->lastCheck + CPU_QUOTA_CHECK_TIME > now) {
+        return;
+    }
+    quota->lastCheck = now;
+    num = CpuQuotaProcessorNum(quota, schedule->schdProcessor.processorNum);
+    if (num != atomic_load(&schedule->schdProcessor.activeNum)) {
+        (void)ScheduleProcessorNumSet(num);
+    }
+}
+
 void SchmonRemovelistClear(struct Dulink *removeList)
 {
     struct CJThread *waitRemoveCJThread;
@@ -230,10 +499,20 @@ void SchmonCJThreadPoolClean(unsigned long long now)
         schdCJThreadNum = schedule->schdCJThread.num;
 
         // If the number of cjthreads in the global free list is greater than twice the
-        // number of cjthreads to be run, clear the global resource pool.
-        if (gfreelist->freeCJThreadNum && gfreelist->freeCJThreadNum >= schdCJThreadNum * multiple) {
-            DulinkMove(&removeList, &(gfreelist->gfreeList), -schdCJThreadNum);
-            gfreelist->freeCJThreadNum = schdCJThreadNum;
+        // number of cjthreads to be run, clear the global resource pool. The cjthreads whose
+        // stacks are reclaimed are the coldest, so they are cleared first.
+        length = gfreelist->freeCJThreadNum + gfreelist->cleanCJThreadNum;
+        if (length && length >= schdCJThreadNum * multiple) {
+            length = gfreelist->freeCJThreadNum >= schdCJThreadNum ? 0 :
+                schdCJThreadNum - gfreelist->freeCJThreadNum;
+            if (gfreelist->cleanCJThreadNum > length) {
+                DulinkMove(&removeList, &(gfreelist->cleanList), -static_cast<int>(length));
+                gfreelist->cleanCJThreadNum = static_cast<unsigned int>(length);
+            }
+            if (gfreelist->freeCJThreadNum > schdCJThreadNum) {
+                DulinkMove(&removeList, &(gfreelist->gfreeList), -schdCJThreadNum);
+                gfreelist->freeCJThreadNum = schdCJThreadNum;
+            }
         }
         pthread_mutex_unlock(&gfreelist->gfreeLock);
 
@@ -243,7 +522,7 @@ void SchmonCJThreadPoolClean(unsigned long long now)
         for (i = 0; i < schdProcessor->processorNum; i++) {
             processor = &(schdProcessor->processorGroup[i]);
             PthreadSpinLock(&processor->lock);
-            length = QueueLength(&processor->runq);
+            length = ProcessorRunqLength(processor);
             if (processor->freelist.cjthreadNum && processor->freelist.cjthreadNum >= length * multiple) {
                 DulinkMove(&removeList, &processor->freelist.freeList, -length);
                 processor->freelist.cjthreadNum = length;
@@ -259,6 +538,128 @@ void SchmonCJThreadPoolClean(unsigned long long now)
 #endif
 }
 
+#ifdef MRT_LINUX
+/* Drain the kick eventfd when it is reported by netpoll. */
+static int SchmonKickCallback(struct epoll_event *event, void *arg)
+{
+    eventfd_t value;
+
+    (void)event;
+    (void)eventfd_read(static_cast<int>(reinterpret_cast<intptr_t>(arg)), &value);
+    return 0;
+}
+
+/* Once netpoll exists, schmon waits in SchdpollAcquire, which must report the kick fd. */
+static bool SchmonKickRegister(struct Schedule *schedule)
+{
+    static bool registerFailed = false;
+    struct Schmon *schmon = &g_scheduleManager.schmon;
+
+    if (schedule->netpoll.npfd == nullptr || schmon->kickPd != nullptr) {
+        return true;
+    }
+    if (registerFailed) {
+        return false;
+    }
+    schmon->kickPd = SchdpollCallbackAdd(schmon->kickFd, EPOLLIN, reinterpret_cast<void *>(SchmonKickCallback),
+                                         reinterpret_cast<void *>(static_cast<intptr_t>(schmon->kickFd)),
+                                         SCHDPOLL_CALLBACK_EVENT);
+    registerFailed = schmon->kickPd == nullptr;
+    return !registerFailed;
+}
+
+/* Whether the default scheduler is the only one and none of its processors has work. */
+static bool SchmonAllProcessorsIdle(struct Schedule *schedule)
+{
+    struct Dulink *scheduleNode;
+    unsigned int scheduleNum = 0;
+    unsigned int i;
+    ProcessorState state;
+
+    // Other schedulers rely on the 10ms cycle to poll their network events.
+    DULINK_FOR_EACH_ITEM(scheduleNode, &g_scheduleManager.allScheduleList) {
+        scheduleNum++;
+    }
+    if (scheduleNum != 1) {
+        return false;
+    }
+    for (i = 0; i < schedule->schdProcessor.processorNum; i++) {
+        state = atomic_load(&schedule->schdProcessor.processorGroup[i].state);
+        if (state != PROCESSOR_IDLE && state != PROCESSOR_OFFLINE) {
+            return false;
+        }
+    }
+    return !ScheduleAnyCJThread(schedule);
+}
+
+/* Length of the next schmon cycle, in us. While all processors are idle there is nothing to
+ * preempt, so the cycle doubles up to SCHMON_IDLE_MAX_DELAY, bounded by the earliest timer. A
+ * processor allocation ends the backoff through SchmonKick. The cycle stays fixed unless the
+ * backoff is enabled, see ScheduleAttrSchmonBackoffSet. Called with allScheduleListLock held. */
+static unsigned int SchmonCycleDelay(struct Schedule *schedule)
+{
+    static unsigned int idleDelay = CYCLE_TIME;
+    struct Schmon *schmon = &g_scheduleManager.schmon;
+    unsigned long long deadline = 0;
+    unsigned long long processorDeadline;
+    unsigned long long now;
+    unsigned int delay;
+    unsigned int i;
+
+    // Without the kick, a backoff would delay the preemption of newly running processors.
+    if (schmon->kickFd < 0 || !SchmonKickRegister(schedule)) {
+        return CYCLE_TIME;
+    }
+    // Publish the backoff before checking the processors. A processor allocated after the check
+    // observes it and kicks schmon.
+    atomic_store(&schmon->backoff, true);
+    if (!SchmonAllProcessorsIdle(schedule)) {
+        atomic_store(&schmon->backoff, false);
+        idleDelay = CYCLE_TIME;
+        return CYCLE_TIME;
+    }
+    idleDelay = idleDelay * 2 > SCHMON_IDLE_MAX_DELAY ? SCHMON_IDLE_MAX_DELAY : idleDelay * 2;
+    delay = idleDelay;
+    if (schmon->deadlineFunc != nullptr) {
+        for (i = 0; i < schedule->schdProcessor.processorNum; i++) {
+            processorDeadline = schmon->deadlineFunc(&schedule->schdProcessor.processorGroup[i]);
+            if (processorDeadline != 0 && (deadline == 0 || processorDeadline < deadline)) {
+                deadline = processorDeadline;
+            }
+        }
+    }
+    if (deadline != 0) {
+        const unsigned long long nsPerUs = 1000;
+        now = CurrentNanotimeGet();
+        now = deadline > now ? (deadline - now) / nsPerUs : 0;
+        if (now < delay) {
+            delay = now < SCHMON_IDLE_MIN_DELAY ? SCHMON_IDLE_MIN_DELAY : static_cast<unsigned int>(now);
+        }
+    }
+    return delay;
+}
+
+/* Sleep for delay us unless schmon is kicked. */
+static void SchmonIdleWait(unsigned int delay)
+{
+    struct Schmon *schmon = &g_scheduleManager.schmon;
+    struct pollfd pfd;
+    eventfd_t value;
+    const unsigned int usPerMs = 1000;
+
+    if (schmon->kickFd < 0) {
+        usleep(delay);
+        return;
+    }
+    pfd.fd = schmon->kickFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, static_cast<int>(delay / usPerMs)) > 0) {
+        (void)eventfd_read(schmon->kickFd, &value);
+    }
+}
+#endif
+
 void SchmonCycle(void)
 {
     int num;
@@ -278,6 +679,9 @@ void SchmonCycle(void)
         // do not set a timeout when executing SchdpollAcquire, otherwise it will affect the
         // network task performance of the default scheduler.
         if (schedule->scheduleType == SCHEDULE_DEFAULT) {
+#ifdef MRT_LINUX
+            delay = SchmonCycleDelay(schedule);
+#endif
             pthread_mutex_unlock(&g_scheduleManager.allScheduleListLock);
         }
 #ifdef MRT_WINDOWS
@@ -291,15 +695,20 @@ void SchmonCycle(void)
             }
         }
 #else
-        /* Waiting time of schmon waits for a network event is 10ms */
-        const int NETPOLL_WAIT_TIME = 10;
+        /* Waiting time of schmon waits for a network event is 10ms, or the backoff delay when
+         * all processors are idle. */
+        const int usPerMs = 1000;
         if (schedule->netpoll.npfd != nullptr && schedule->scheduleType == SCHEDULE_DEFAULT) {
-            num = SchdpollAcquire(schedule, buf, SCHDPOLL_ACQUIRE_MAX_NUM, NETPOLL_WAIT_TIME);
+            num = SchdpollAcquire(schedule, buf, SCHDPOLL_ACQUIRE_MAX_NUM, static_cast<int>(delay / usPerMs));
             if (num > 0) {
                 CJThreadAddBatch(buf, num);
             }
         } else if (schedule->netpoll.npfd == nullptr && schedule->scheduleType == SCHEDULE_DEFAULT) {
+#ifdef MRT_LINUX
+            SchmonIdleWait(delay);
+#else
             usleep(delay);
+#endif
         } else if (schedule->netpoll.npfd != nullptr && schedule->scheduleType != SCHEDULE_DEFAULT) {
             num = SchdpollAcquire(schedule, buf, SCHDPOLL_ACQUIRE_MAX_NUM, 0);
             if (num > 0) {
@@ -314,8 +723,10 @@ void SchmonCycle(void)
     now = CurrentNanotimeGet();
     // Timer check.
     SchmonCheckAllprocessors(now);
+    SchmonCpuQuotaCheck(now);
     SchmonCJThreadPoolClean(now);
     pthread_mutex_unlock(&g_scheduleManager.allScheduleListLock);
+    StackReclaimCheck(&g_scheduleManager.stackReclaim, now);
 }
 
 /* Schedule monitor thread entry function */
@@ -361,6 +772,17 @@ int SchmonStart(ScheduleHandle handle)
     }
     pthread_attr_setdetachstate(&pthreadAttr, PTHREAD_CREATE_JOINABLE);
 
+#ifdef MRT_LINUX
+    // Without the kick fd, schmon keeps the fixed cycle, see SchmonCycleDelay.
+    if (g_scheduleManager.schmon.backoffEnable) {
+        g_scheduleManager.schmon.kickFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    g_scheduleManager.schmon.kickPd = nullptr;
+    if (g_scheduleManager.schmon.preemptSlice != 0) {
+        SchmonPreemptSignalInit();
+    }
+#endif
+
     error = pthread_create(&g_scheduleManager.schmon.schmonId, &pthreadAttr, SchmonEntry, schedule);
     if (error != 0) {
         LOG_ERROR(ERRNO_SCHD_THREAD_CREATE_FAILED, "pthread_create failed");
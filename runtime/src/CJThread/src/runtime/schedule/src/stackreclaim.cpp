@@ -0,0 +1,284 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include <cerrno>
+#include <climits>
+#include "schedule_impl.h"
+#include "stackreclaim.h"
+#include "log.h"
+
+#if defined (__linux__) || defined(__OHOS__) || defined(__ANDROID__)
+#include <sys/mman.h>
+#define STACK_RECLAIM_SUPPORTED
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pages looked up by one mincore call */
+const size_t STACK_RESIDENT_VEC_LEN = 256;
+
+void StackReclaimInit(struct ScheduleStackReclaim *reclaim, int mode, size_t keepSize)
+{
+    size_t pageSize = SchedulePageSize();
+
+#ifndef STACK_RECLAIM_SUPPORTED
+    mode = SCHEDULE_STACK_RECLAIM_OFF;
+#endif
+    atomic_store_explicit(&reclaim->mode, mode, std::memory_order_relaxed);
+    reclaim->keepSize = (keepSize + pageSize - 1) & ~(pageSize - 1);
+    atomic_store_explicit(&reclaim->epoch, 0u, std::memory_order_relaxed);
+    reclaim->lastCheck = 0;
+    atomic_store_explicit(&reclaim->pooledCnt, 0ull, std::memory_order_relaxed);
+    atomic_store_explicit(&reclaim->parkedCnt, 0ull, std::memory_order_relaxed);
+    atomic_store_explicit(&reclaim->releasedBytes, 0ull, std::memory_order_relaxed);
+}
+
+/* Release the pages within [start, end). Returns the bytes released. */
+static size_t StackReclaimRange(struct ScheduleStackReclaim *reclaim, uintptr_t start, uintptr_t end)
+{
+#ifdef STACK_RECLAIM_SUPPORTED
+    size_t pageSize = SchedulePageSize();
+
+    start = (start + pageSize - 1) & ~(pageSize - 1);
+    end &= ~(pageSize - 1);
+    if (end <= start) {
+        return 0;
+    }
+#ifdef MADV_FREE
+    if (atomic_load_explicit(&reclaim->mode, std::memory_order_relaxed) == SCHEDULE_STACK_RECLAIM_FREE) {
+        if (madvise(reinterpret_cast<void *>(start), end - start, MADV_FREE) == 0) {
+            return end - start;
+        }
+        // Kernels before 4.5 do not know MADV_FREE.
+        if (errno != EINVAL) {
+            return 0;
+        }
+        LOG_ERROR(errno, "MADV_FREE is not supported, stacks are reclaimed with MADV_DONTNEED");
+        atomic_store_explicit(&reclaim->mode, static_cast<int>(SCHEDULE_STACK_RECLAIM_DONTNEED),
+                              std::memory_order_relaxed);
+    }
+#endif
+    if (madvise(reinterpret_cast<void *>(start), end - start, MADV_DONTNEED) != 0) {
+        return 0;
+    }
+    return end - start;
+#else
+    (void)reclaim;
+    (void)start;
+    (void)end;
+    return 0;
+#endif
+}
+
+/* Release the pages of the stacks in the global free list of a scheduler, except keepSize bytes
+ * at their base. The stacks are taken out of the list while their pages are released, and are
+ * put in the clean list, which is used after the free list. */
+static void StackReclaimPooled(struct ScheduleStackReclaim *reclaim, struct Schedule *schedule)
+{
+    struct ScheduleGfreeList *gfreelist = &schedule->schdCJThread.gfreelist;
+    struct CJThread *batch[STACK_RECLAIM_BATCH];
+    struct CJThread *cjthread;
+    unsigned int remain;
+    unsigned int num;
+    unsigned int i;
+    size_t released;
+
+    pthread_mutex_lock(&gfreelist->gfreeLock);
+    remain = gfreelist->freeCJThreadNum;
+    pthread_mutex_unlock(&gfreelist->gfreeLock);
+    while (remain != 0) {
+        num = 0;
+        pthread_mutex_lock(&gfreelist->gfreeLock);
+        // The tail of the free list holds the cjthreads pooled the longest.
+        while (num < STACK_RECLAIM_BATCH && num < remain && gfreelist->freeCJThreadNum != 0) {
+            cjthread = DULINK_ENTRY(gfreelist->gfreeList.prev, struct CJThread, schdDulink);
+            DulinkRemove(&(cjthread->schdDulink));
+            gfreelist->freeCJThreadNum--;
+            batch[num++] = cjthread;
+        }
+        pthread_mutex_unlock(&gfreelist->gfreeLock);
+        if (num == 0) {
+            return;
+        }
+        remain -= num;
+
+        for (i = 0; i < num; i++) {
+            cjthread = batch[i];
+            if (cjthread->stack.stackTopAddr == nullptr) {
+                continue;
+            }
+            released = StackReclaimRange(reclaim, reinterpret_cast<uintptr_t>(cjthread->stack.stackTopAddr),
+                                         reinterpret_cast<uintptr_t>(cjthread->stack.stackBaseAddr) -
+                                         reclaim->keepSize);
+            if (released != 0) {
+                atomic_fetch_add_explicit(&reclaim->pooledCnt, 1ull, std::memory_order_relaxed);
+                atomic_fetch_add_explicit(&reclaim->releasedBytes, static_cast<unsigned long long>(released),
+                                          std::memory_order_relaxed);
+            }
+        }
+
+        pthread_mutex_lock(&gfreelist->gfreeLock);
+        for (i = 0; i < num; i++) {
+            DulinkAdd(&(batch[i]->schdDulink), &(gfreelist->cleanList));
+        }
+        gfreelist->cleanCJThreadNum += num;
+        pthread_mutex_unlock(&gfreelist->gfreeLock);
+    }
+}
+
+/* Pages of a parked stack that can be released: those below its SP, less a page for the red zone,
+ * and outside the keepSize bytes at its base. Returns the end of the range, 0 if it is too small. */
+static uintptr_t StackReclaimParkedEnd(struct ScheduleStackReclaim *reclaim, struct CJThread *cjthread)
+{
+    uintptr_t top = reinterpret_cast<uintptr_t>(cjthread->stack.stackTopAddr);
+    uintptr_t base = reinterpret_cast<uintptr_t>(cjthread->stack.stackBaseAddr);
+    uintptr_t sp = static_cast<uintptr_t>(cjthread->context.GetSP());
+    uintptr_t end;
+
+    // A cjthread that parked on another stack, such as a foreign thread, is skipped.
+    if (sp <= top || sp > base) {
+        return 0;
+    }
+    end = sp - SchedulePageSize();
+    if (end > base - reclaim->keepSize) {
+        end = base - reclaim->keepSize;
+    }
+    if (end <= top || end - top < STACK_RECLAIM_PARKED_MIN) {
+        return 0;
+    }
+    return end;
+}
+
+/* Let the cjthread run again, and wake the waiter if it sleeps in StackReclaimWait. */
+static void StackReclaimDone(struct CJThread *cjthread)
+{
+    if (atomic_exchange(&cjthread->stackReclaiming, STACK_RECLAIM_IDLE) == STACK_RECLAIM_WAITED) {
+#ifdef MRT_LINUX
+        (void)SemaphoreFutex(&cjthread->stackReclaiming, FUTEX_WAKE_PRIVATE, INT_MAX);
+#endif
+    }
+}
+
+/* Collect up to a batch of the cjthreads of the default scheduler parked for
+ * STACK_RECLAIM_PARK_EPOCHS checks. A cjthread is taken by setting its stackReclaiming and
+ * then seeing it still pending. Its waker changes the state first and then waits for the flag
+ * to be cleared, see StackReclaimWait, so the cjthread cannot run until its pages are released. */
+static unsigned int StackReclaimParkedCollect(struct ScheduleStackReclaim *reclaim, unsigned int epoch,
+                                              struct CJThread **batch)
+{
+    struct Dulink *node;
+    struct CJThread *cjthread;
+    unsigned int num = 0;
+
+    pthread_mutex_lock(&g_scheduleManager.allCJThreadListLock);
+    DULINK_FOR_EACH_ITEM(node, &g_scheduleManager.allCJThreadList) {
+        cjthread = DULINK_ENTRY(node, struct CJThread, allCJThreadDulink);
+        if (cjthread->schedule == nullptr || cjthread->schedule->scheduleType != SCHEDULE_DEFAULT ||
+            cjthread->stack.stackTopAddr == nullptr || cjthread->parkEpoch == STACK_RECLAIM_EPOCH_DONE ||
+            epoch - cjthread->parkEpoch < STACK_RECLAIM_PARK_EPOCHS ||
+            atomic_load_explicit(&cjthread->state, std::memory_order_relaxed) != CJTHREAD_PENDING ||
+            StackReclaimParkedEnd(reclaim, cjthread) == 0) {
+            continue;
+        }
+        atomic_store(&cjthread->stackReclaiming, STACK_RECLAIM_BUSY);
+        if (atomic_load(&cjthread->state) != CJTHREAD_PENDING) {
+            StackReclaimDone(cjthread);
+            continue;
+        }
+        // The stack is shrunk once per park.
+        cjthread->parkEpoch = STACK_RECLAIM_EPOCH_DONE;
+        batch[num++] = cjthread;
+        if (num == STACK_RECLAIM_BATCH) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_scheduleManager.allCJThreadListLock);
+    return num;
+}
+
+/* Release the pages below the SP of the cjthreads parked for STACK_RECLAIM_PARK_EPOCHS checks. The
+ * pages above it, with the frames and anything the cjthread put on its stack before it parked, are
+ * kept. */
+static void StackReclaimParked(struct ScheduleStackReclaim *reclaim, unsigned int epoch)
+{
+    struct CJThread *batch[STACK_RECLAIM_BATCH];
+    struct CJThread *cjthread;
+    unsigned int round;
+    unsigned int num;
+    unsigned int i;
+    size_t released;
+
+    for (round = 0; round < STACK_RECLAIM_PARKED_ROUNDS; round++) {
+        num = StackReclaimParkedCollect(reclaim, epoch, batch);
+        for (i = 0; i < num; i++) {
+            cjthread = batch[i];
+            released = StackReclaimRange(reclaim, reinterpret_cast<uintptr_t>(cjthread->stack.stackTopAddr),
+                                         StackReclaimParkedEnd(reclaim, cjthread));
+            StackReclaimDone(cjthread);
+            if (released != 0) {
+                atomic_fetch_add_explicit(&reclaim->parkedCnt, 1ull, std::memory_order_relaxed);
+                atomic_fetch_add_explicit(&reclaim->releasedBytes, static_cast<unsigned long long>(released),
+                                          std::memory_order_relaxed);
+            }
+        }
+        if (num < STACK_RECLAIM_BATCH) {
+            break;
+        }
+    }
+}
+
+void StackReclaimCheck(struct ScheduleStackReclaim *reclaim, unsigned long long now)
+{
+    unsigned int epoch;
+
+    if (atomic_load_explicit(&reclaim->mode, std::memory_order_relaxed) == SCHEDULE_STACK_RECLAIM_OFF ||
+        reclaim->lastCheck + STACK_RECLAIM_CHECK_TIME > now) {
+        return;
+    }
+    reclaim->lastCheck = now;
+    epoch = atomic_fetch_add_explicit(&reclaim->epoch, 1u, std::memory_order_relaxed) + 1;
+
+    // The default scheduler lives as long as schmon, the others may be deleted while their stacks
+    // are released.
+    StackReclaimPooled(reclaim, g_scheduleManager.defaultSchedule);
+    StackReclaimParked(reclaim, epoch);
+}
+
+size_t StackResidentSize(const char *addr, size_t size)
+{
+#ifdef STACK_RECLAIM_SUPPORTED
+    unsigned char vec[STACK_RESIDENT_VEC_LEN];
+    size_t pageSize = SchedulePageSize();
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~(pageSize - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(addr) + size;
+    size_t pages;
+    size_t resident = 0;
+    size_t i;
+
+    while (start < end) {
+        pages = (end - start + pageSize - 1) / pageSize;
+        pages = pages > STACK_RESIDENT_VEC_LEN ? STACK_RESIDENT_VEC_LEN : pages;
+        if (mincore(reinterpret_cast<void *>(start), pages * pageSize, vec) != 0) {
+            return size;
+        }
+        for (i = 0; i < pages; i++) {
+            resident += (vec[i] & 1) != 0 ? pageSize : 0;
+        }
+        start += pages * pageSize;
+    }
+    return resident > size ? size : resident;
+#else
+    (void)addr;
+    return size;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,7 +7,12 @@
 
 #include <sched.h>
 #include <unistd.h>
+#ifdef MRT_LINUX
+#include <cerrno>
+#include <csignal>
+#endif
 #include "schedule_impl.h"
+#include "basetime.h"
 #include "log.h"
 #if defined(CANGJIE_ASAN_SUPPORT)
 #include "Sanitizer/SanitizerInterface.h"
@@ -52,6 +57,68 @@ int ThreadSleep(struct Thread *thread)
     return 0;
 }
 
+#ifdef MRT_LINUX
+// A sleep longer than parkSpinMax * THREAD_PARK_SPIN_IDLE_FACTOR clears the spin budget.
+const unsigned long long THREAD_PARK_SPIN_IDLE_FACTOR = 4;
+
+/* Learn the spin budget of idle threads from the latest idle period, as fds learn their busy-poll
+ * budget. The budget is shared by the idle threads, a lost update only delays the learning.
+ */
+static void ThreadParkSpinLearn(struct ScheduleThread *schdThread, unsigned long long idleNs, bool spinHit)
+{
+    unsigned long long budget = atomic_load_explicit(&schdThread->parkSpinBudget, std::memory_order_relaxed);
+    unsigned long long spinMax = schdThread->parkSpinMax;
+    unsigned long long next;
+
+    if (spinHit) {
+        next = budget + (budget >> 1);
+    } else if (idleNs <= spinMax) {
+        next = idleNs + (idleNs >> 1);
+    } else if (idleNs <= spinMax * THREAD_PARK_SPIN_IDLE_FACTOR) {
+        next = budget >> 1;
+    } else {
+        next = 0;
+    }
+    atomic_store_explicit(&schdThread->parkSpinBudget, next > spinMax ? spinMax : next,
+                          std::memory_order_relaxed);
+}
+
+/* Spin on the wake word of the thread within the learned budget. Returns true if the thread was
+ * woken meanwhile, then ThreadSleep takes the token without sleeping. Spinning is skipped while
+ * enough threads are spinning or searching for work already.
+ */
+static bool ThreadParkSpin(struct Schedule *schedule, struct Thread *thread, unsigned long long start)
+{
+    struct ScheduleThread *schdThread = &schedule->schdThread;
+    unsigned long long budget = atomic_load_explicit(&schdThread->parkSpinBudget, std::memory_order_relaxed);
+    unsigned long long now = start;
+    bool spinHit = false;
+
+    if (budget == 0) {
+        return false;
+    }
+    if (atomic_fetch_add(&schdThread->parkSpinNum, 1u) +
+        atomic_load_explicit(&schdThread->searchingNum, std::memory_order_relaxed) >= ProcessorSpinCap(schedule)) {
+        atomic_fetch_sub(&schdThread->parkSpinNum, 1u);
+        atomic_fetch_add_explicit(&schdThread->parkSpinSkipCnt, 1ULL, std::memory_order_relaxed);
+        return false;
+    }
+    while (now < start + budget) {
+        if (SemaphorePosted(&(thread->sem))) {
+            spinHit = true;
+            break;
+        }
+        now = CurrentNanotimeGet();
+    }
+    atomic_fetch_sub(&schdThread->parkSpinNum, 1u);
+    atomic_fetch_add_explicit(&schdThread->parkSpinNs, CurrentNanotimeGet() - start, std::memory_order_relaxed);
+    if (spinHit) {
+        atomic_fetch_add_explicit(&schdThread->parkSpinHitCnt, 1ULL, std::memory_order_relaxed);
+    }
+    return spinHit;
+}
+#endif
+
 /* Pointer to the preemption bit of the current thread structure. */
 void ThreadPreemptFlagInit(void)
 {
@@ -61,6 +128,44 @@ void ThreadPreemptFlagInit(void)
     thread->preemptRequest = PreemptRequestAddr();
 }
 
+#ifdef MRT_LINUX
+/* Signal handlers registered with SA_ONSTACK, such as the time-slice timer and profiling
+ * handlers, run on this stack instead of the small stack of the interrupted cjthread. */
+static void ThreadSigStackInit(struct Thread *thread)
+{
+    const size_t stackSizeMultiples = 4;
+    stack_t signalStack;
+
+    thread->sigStack = malloc(SIGSTKSZ * stackSizeMultiples);
+    if (thread->sigStack == nullptr) {
+        LOG_ERROR(ERRNO_SCHD_MALLOC_FAILED, "signal stack alloc failed");
+        return;
+    }
+    signalStack.ss_sp = thread->sigStack;
+    signalStack.ss_size = SIGSTKSZ * stackSizeMultiples;
+    signalStack.ss_flags = 0;
+    if (sigaltstack(&signalStack, nullptr) != 0) {
+        LOG_ERROR(ERRNO_SCHD_INIT_FAILED, "sigaltstack failed, errno: %d", errno);
+        free(thread->sigStack);
+        thread->sigStack = nullptr;
+    }
+}
+
+static void ThreadSigStackFini(struct Thread *thread)
+{
+    stack_t signalStack;
+
+    if (thread->sigStack == nullptr) {
+        return;
+    }
+    (void)memset_s(&signalStack, sizeof(signalStack), 0, sizeof(signalStack));
+    signalStack.ss_flags = SS_DISABLE;
+    (void)sigaltstack(&signalStack, nullptr);
+    free(thread->sigStack);
+    thread->sigStack = nullptr;
+}
+#endif
+
 void *ThreadEntry(void *arg)
 {
     struct Thread *thread;
@@ -99,6 +204,9 @@ void *ThreadEntry(void *arg)
     cjthread0->thread = thread;
 
     thread->tid = GetSystemThreadId();
+#ifdef MRT_LINUX
+    ThreadSigStackInit(thread);
+#endif
 
     // Initialize the thread and set the cjthread running context.
     CJThreadSet(cjthread0);
@@ -120,6 +228,9 @@ void *ThreadEntry(void *arg)
     // A thread may enter the exit process without any scheduling.
     // In this case, need to unbind the thread and exit.
     ProcessorRelease();
+#ifdef MRT_LINUX
+    ThreadSigStackFini(thread);
+#endif
 
     return nullptr;
 }
@@ -281,6 +392,8 @@ int ThreadStop(ScheduleHandle handle)
     struct Thread *thread;
     struct ScheduleThread *schdThread;
     struct Schedule *schedule = (struct Schedule *)handle;
+    unsigned long long start = 0;
+    bool spinHit = false;
     int error;
 
     // When a thread stops, it cannot be bound to a processor.
@@ -301,12 +414,28 @@ int ThreadStop(ScheduleHandle handle)
     schdThread->freeNum++;
     pthread_mutex_unlock(&(schdThread->mutex));
 
+#ifdef MRT_LINUX
+    // The thread is the first one to be woken, spin for a while before sleeping.
+    if (schdThread->parkSpinMax != 0) {
+        start = CurrentNanotimeGet();
+        spinHit = ThreadParkSpin(schedule, thread, start);
+    }
+#endif
+    if (!spinHit) {
+        atomic_fetch_add_explicit(&schdThread->parkCnt, 1ULL, std::memory_order_relaxed);
+    }
+
     // sleep thread
     error = ThreadSleep(thread);
     if (error != 0) {
         LOG_ERROR(error, "ThreadSleep failed");
         return error;
     }
+#ifdef MRT_LINUX
+    if (schdThread->parkSpinMax != 0) {
+        ThreadParkSpinLearn(schdThread, CurrentNanotimeGet() - start, spinHit);
+    }
+#endif
 
     return 0;
 }
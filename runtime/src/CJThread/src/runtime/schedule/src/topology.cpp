@@ -0,0 +1,358 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include <cstdio>
+#include <cstdlib>
+#include "schedule_impl.h"
+#include "topology.h"
+#include "securec.h"
+#include "log.h"
+
+#ifdef MRT_LINUX
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sched.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef MRT_LINUX
+/* Root of the CPU topology in sysfs */
+#define TOPOLOGY_SYSFS_CPU "/sys/devices/system/cpu"
+
+/* Root of the NUMA topology in sysfs, absent on kernels without NUMA */
+#define TOPOLOGY_SYSFS_NODE "/sys/devices/system/node"
+
+/* Length of the sysfs paths and file contents read here */
+const int TOPOLOGY_BUF_LEN = 128;
+
+/* Length of a CPU list read from sysfs, such as "0-63,128-191" */
+const int TOPOLOGY_LIST_LEN = 4096;
+
+/* Number of cache indexes scanned for the last level cache */
+const int TOPOLOGY_CACHE_INDEX_NUM = 8;
+
+/**
+ * @brief Sort key of a CPU in the pinning order
+ */
+struct TopologyPinKey {
+    int smtRank;                    /* rank of the CPU among the allowed CPUs of its core */
+    int node;
+    int cache;
+    int core;
+    int cpu;
+};
+
+/* Read the leading integer of a sysfs file, such as the first CPU of a CPU list. */
+static int TopologyReadInt(const char *path)
+{
+    char buf[TOPOLOGY_BUF_LEN];
+    ssize_t len;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0 || buf[0] < '0' || buf[0] > '9') {
+        return -1;
+    }
+    buf[len] = '\0';
+    return static_cast<int>(strtol(buf, nullptr, 10)); // 10: decimal
+}
+
+/* The last level cache is the cache index with the highest level. */
+static int TopologyCacheRead(int cpu)
+{
+    char path[TOPOLOGY_BUF_LEN];
+    int index;
+    int level;
+    int bestLevel = 0;
+    int cache = -1;
+
+    for (index = 0; index < TOPOLOGY_CACHE_INDEX_NUM; index++) {
+        if (snprintf_s(path, sizeof(path), sizeof(path) - 1, TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/level",
+                       cpu, index) < 0) {
+            break;
+        }
+        level = TopologyReadInt(path);
+        if (level < 0) {
+            break;
+        }
+        if (level <= bestLevel) {
+            continue;
+        }
+        if (snprintf_s(path, sizeof(path), sizeof(path) - 1,
+                       TOPOLOGY_SYSFS_CPU "/cpu%d/cache/index%d/shared_cpu_list", cpu, index) < 0) {
+            break;
+        }
+        bestLevel = level;
+        cache = TopologyReadInt(path);
+    }
+    return cache;
+}
+
+/* Assign a NUMA node to the CPUs of its cpulist, a list of ranges such as "0-3,8-11". */
+static void TopologyNodeCpusRead(struct ScheduleTopology *topology, int node)
+{
+    char path[TOPOLOGY_BUF_LEN];
+    char buf[TOPOLOGY_LIST_LEN];
+    char *pos;
+    char *end;
+    ssize_t len;
+    long first;
+    long last;
+    int fd;
+
+    if (snprintf_s(path, sizeof(path), sizeof(path) - 1, TOPOLOGY_SYSFS_NODE "/node%d/cpulist", node) < 0) {
+        return;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) {
+        return;
+    }
+    buf[len] = '\0';
+    pos = buf;
+    while (*pos >= '0' && *pos <= '9') {
+        first = strtol(pos, &end, 10); // 10: decimal
+        last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10); // 10: decimal
+        }
+        for (; first <= last && first < topology->cpuMax; first++) {
+            topology->cpus[first].node = node;
+        }
+        pos = *end == ',' ? end + 1 : end;
+    }
+}
+
+/* The NUMA nodes are the nodeN entries of the node directory, each read once. */
+static void TopologyNodesRead(struct ScheduleTopology *topology)
+{
+    struct dirent *entry;
+    DIR *dir;
+    const int prefixLen = 4; // 4: length of "node"
+
+    dir = opendir(TOPOLOGY_SYSFS_NODE);
+    if (dir == nullptr) {
+        return;
+    }
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strncmp(entry->d_name, "node", prefixLen) == 0 && entry->d_name[prefixLen] >= '0' &&
+            entry->d_name[prefixLen] <= '9') {
+            TopologyNodeCpusRead(topology,
+                                 static_cast<int>(strtol(entry->d_name + prefixLen, nullptr, 10))); // 10: decimal
+        }
+    }
+    closedir(dir);
+}
+
+static int TopologyPinKeyCompare(const void *left, const void *right)
+{
+    const struct TopologyPinKey *a = static_cast<const struct TopologyPinKey *>(left);
+    const struct TopologyPinKey *b = static_cast<const struct TopologyPinKey *>(right);
+
+    if (a->smtRank != b->smtRank) {
+        return a->smtRank - b->smtRank;
+    }
+    if (a->node != b->node) {
+        return a->node - b->node;
+    }
+    if (a->cache != b->cache) {
+        return a->cache - b->cache;
+    }
+    if (a->core != b->core) {
+        return a->core - b->core;
+    }
+    return a->cpu - b->cpu;
+}
+
+/* Processors take one CPU per core first, so that SMT siblings are used only when there are more
+ * processors than cores. Neighbouring processors share caches and nodes. */
+static int TopologyPinOrderInit(struct ScheduleTopology *topology, const cpu_set_t *allowed)
+{
+    struct TopologyPinKey *keys;
+    struct TopologyCpu *cpu;
+    unsigned int num = 0;
+    unsigned int i;
+    unsigned int j;
+
+    keys = static_cast<struct TopologyPinKey *>(malloc(sizeof(struct TopologyPinKey) * topology->cpuMax));
+    topology->pinOrder = static_cast<int *>(malloc(sizeof(int) * topology->cpuMax));
+    if (keys == nullptr || topology->pinOrder == nullptr) {
+        free(keys);
+        return ERRNO_SCHD_MALLOC_FAILED;
+    }
+    for (i = 0; i < static_cast<unsigned int>(topology->cpuMax); i++) {
+        if (!CPU_ISSET(i, allowed)) {
+            continue;
+        }
+        cpu = &topology->cpus[i];
+        keys[num].smtRank = 0;
+        for (j = 0; j < num; j++) {
+            if (cpu->core >= 0 && keys[j].core == cpu->core) {
+                keys[num].smtRank++;
+            }
+        }
+        keys[num].node = cpu->node;
+        keys[num].cache = cpu->cache;
+        keys[num].core = cpu->core;
+        keys[num].cpu = static_cast<int>(i);
+        num++;
+    }
+    qsort(keys, num, sizeof(struct TopologyPinKey), TopologyPinKeyCompare);
+    for (i = 0; i < num; i++) {
+        topology->pinOrder[i] = keys[i].cpu;
+    }
+    topology->pinNum = num;
+    free(keys);
+    return 0;
+}
+#endif
+
+int TopologyInit(struct ScheduleTopology *topology, bool pin)
+{
+#ifdef MRT_LINUX
+    char path[TOPOLOGY_BUF_LEN];
+    cpu_set_t allowed;
+    struct TopologyCpu *cpu;
+    int cpuMax;
+    int maxNode = -1;
+    int i;
+    bool numa;
+
+    (void)memset_s(topology, sizeof(struct ScheduleTopology), 0, sizeof(struct ScheduleTopology));
+    cpuMax = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+    CPU_ZERO(&allowed);
+    if (cpuMax <= 0 || sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return ERRNO_SCHD_TOPOLOGY_UNKNOWN;
+    }
+    if (cpuMax > CPU_SETSIZE) {
+        cpuMax = CPU_SETSIZE;
+    }
+    topology->cpus = static_cast<struct TopologyCpu *>(malloc(sizeof(struct TopologyCpu) * cpuMax));
+    if (topology->cpus == nullptr) {
+        return ERRNO_SCHD_MALLOC_FAILED;
+    }
+    topology->cpuMax = cpuMax;
+
+    topology->allowed = allowed;
+
+    // Without NUMA support in the kernel, all CPUs are on node 0.
+    numa = access(TOPOLOGY_SYSFS_NODE, F_OK) == 0;
+    for (i = 0; i < cpuMax; i++) {
+        topology->cpus[i].core = -1;
+        topology->cpus[i].cache = -1;
+        topology->cpus[i].node = numa ? -1 : 0;
+    }
+    if (numa) {
+        TopologyNodesRead(topology);
+    }
+    // Processors only run on the allowed CPUs, the others stay unknown.
+    for (i = 0; i < cpuMax; i++) {
+        if (!CPU_ISSET(i, &allowed)) {
+            continue;
+        }
+        cpu = &topology->cpus[i];
+        if (snprintf_s(path, sizeof(path), sizeof(path) - 1,
+                       TOPOLOGY_SYSFS_CPU "/cpu%d/topology/thread_siblings_list", i) >= 0) {
+            cpu->core = TopologyReadInt(path);
+        }
+        // SMT siblings share the caches of their core, which are read at its first CPU.
+        if (cpu->core >= 0 && cpu->core < i && CPU_ISSET(cpu->core, &allowed)) {
+            cpu->cache = topology->cpus[cpu->core].cache;
+        } else {
+            cpu->cache = TopologyCacheRead(i);
+        }
+    }
+    for (i = 0; i < cpuMax; i++) {
+        maxNode = topology->cpus[i].node > maxNode ? topology->cpus[i].node : maxNode;
+    }
+    topology->nodeNum = static_cast<unsigned int>(maxNode + 1);
+    if (pin && TopologyPinOrderInit(topology, &allowed) == 0 && topology->pinNum != 0) {
+        topology->pin = true;
+    }
+    topology->valid = true;
+    return 0;
+#else
+    (void)pin;
+    (void)memset_s(topology, sizeof(struct ScheduleTopology), 0, sizeof(struct ScheduleTopology));
+    return ERRNO_SCHD_TOPOLOGY_UNKNOWN;
+#endif
+}
+
+void TopologyFini(struct ScheduleTopology *topology)
+{
+    free(topology->cpus);
+    free(topology->pinOrder);
+    (void)memset_s(topology, sizeof(struct ScheduleTopology), 0, sizeof(struct ScheduleTopology));
+}
+
+int TopologyPinCpu(const struct ScheduleTopology *topology, unsigned int index)
+{
+    if (!topology->pin) {
+        return -1;
+    }
+    return topology->pinOrder[index % topology->pinNum];
+}
+
+int TopologyThreadPin(int cpu)
+{
+#ifdef MRT_LINUX
+    cpu_set_t set;
+
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return ERRNO_SCHD_ARG_INVALID;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        LOG_ERROR(ERRNO_SCHD_CORE_BIND_FAILED, "sched_setaffinity failed, cpu: %d, errno: %d", cpu, errno);
+        return ERRNO_SCHD_CORE_BIND_FAILED;
+    }
+    return 0;
+#else
+    (void)cpu;
+    return ERRNO_SCHD_CORE_BIND_FAILED;
+#endif
+}
+
+int TopologyThreadUnpin(const struct ScheduleTopology *topology)
+{
+#ifdef MRT_LINUX
+    if (sched_setaffinity(0, sizeof(topology->allowed), &topology->allowed) != 0) {
+        return ERRNO_SCHD_CORE_BIND_FAILED;
+    }
+    return 0;
+#else
+    (void)topology;
+    return ERRNO_SCHD_CORE_BIND_FAILED;
+#endif
+}
+
+int TopologyCurrentCpu(void)
+{
+#ifdef MRT_LINUX
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
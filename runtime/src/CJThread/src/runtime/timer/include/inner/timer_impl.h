@@ -109,6 +109,13 @@ int TimerExit(void *processor);
  **/
 int TimerSchmonCheck(void *pro, unsigned long long now);
 
+/**
+ * @brief Hook provided for the schmon module for bounding its cycle by the timers
+ * @param pro    [IN] Processor to be checked
+ * @retval Earliest timer deadline of the processor, or 0 if it has no timer.
+ **/
+unsigned long long TimerSchmonDeadline(void *pro);
+
 /**
  * @brief Check whether an executable timer exists in the processor and provide the timer to the non-default scheduler.
  * @param processor     [IN] Processor to be checked
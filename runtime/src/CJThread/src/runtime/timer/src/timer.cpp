@@ -936,6 +936,7 @@ TimerHandle TimerNew(unsigned long long dur, unsigned long long period, TimerFun
     error = SchdProcessorHookRegister(TimerTrigger, PROCESSOR_TIMER_HOOK);
     if (error == 0) {
         SchdSchmonHookRegister(TimerSchmonCheck, SCHMON_TIMER_HOOK);
+        SchdSchmonDeadlineHookRegister(TimerSchmonDeadline);
         SchdCheckExistenceHookRegister(TimerCheckExistence);
         SchdCheckReadyHookRegister(TimerCheckReady);
         SchdExitHookRegister(TimerExit, KEY_TIMER);
@@ -1062,11 +1063,30 @@ int TimerSchmonCheck(void *pro, unsigned long long now)
             ProcessorWake(wakeSchedule, nullptr);
         } else if (processor->state == PROCESSOR_IDLE) {
             ProcessorWake(wakeSchedule, processor);
+        } else if (processor->state == PROCESSOR_OFFLINE) {
+            // An offline processor is not run again, its timers are stolen by a woken one.
+            ProcessorWake(wakeSchedule, nullptr);
         }
     }
     return 0;
 }
 
+/* Earliest deadline of the processor for schmon, 0 if it has no timer. */
+unsigned long long TimerSchmonDeadline(void *pro)
+{
+    struct TimerHeap *timer;
+
+    timer = static_cast<struct TimerHeap *>(ProcessorGetspecific(static_cast<struct Processor *>(pro), KEY_TIMER));
+    if (timer == nullptr) {
+        return 0;
+    }
+    // Timers modified ahead are not reflected in timer0Deadline yet, so it may be too late.
+    if (atomic_load_explicit(&timer->adjustTimers, std::memory_order_relaxed) != 0) {
+        return CurrentNanotimeGet();
+    }
+    return timer->timer0Deadline;
+}
+
 /* Check whether a timer that can be triggered exists in the processor. */
 bool TimerCheckReady(struct Processor *processor)
 {
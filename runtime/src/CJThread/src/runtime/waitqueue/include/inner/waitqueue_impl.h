@@ -42,6 +42,7 @@ struct WaitqueueNode {
     struct WaitqueueInner *queue;
     struct CJThread *cjthread;
     int *timeout;
+    int *requeued;
     TimerHandle timer;
 };
 
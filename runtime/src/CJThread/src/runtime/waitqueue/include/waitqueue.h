@@ -63,6 +63,11 @@ extern "C" {
 */
 #define  WAIT_QUEUE_TIMEOUT ((MID_WAITQUEUE) | 0x1000)
 
+/**
+* @brief 0x100d1001 WaitqueuePark interface returned after being moved to another queue by WaitqueueRequeue
+*/
+#define  WAIT_QUEUE_REQUEUED ((MID_WAITQUEUE) | 0x1001)
+
 /**
 * @brief The callback function to be executed before waiting for queue park and wake
 */
@@ -92,6 +97,7 @@ int WaitqueueNew(struct Waitqueue *wq);
  * @param  arg              [IN]  callback parameters
  * @retval The value 0 indicates success.
  * The value WAIT_QUEUE_TIMEOUT(0x100d1000) indicates automatic wakeup upon timeout.
+ * The value WAIT_QUEUE_REQUEUED(0x100d1001) indicates a wakeup from the queue it was requeued to.
  * Other values indicate error scenarios.
  */
 int WaitqueuePark(struct Waitqueue *wq, long long ns,
@@ -121,6 +127,23 @@ int WaitqueueWakeOne(struct Waitqueue *wqHandle, WqCallbackFunc callbackFunc,
 int WaitqueueWakeAll(struct Waitqueue *wqHandle, WqCallbackFunc callbackFunc,
                      void *arg);
 
+/**
+ * @brief Move the cjthreads of a queue to the tail of another one
+ * @par The cjthreads are woken from the new queue instead of being woken all at once, and their
+ * WaitqueuePark returns WAIT_QUEUE_REQUEUED. The callback function is called for each cjthread
+ * with both queues locked, and the cjthread is woken up at once if it returns false. If it is NULL,
+ * all of them are moved. Cjthreads waiting with a timeout are always woken up, since their timers
+ * refer to the old queue.
+ * @attention The queues are locked from, then to. Requeueing between two queues both ways deadlocks.
+ * @param  from             [IN]  waitqueue handle the cjthreads wait on
+ * @param  to               [IN]  waitqueue handle the cjthreads are moved to
+ * @param  callbackFunc     [IN]  callback function
+ * @param  arg              [IN]  callback parameters
+ * @retval The value 0 indicates success. A non-zero value indicates an error code.
+ */
+int WaitqueueRequeue(struct Waitqueue *from, struct Waitqueue *to, WqCallbackFunc callbackFunc,
+                     void *arg);
+
 /**
  * @brief Deletes and releases a specified waiting queue.
  * @par Release all nodes in the waiting queue, destroy the lock of the waiting queue,
@@ -120,6 +120,8 @@ int WaitqueuePark(struct Waitqueue *wq, long long ns,
     int ret;
     // Indicates whether the system is woken up due to timeout.
     int isTimeout = 0;
+    // Indicates whether the cjthread is woken up from the queue it was requeued to.
+    int isRequeued = 0;
 
     if (queue == nullptr) {
         return ERRNO_QUEUE_DOESNT_EXIST;
@@ -133,10 +135,14 @@ int WaitqueuePark(struct Waitqueue *wq, long long ns,
         pthread_mutex_unlock(&queue->mutex);
         return ret;
     }
+    node->requeued = &isRequeued;
     // ns is LLONG_MAX, indicating that there is no timeout period.
     // The current cjthread waits until it is woken up by another cjthread.
     if (ns == static_cast<long long>(LLONG_MAX)) {
         CJThreadPark(WaitqueueParkUnlock, TRACE_EV_CJTHREAD_BLOCK_SYNC, queue);
+        if (isRequeued) {
+            return WAIT_QUEUE_REQUEUED;
+        }
     } else {
         // There is a timeout period, and a timer is set.
         atomic_fetch_add(&queue->timerNwait, 1u);
@@ -260,6 +266,73 @@ int WaitqueueWakeAll(struct Waitqueue *wqHandle, WqCallbackFunc callbackFunc,
     return 0;
 }
 
+int WaitqueueRequeue(struct Waitqueue *fromHandle, struct Waitqueue *toHandle, WqCallbackFunc callbackFunc,
+                     void *arg)
+{
+    struct Link *listNode;
+    struct Link *next;
+    struct WaitqueueNode *wqNode;
+    struct WaitqueueInner *from = reinterpret_cast<struct WaitqueueInner *>(fromHandle);
+    struct WaitqueueInner *to = reinterpret_cast<struct WaitqueueInner *>(toHandle);
+
+    if (from == nullptr || to == nullptr) {
+        return ERRNO_QUEUE_DOESNT_EXIST;
+    }
+    if (from == to) {
+        return ERRNO_SCHD_ARG_INVALID;
+    }
+    pthread_mutex_lock(&from->mutex);
+    if (from->nwait == 0) {
+        pthread_mutex_unlock(&from->mutex);
+        return ERRNO_QUEUE_IS_EMPTY;
+    }
+    pthread_mutex_lock(&to->mutex);
+    listNode = (&from->head)->next;
+    while (listNode != nullptr) {
+        next = listNode->next;
+        wqNode = LINK_ENTRY(listNode, struct WaitqueueNode, listNode);
+        // The timer has fired, its callback takes the node out once the lock is released.
+        if (wqNode->timer != nullptr && TimerTryStop(wqNode->timer) != 0) {
+            listNode = next;
+            continue;
+        }
+        if (next == nullptr) {
+            if (from->nwait == 1) {
+                from->tail = nullptr;
+            } else {
+                from->tail = listNode->prev;
+            }
+        }
+        LinkRemove(listNode);
+        LinkInit(listNode);
+        from->nwait--;
+        if (wqNode->timer == nullptr && to->nwait != UINT32_MAX &&
+            (callbackFunc == nullptr || callbackFunc(arg))) {
+            to->nwait++;
+            if (to->nwait == 1) {
+                LinkPushHead(&to->head, listNode);
+            } else {
+                LinkPushTail(to->tail, listNode);
+            }
+            to->tail = listNode;
+            wqNode->queue = to;
+            *wqNode->requeued = 1;
+        } else {
+            // Wake up the cjthread. If the timer is set for the node, release it.
+            CJThreadReady(wqNode->cjthread);
+            if (wqNode->timer != nullptr) {
+                TimerRelease(wqNode->timer);
+                atomic_fetch_sub(&from->timerNwait, 1u);
+            }
+            free(wqNode);
+        }
+        listNode = next;
+    }
+    pthread_mutex_unlock(&to->mutex);
+    pthread_mutex_unlock(&from->mutex);
+    return 0;
+}
+
 struct WaitqueueNode *WaitqueueNodeNew(struct CJThread *cjthread, struct WaitqueueInner *queue)
 {
     struct WaitqueueNode *node = (struct WaitqueueNode *)malloc(sizeof(struct WaitqueueNode));
@@ -271,6 +344,7 @@ struct WaitqueueNode *WaitqueueNodeNew(struct CJThread *cjthread, struct Waitque
     node->timer = nullptr;
     node->queue = queue;
     node->timeout = nullptr;
+    node->requeued = nullptr;
     return node;
 }
 
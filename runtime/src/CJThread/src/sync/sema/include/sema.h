@@ -75,6 +75,18 @@ int SemaAcquire(struct Sema *semHandle, bool head);
  */
 int SemaRelease(struct Sema *semHandle);
 
+/**
+ * @brief Move the cjthreads waiting on a waitqueue to the waiting queue of a semaphore
+ * @par They are woken up one by one by SemaRelease, see WaitqueueRequeue. The semaphore is not
+ * acquired for them, they call SemaAcquire after their WaitqueuePark returns WAIT_QUEUE_REQUEUED.
+ * @param  wq            [IN]  Waitqueue the cjthreads wait on
+ * @param  semHandle     [IN]  The target semaphore
+ * @param  callbackFunc  [IN]  Called for each cjthread, it is woken up at once if it returns false
+ * @param  arg           [IN]  callback parameters
+ * @retval Success returns 0, failure returns error code
+ */
+int SemaRequeue(struct Waitqueue *wq, struct Sema *semHandle, WqCallbackFunc callbackFunc, void *arg);
+
 /**
  * @brief Obtain the value of the semaphore
  * @attention  Once the semaphore value returns, it should be considered outdated
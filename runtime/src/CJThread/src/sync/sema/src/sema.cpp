@@ -115,6 +115,16 @@ int SemaRelease(struct Sema *semHandle)
     return 0;
 }
 
+int SemaRequeue(struct Waitqueue *wq, struct Sema *semHandle, WqCallbackFunc callbackFunc, void *arg)
+{
+    struct SemaInner *sema = reinterpret_cast<struct SemaInner*>(semHandle);
+
+    if (sema == nullptr) {
+        return ERRNO_SEMA_DOESNT_EXIST;
+    }
+    return WaitqueueRequeue(wq, &sema->queue, callbackFunc, arg);
+}
+
 int SemaDelete(struct Sema *semHandle)
 {
     struct SemaInner *sema = reinterpret_cast<struct SemaInner*>(semHandle);
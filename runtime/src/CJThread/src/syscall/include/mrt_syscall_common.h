@@ -119,6 +119,25 @@ int SyscallGetnameinfo(const struct sockaddr *sa, socklen_t salen, char *host, s
  */
 void SyscallFreeaddrinfo(struct addrinfo *res);
 
+/**
+ * @brief Enter a blocking region
+ * @par Declare that the current cjthread is about to make a call that is known to block, such as
+ * a file read. Unlike the syscall wrappers above, which leave the processor to schmon until the
+ * call has blocked for a monitor cycle, the processor is handed off immediately: it is bound to
+ * another thread if it has runnable cjthreads, and becomes idle otherwise.
+ * @attention Must be paired with SyscallBlockingRegionExit in the same cjthread, and the region
+ * must not park the cjthread. It does nothing outside the cjthread context.
+ */
+void SyscallBlockingRegionEnter(void);
+
+/**
+ * @brief Leave a blocking region
+ * @par Rebind the current cjthread to a processor after SyscallBlockingRegionEnter. If no
+ * processor is idle, the cjthread is put into the global run queue and continues when scheduled.
+ * errno set by the blocking call is preserved even if the cjthread resumes on another thread.
+ */
+void SyscallBlockingRegionExit(void);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -111,6 +111,65 @@ void SyscallExit(void)
     CJThreadMcall(reinterpret_cast<void *>(SyscallExit0), CJThreadAddr());
 }
 
+/* Hand off the processor left by SyscallEnter without waiting for schmon. If the processor
+ * has runnable cjthreads, bind it to another thread; otherwise put it back to the idle list
+ * so that it can be woken up by new cjthreads. Returns whether the processor was handed off.
+ */
+static bool SyscallHandoff(struct Processor *processor)
+{
+    struct Schedule *schedule = static_cast<struct Schedule *>(processor->schedule);
+    ProcessorState processorSyscall = PROCESSOR_SYSCALL;
+
+    if (schedule->scheduleType != SCHEDULE_DEFAULT ||
+        !atomic_compare_exchange_strong(&processor->state, &processorSyscall, PROCESSOR_RUNNING)) {
+        return false;
+    }
+    atomic_fetch_add(&schedule->schdCJThread.handoffCnt, 1ULL);
+    if (ProcessorHasReady(processor) || ScheduleAnyCJThread(schedule)) {
+        ThreadAllocBindProcessor(processor, false);
+        return true;
+    }
+    if (schedule->state == SCHEDULE_EXITING) {
+        atomic_store(&processor->state, PROCESSOR_EXITING);
+        return true;
+    }
+    ProcessorFree(schedule, processor);
+    // A cjthread may become ready after the check above and miss this processor, so check again.
+    if (ScheduleAnyCJThread(schedule)) {
+        ProcessorWake(schedule, nullptr);
+    }
+    return true;
+}
+
+void SyscallBlockingRegionEnter(void)
+{
+    struct CJThread *cjthread;
+    struct Thread *thread;
+    struct Processor *processor;
+
+    SyscallEnter();
+    cjthread = CJThreadGet();
+    if (cjthread == nullptr) {
+        return;
+    }
+    thread = static_cast<struct Thread *>(cjthread->thread);
+    processor = static_cast<struct Processor *>(thread->oldProcessor);
+    if (processor != nullptr && SyscallHandoff(processor) && thread->cpuPinned) {
+        // The next thread of the processor is pinned to the same CPU. The thread is pinned again
+        // by the processor it runs after the syscall.
+        (void)TopologyThreadUnpin(&g_scheduleManager.topology);
+        thread->cpuPinned = false;
+    }
+}
+
+void SyscallBlockingRegionExit(void)
+{
+    // The cjthread may resume on another thread, so carry errno of the blocking call over.
+    int savedErrno = errno;
+    SyscallExit();
+    errno = savedErrno;
+}
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
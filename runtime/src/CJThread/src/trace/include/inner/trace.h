@@ -72,6 +72,16 @@ extern "C" {
 */
 #define ERRNO_TRACE_STACK_EVENT ((MID_TRACE) | 0x00A)
 
+/**
+* @brief 0x1015000B flight recorder is off or its arguments are invalid
+*/
+#define ERRNO_TRACE_FLIGHT_RECORDER_ARGS ((MID_TRACE) | 0x00B)
+
+/**
+* @brief 0x1015000C flight recorder dump timed out waiting for the events in flight
+*/
+#define ERRNO_TRACE_FLIGHT_RECORDER_BUSY ((MID_TRACE) | 0x00C)
+
 /**
  * @brief start trace
  * @par start trace
@@ -89,6 +99,31 @@ bool TraceStart(unsigned short traceType);
  */
 bool TraceStop(void);
 
+/**
+ * @brief start the flight recorder
+ * @par start the flight recorder
+ * The events are kept in a ring of traceBufs per processor instead of being streamed to the
+ * trace reader, so that the latest window can be dumped at any time. Events are recorded
+ * without call stacks.
+ * @attention only one trace exists globally, it is stopped by TraceStop
+ * @param  traceType         [IN]  trace event
+ * @param  windowMs          [IN]  traceBufs filled earlier than the window are dropped
+ * @param  bufNum            [IN]  filled traceBufs kept per processor at most
+ * @retval true or false
+ */
+bool TraceFlightRecorderStart(unsigned short traceType, unsigned int windowMs, unsigned int bufNum);
+
+bool TraceFlightRecorderStop(void);
+
+/**
+ * @brief dump the flight recorder
+ * @par dump the flight recorder
+ * The window is written to fd in the format of TraceDump. Events are dropped while it is written.
+ * @param  fd                [IN]  file descriptor
+ * @retval true or false
+ */
+bool TraceFlightRecorderDump(int fd);
+
 /**
  * @brief Common methods for recording common trace events
  * @par Common methods for recording common trace events
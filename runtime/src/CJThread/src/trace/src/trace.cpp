@@ -5,6 +5,12 @@
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
 
+#include <cerrno>
+#ifdef MRT_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 #include "basetime.h"
 #include "securec.h"
 #include "log.h"
@@ -16,6 +22,19 @@
 extern "C" {
 #endif
 
+/* Stacks of the scheduler functions, recorded once as special stack events. */
+static const struct {
+    unsigned long long stackId;
+    const char *funcStr;
+} g_traceSpecialStacks[] = {
+    { SpecialStackId::CJTHREAD_EXIT, TRACE_EXIT_STRING },
+    { SpecialStackId::CJTHREAD_RESCHED, TRACE_RESCHED_STRING },
+    { SpecialStackId::CJTHREAD_NET_BLOCK, TRACE_NET_BLOCK_STRING },
+    { SpecialStackId::CJTHREAD_NET_UNBLOCK, TRACE_NET_UNBLOCK_STRING },
+    { SpecialStackId::CJTHREAD_UNBLOCK, TRACE_UNBLOCK_STRING },
+    { SpecialStackId::UNKNOWN, TRACE_UNKNOWN_STRING },
+};
+
 bool TraceStart(unsigned short traceType)
 {
     int error;
@@ -130,6 +149,9 @@ bool TraceStop(void)
         LOG_ERROR(ERRNO_TRACE_ALREADY_STOP, "trace is already stop");
         return false;
     }
+    if (g_scheduleManager.trace.flightRecorder) {
+        return TraceFlightRecorderStop();
+    }
     /* Record the cjthread events of the currently stopped trace. */
     if (CJThreadGet() != nullptr && CJThreadGet() != ThreadGet()->cjthread0) {
         ScheduleTraceEvent(TRACE_EV_CJTHREAD_RESCHED, TRACE_STACK_1, nullptr, 0);
@@ -194,11 +216,39 @@ void TraceUint64(struct TraceBuf *traceBuf, unsigned long long value)
     traceBuf->header.pos++;
 }
 
-/* Allocate a new memory to traceBuf. If the original address is not nullptr, store it in fullBufHead to be written. */
-void TraceFlush(struct TraceBuf **traceBuf, unsigned int processorId, bool batchFlag)
+/* Keep a filled traceBuf in the ring of its processor, and recycle the traceBufs that fall out
+ * of the window or beyond the ring size. The latest traceBuf is always kept. */
+void TraceRingPush(struct TraceRing *ring, struct TraceBuf **traceBuf)
+{
+    unsigned long long now = CurrentNanotimeGet();
+    struct TraceBuf *oldest;
+    if (ring->bufHead.next == nullptr) {
+        DulinkInit(&ring->bufHead);
+    }
+    (*traceBuf)->header.fullTime = now;
+    DulinkPushtail(&ring->bufHead, *traceBuf);
+    ring->bufNum++;
+    *traceBuf = nullptr;
+    while (ring->bufNum > 1) {
+        oldest = reinterpret_cast<struct TraceBuf *>(ring->bufHead.next);
+        if (ring->bufNum <= g_scheduleManager.trace.ringBufNum &&
+            oldest->header.fullTime + g_scheduleManager.trace.windowNs >= now) {
+            break;
+        }
+        DulinkPopHead(&ring->bufHead);
+        ring->bufNum--;
+        DulinkPushtail(&g_scheduleManager.trace.freeBufHead, oldest);
+    }
+}
+
+/* Allocate a new memory to traceBuf. If the original address is not nullptr, store it in fullBufHead to be written,
+ * or in the ring when the flight recorder is on. */
+void TraceFlush(struct TraceBuf **traceBuf, struct TraceRing *ring, unsigned int processorId, bool batchFlag)
 {
     pthread_mutex_lock(&g_scheduleManager.trace.lock);
-    if (*traceBuf != nullptr) {
+    if (*traceBuf != nullptr && ring != nullptr && g_scheduleManager.trace.flightRecorder) {
+        TraceRingPush(ring, traceBuf);
+    } else if (*traceBuf != nullptr) {
         TraceFullQueue(traceBuf);
     }
     if (!DulinkIsEmpty(&g_scheduleManager.trace.freeBufHead)) {
@@ -226,11 +276,11 @@ void TraceFlush(struct TraceBuf **traceBuf, unsigned int processorId, bool batch
     pthread_mutex_unlock(&g_scheduleManager.trace.lock);
 }
 
-bool TraceCheckEvSizeAndFlush(struct TraceBuf **traceBuf, unsigned int processorId,
+bool TraceCheckEvSizeAndFlush(struct TraceBuf **traceBuf, struct TraceRing *ring, unsigned int processorId,
                               unsigned int eventMaxSize, bool batchFlag)
 {
     if (*traceBuf == nullptr || sizeof((*traceBuf)->arr) - ((*traceBuf)->header.pos) < eventMaxSize) {
-        TraceFlush(traceBuf, processorId, batchFlag);
+        TraceFlush(traceBuf, ring, processorId, batchFlag);
         if (*traceBuf == nullptr && processorId == 0) {
             /* get buflock in TraceBufAquire */
             pthread_mutex_unlock(&g_scheduleManager.trace.bufLock);
@@ -257,16 +307,18 @@ unsigned long long TraceGetTimeDiff(struct TraceBuf **traceBuf)
 }
 
 /* Obtain the current Processor or the global tarceBuf pointer, depending on whether the cjthread context. */
-struct TraceBuf **TraceBufAquire(unsigned int *processorId)
+struct TraceBuf **TraceBufAquire(unsigned int *processorId, struct TraceRing **ring)
 {
     struct Processor *processor = ProcessorGetWithCheck();
     if (processor != nullptr) {
         *processorId = processor->processorId;
+        *ring = &processor->traceRing;
         return &processor->traceBuf;
     }
     pthread_mutex_lock(&g_scheduleManager.trace.bufLock);
     // If processorId is 0, use global traceBuf
     *processorId = 0;
+    *ring = &g_scheduleManager.trace.bufRing;
     return &g_scheduleManager.trace.buf;
 }
 
@@ -284,12 +336,20 @@ bool TraceDoubleCheckShutdown()
         LOG_INFO(ERRNO_TRACE_EVENT_WHEN_STOP, "The trace is being closed.");
         return true;
     }
+    /* Events are dropped quietly while the flight recorder dumps. */
+    if (g_scheduleManager.trace.paused.load()) {
+        return true;
+    }
     atomic_fetch_add(&g_scheduleManager.trace.eventCount, 1);
     if (g_scheduleManager.trace.shutdown == true) {
         LOG_INFO(ERRNO_TRACE_EVENT_WHEN_STOP, "The trace is being closed.");
         atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
         return true;
     }
+    if (g_scheduleManager.trace.paused.load()) {
+        atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
+        return true;
+    }
     return false;
 }
 
@@ -300,13 +360,14 @@ void TraceRecordEvent(TraceEvent event, int skip, void *mutator, int argNum, va_
     unsigned long long arg;
     unsigned char evArgNum = static_cast<unsigned char>(argNum & TRACE_EFFECTIVE_ARG_NUM);
     struct TraceBuf **traceBuf;
+    struct TraceRing *ring;
     /* add eventCount here */
     if (TraceDoubleCheckShutdown()) {
         return;
     }
     /* get bufLock here */
-    traceBuf = TraceBufAquire(&processorId);
-    if (!TraceCheckEvSizeAndFlush(traceBuf, processorId, TRACE_EVENT_MAXSIZE, true)) {
+    traceBuf = TraceBufAquire(&processorId, &ring);
+    if (!TraceCheckEvSizeAndFlush(traceBuf, ring, processorId, TRACE_EVENT_MAXSIZE, true)) {
         atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
         return;
     }
@@ -323,15 +384,17 @@ void TraceRecordEvent(TraceEvent event, int skip, void *mutator, int argNum, va_
         arg = va_arg(args, unsigned long long);
         TraceUint64(*traceBuf, arg);
     }
+    /* The flight recorder is always on and does not unwind, the stacks of its events are unknown. */
+    bool unwind = !g_scheduleManager.trace.flightRecorder;
     unsigned long long stackId = 0;
     if (skip > 0 && skip <= TRACE_STACK_MAX_DEPTH) {
-        stackId = TraceStackId();
+        stackId = unwind ? TraceStackId() : static_cast<unsigned long long>(SpecialStackId::UNKNOWN);
         TraceUint64(*traceBuf, stackId);
     }
     
     TraceBufRelease();
     atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
-    if (skip <= 0) {
+    if (skip <= 0 || !unwind) {
         return;
     }
 
@@ -344,7 +407,7 @@ void TraceRecordEvent(TraceEvent event, int skip, void *mutator, int argNum, va_
 unsigned char *TraceDumpHeader(int *len)
 {
     g_scheduleManager.trace.headerWritten = true;
-    TraceFlush(&g_scheduleManager.trace.reading, 0, false);
+    TraceFlush(&g_scheduleManager.trace.reading, nullptr, 0, false);
     if (g_scheduleManager.trace.reading == nullptr) {
         LOG_ERROR(ERRNO_TRACE_BUF_FLUSH_WRONG, "TraceFlush Failed");
         pthread_mutex_unlock(&g_scheduleManager.trace.lock);
@@ -362,7 +425,7 @@ unsigned char *TraceDumpFooter(int *len)
     g_scheduleManager.trace.footerWritten = true;
     double freq = static_cast<double>(g_scheduleManager.trace.ticksEnd - g_scheduleManager.trace.ticksStart) * 1e9 /
             static_cast<double>(g_scheduleManager.trace.timeEnd - g_scheduleManager.trace.timeStart);
-    TraceFlush(&g_scheduleManager.trace.reading, 0, false);
+    TraceFlush(&g_scheduleManager.trace.reading, nullptr, 0, false);
     if (g_scheduleManager.trace.reading == nullptr) {
         LOG_ERROR(ERRNO_TRACE_BUF_FLUSH_WRONG, "TraceFlush Failed");
         pthread_mutex_unlock(&g_scheduleManager.trace.lock);
@@ -386,6 +449,11 @@ unsigned char *TraceDump(int *len)
         LOG_ERROR(ERRNO_TRACE_MULTIPLE_READER, "ReadTrace called from multiple goroutines simultaneously");
         return nullptr;
     }
+    /* The flight recorder is dumped as a whole by TraceFlightRecorderDump. */
+    if (g_scheduleManager.trace.flightRecorder) {
+        pthread_mutex_unlock(&g_scheduleManager.trace.lock);
+        return nullptr;
+    }
     if (g_scheduleManager.trace.reading != nullptr) {
         DulinkPushtail(&g_scheduleManager.trace.freeBufHead, g_scheduleManager.trace.reading);
         g_scheduleManager.trace.reading = nullptr;
@@ -502,6 +570,7 @@ bool TraceRecordStackEvent(unsigned long long stackId, int skip, void *mutator)
     const unsigned int maxStrSize = TRACE_BUF_LENGTH - 1;
     struct TraceBuf **traceBuf;
     unsigned int processorId;
+    struct TraceRing *ring;
     char *funcNames[arrSize] = {};
     char *fileNames[arrSize] = {};
     unsigned int lineNumbers[arrSize] = {0};
@@ -520,8 +589,8 @@ bool TraceRecordStackEvent(unsigned long long stackId, int skip, void *mutator)
         return false;
     }
     atomic_fetch_add(&g_scheduleManager.trace.eventCount, 1);
-    traceBuf = TraceBufAquire(&processorId);
-    if (!TraceCheckEvSizeAndFlush(traceBuf, processorId, TRACE_STACK_EVENT_MAXSIZE, true)) {
+    traceBuf = TraceBufAquire(&processorId, &ring);
+    if (!TraceCheckEvSizeAndFlush(traceBuf, ring, processorId, TRACE_STACK_EVENT_MAXSIZE, true)) {
         atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
         return false;
     }
@@ -542,27 +611,34 @@ bool TraceRecordStackEvent(unsigned long long stackId, int skip, void *mutator)
     return true;
 }
 
+/* Writes a stack event of one frame in the runtime, named by the string `funcStringId`. */
+void TraceWriteSpecialStack(struct TraceBuf *traceBuf, unsigned long long stackId, unsigned long long funcStringId)
+{
+    unsigned char evArgNum = 1;
+    TraceByte(traceBuf, static_cast<unsigned char>(TRACE_EV_STACK & TRACE_EFFECTIVE_EVENT));
+    TraceByte(traceBuf, evArgNum + TRACE_STACK_ARG_NUM * 1);
+    TraceUint64(traceBuf, stackId);
+    TraceByte(traceBuf, 1);
+
+    TraceByte(traceBuf, 0);
+    TraceUint64(traceBuf, funcStringId);
+    TraceUint64(traceBuf, 1);
+    TraceUint64(traceBuf, 0);
+}
+
 bool TraceRecordSpecialStackEvent(unsigned long long stackId, const char* funcStr)
 {
     auto fucStringId = TraceRecordStringEvent(funcStr);
-    unsigned char evArgNum = 1;
     unsigned int processorId;
+    struct TraceRing *ring;
     atomic_fetch_add(&g_scheduleManager.trace.eventCount, 1);
-    struct TraceBuf **traceBuf = TraceBufAquire(&processorId);
-    if (!TraceCheckEvSizeAndFlush(traceBuf, processorId, TRACE_STACK_EVENT_MAXSIZE, true)) {
+    struct TraceBuf **traceBuf = TraceBufAquire(&processorId, &ring);
+    if (!TraceCheckEvSizeAndFlush(traceBuf, ring, processorId, TRACE_STACK_EVENT_MAXSIZE, true)) {
         atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
         return false;
     }
 
-    TraceByte(*traceBuf, static_cast<unsigned char>(TRACE_EV_STACK & TRACE_EFFECTIVE_EVENT));
-    TraceByte(*traceBuf, evArgNum + TRACE_STACK_ARG_NUM * 1);
-    TraceUint64(*traceBuf, stackId);
-    TraceByte(*traceBuf, 1);
-
-    TraceByte(*traceBuf, 0);
-    TraceUint64(*traceBuf, fucStringId);
-    TraceUint64(*traceBuf, 1);
-    TraceUint64(*traceBuf, 0);
+    TraceWriteSpecialStack(*traceBuf, stackId, fucStringId);
 
     TraceBufRelease();
     atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
@@ -576,6 +652,17 @@ unsigned long long TraceStackId()
     return stackId;
 }
 
+/* Writes a string event. */
+void TraceWriteString(struct TraceBuf *traceBuf, unsigned long long stringId, const char *str, size_t len)
+{
+    TraceByte(traceBuf, static_cast<unsigned char>(TRACE_EV_STRING & TRACE_EFFECTIVE_EVENT));
+    TraceUint64(traceBuf, stringId);
+    TraceUint64(traceBuf, len);
+    for (size_t i = 0; i < len; i++) {
+        TraceByte(traceBuf, str[i]);
+    }
+}
+
 unsigned long long TraceRecordStringEvent(const char* str)
 {
     if (str == nullptr) {
@@ -584,22 +671,18 @@ unsigned long long TraceRecordStringEvent(const char* str)
     }
     size_t len = strlen(str);
     struct TraceBuf **traceBuf;
+    struct TraceRing *ring;
     unsigned int processorId;
     if (TraceDoubleCheckShutdown()) {
         return 0;
     }
-    traceBuf = TraceBufAquire(&processorId);
-    if (!TraceCheckEvSizeAndFlush(traceBuf, processorId, len, true)) {
+    traceBuf = TraceBufAquire(&processorId, &ring);
+    if (!TraceCheckEvSizeAndFlush(traceBuf, ring, processorId, len, true)) {
         atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
         return 0;
     }
-    TraceByte(*traceBuf, static_cast<unsigned char>(TRACE_EV_STRING & TRACE_EFFECTIVE_EVENT));
     auto stringId = atomic_fetch_add(&g_scheduleManager.trace.stringId, 1ULL);
-    TraceUint64(*traceBuf, stringId);
-    TraceUint64(*traceBuf, len);
-    for (size_t i = 0; i < len; i++) {
-        TraceByte(*traceBuf, str[i]);
-    }
+    TraceWriteString(*traceBuf, stringId, str, len);
     TraceBufRelease();
     atomic_fetch_sub(&g_scheduleManager.trace.eventCount, 1);
     return stringId;
@@ -618,15 +701,227 @@ void TraceRecordStartEvent()
         ScheduleTraceEvent(TRACE_EV_CJTHREAD_START, -1, nullptr, 1,
                            CJThreadGetId(static_cast<CJThreadHandle>(currCJThread)));
     }
+    /* The flight recorder would lose them with the oldest traceBufs, it writes them with every dump. */
+    if (g_scheduleManager.trace.flightRecorder) {
+        return;
+    }
     /* Record runtime name for string event. It will be used for stack strace. */
     TraceRecordStringEvent(TRACE_RUNTIME_STRING);
     /* Record cjthread special stack event. */
-    TraceRecordSpecialStackEvent(SpecialStackId::CJTHREAD_EXIT, TRACE_EXIT_STRING);
-    TraceRecordSpecialStackEvent(SpecialStackId::CJTHREAD_RESCHED, TRACE_RESCHED_STRING);
-    TraceRecordSpecialStackEvent(SpecialStackId::CJTHREAD_NET_BLOCK, TRACE_NET_BLOCK_STRING);
-    TraceRecordSpecialStackEvent(SpecialStackId::CJTHREAD_NET_UNBLOCK, TRACE_NET_UNBLOCK_STRING);
-    TraceRecordSpecialStackEvent(SpecialStackId::CJTHREAD_UNBLOCK, TRACE_UNBLOCK_STRING);
-    TraceRecordSpecialStackEvent(SpecialStackId::UNKNOWN, TRACE_UNKNOWN_STRING);
+    for (const auto &special : g_traceSpecialStacks) {
+        TraceRecordSpecialStackEvent(special.stackId, special.funcStr);
+    }
+}
+
+bool TraceFlightRecorderStart(unsigned short traceType, unsigned int windowMs, unsigned int bufNum)
+{
+    if (g_scheduleManager.trace.openType || g_scheduleManager.trace.shutdown) {
+        LOG_ERROR(ERRNO_TRACE_ALREADY_START, "trace is already start");
+        return false;
+    }
+    if (windowMs == 0 || bufNum == 0) {
+        LOG_ERROR(ERRNO_TRACE_FLIGHT_RECORDER_ARGS, "window %u ms or traceBufs %u is 0", windowMs, bufNum);
+        return false;
+    }
+    /* Set before the events start, they are kept in the rings from the first one on. */
+    g_scheduleManager.trace.flightRecorder = true;
+    g_scheduleManager.trace.windowNs = static_cast<unsigned long long>(windowMs) * 1000 * 1000;
+    g_scheduleManager.trace.ringBufNum = bufNum;
+    if (!TraceStart(traceType)) {
+        g_scheduleManager.trace.flightRecorder = false;
+        return false;
+    }
+    return true;
+}
+
+/* Free a traceBuf and the traceBufs kept in its ring. */
+void TraceRingFree(struct TraceBuf **traceBuf, struct TraceRing *ring)
+{
+    struct Dulink *traceBufNode;
+    free(*traceBuf);
+    *traceBuf = nullptr;
+    if (ring->bufHead.next == nullptr) {
+        return;
+    }
+    while (!DulinkIsEmpty(&ring->bufHead)) {
+        traceBufNode = ring->bufHead.next;
+        DulinkPopHead(&ring->bufHead);
+        free(traceBufNode);
+    }
+    ring->bufNum = 0;
+}
+
+bool TraceFlightRecorderStop(void)
+{
+    struct Dulink *scheduleNode = nullptr;
+    struct Dulink *traceBufNode;
+    struct Schedule *schedule;
+    struct ScheduleProcessor *scheduleProcessor;
+    g_scheduleManager.trace.openType = 0;
+    g_scheduleManager.trace.shutdown = true;
+    while (atomic_load(&g_scheduleManager.trace.eventCount) != 0) {}
+    /* The window is dropped, nothing is left to read. */
+    pthread_mutex_lock(&g_scheduleManager.trace.lock);
+    pthread_mutex_lock(&g_scheduleManager.allScheduleListLock);
+    DULINK_FOR_EACH_ITEM(scheduleNode, &g_scheduleManager.allScheduleList) {
+        schedule = DULINK_ENTRY(scheduleNode, struct Schedule, allScheduleDulink);
+        scheduleProcessor = &schedule->schdProcessor;
+        for (unsigned int i = 0; i < scheduleProcessor->processorNum; ++i) {
+            TraceRingFree(&scheduleProcessor->processorGroup[i].traceBuf,
+                          &scheduleProcessor->processorGroup[i].traceRing);
+        }
+    }
+    pthread_mutex_unlock(&g_scheduleManager.allScheduleListLock);
+    pthread_mutex_lock(&g_scheduleManager.trace.bufLock);
+    TraceRingFree(&g_scheduleManager.trace.buf, &g_scheduleManager.trace.bufRing);
+    pthread_mutex_unlock(&g_scheduleManager.trace.bufLock);
+    while (!DulinkIsEmpty(&g_scheduleManager.trace.freeBufHead)) {
+        traceBufNode = g_scheduleManager.trace.freeBufHead.next;
+        DulinkPopHead(&g_scheduleManager.trace.freeBufHead);
+        free(traceBufNode);
+    }
+    g_scheduleManager.trace.flightRecorder = false;
+    pthread_mutex_unlock(&g_scheduleManager.trace.lock);
+    g_scheduleManager.trace.shutdown = false;
+    TraceDeregister();
+    return true;
+}
+
+bool TraceWriteAll(int fd, const unsigned char *data, int len)
+{
+    while (len > 0) {
+#ifdef MRT_WINDOWS
+        int written = _write(fd, data, static_cast<unsigned int>(len));
+#else
+        ssize_t written = write(fd, data, static_cast<size_t>(len));
+#endif
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            LOG_ERROR(errno, "write flight recorder dump failed");
+            return false;
+        }
+        data += written;
+        len -= static_cast<int>(written);
+    }
+    return true;
+}
+
+/* Write the traceBufs of a ring that are still in the window, then the traceBuf being filled. */
+bool TraceRingWrite(int fd, struct TraceBuf *traceBuf, struct TraceRing *ring, unsigned long long now)
+{
+    struct Dulink *traceBufNode = nullptr;
+    struct TraceBuf *kept;
+    if (ring->bufHead.next != nullptr) {
+        DULINK_FOR_EACH_ITEM(traceBufNode, &ring->bufHead) {
+            kept = reinterpret_cast<struct TraceBuf *>(traceBufNode);
+            if (kept->header.fullTime + g_scheduleManager.trace.windowNs < now) {
+                continue;
+            }
+            if (!TraceWriteAll(fd, kept->arr, kept->header.pos)) {
+                return false;
+            }
+        }
+    }
+    return traceBuf == nullptr || TraceWriteAll(fd, traceBuf->arr, traceBuf->header.pos);
+}
+
+/* Write the strings and stacks the events refer to, which the window may have lost. */
+bool TraceFlightRecorderWritePreamble(int fd, struct TraceBuf *meta)
+{
+    unsigned long long stringId = 1;
+    meta->header.pos = 0;
+    meta->header.lastTicks = CurrentCPUTicks();
+    TraceByte(meta, static_cast<unsigned char>(TRACE_EV_BATCH & TRACE_EFFECTIVE_EVENT));
+    TraceByte(meta, static_cast<unsigned char>(1));
+    TraceUint64(meta, 0);
+    TraceUint64(meta, meta->header.lastTicks);
+    TraceWriteString(meta, stringId++, TRACE_RUNTIME_STRING, strlen(TRACE_RUNTIME_STRING));
+    for (const auto &special : g_traceSpecialStacks) {
+        TraceWriteString(meta, stringId, special.funcStr, strlen(special.funcStr));
+        TraceWriteSpecialStack(meta, special.stackId, stringId++);
+    }
+    return TraceWriteAll(fd, meta->arr, meta->header.pos);
+}
+
+bool TraceFlightRecorderWriteFooter(int fd, struct TraceBuf *meta)
+{
+    unsigned long long ticks = CurrentCPUTicks() - g_scheduleManager.trace.ticksStart;
+    unsigned long long time = CurrentNanotimeGet() - g_scheduleManager.trace.timeStart;
+    double freq = time == 0 ? 0 : static_cast<double>(ticks) * 1e9 / static_cast<double>(time);
+    meta->header.pos = 0;
+    TraceByte(meta, static_cast<unsigned char>(TRACE_EV_FREQUENCY & TRACE_EFFECTIVE_EVENT));
+    TraceByte(meta, static_cast<unsigned char>(0));
+    TraceUint64(meta, (unsigned long long)freq);
+    return TraceWriteAll(fd, meta->arr, meta->header.pos);
+}
+
+/* Write the window in the format of TraceDump, with the traceBufs of every processor in order. */
+bool TraceFlightRecorderWrite(int fd)
+{
+    struct Dulink *scheduleNode = nullptr;
+    struct Schedule *schedule;
+    struct ScheduleProcessor *scheduleProcessor;
+    struct Processor *processor;
+    unsigned char header[TRACE_HEADER_LENGTH] = {};
+    unsigned long long now = CurrentNanotimeGet();
+    bool result;
+    struct TraceBuf *meta = (struct TraceBuf *)malloc(sizeof(struct TraceBuf));
+    if (meta == nullptr) {
+        LOG_ERROR(ERRNO_TRACE_MALLOC_FAILED, "malloc failed");
+        return false;
+    }
+    memcpy_s(header, TRACE_HEADER_LENGTH, TRACE_HEADER, strlen(TRACE_HEADER));
+    result = TraceWriteAll(fd, header, TRACE_HEADER_LENGTH) && TraceFlightRecorderWritePreamble(fd, meta);
+    pthread_mutex_lock(&g_scheduleManager.allScheduleListLock);
+    DULINK_FOR_EACH_ITEM(scheduleNode, &g_scheduleManager.allScheduleList) {
+        schedule = DULINK_ENTRY(scheduleNode, struct Schedule, allScheduleDulink);
+        scheduleProcessor = &schedule->schdProcessor;
+        for (unsigned int i = 0; i < scheduleProcessor->processorNum && result; ++i) {
+            processor = &scheduleProcessor->processorGroup[i];
+            result = TraceRingWrite(fd, processor->traceBuf, &processor->traceRing, now);
+        }
+    }
+    pthread_mutex_unlock(&g_scheduleManager.allScheduleListLock);
+    pthread_mutex_lock(&g_scheduleManager.trace.bufLock);
+    result = result && TraceRingWrite(fd, g_scheduleManager.trace.buf, &g_scheduleManager.trace.bufRing, now);
+    pthread_mutex_unlock(&g_scheduleManager.trace.bufLock);
+    result = result && TraceFlightRecorderWriteFooter(fd, meta);
+    free(meta);
+    return result;
+}
+
+bool TraceFlightRecorderDump(int fd)
+{
+    bool expected = false;
+    bool result = false;
+    unsigned long long deadline;
+    if (!g_scheduleManager.trace.flightRecorder || fd < 0) {
+        LOG_ERROR(ERRNO_TRACE_FLIGHT_RECORDER_ARGS, "flight recorder is off or fd %d is invalid", fd);
+        return false;
+    }
+    if (!g_scheduleManager.trace.paused.compare_exchange_strong(expected, true)) {
+        LOG_ERROR(ERRNO_TRACE_MULTIPLE_READER, "flight recorder is being dumped");
+        return false;
+    }
+    /* Events are dropped until the dump is written, the ones in flight are waited for. A dump
+     * during a stop-the-world timeout may find an event that never ends, so the wait is bounded. */
+    deadline = CurrentNanotimeGet() + TRACE_PAUSE_TIMEOUT_NS;
+    while (atomic_load(&g_scheduleManager.trace.eventCount) != 0) {
+        if (CurrentNanotimeGet() > deadline) {
+            g_scheduleManager.trace.paused.store(false);
+            LOG_ERROR(ERRNO_TRACE_FLIGHT_RECORDER_BUSY, "events in flight did not end");
+            return false;
+        }
+    }
+    pthread_mutex_lock(&g_scheduleManager.trace.lock);
+    if (g_scheduleManager.trace.flightRecorder) {
+        result = TraceFlightRecorderWrite(fd);
+    }
+    pthread_mutex_unlock(&g_scheduleManager.trace.lock);
+    g_scheduleManager.trace.paused.store(false);
+    return result;
 }
 
 void TraceRegister()
@@ -637,6 +932,8 @@ void TraceRegister()
     g_scheduleManager.trace.hooks.traceRecordEvent = TraceRecordEvent;
     g_scheduleManager.trace.hooks.traceDump = TraceDump;
     g_scheduleManager.trace.hooks.traceReaderGet = TraceReaderGet;
+    g_scheduleManager.trace.hooks.flightRecorderStart = TraceFlightRecorderStart;
+    g_scheduleManager.trace.hooks.flightRecorderDump = TraceFlightRecorderDump;
 }
 
 void TraceDeregister()
@@ -647,6 +944,8 @@ void TraceDeregister()
     g_scheduleManager.trace.hooks.traceRecordEvent = nullptr;
     g_scheduleManager.trace.hooks.traceDump = nullptr;
     g_scheduleManager.trace.hooks.traceReaderGet = nullptr;
+    g_scheduleManager.trace.hooks.flightRecorderStart = nullptr;
+    g_scheduleManager.trace.hooks.flightRecorderDump = nullptr;
 }
 
 #ifdef  __cplusplus
@@ -771,6 +771,20 @@ void MRT_ResumeAll(void* wq, WqCallbackFunc callBack, void* callBackObj)
     ReportWaitQueueRetMsg(WaitqueueWakeAll(handle, callBack, callBackObj));
 }
 
+bool MRT_SuspendRequeueable(void* wq, WqCallbackFunc callBack, void* callBackObj, int64_t timeOut, bool* requeued)
+{
+    auto handle = reinterpret_cast<Waitqueue*>(wq);
+    int ret = WaitqueuePark(handle, timeOut, callBack, callBackObj, false);
+    *requeued = ret == WAIT_QUEUE_REQUEUED;
+    return *requeued || ReportWaitQueueRetMsg(ret);
+}
+
+void MRT_RequeueToSem(void* wq, void* sem, WqCallbackFunc callBack, void* callBackObj)
+{
+    ReportWaitQueueRetMsg(SemaRequeue(reinterpret_cast<Waitqueue*>(wq), reinterpret_cast<Sema*>(sem), callBack,
+                                      callBackObj));
+}
+
 int MRT_NewSem(void* semPtr) { return SemaNew(reinterpret_cast<Sema*>(semPtr), 0); }
 
 void MRT_SemAcquire(void* sem, bool isPushToHead)
@@ -785,6 +799,8 @@ void MRT_SemRelease(void* sem)
     ReportSemRetMsg(SemaRelease(handle));
 }
 
+void MRT_WakeHandoff() { (void)CJThreadWakeHandoff(); }
+
 int64_t MRT_GetCurrentThreadID() { return static_cast<int64_t>(CJThreadId()); }
 
 struct SubSchedulerContextData {
@@ -31,10 +31,14 @@ int MRT_NewWaitQueue(void* waitQueuePtr);
 bool MRT_SuspendWithTimeout(void* wq, const WqCallbackFunc callBack, void* callBackObj, int64_t timeOut);
 void MRT_ResumeOne(void* wq, const WqCallbackFunc callBack, void* callBackObj);
 void MRT_ResumeAll(void* wq, const WqCallbackFunc callBack, void* callBackObj);
+bool MRT_SuspendRequeueable(void* wq, const WqCallbackFunc callBack, void* callBackObj, int64_t timeOut,
+                            bool* requeued);
+void MRT_RequeueToSem(void* wq, void* sem, const WqCallbackFunc callBack, void* callBackObj);
 
 int MRT_NewSem(void* semPtr);
 void MRT_SemAcquire(void* sem, bool isPushToHead);
 void MRT_SemRelease(void* sem);
+void MRT_WakeHandoff();
 int64_t MRT_GetCurrentThreadID();
 
 void* NewFinalizerCJThread();
@@ -46,8 +46,26 @@ extern "C" MRT_EXPORT size_t CJ_MCC_GetGCCount() __attribute__((alias("MCC_GetGC
 extern "C" MRT_EXPORT bool CJ_MCC_IsGCRunning() __attribute__((alias("MCC_IsGCRunning")));
 extern "C" MRT_EXPORT uint64_t CJ_MCC_GetGCTimeUs() __attribute__((alias("MCC_GetGCTimeUs")));
 extern "C" MRT_EXPORT size_t CJ_MCC_GetGCFreedSize() __attribute__((alias("MCC_GetGCFreedSize")));
+extern "C" MRT_EXPORT size_t CJ_MCC_GetGCEvents(GCCycleRecord* records, size_t num)
+    __attribute__((alias("MCC_GetGCEvents")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpGCEvents(int fd) __attribute__((alias("MCC_DumpGCEvents")));
 extern "C" MRT_EXPORT size_t CJ_MCC_StartCpuProfiling() __attribute__((alias("MCC_StartCpuProfiling")));
 extern "C" MRT_EXPORT size_t CJ_MCC_StopCpuProfiling(int fd) __attribute__((alias("MCC_StopCpuProfiling")));
+extern "C" MRT_EXPORT bool CJ_MCC_StopCpuProfilingWithFormat(int fd, int32_t format)
+    __attribute__((alias("MCC_StopCpuProfilingWithFormat")));
+extern "C" MRT_EXPORT bool CJ_MCC_StartFlightRecorder(uint32_t windowMs, uint32_t bufNum)
+    __attribute__((alias("MCC_StartFlightRecorder")));
+extern "C" MRT_EXPORT bool CJ_MCC_StopFlightRecorder() __attribute__((alias("MCC_StopFlightRecorder")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpFlightRecorder(int fd) __attribute__((alias("MCC_DumpFlightRecorder")));
+extern "C" MRT_EXPORT bool CJ_MCC_ExportChromeTrace(int inFd, int outFd)
+    __attribute__((alias("MCC_ExportChromeTrace")));
+extern "C" MRT_EXPORT char* CJ_MCC_GetMetrics() __attribute__((alias("MCC_GetMetrics")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpMetrics(int fd) __attribute__((alias("MCC_DumpMetrics")));
+extern "C" MRT_EXPORT HeapHistogramRecord* CJ_MCC_GetHeapHistogram(size_t* num)
+    __attribute__((alias("MCC_GetHeapHistogram")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpHeapHistogram(int fd) __attribute__((alias("MCC_DumpHeapHistogram")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpCJHeapDataCompressed(int fd)
+    __attribute__((alias("MCC_DumpCJHeapDataCompressed")));
 extern "C" MRT_EXPORT void CJ_MCC_SetGCThreshold(uint64_t GCThreshold) __attribute__((alias("MCC_SetGCThreshold")));
 extern "C" MRT_EXPORT void* CJ_MCC_PostThrowException(ExceptionWrapper* mExceptionWrapper)
     __attribute__((alias("MCC_PostThrowException")));
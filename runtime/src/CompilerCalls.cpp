@@ -29,6 +29,7 @@
 #include "ExceptionManager.inline.h"
 #include "Heap/Barrier/Barrier.h"
 #include "Heap/Collector/CollectorResources.h"
+#include "Heap/Collector/GcStats.h"
 #include "Heap/Heap.h"
 #include "HeapManager.inline.h"
 #include "LoaderManager.h"
@@ -42,6 +43,10 @@
 #include "Sync/Sync.h"
 #include "UnwindStack/GcStackInfo.h"
 #include "CpuProfiler/CpuProfiler.h"
+#include "Inspector/FlightRecorder.h"
+#include "Inspector/HeapHistogram.h"
+#include "Inspector/Metrics.h"
+#include "Inspector/TraceExporter.h"
 #ifdef __OHOS__
 #include "schedule.h"
 #include "Base/SpinLock.h"
@@ -418,6 +423,16 @@ extern "C" bool MCC_DumpCJHeapData(int fd)
     return result;
 }
 
+extern "C" bool MCC_DumpCJHeapDataCompressed(int fd)
+{
+    ScopedEnterSaferegion enterSaferegion(false);
+    CjHeapData* cjHeapData = new CjHeapData(false, true);
+    CHECK_DETAIL(cjHeapData != nullptr, "new cjHeapData fail");
+    bool result = cjHeapData->DumpHeap(fd);
+    delete cjHeapData;
+    return result;
+}
+
 extern "C" size_t MCC_GetCJThreadNumber() { return ScheduleCJThreadCountPublic(CJTHREAD_PSTATE_ALL); }
 
 extern "C" size_t MCC_GetBlockingCJThreadNumber() { return ScheduleCJThreadCountPublic(CJTHREAD_PSTATE_BLOCKING); }
@@ -430,6 +445,16 @@ extern "C" uint64_t MCC_GetGCTimeUs() { return g_gcTotalTimeUs; }
 
 extern "C" size_t MCC_GetGCFreedSize() { return g_gcCollectedTotalBytes; }
 
+extern "C" size_t MCC_GetGCEvents(GCCycleRecord* records, size_t num)
+{
+    if (records == nullptr) {
+        return 0;
+    }
+    return GCEventLog::Instance().GetRecords(records, num);
+}
+
+extern "C" bool MCC_DumpGCEvents(int fd) { return GCEventLog::Instance().Dump(fd); }
+
 extern "C" bool MCC_StartCpuProfiling()
 {
     return CpuProfiler::GetInstance().StartCpuProfilerForFile();
@@ -440,6 +465,55 @@ extern "C" bool MCC_StopCpuProfiling(int fd)
     return CpuProfiler::GetInstance().StopCpuProfilerForFile(fd);
 }
 
+extern "C" bool MCC_StopCpuProfilingWithFormat(int fd, int32_t format)
+{
+    if (format < static_cast<int32_t>(CpuProfileFormat::DEVTOOLS_JSON) ||
+        format > static_cast<int32_t>(CpuProfileFormat::COLLAPSED)) {
+        LOG(RTLOG_ERROR, "Unknown cpu profile format %d", format);
+        return false;
+    }
+    return CpuProfiler::GetInstance().StopCpuProfilerForFile(fd, static_cast<CpuProfileFormat>(format));
+}
+
+extern "C" bool MCC_StartFlightRecorder(uint32_t windowMs, uint32_t bufNum)
+{
+    return FlightRecorder::GetInstance().Start(windowMs, bufNum);
+}
+
+extern "C" bool MCC_StopFlightRecorder() { return FlightRecorder::GetInstance().Stop(); }
+
+extern "C" bool MCC_DumpFlightRecorder(int fd) { return FlightRecorder::GetInstance().Dump(fd); }
+
+extern "C" bool MCC_ExportChromeTrace(int inFd, int outFd) { return TraceExporter::ExportChromeTrace(inFd, outFd); }
+
+extern "C" char* MCC_GetMetrics()
+{
+    CString text = MetricsRegistry::GetInstance().RenderPrometheus();
+    char* result = static_cast<char*>(malloc(text.Length() + 1));
+    if (result == nullptr) {
+        LOG(RTLOG_ERROR, "Malloc metrics text failed");
+        return nullptr;
+    }
+    if (memcpy_s(result, text.Length() + 1, text.Str(), text.Length() + 1) != EOK) {
+        free(result);
+        return nullptr;
+    }
+    return result;
+}
+
+extern "C" bool MCC_DumpMetrics(int fd) { return MetricsRegistry::GetInstance().Dump(fd); }
+
+extern "C" HeapHistogramRecord* MCC_GetHeapHistogram(size_t* num)
+{
+    std::vector<HeapHistogramReport::Row> rows;
+    if (num == nullptr || !HeapHistogramReport::Collect(rows)) {
+        return nullptr;
+    }
+    return HeapHistogramReport::ToRecords(rows, *num);
+}
+
+extern "C" bool MCC_DumpHeapHistogram(int fd) { return HeapHistogramReport::Dump(fd); }
+
 extern "C" void MCC_SetGCThreshold(uint64_t GCThreshold) { Runtime::Current().SetGCThreshold(GCThreshold); }
 
 extern "C" void* MCC_PostThrowException(ExceptionWrapper* mExceptionWrapper)
@@ -26,6 +26,9 @@
 // The compiler should only call MCC_* to access runtime functions.
 // MCC_* calls follows C standard calling convention.
 namespace MapleRuntime {
+struct GCCycleRecord;
+struct HeapHistogramRecord;
+
 // create new objects
 extern "C" ObjRef MCC_NewObject(const TypeInfo* classInfo, MSize size);
 extern "C" ObjRef MCC_NewPinnedObject(const TypeInfo* classInfo, MSize size, bool isFinalizer);
@@ -58,6 +61,8 @@ extern "C" ssize_t MCC_GetRealHeapSize();
 extern "C" size_t MCC_GetAllocatedHeapSize();
 extern "C" size_t MCC_GetMaxHeapSize();
 extern "C" bool MCC_DumpCJHeapData(int fd);
+// Dump the heap as MCC_DumpCJHeapData does, compressed into an LZ4 frame.
+extern "C" bool MCC_DumpCJHeapDataCompressed(int fd);
 
 extern "C" size_t MCC_GetCJThreadNumber();
 extern "C" size_t MCC_GetBlockingCJThreadNumber();
@@ -67,9 +72,29 @@ extern "C" size_t MCC_GetGCCount();
 extern "C" uint64_t MCC_GetGCTimeUs();
 extern "C" size_t MCC_GetGCFreedSize();
 extern "C" bool MCC_IsGCRunning();
+// Copy the records of the last gc cycles, at most `num`, oldest first.
+extern "C" size_t MCC_GetGCEvents(GCCycleRecord* records, size_t num);
+// Write the records of the last gc cycles to `fd` as JSON lines.
+extern "C" bool MCC_DumpGCEvents(int fd);
 
 extern "C" bool MCC_StartCpuProfiling();
 extern "C" bool MCC_StopCpuProfiling(int fd);
+// `format` is a CpuProfileFormat: 0 for DevTools JSON, 1 for gzip'd pprof, 2 for collapsed stacks.
+extern "C" bool MCC_StopCpuProfilingWithFormat(int fd, int32_t format);
+// Keep the last `windowMs` of trace events in at most `bufNum` buffers of 64 KB per processor.
+extern "C" bool MCC_StartFlightRecorder(uint32_t windowMs, uint32_t bufNum);
+extern "C" bool MCC_StopFlightRecorder();
+extern "C" bool MCC_DumpFlightRecorder(int fd);
+// Convert the trace or a flight recorder dump read from `inFd` to the Chrome trace event format.
+extern "C" bool MCC_ExportChromeTrace(int inFd, int outFd);
+// Render the runtime metrics in the Prometheus text format, the result is freed by the caller.
+extern "C" char* MCC_GetMetrics();
+extern "C" bool MCC_DumpMetrics(int fd);
+// Count the objects of the heap by type, largest first. `num` is set to the number of types and the
+// result is freed by the caller.
+extern "C" HeapHistogramRecord* MCC_GetHeapHistogram(size_t* num);
+// Write the heap histogram to `fd` as a text table.
+extern "C" bool MCC_DumpHeapHistogram(int fd);
 // for general array allocation
 extern "C" ArrayRef MCC_NewArray(const TypeInfo* arrayInfo, MIndex nElems);
 
@@ -91,6 +91,189 @@ static bool GetStackGuardFlagEnv()
     return false;
 }
 
+// The busy-poll budget of fd waits is configured by 'cjBusyPoll' with a time unit, such as "50us".
+// Busy-poll is disabled by default, and the budget is capped at 1ms.
+static uint64_t GetBusyPollEnv()
+{
+    const char* env = std::getenv("cjBusyPoll");
+    if (env == nullptr) {
+        return 0;
+    }
+    constexpr uint64_t maxBusyPoll = 1000 * 1000; // 1ms
+    uint64_t busyPoll = CString::ParseTimeFromEnv(env);
+    if (busyPoll > 0 && busyPoll <= maxBusyPoll) {
+        return busyPoll;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjBusyPoll parameter. Valid cjBusyPoll range is (0ns, 1ms].\n");
+    return 0;
+}
+
+// The spin of idle processor threads before they sleep is configured by 'cjParkSpin' with a time unit,
+// such as "20us". Spinning is disabled by default, and the spin is capped at 1ms.
+static uint64_t GetParkSpinEnv()
+{
+    const char* env = std::getenv("cjParkSpin");
+    if (env == nullptr) {
+        return 0;
+    }
+    constexpr uint64_t maxParkSpin = 1000 * 1000; // 1ms
+    uint64_t parkSpin = CString::ParseTimeFromEnv(env);
+    if (parkSpin > 0 && parkSpin <= maxParkSpin) {
+        return parkSpin;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjParkSpin parameter. Valid cjParkSpin range is (0ns, 1ms].\n");
+    return 0;
+}
+
+// Stacks of pooled and long-parked cjthreads are returned to the OS when 'cjStackReclaim' is set to
+// "free" (MADV_FREE) or "dontneed" (MADV_DONTNEED). Stack reclaim is disabled by default.
+static int GetStackReclaimEnv()
+{
+    const char* env = std::getenv("cjStackReclaim");
+    if (env == nullptr) {
+        return SCHEDULE_STACK_RECLAIM_OFF;
+    }
+    CString mode = CString(env).RemoveBlankSpace();
+    mode.ToLowerCase();
+    if (mode == "free") {
+        return SCHEDULE_STACK_RECLAIM_FREE;
+    }
+    if (mode == "dontneed") {
+        return SCHEDULE_STACK_RECLAIM_DONTNEED;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjStackReclaim parameter. Should set variable to free or dontneed.\n");
+    return SCHEDULE_STACK_RECLAIM_OFF;
+}
+
+// The bytes kept at the base of a reclaimed stack are configured by 'cjStackReclaimKeep' with a size
+// unit, such as "16kb". The default is 16KB, and the size is capped at 1GB.
+static size_t GetStackReclaimKeepEnv()
+{
+    constexpr size_t defaultKeep = 16; // 16KB
+    constexpr size_t maxKeep = 1024UL * 1024; // 1GB in KB
+    const char* env = std::getenv("cjStackReclaimKeep");
+    if (env == nullptr) {
+        return defaultKeep * KB;
+    }
+    size_t keep = CString::ParseSizeFromEnv(env);
+    if (keep > 0 && keep <= maxKeep) {
+        return keep * KB;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjStackReclaimKeep parameter. Valid cjStackReclaimKeep range is (0KB, 1GB].\n");
+    return defaultKeep * KB;
+}
+
+// Processor threads are pinned to CPUs when 'cjProcessorPin' is set to 1 or true.
+static bool GetProcessorPinEnv()
+{
+    const char* env = std::getenv("cjProcessorPin");
+    if (env == nullptr) {
+        return false;
+    }
+    if (CString::ParseFlagFromEnv(env)) {
+        return true;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjProcessorPin parameter. Should set variable to 1 or true or TRUE\n");
+    return false;
+}
+
+// A waker hands its time slice to the cjthread it woke when 'cjWakeHandoff' is set to 1 or true.
+static bool GetWakeHandoffEnv()
+{
+    const char* env = std::getenv("cjWakeHandoff");
+    if (env == nullptr) {
+        return false;
+    }
+    if (CString::ParseFlagFromEnv(env)) {
+        return true;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjWakeHandoff parameter. Should set variable to 1 or true or TRUE\n");
+    return false;
+}
+
+// The schmon cycle backs off while all processors are idle when 'cjSchmonBackoff' is set to 1 or true.
+static bool GetSchmonBackoffEnv()
+{
+    const char* env = std::getenv("cjSchmonBackoff");
+    if (env == nullptr) {
+        return false;
+    }
+    if (CString::ParseFlagFromEnv(env)) {
+        return true;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjSchmonBackoff parameter. Should set variable to 1 or true or TRUE\n");
+    return false;
+}
+
+// Processors record the run-queue wait and time slice histograms from the start when
+// 'cjSchedLatencyStats' is set to 1 or true.
+static bool GetSchedLatencyStatsEnv()
+{
+    const char* env = std::getenv("cjSchedLatencyStats");
+    if (env == nullptr) {
+        return false;
+    }
+    if (CString::ParseFlagFromEnv(env)) {
+        return true;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjSchedLatencyStats parameter. Should set variable to 1 or true or TRUE\n");
+    return false;
+}
+
+// Processors allocated for the default scheduler are configured by 'cjProcessorMax'. The active processors,
+// 'cjProcessorNum' at start, can grow up to it at runtime. The valid range is (0, 2 * hardware_concurrency],
+// and a value below the processor number has no effect.
+static uint32_t GetProcessorMaxEnv()
+{
+    auto env = CString(std::getenv("cjProcessorMax"));
+    if (env.Str() == nullptr) {
+        return 0;
+    }
+    CString s = env.RemoveBlankSpace();
+    const unsigned int maxMultiple = 2;
+    if (CString::IsPosNumber(s)) {
+        uint32_t processorMax = std::strtol(s.Str(), nullptr, 0);
+        if (processorMax > 0 && processorMax <= std::thread::hardware_concurrency() * maxMultiple) {
+            return processorMax;
+        }
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjProcessorMax parameter. Valid cjProcessorMax range is"
+        "(0, 2 * hardware_concurrency].\n");
+    return 0;
+}
+
+// The active processors follow the cgroup cpu quota when 'cjProcessorQuota' is set to 1 or true.
+static bool GetProcessorQuotaEnv()
+{
+    const char* env = std::getenv("cjProcessorQuota");
+    if (env == nullptr) {
+        return false;
+    }
+    if (CString::ParseFlagFromEnv(env)) {
+        return true;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjProcessorQuota parameter. Should set variable to 1 or true or TRUE\n");
+    return false;
+}
+
+// The time slice of timer-driven preemption is configured by 'cjPreemptSlice' with a time unit, such as
+// "2ms". Preemption is driven by the schmon thread by default, and the valid slice range is [100us, 1s].
+static uint64_t GetPreemptSliceEnv()
+{
+    const char* env = std::getenv("cjPreemptSlice");
+    if (env == nullptr) {
+        return 0;
+    }
+    constexpr uint64_t minPreemptSlice = 100 * 1000; // 100us
+    constexpr uint64_t maxPreemptSlice = 1000 * 1000 * 1000; // 1s
+    uint64_t preemptSlice = CString::ParseTimeFromEnv(env);
+    if (preemptSlice >= minPreemptSlice && preemptSlice <= maxPreemptSlice) {
+        return preemptSlice;
+    }
+    LOG(RTLOG_ERROR, "Unsupported cjPreemptSlice parameter. Valid cjPreemptSlice range is [100us, 1s].\n");
+    return 0;
+}
+
 // ConcurrencyParam.processorNum set the processor number of scheduler, it is set as following ways:
 // 1. User can set the environment variable 'cjProcessorNum' firstly.
 // 2. If the variable 'cjProcessorNum' is invalid, set it by return value of hardware_concurrency().
@@ -109,6 +292,15 @@ void CJThreadModel::Init(const ConcurrencyParam param, ScheduleType scheduleType
     if (scheduleType == SCHEDULE_UI_THREAD) {
         ScheduleAttrStackGrowSet(&attr, false);
     }
+    ScheduleAttrBusyPollSet(&attr, GetBusyPollEnv());
+    ScheduleAttrPreemptSliceSet(&attr, GetPreemptSliceEnv());
+    ScheduleAttrCpuPinSet(&attr, GetProcessorPinEnv());
+    ScheduleAttrWakeHandoffSet(&attr, GetWakeHandoffEnv());
+    ScheduleAttrSchmonBackoffSet(&attr, GetSchmonBackoffEnv());
+    ScheduleAttrProcessorMaxSet(&attr, GetProcessorMaxEnv());
+    ScheduleAttrCpuQuotaSet(&attr, GetProcessorQuotaEnv());
+    ScheduleAttrParkSpinSet(&attr, GetParkSpinEnv());
+    ScheduleAttrStackReclaimSet(&attr, GetStackReclaimEnv(), GetStackReclaimKeepEnv());
 
     ScheduleGetTlsHookRegister((GetTlsHookFunc)MRT_GetThreadLocalData);
 
@@ -121,6 +313,9 @@ void CJThreadModel::Init(const ConcurrencyParam param, ScheduleType scheduleType
 #endif
     CJThreadStackReversedSet(reservedStackSize);
     scheduler = ScheduleNew(scheduleType, &attr);
+    if (scheduleType == SCHEDULE_DEFAULT && GetSchedLatencyStatsEnv()) {
+        (void)ScheduleLatencyStatsSet(true);
+    }
     Cki::CreateCKI();
 
 #if defined(CANGJIE_TSAN_SUPPORT)
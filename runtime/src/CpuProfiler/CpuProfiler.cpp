@@ -7,6 +7,8 @@
 
 #include "CpuProfiler.h"
 #include "Mutator/MutatorManager.h"
+#include "SignalSampler.h"
+#include "StackManager.h"
 
 namespace MapleRuntime {
 CpuProfiler::~CpuProfiler()
@@ -30,7 +32,7 @@ bool CpuProfiler::StartCpuProfilerForFile()
     return true;
 }
 
-bool CpuProfiler::StopCpuProfilerForFile(const int fd)
+bool CpuProfiler::StopCpuProfilerForFile(const int fd, CpuProfileFormat format)
 {
     if (!generator.GetIsStart()) {
         LOG(RTLOG_ERROR, "CpuProfiler is not in profiling");
@@ -41,6 +43,7 @@ bool CpuProfiler::StopCpuProfilerForFile(const int fd)
     if (!ret) {
         LOG(RTLOG_ERROR, "Open file failed");
     }
+    generator.SetOutputFormat(format);
     TryStopSampling();
     return ret;
 }
@@ -61,6 +64,8 @@ void CpuProfiler::SamplingThread(SamplesRecord& generator)
 {
     generator.InitProfileInfo();
     uint32_t interval = generator.GetSamplingInterval();
+    // Mutators are sampled by SIGPROF where it is supported, and otherwise stopped at their safepoints.
+    bool signalSampling = SignalSampler::GetInstance().Start(interval);
     uint64_t startTime = SamplesRecord::GetMicrosecondsTimeStamp();
     generator.SetThreadStartTime(startTime);
     uint64_t endTime = startTime;
@@ -73,10 +78,18 @@ void CpuProfiler::SamplingThread(SamplesRecord& generator)
             usleep(ts);
             endTime = SamplesRecord::GetMicrosecondsTimeStamp();
         }
-        DoSampleStack();
+        if (signalSampling) {
+            DrainSignalSamples(generator, endTime);
+        } else {
+            DoSampleStack();
+        }
         generator.ParseSampleData(endTime);
         // Save the sampling data to profileInfo.
-        generator.DoSingleTask(endTime);
+        while (generator.DoSingleTask(endTime)) {}
+    }
+    if (signalSampling) {
+        SignalSampler::GetInstance().Stop();
+        DrainSignalSamples(generator, SamplesRecord::GetMicrosecondsTimeStamp());
     }
     // Traverse the task queue until all sampling data is saved to profileInfo.
     generator.RunTaskLoop();
@@ -89,4 +102,20 @@ void CpuProfiler::DoSampleStack()
 {
     MutatorManager::Instance().TransitionAllMutatorsToCpuProfile();
 }
+
+void CpuProfiler::DrainSignalSamples(SamplesRecord& generator, uint64_t now)
+{
+    std::vector<RawSample> samples;
+    SignalSampler::GetInstance().Drain(samples);
+    for (const RawSample& sample : samples) {
+        StackManager::RecordRawSampleForCpuProfile(sample);
+    }
+    // SIGPROF only fires while the process uses cpu, an interval without samples is idle.
+    if (samples.empty()) {
+        std::vector<uint64_t> funcDescRefs;
+        std::vector<FrameType> frameTypes;
+        std::vector<uint32_t> lineNumbers;
+        generator.Post(now, 0, -1, funcDescRefs, frameTypes, lineNumbers);
+    }
+}
 }
\ No newline at end of file
@@ -20,7 +20,7 @@ public:
         return instance;
     }
     bool StartCpuProfilerForFile();
-    bool StopCpuProfilerForFile(const int fd);
+    bool StopCpuProfilerForFile(const int fd, CpuProfileFormat format = CpuProfileFormat::DEVTOOLS_JSON);
     SamplesRecord& GetGenerator() { return generator; }
     void TryStopSampling();
 
@@ -29,6 +29,7 @@ private:
     ~CpuProfiler();
     static void SamplingThread(SamplesRecord& generator);
     static void DoSampleStack();
+    static void DrainSignalSamples(SamplesRecord& generator, uint64_t now);
     SamplesRecord generator;
     std::thread tid;
 };
@@ -0,0 +1,154 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "OffCpuProfiler.h"
+
+#include "Mutator/Mutator.h"
+#include "PprofEncoder.h"
+#include "StackManager.h"
+#include "schedule.h"
+
+namespace MapleRuntime {
+int64_t OffCpuProfiler::SetThreshold(int64_t newThresholdNs)
+{
+    newThresholdNs = newThresholdNs < 0 ? -1 : newThresholdNs;
+    int64_t oldThresholdNs = thresholdNs.load(std::memory_order_relaxed);
+    if (oldThresholdNs < 0 && newThresholdNs >= 0) {
+        std::lock_guard<std::mutex> lg(recordsMutex);
+        for (auto& kindRecords : records) {
+            kindRecords.clear();
+        }
+    }
+    thresholdNs.store(newThresholdNs, std::memory_order_relaxed);
+    if (newThresholdNs < 0) {
+        CJThreadParkHookSet(nullptr, 0);
+    } else {
+        CJThreadParkHookSet(OffCpuProfiler::OnPark, static_cast<unsigned long long>(newThresholdNs));
+    }
+    return oldThresholdNs;
+}
+
+// Called by the scheduler on the cjthread, still within the park call of the park site.
+void OffCpuProfiler::OnPark(int kind, unsigned long long parkNs)
+{
+    OffCpuProfiler& profiler = GetInstance();
+    switch (kind) {
+        case CJTHREAD_PARK_SYNC:
+            profiler.Record(OffCpuProfileKind::BLOCK, REASON_SYNC, parkNs);
+            break;
+        case CJTHREAD_PARK_SLEEP:
+            profiler.Record(OffCpuProfileKind::BLOCK, REASON_SLEEP, parkNs);
+            break;
+        case CJTHREAD_PARK_NET:
+            profiler.Record(OffCpuProfileKind::IO, REASON_NET, parkNs);
+            break;
+        case CJTHREAD_PARK_FILE:
+            profiler.Record(OffCpuProfileKind::IO, REASON_FILE, parkNs);
+            break;
+        default:
+            profiler.Record(OffCpuProfileKind::BLOCK, REASON_OTHER, parkNs);
+            break;
+    }
+}
+
+void OffCpuProfiler::RecordMutexWait(uint64_t waitNs)
+{
+    int64_t currThresholdNs = thresholdNs.load(std::memory_order_relaxed);
+    if (currThresholdNs < 0 || waitNs < static_cast<uint64_t>(currThresholdNs)) {
+        return;
+    }
+    Record(OffCpuProfileKind::MUTEX, REASON_MUTEX, waitNs);
+}
+
+void OffCpuProfiler::Record(OffCpuProfileKind kind, Reason reason, uint64_t waitNs)
+{
+    if (!IsEnabled() || Mutator::GetMutator() == nullptr) {
+        return;
+    }
+    std::vector<uint64_t> frames;
+    StackManager::RecordLiteFrameInfos(frames, STACK_DEPTH);
+
+    std::lock_guard<std::mutex> lg(recordsMutex);
+    std::map<RecordKey, Blocking>& kindRecords = records[static_cast<size_t>(kind)];
+    RecordKey key(reason, std::move(frames));
+    auto it = kindRecords.find(key);
+    if (it == kindRecords.end()) {
+        if (kindRecords.size() >= MAX_STACKS) {
+            key.second.clear();
+        }
+        it = kindRecords.emplace(std::move(key), Blocking { 0, 0 }).first;
+    }
+    it->second.count++;
+    it->second.delayNs += waitNs;
+}
+
+const char* OffCpuProfiler::ReasonName(uint32_t reason)
+{
+    switch (reason) {
+        case REASON_MUTEX:
+            return "mutex";
+        case REASON_SYNC:
+            return "sync";
+        case REASON_SLEEP:
+            return "sleep";
+        case REASON_NET:
+            return "net";
+        case REASON_FILE:
+            return "file";
+        default:
+            return "other";
+    }
+}
+
+bool OffCpuProfiler::Dump(int fd, OffCpuProfileKind kind)
+{
+    if (fd < 0 || kind >= OffCpuProfileKind::KIND_NUM || kind < OffCpuProfileKind::MUTEX) {
+        return false;
+    }
+    // Symbols are resolved out of the lock, so that parking cjthreads do not wait for them.
+    std::map<RecordKey, Blocking> kindRecords;
+    {
+        std::lock_guard<std::mutex> lg(recordsMutex);
+        kindRecords = records[static_cast<size_t>(kind)];
+    }
+    PprofEncoder encoder;
+    encoder.AddSampleType("contentions", "count");
+    encoder.AddSampleType("delay", "nanoseconds");
+    encoder.SetPeriod("contentions", "count", 1);
+
+    constexpr size_t liteFrameInfoElementSize = 3; // {ip, startPC, funcDesc} per frame
+    std::map<uint64_t, uint64_t> locationIds;
+    std::map<std::pair<CString, CString>, uint64_t> functionIds;
+    std::vector<uint64_t> stack;
+    for (const auto& record : kindRecords) {
+        const std::vector<uint64_t>& frames = record.first.second;
+        stack.clear();
+        for (size_t i = 0; i + liteFrameInfoElementSize <= frames.size(); i += liteFrameInfoElementSize) {
+            auto location = locationIds.find(frames[i]);
+            if (location != locationIds.end()) {
+                stack.push_back(location->second);
+                continue;
+            }
+            StackTraceElement ste;
+            StackManager::GetStackTraceByLiteFrameInfo(frames[i], frames[i + 1], frames[i + 2], ste);
+            CString name = ste.className.Length() > 0 ? ste.className + "." + ste.methodName : ste.methodName;
+            auto key = std::make_pair(name, ste.fileName);
+            auto function = functionIds.find(key);
+            if (function == functionIds.end()) {
+                function = functionIds.emplace(key, encoder.AddFunction(name, ste.fileName)).first;
+            }
+            uint64_t locationId = encoder.AddLocation(function->second, ste.lineNumber);
+            locationIds.emplace(frames[i], locationId);
+            stack.push_back(locationId);
+        }
+        encoder.AddSample(stack,
+                          { static_cast<int64_t>(record.second.count), static_cast<int64_t>(record.second.delayNs) },
+                          { { "reason", ReasonName(record.first.first), 0 } });
+    }
+    return encoder.WriteGzip(fd);
+}
+} // namespace MapleRuntime
@@ -0,0 +1,73 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_OFF_CPU_PROFILER_H
+#define MRT_OFF_CPU_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace MapleRuntime {
+// Profiles of the time cjthreads spend off cpu, named after the pprof profiles they are written as.
+enum class OffCpuProfileKind : int32_t {
+    MUTEX = 0, // waits for contended mutexes
+    BLOCK = 1, // parks on waitqueues, semaphores and sleeps, mutex waits included
+    IO = 2,    // parks for fd events and file io
+    KIND_NUM = 3,
+};
+
+// Records the park site stack of every cjthread that stays off cpu for at least a threshold, with
+// what it waited for and for how long.
+class OffCpuProfiler {
+public:
+    static OffCpuProfiler& GetInstance()
+    {
+        static OffCpuProfiler instance;
+        return instance;
+    }
+
+    // A negative threshold disables the profiles. Turning them on drops the records of the previous
+    // run. Returns the previous threshold.
+    int64_t SetThreshold(int64_t newThresholdNs);
+    bool IsEnabled() const { return thresholdNs.load(std::memory_order_relaxed) >= 0; }
+
+    // Called by a mutator that acquired a mutex after waiting `waitNs` for it.
+    void RecordMutexWait(uint64_t waitNs);
+
+    // Write the records of `kind` to `fd` as a gzip'd pprof profile.
+    bool Dump(int fd, OffCpuProfileKind kind);
+
+private:
+    // What the cjthread waited for, a label of the samples.
+    enum Reason : uint32_t { REASON_MUTEX, REASON_SYNC, REASON_SLEEP, REASON_OTHER, REASON_NET, REASON_FILE };
+
+    struct Blocking {
+        uint64_t count;
+        uint64_t delayNs;
+    };
+
+    // Keyed by the reason and the lite frame infos of the park site, see `StackManager::RecordLiteFrameInfos`.
+    using RecordKey = std::pair<uint32_t, std::vector<uint64_t>>;
+
+    OffCpuProfiler() = default;
+    ~OffCpuProfiler() = default;
+    static void OnPark(int kind, unsigned long long parkNs);
+    void Record(OffCpuProfileKind kind, Reason reason, uint64_t waitNs);
+    static const char* ReasonName(uint32_t reason);
+
+    static constexpr size_t MAX_STACKS = 4096; // park sites beyond it are counted as one with no stack
+    static constexpr size_t STACK_DEPTH = 32;
+    std::atomic<int64_t> thresholdNs { -1 };
+    std::mutex recordsMutex;
+    std::map<RecordKey, Blocking> records[static_cast<size_t>(OffCpuProfileKind::KIND_NUM)];
+};
+} // namespace MapleRuntime
+#endif // MRT_OFF_CPU_PROFILER_H
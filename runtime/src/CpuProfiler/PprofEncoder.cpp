@@ -0,0 +1,234 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "PprofEncoder.h"
+#include <algorithm>
+#include <array>
+
+#include "Base/Log.h"
+#include "Base/SysCall.h"
+
+namespace MapleRuntime {
+namespace {
+// Field numbers of profile.proto.
+constexpr uint32_t PROFILE_SAMPLE_TYPE = 1;
+constexpr uint32_t PROFILE_SAMPLE = 2;
+constexpr uint32_t PROFILE_LOCATION = 4;
+constexpr uint32_t PROFILE_FUNCTION = 5;
+constexpr uint32_t PROFILE_STRING_TABLE = 6;
+constexpr uint32_t PROFILE_TIME_NANOS = 9;
+constexpr uint32_t PROFILE_DURATION_NANOS = 10;
+constexpr uint32_t PROFILE_PERIOD_TYPE = 11;
+constexpr uint32_t PROFILE_PERIOD = 12;
+constexpr uint32_t VALUE_TYPE_TYPE = 1;
+constexpr uint32_t VALUE_TYPE_UNIT = 2;
+constexpr uint32_t SAMPLE_LOCATION_ID = 1;
+constexpr uint32_t SAMPLE_VALUE = 2;
+constexpr uint32_t SAMPLE_LABEL = 3;
+constexpr uint32_t LABEL_KEY = 1;
+constexpr uint32_t LABEL_STR = 2;
+constexpr uint32_t LABEL_NUM = 3;
+constexpr uint32_t LOCATION_ID = 1;
+constexpr uint32_t LOCATION_LINE = 4;
+constexpr uint32_t LINE_FUNCTION_ID = 1;
+constexpr uint32_t LINE_LINE = 2;
+constexpr uint32_t FUNCTION_ID = 1;
+constexpr uint32_t FUNCTION_NAME = 2;
+constexpr uint32_t FUNCTION_SYSTEM_NAME = 3;
+constexpr uint32_t FUNCTION_FILENAME = 4;
+
+constexpr uint32_t WIRE_VARINT = 0;
+constexpr uint32_t WIRE_LEN = 2;
+
+std::array<uint32_t, 256> MakeCrc32Table() // 256: one entry per byte value
+{
+    constexpr uint32_t polynomial = 0xEDB88320;
+    std::array<uint32_t, 256> table; // 256: one entry per byte value
+    for (uint32_t i = 0; i < table.size(); ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) { // 8: bits per byte
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ polynomial : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size)
+{
+    static const std::array<uint32_t, 256> table = MakeCrc32Table(); // 256: one entry per byte value
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8); // 8: bits per byte
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+void PutLE32(std::vector<uint8_t>& buf, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) { // 4: bytes of uint32_t
+        buf.push_back(static_cast<uint8_t>(value >> (i * 8))); // 8: bits per byte
+    }
+}
+} // namespace
+
+uint64_t PprofEncoder::StringId(const CString& str)
+{
+    auto it = stringIds.find(str);
+    if (it != stringIds.end()) {
+        return it->second;
+    }
+    uint64_t id = strings.size();
+    strings.push_back(str);
+    stringIds.emplace(str, id);
+    return id;
+}
+
+void PprofEncoder::PutVarint(Buffer& buf, uint64_t value)
+{
+    constexpr uint64_t lowBits = 0x7F;
+    constexpr uint8_t moreBit = 0x80;
+    while (value > lowBits) {
+        buf.push_back(static_cast<uint8_t>(value & lowBits) | moreBit);
+        value >>= 7; // 7: payload bits per byte
+    }
+    buf.push_back(static_cast<uint8_t>(value));
+}
+
+void PprofEncoder::PutTag(Buffer& buf, uint32_t field, uint32_t wireType)
+{
+    PutVarint(buf, (static_cast<uint64_t>(field) << 3) | wireType); // 3: bits of the wire type
+}
+
+void PprofEncoder::PutUint(Buffer& buf, uint32_t field, uint64_t value)
+{
+    PutTag(buf, field, WIRE_VARINT);
+    PutVarint(buf, value);
+}
+
+void PprofEncoder::PutBytes(Buffer& buf, uint32_t field, const uint8_t* data, size_t size)
+{
+    PutTag(buf, field, WIRE_LEN);
+    PutVarint(buf, size);
+    buf.insert(buf.end(), data, data + size);
+}
+
+void PprofEncoder::PutMessage(Buffer& buf, uint32_t field, const Buffer& message)
+{
+    PutBytes(buf, field, message.data(), message.size());
+}
+
+void PprofEncoder::AddSampleType(const char* type, const char* unit)
+{
+    Buffer valueType;
+    PutUint(valueType, VALUE_TYPE_TYPE, StringId(type));
+    PutUint(valueType, VALUE_TYPE_UNIT, StringId(unit));
+    PutMessage(body, PROFILE_SAMPLE_TYPE, valueType);
+}
+
+void PprofEncoder::SetPeriod(const char* type, const char* unit, int64_t period)
+{
+    Buffer valueType;
+    PutUint(valueType, VALUE_TYPE_TYPE, StringId(type));
+    PutUint(valueType, VALUE_TYPE_UNIT, StringId(unit));
+    PutMessage(body, PROFILE_PERIOD_TYPE, valueType);
+    PutUint(body, PROFILE_PERIOD, static_cast<uint64_t>(period));
+}
+
+void PprofEncoder::SetTime(int64_t timeNanos, int64_t durationNanos)
+{
+    PutUint(body, PROFILE_TIME_NANOS, static_cast<uint64_t>(timeNanos));
+    PutUint(body, PROFILE_DURATION_NANOS, static_cast<uint64_t>(durationNanos));
+}
+
+uint64_t PprofEncoder::AddFunction(const CString& name, const CString& systemName, const CString& fileName)
+{
+    uint64_t id = ++functionCount;
+    Buffer function;
+    PutUint(function, FUNCTION_ID, id);
+    PutUint(function, FUNCTION_NAME, StringId(name));
+    PutUint(function, FUNCTION_SYSTEM_NAME, StringId(systemName));
+    PutUint(function, FUNCTION_FILENAME, StringId(fileName));
+    PutMessage(body, PROFILE_FUNCTION, function);
+    return id;
+}
+
+uint64_t PprofEncoder::AddLocation(uint64_t functionId, int64_t line)
+{
+    uint64_t id = ++locationCount;
+    Buffer lineMessage;
+    PutUint(lineMessage, LINE_FUNCTION_ID, functionId);
+    PutUint(lineMessage, LINE_LINE, static_cast<uint64_t>(line));
+    Buffer location;
+    PutUint(location, LOCATION_ID, id);
+    PutMessage(location, LOCATION_LINE, lineMessage);
+    PutMessage(body, PROFILE_LOCATION, location);
+    return id;
+}
+
+void PprofEncoder::AddSample(const std::vector<uint64_t>& locationIds, const std::vector<int64_t>& values,
+                             const std::vector<Label>& labels)
+{
+    Buffer sample;
+    Buffer packed;
+    for (uint64_t id : locationIds) {
+        PutVarint(packed, id);
+    }
+    PutMessage(sample, SAMPLE_LOCATION_ID, packed);
+    packed.clear();
+    for (int64_t value : values) {
+        PutVarint(packed, static_cast<uint64_t>(value));
+    }
+    PutMessage(sample, SAMPLE_VALUE, packed);
+    for (const Label& label : labels) {
+        Buffer labelMessage;
+        PutUint(labelMessage, LABEL_KEY, StringId(label.key));
+        if (label.str != nullptr) {
+            PutUint(labelMessage, LABEL_STR, StringId(label.str));
+        } else {
+            PutUint(labelMessage, LABEL_NUM, static_cast<uint64_t>(label.num));
+        }
+        PutMessage(sample, SAMPLE_LABEL, labelMessage);
+    }
+    PutMessage(body, PROFILE_SAMPLE, sample);
+}
+
+// The runtime does not link a compressor, so the deflate stream is made of stored blocks. It is
+// still the gzip file that pprof tools expect.
+void PprofEncoder::Gzip(const Buffer& in, Buffer& out)
+{
+    constexpr size_t maxStoredBlock = 0xFFFF;
+    const uint8_t header[] = { 0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF };
+    out.reserve(in.size() + in.size() / maxStoredBlock * 5 + 32); // 5: block header, 32: gzip framing
+    out.insert(out.end(), header, header + sizeof(header));
+    size_t offset = 0;
+    do {
+        size_t len = std::min(in.size() - offset, maxStoredBlock);
+        bool final = offset + len == in.size();
+        out.push_back(final ? 1 : 0);
+        out.push_back(static_cast<uint8_t>(len & 0xFF));
+        out.push_back(static_cast<uint8_t>(len >> 8)); // 8: bits per byte
+        out.push_back(static_cast<uint8_t>(~len & 0xFF));
+        out.push_back(static_cast<uint8_t>((~len >> 8) & 0xFF)); // 8: bits per byte
+        out.insert(out.end(), in.begin() + offset, in.begin() + offset + len);
+        offset += len;
+    } while (offset < in.size());
+    PutLE32(out, Crc32(in.data(), in.size()));
+    PutLE32(out, static_cast<uint32_t>(in.size()));
+}
+
+bool PprofEncoder::WriteGzip(int fd)
+{
+    Buffer profile(body);
+    for (const CString& str : strings) {
+        PutBytes(profile, PROFILE_STRING_TABLE, reinterpret_cast<const uint8_t*>(str.Str()), str.Length());
+    }
+    Buffer out;
+    Gzip(profile, out);
+    return WriteAll(fd, out.data(), out.size());
+}
+} // namespace MapleRuntime
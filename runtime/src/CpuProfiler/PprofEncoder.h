@@ -0,0 +1,65 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_PPROF_ENCODER_H
+#define MRT_PPROF_ENCODER_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "Base/CString.h"
+
+namespace MapleRuntime {
+// Encodes a profile in the protobuf format of pprof (profile.proto). Functions, locations and samples
+// are encoded as they are added, strings are interned and written last.
+class PprofEncoder {
+public:
+    struct Label {
+        const char* key;
+        const char* str;  // nullptr for a numeric label
+        int64_t num;
+    };
+
+    PprofEncoder() { (void)StringId(""); }
+    ~PprofEncoder() = default;
+
+    // Sample types are in the order of the values of every sample.
+    void AddSampleType(const char* type, const char* unit);
+    void SetPeriod(const char* type, const char* unit, int64_t period);
+    void SetTime(int64_t timeNanos, int64_t durationNanos);
+
+    uint64_t AddFunction(const CString& name, const CString& fileName) { return AddFunction(name, name, fileName); }
+    // `systemName` tells apart functions of the same name, pprof shows it with `-symbolize=none` or `-raw`.
+    uint64_t AddFunction(const CString& name, const CString& systemName, const CString& fileName);
+    uint64_t AddLocation(uint64_t functionId, int64_t line);
+    // Locations are leaf first.
+    void AddSample(const std::vector<uint64_t>& locationIds, const std::vector<int64_t>& values,
+                   const std::vector<Label>& labels);
+
+    // Write the profile to `fd` gzip'd, which is how pprof stores it.
+    bool WriteGzip(int fd);
+
+private:
+    using Buffer = std::vector<uint8_t>;
+
+    uint64_t StringId(const CString& str);
+    static void PutVarint(Buffer& buf, uint64_t value);
+    static void PutTag(Buffer& buf, uint32_t field, uint32_t wireType);
+    static void PutUint(Buffer& buf, uint32_t field, uint64_t value);
+    static void PutBytes(Buffer& buf, uint32_t field, const uint8_t* data, size_t size);
+    static void PutMessage(Buffer& buf, uint32_t field, const Buffer& message);
+    static void Gzip(const Buffer& in, Buffer& out);
+
+    Buffer body;
+    uint64_t functionCount { 0 };
+    uint64_t locationCount { 0 };
+    std::map<CString, uint64_t> stringIds;
+    std::vector<CString> strings;
+};
+} // namespace MapleRuntime
+#endif // MRT_PPROF_ENCODER_H
@@ -7,9 +7,12 @@
 
 #include "SamplesRecord.h"
 #include <algorithm>
+#include <tuple>
 #include "ObjectModel/MFuncdesc.inline.h"
 #include "UnwindStack/MangleNameHelper.h"
+#include "Base/SysCall.h"
 #include "Base/TimeUtils.h"
+#include "PprofEncoder.h"
 
 namespace MapleRuntime {
 constexpr int TIME_USEC_PER_SEC = 1000 * 1000;
@@ -156,6 +159,11 @@ void SamplesRecord::AddTimeDelta(ProfileInfo* info, int timeDelta)
     info->timeDeltas.emplace_back(timeDelta);
 }
 
+void SamplesRecord::AddSampleLabel(ProfileInfo* info, uint64_t cjthreadId, int processorId)
+{
+    info->sampleLabels.push_back(SampleLabel { cjthreadId, processorId });
+}
+
 void SamplesRecord::SetPreviousTimeStamp(ProfileInfo* info, uint64_t timeStamp)
 {
     info->previousTimeStamp = timeStamp;
@@ -204,6 +212,8 @@ void SamplesRecord::AddSample(SampleTask& task)
 
     AddTimeDelta(info, timeDelta);
 
+    AddSampleLabel(info, task.mutatorId, task.processorId);
+
     SetPreviousTimeStamp(info, task.timeStamp);
 }
 
@@ -225,6 +235,8 @@ void SamplesRecord::AddEmptySample(SampleTask& task)
 
     AddTimeDelta(info, timeDelta);
 
+    AddSampleLabel(info, task.mutatorId, task.processorId);
+
     SetPreviousTimeStamp(info, task.timeStamp);
 }
 
@@ -277,17 +289,14 @@ void SamplesRecord::StringifyNodes(ProfileInfo* info)
         sampleData.Append(CString::FormatString("\",\"lineNumber\":%d},", codeEntry.lineNumber));
         sampleData.Append(CString::FormatString("\"hitCount\":%d,\"children\":[", node.hitCount));
 
-        std::vector<uint64_t> children = node.children;
+        // Separators are put before the items, trimming the last one would copy the whole data per node.
+        std::vector<uint64_t>& children = node.children;
         size_t childrenCount = children.size();
         for (size_t j = 0; j < childrenCount; j++) {
-            sampleData.Append(CString::FormatString("%d,", children[j]));
-        }
-        if (childrenCount > 0) {
-            sampleData = sampleData.SubStr(0, sampleData.Length() - 1);
+            sampleData.Append(CString::FormatString(j == 0 ? "%d" : ",%d", children[j]));
         }
-        sampleData += "]},";
+        sampleData += i + 1 < nodeCount ? "]}," : "]}";
     }
-    sampleData = sampleData.SubStr(0, sampleData.Length() - 1);
     sampleData += "],";
 }
 
@@ -320,8 +329,139 @@ void SamplesRecord::StringifySamples(ProfileInfo* info)
 
 void SamplesRecord::DumpProfileInfo()
 {
-    StringifySampleData(profileInfo);
-    WriteFile();
+    switch (outputFormat) {
+        case CpuProfileFormat::PPROF:
+            DumpPprof(profileInfo);
+            break;
+        case CpuProfileFormat::COLLAPSED:
+            DumpCollapsedStacks(profileInfo);
+            break;
+        default:
+            StringifySampleData(profileInfo);
+            WriteFile();
+            break;
+    }
+}
+
+static const char* FrameTypeName(FrameType frameType)
+{
+    switch (frameType) {
+        case FrameType::MANAGED:
+            return "managed";
+        case FrameType::N2C_STUB:
+            return "n2c_stub";
+        case FrameType::C2N_STUB:
+            return "c2n_stub";
+        case FrameType::RUNTIME:
+            return "runtime";
+        case FrameType::SAFEPOINT:
+            return "safepoint";
+        case FrameType::C2R_STUB:
+            return "c2r_stub";
+        case FrameType::NATIVE:
+            return "native";
+        case FrameType::STACKGROW:
+            return "stackgrow";
+        case FrameType::EXSLUSIVE:
+            return "exclusive";
+        default:
+            return "unknown";
+    }
+}
+
+void SamplesRecord::DumpPprof(ProfileInfo* info)
+{
+    PprofEncoder encoder;
+    encoder.AddSampleType("samples", "count");
+    encoder.AddSampleType("cpu", "nanoseconds");
+    int64_t period = static_cast<int64_t>(interval) * TIME_NSEC_PER_USEC;
+    encoder.SetPeriod("cpu", "nanoseconds", period);
+    // pprof wants the wall clock time the profile started at, the samples are in monotonic time.
+    struct timespec realTime;
+    clock_gettime(CLOCK_REALTIME, &realTime);
+    int64_t realNow = static_cast<int64_t>(realTime.tv_sec) * TIME_USEC_PER_SEC + realTime.tv_nsec / TIME_NSEC_PER_USEC;
+    int64_t elapsed = static_cast<int64_t>(GetMicrosecondsTimeStamp() - info->startTime);
+    encoder.SetTime((realNow - elapsed) * TIME_NSEC_PER_USEC,
+                    static_cast<int64_t>(info->stopTime - info->startTime) * TIME_NSEC_PER_USEC);
+
+    // Nodes of the caller tree are locations. They are encoded once, and so are the functions they
+    // share, so the names resolved while sampling are not looked up again. The type of every frame
+    // is kept in the system name of its function, e.g. "native:memcpy".
+    std::map<std::tuple<uint64_t, CString, FrameType>, uint64_t> functionIds;
+    std::vector<uint64_t> locationIds(info->nodeCount, 0);
+    auto getLocation = [&](uint64_t nodeId) {
+        uint64_t& locationId = locationIds[nodeId - 1];
+        if (locationId == 0) {
+            const CodeInfo& code = info->nodes[nodeId - 1].codeEntry;
+            auto key = std::make_tuple(code.funcIdentifier, code.functionName, code.frameType);
+            auto it = functionIds.find(key);
+            if (it == functionIds.end()) {
+                CString systemName(FrameTypeName(code.frameType));
+                systemName.Append(":");
+                systemName.Append(code.functionName);
+                it = functionIds.emplace(key, encoder.AddFunction(code.functionName, systemName, code.url)).first;
+            }
+            locationId = encoder.AddLocation(it->second, code.lineNumber);
+        }
+        return locationId;
+    };
+
+    // Samples of one node with the same labels are merged. Every sample stands for one sampling
+    // interval of CPU time, the time deltas between samples also count the time the thread was off CPU.
+    using SampleKey = std::tuple<int, uint64_t, int>;
+    std::map<SampleKey, int64_t> merged;
+    for (size_t i = 0; i < info->samples.size() && i < info->sampleLabels.size(); ++i) {
+        const SampleLabel& label = info->sampleLabels[i];
+        merged[SampleKey(info->samples[i], label.cjthreadId, label.processorId)]++;
+    }
+    std::vector<uint64_t> stack;
+    std::vector<PprofEncoder::Label> labels;
+    for (const auto& sample : merged) {
+        stack.clear();
+        uint64_t nodeId = static_cast<uint64_t>(std::get<0>(sample.first));
+        while (nodeId != UNKNOWN_NODE_ID && nodeId <= info->nodeCount) {
+            if (nodeId != ROOT_NODE_ID || stack.empty()) {
+                stack.push_back(getLocation(nodeId));
+            }
+            nodeId = info->nodes[nodeId - 1].parentId;
+        }
+        labels.clear();
+        if (std::get<1>(sample.first) != 0) {
+            labels.push_back({ "cjthread_id", nullptr, static_cast<int64_t>(std::get<1>(sample.first)) });
+        }
+        if (std::get<2>(sample.first) >= 0) {
+            labels.push_back({ "processor_id", nullptr, std::get<2>(sample.first) });
+        }
+        encoder.AddSample(stack, { sample.second, sample.second * period }, labels);
+    }
+    (void)encoder.WriteGzip(fileDesc);
+}
+
+void SamplesRecord::DumpCollapsedStacks(ProfileInfo* info)
+{
+    std::map<int, uint64_t> counts;
+    for (int nodeId : info->samples) {
+        counts[nodeId]++;
+    }
+    CString out;
+    std::vector<const CString*> names;
+    for (const auto& count : counts) {
+        names.clear();
+        uint64_t nodeId = static_cast<uint64_t>(count.first);
+        while (nodeId != UNKNOWN_NODE_ID && nodeId != ROOT_NODE_ID && nodeId <= info->nodeCount) {
+            names.push_back(&info->nodes[nodeId - 1].codeEntry.functionName);
+            nodeId = info->nodes[nodeId - 1].parentId;
+        }
+        if (names.empty()) {
+            continue;
+        }
+        for (auto it = names.rbegin(); it != names.rend(); ++it) {
+            out.Append(**it);
+            out.Append(it + 1 == names.rend() ? " " : ";");
+        }
+        out.Append(CString::FormatString("%llu\n", static_cast<unsigned long long>(count.second)));
+    }
+    (void)WriteAll(fileDesc, out.Str(), out.Length());
 }
 
 bool SamplesRecord::OpenFile(int fd)
@@ -358,17 +498,17 @@ void SamplesRecord::RunTaskLoop()
     }
 }
 
-void SamplesRecord::DoSingleTask(uint64_t previousTimeStemp)
+bool SamplesRecord::DoSingleTask(uint64_t previousTimeStemp)
 {
     if (IsTimeout(previousTimeStemp)) {
-        return;
+        return false;
     }
     if (taskQueue.empty()) {
-        return;
+        return false;
     }
     auto task = taskQueue.front();
     if (!task.finishParsed) {
-        return;
+        return false;
     }
     taskQueue.pop_front();
     if (task.frameCnt == 0) {
@@ -376,6 +516,7 @@ void SamplesRecord::DoSingleTask(uint64_t previousTimeStemp)
     } else {
         AddSample(task);
     }
+    return true;
 }
 
 void SamplesRecord::ParseSampleData(uint64_t previousTimeStemp)
@@ -415,8 +556,14 @@ bool SamplesRecord::IsTimeout(uint64_t previousTimeStemp)
 void SamplesRecord::Post(uint64_t mutatorId, std::vector<uint64_t>& FuncDescRefs,
                          std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers)
 {
-    uint64_t timeStamp = SamplesRecord::GetMicrosecondsTimeStamp();
+    Post(SamplesRecord::GetMicrosecondsTimeStamp(), mutatorId, -1, FuncDescRefs, FrameTypes, LineNumbers);
+}
+
+void SamplesRecord::Post(uint64_t timeStamp, uint64_t mutatorId, int processorId, std::vector<uint64_t>& FuncDescRefs,
+                         std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers)
+{
     SampleTask task(timeStamp, mutatorId, FuncDescRefs, FrameTypes, LineNumbers);
+    task.processorId = processorId;
     taskQueue.push_back(task);
 }
 
@@ -438,8 +585,9 @@ std::vector<CodeInfo> SamplesRecord::GetCodeInfos(SampleTask& task)
 
 CString SamplesRecord::GetUrl(uint64_t funcIdentifier)
 {
-    if (identifierUrlMap.find(funcIdentifier) != identifierUrlMap.end()) {
-        return identifierUrlMap[funcIdentifier];
+    auto it = identifierUrlMap.find(funcIdentifier);
+    if (it != identifierUrlMap.end()) {
+        return it->second;
     }
     return ParseUrl(funcIdentifier);
 }
@@ -456,13 +604,14 @@ CString SamplesRecord::ParseUrl(uint64_t funcIdentifier)
 #endif
     CString url =  path.IsEmpty() ? fileName : path + slash + fileName;
     identifierUrlMap.emplace(funcIdentifier, url);
-    return fileName;
+    return url;
 }
 
 CString SamplesRecord::GetDemangleName(uint64_t funcIdentifier)
 {
-    if (identifierFuncnameMap.find(funcIdentifier) != identifierFuncnameMap.end()) {
-        return identifierFuncnameMap[funcIdentifier];
+    auto it = identifierFuncnameMap.find(funcIdentifier);
+    if (it != identifierFuncnameMap.end()) {
+        return it->second;
     }
     return ParseDemangleName(funcIdentifier);
 }
@@ -22,6 +22,13 @@ constexpr int ROOT_NODE_ID = 1;         // 1: the (root) node id
 constexpr int PROGRAM_NODE_ID = 2;      // 2: the (program) node id
 constexpr int IDLE_NODE_ID = 3;         // 3: the (idel) node id
 
+// Format of the profile written when the profiler stops.
+enum class CpuProfileFormat : int32_t {
+    DEVTOOLS_JSON = 0, // the .cpuprofile of Chrome DevTools
+    PPROF = 1,         // gzip'd protobuf of pprof
+    COLLAPSED = 2,     // collapsed stacks, one "root;...;leaf count" line per stack, as read by flamegraph.pl
+};
+
 struct CodeInfo {
     uint64_t funcIdentifier = 0;
     uint64_t scriptId = 0;
@@ -54,6 +61,11 @@ struct CpuProfileNode {
     }
 };
 
+struct SampleLabel {
+    uint64_t cjthreadId = 0;
+    int processorId = -1;
+};
+
 struct ProfileInfo {
     uint64_t mutatorId = 0;
     uint64_t startTime = 0;
@@ -63,6 +75,7 @@ struct ProfileInfo {
     CpuProfileNode nodes[MAX_NODE_COUNT];
     std::vector<int> samples;
     std::vector<int> timeDeltas;
+    std::vector<SampleLabel> sampleLabels;
 
     std::set<CpuProfileNode> nodeSet;
     uint64_t previousTimeStamp = 0;
@@ -86,6 +99,7 @@ public:
     std::vector<FrameType> frameTypes;
     std::vector<uint32_t> lineNumbers;
     uint64_t frameCnt;
+    int processorId {-1};
     bool finishParsed {false};
     int checkPoint {0};
 };
@@ -105,13 +119,16 @@ public:
     void StringifySampleData(ProfileInfo* info);
     void DumpProfileInfo();
     void RunTaskLoop();
-    void DoSingleTask(uint64_t previousTimeStemp);
+    bool DoSingleTask(uint64_t previousTimeStemp);
     void ParseSampleData(uint64_t previousTimeStemp);
     void Post(uint64_t mutatorId, std::vector<uint64_t>& FuncDescRefs,
             std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers);
+    void Post(uint64_t timeStamp, uint64_t mutatorId, int processorId, std::vector<uint64_t>& FuncDescRefs,
+            std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers);
     std::vector<CodeInfo> BuildCodeInfos(SampleTask* task);
     int GetSamplingInterval() { return interval; }
     bool OpenFile(int fd);
+    void SetOutputFormat(CpuProfileFormat format) { outputFormat = format; }
     static uint64_t GetMicrosecondsTimeStamp();
 
 private:
@@ -137,6 +154,9 @@ private:
     CString GetDemangleName(uint64_t funcIdentifier);
     CString ParseDemangleName(uint64_t funcIdentifier);
     void WriteFile();
+    void DumpPprof(ProfileInfo* info);
+    void DumpCollapsedStacks(ProfileInfo* info);
+    void AddSampleLabel(ProfileInfo* info, uint64_t cjthreadId, int processorId);
     bool IsTimeout(uint64_t previousTimeStemp);
     ProfileInfo* GetProfileInfo(uint64_t mutatorId);
 
@@ -150,6 +170,7 @@ private:
     int interval {500}; // 500 : default interval 500us
     std::map<uint64_t, CString> identifierFuncnameMap;
     std::map<uint64_t, CString> identifierUrlMap;
+    CpuProfileFormat outputFormat {CpuProfileFormat::DEVTOOLS_JSON};
 };
 } // namespace MapleRuntime
 #endif // MRT_SAMPLES_RECORD_H
\ No newline at end of file
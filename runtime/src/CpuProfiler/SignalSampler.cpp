@@ -0,0 +1,235 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "SignalSampler.h"
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "Base/Log.h"
+#include "Common/StackType.h"
+#include "Mutator/Mutator.h"
+#include "Mutator/ThreadLocal.h"
+#include "Signal/SignalStack.h"
+#include "Signal/SignalUtils.h"
+#include "SignalManager.h"
+#include "schedule.h"
+
+namespace MapleRuntime {
+#ifdef SIGNAL_SAMPLER_SUPPORTED
+// Ring of the current thread, claimed by its first sample.
+static __thread void* g_sampleRing __attribute__((tls_model("initial-exec"))) = nullptr;
+
+static bool SetProfTimer(uint32_t intervalUs)
+{
+    constexpr uint32_t usPerSec = 1000 * 1000;
+    struct itimerval spec;
+    spec.it_interval.tv_sec = static_cast<time_t>(intervalUs / usPerSec);
+    spec.it_interval.tv_usec = static_cast<suseconds_t>(intervalUs % usPerSec);
+    spec.it_value = spec.it_interval;
+    return setitimer(ITIMER_PROF, &spec, nullptr) == 0;
+}
+
+static bool ThreadExited(int tid)
+{
+    return syscall(SYS_tgkill, getpid(), tid, 0) != 0 && errno == ESRCH;
+}
+#endif
+
+bool SignalSampler::Start(uint32_t intervalUs)
+{
+#ifdef SIGNAL_SAMPLER_SUPPORTED
+    if (intervalUs == 0) {
+        return false;
+    }
+    // The handler runs synchronously on the interrupted thread, which is the one the sample is for.
+    if (!installed) {
+        SignalAction action;
+        sigemptyset(&action.scMask);
+        action.saSignalAction = SignalSampler::Handler;
+        action.scFlags = SA_SIGINFO | SA_ONSTACK | SIGNAL_STACK_SYNC;
+        SignalManager::AddHandlerToSignalStack(SIGPROF, &action);
+        installed = true;
+    }
+    sampling.store(true, std::memory_order_relaxed);
+    if (!SetProfTimer(intervalUs)) {
+        LOG(RTLOG_ERROR, "Set profiling timer failed, errno: %d", errno);
+        sampling.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+#else
+    (void)intervalUs;
+    return false;
+#endif
+}
+
+void SignalSampler::Stop()
+{
+#ifdef SIGNAL_SAMPLER_SUPPORTED
+    if (!sampling.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // The timer is disarmed first, so that no SIGPROF is raised once the handler is gone.
+    (void)SetProfTimer(0);
+    sampling.store(false, std::memory_order_relaxed);
+    // A SIGPROF raised before the timer stopped may still be pending, and without the handler it
+    // would take the default action and end the process. The handler stays if it does not land.
+    constexpr int pendingWaitRetry = 100;
+    constexpr useconds_t pendingWaitUs = 100;
+    for (int i = 0; i < pendingWaitRetry; ++i) {
+        sigset_t pending;
+        if (sigpending(&pending) == 0 && sigismember(&pending, SIGPROF) == 0) {
+            // Returns once no thread runs the handler, the rings are then left to `Drain` only.
+            SignalManager::RemoveHandlerFromSignalStack(SIGPROF, SignalSampler::Handler);
+            installed = false;
+            return;
+        }
+        (void)usleep(pendingWaitUs);
+    }
+    LOG(RTLOG_ERROR, "SIGPROF is still pending, the sampling handler is kept");
+#endif
+}
+
+void SignalSampler::Drain(std::vector<RawSample>& samples)
+{
+    size_t start = samples.size();
+    for (uint32_t i = 0; i < RING_NUM; ++i) {
+        SampleRing& ring = rings[i];
+        int owner = ring.owner.load(std::memory_order_acquire);
+        if (owner == 0) {
+            continue;
+        }
+#ifdef SIGNAL_SAMPLER_SUPPORTED
+        // Checked before the drain, so that the last samples of the thread are taken too.
+        bool exited = ThreadExited(owner);
+#else
+        bool exited = false;
+#endif
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            samples.push_back(ring.slots[tail % RING_SIZE]);
+        }
+        ring.tail.store(tail, std::memory_order_release);
+        if (exited) {
+            ring.owner.store(0, std::memory_order_release);
+        }
+    }
+    std::sort(samples.begin() + start, samples.end(),
+              [](const RawSample& a, const RawSample& b) { return a.timeStamp < b.timeStamp; });
+}
+
+#ifdef SIGNAL_SAMPLER_SUPPORTED
+// Runs on the interrupted thread from the signal stack and must stay async-signal-safe. Returns
+// false for SIGPROF sent by kill or sigqueue, which belongs to the next handler of the stack.
+bool SignalSampler::Handler(int sig, siginfo_t* info, void* context)
+{
+    (void)sig;
+    if (info == nullptr || info->si_code <= 0) {
+        return false;
+    }
+    SignalSampler& sampler = SignalSampler::GetInstance();
+    if (sampler.sampling.load(std::memory_order_relaxed) && context != nullptr) {
+        sampler.TakeSample(context);
+    }
+    return true;
+}
+
+SignalSampler::SampleRing* SignalSampler::GetRing()
+{
+    if (g_sampleRing != nullptr) {
+        return static_cast<SampleRing*>(g_sampleRing);
+    }
+    int tid = static_cast<int>(syscall(SYS_gettid));
+    for (uint32_t i = 0; i < RING_NUM; ++i) {
+        int expected = 0;
+        if (rings[i].owner.load(std::memory_order_relaxed) == 0 &&
+            rings[i].owner.compare_exchange_strong(expected, tid, std::memory_order_acq_rel)) {
+            g_sampleRing = &rings[i];
+            return &rings[i];
+        }
+    }
+    return nullptr;
+}
+
+void SignalSampler::TakeSample(void* context)
+{
+    // Threads running no cjthread, such as GC workers, are not sampled.
+    Mutator* mutator = ThreadLocal::GetMutator();
+    uint64_t cjthreadId = CJThreadId();
+    if (mutator == nullptr || cjthreadId == 0) {
+        return;
+    }
+    SampleRing* ring = GetRing();
+    if (ring == nullptr) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= RING_SIZE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    RawSample& sample = ring->slots[head % RING_SIZE];
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    constexpr uint64_t usPerSec = 1000 * 1000;
+    constexpr uint64_t nsPerUs = 1000;
+    sample.timeStamp = static_cast<uint64_t>(now.tv_sec) * usPerSec + static_cast<uint64_t>(now.tv_nsec) / nsPerUs;
+    sample.cjthreadId = cjthreadId;
+    sample.processorId = ProcessorIdTry();
+    sample.inSaferegion = mutator->InSaferegion();
+
+    const ucontext_t& ucontext = *static_cast<ucontext_t*>(context);
+    uintptr_t pc = GetPCFromUContext(ucontext);
+    uintptr_t fa = GetFAFromUContext(ucontext);
+    // Frame addresses outside the stack of the cjthread end the walk, e.g. when the signal lands
+    // in code that does not keep frame pointers, or on the stack of the scheduler.
+    uintptr_t stackLow = reinterpret_cast<uintptr_t>(CJThreadStackAddrGet());
+    uintptr_t stackHigh = reinterpret_cast<uintptr_t>(CJThreadStackBaseAddrGet());
+    uint32_t frameCnt = 0;
+    while (pc != 0 && frameCnt < RawSample::MAX_FRAMES) {
+        bool inStack = fa > stackLow + sizeof(uint64_t) && fa + sizeof(FrameAddress) <= stackHigh &&
+            (fa % sizeof(uint64_t)) == 0;
+        sample.pcs[frameCnt] = pc;
+        sample.startPCs[frameCnt] = inStack ?
+            reinterpret_cast<uint64_t>(FrameInfo::GetFuncStartPCFromFrameAddress(reinterpret_cast<FrameAddress*>(fa))) :
+            0;
+        frameCnt++;
+        if (!inStack) {
+            break;
+        }
+        const FrameAddress* frame = reinterpret_cast<const FrameAddress*>(fa);
+        uintptr_t callerFa = reinterpret_cast<uintptr_t>(frame->callerFrameAddress);
+        pc = reinterpret_cast<uintptr_t>(frame->returnAddress);
+        // Frames grow down, a caller below its callee is a broken chain.
+        if (callerFa <= fa) {
+            break;
+        }
+        fa = callerFa;
+    }
+    sample.frameCnt = frameCnt;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+#else
+bool SignalSampler::Handler(int sig, siginfo_t* info, void* context)
+{
+    (void)sig;
+    (void)info;
+    (void)context;
+    return false;
+}
+
+SignalSampler::SampleRing* SignalSampler::GetRing() { return nullptr; }
+
+void SignalSampler::TakeSample(void* context) { (void)context; }
+#endif
+} // namespace MapleRuntime
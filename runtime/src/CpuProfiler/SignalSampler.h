@@ -0,0 +1,82 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_SIGNAL_SAMPLER_H
+#define MRT_SIGNAL_SAMPLER_H
+
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <vector>
+
+#if defined(__linux__) || defined(__OHOS__) || defined(__ANDROID__)
+#define SIGNAL_SAMPLER_SUPPORTED
+#endif
+
+namespace MapleRuntime {
+// A stack taken by the SIGPROF handler. The frames are raw, leaf first, and are resolved by
+// `StackManager::RecordRawSampleForCpuProfile`.
+struct RawSample {
+    static constexpr uint32_t MAX_FRAMES = 32;
+    uint64_t timeStamp;              // us, CLOCK_MONOTONIC
+    uint64_t cjthreadId;
+    int processorId;
+    bool inSaferegion;               // the leaf frames are native code or the runtime, not managed code
+    uint32_t frameCnt;
+    uint64_t pcs[MAX_FRAMES];
+    uint64_t startPCs[MAX_FRAMES];   // function start of the frame if it is a managed one
+};
+
+// Samples the CPU with the SIGPROF of ITIMER_PROF, which fires for every `interval` of CPU time
+// the process uses. The handler walks the frame pointers of the interrupted cjthread within its
+// stack and puts the frames into a ring owned by the thread, so sampling takes no lock and stops
+// no mutator. The sampling thread drains the rings.
+class SignalSampler {
+public:
+    static SignalSampler& GetInstance()
+    {
+        static SignalSampler instance;
+        return instance;
+    }
+
+    // Returns false if SIGPROF cannot be used, the caller falls back to safepoint sampling.
+    bool Start(uint32_t intervalUs);
+    void Stop();
+    bool IsSampling() const { return sampling.load(std::memory_order_relaxed); }
+
+    // Append the samples taken since the last drain to `samples`, oldest first.
+    void Drain(std::vector<RawSample>& samples);
+
+    // Samples lost because a ring was full or no ring was left for the thread.
+    uint64_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    // Rings are claimed by threads on their first sample and are reclaimed by `Drain` once their
+    // thread has exited. A thread that finds none free is not sampled.
+    static constexpr uint32_t RING_NUM = 128;
+    static constexpr uint32_t RING_SIZE = 16;
+
+    struct SampleRing {
+        std::atomic<int> owner;      // tid of the thread owning the ring, 0 if the ring is free
+        std::atomic<uint64_t> head;  // next slot written by the owner thread
+        std::atomic<uint64_t> tail;  // next slot read by the sampling thread
+        RawSample slots[RING_SIZE];
+    };
+
+    SignalSampler() = default;
+    ~SignalSampler() = default;
+    static bool Handler(int sig, siginfo_t* info, void* context);
+    void TakeSample(void* context);
+    SampleRing* GetRing();
+
+    std::atomic<bool> sampling { false };
+    bool installed { false };
+    std::atomic<uint64_t> dropped { 0 };
+    SampleRing rings[RING_NUM];
+};
+} // namespace MapleRuntime
+#endif // MRT_SIGNAL_SAMPLER_H
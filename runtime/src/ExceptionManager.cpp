@@ -17,6 +17,7 @@
 #include "Heap/Collector/CollectorResources.h"
 #include "Heap/Collector/GcRequest.h"
 #include "Inspector/CjHeapData.h"
+#include "Inspector/FlightRecorder.h"
 namespace MapleRuntime {
 std::mutex ExceptionManager::gUncaughtExceptionHandlerMtx;
 #if defined(__OHOS__) && (__OHOS__ == 1)
@@ -193,6 +194,7 @@ void ExceptionManager::AndroidDefaultUncaughtTask(const char* summary, const CJE
 
 void ExceptionManager::DumpException()
 {
+    FlightRecorder::GetInstance().OnUncaughtException();
     ExceptionWrapper& eWrapper = Mutator::GetMutator()->GetExceptionWrapper();
     std::vector<uint64_t>& liteFrameInfos = eWrapper.GetLiteFrameInfos();
     LOG(RTLOG_ERROR, "An exception has occurred:\n");
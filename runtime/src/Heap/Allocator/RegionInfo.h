@@ -627,6 +627,7 @@ public:
 #endif
 
     void VisitAllObjects(const std::function<void(BaseObject*)>&& func);
+    bool VisitAllObjectsUntilFalse(const std::function<bool(BaseObject*)>&& func);
     bool VisitLiveObjectsUntilFalse(const std::function<bool(BaseObject*)>&& func);
 
     // reset so that this region can be reused for allocation
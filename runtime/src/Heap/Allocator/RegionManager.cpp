@@ -126,6 +126,23 @@ void RegionInfo::VisitAllObjects(const std::function<void(BaseObject*)>&& func)
     }
 }
 
+bool RegionInfo::VisitAllObjectsUntilFalse(const std::function<bool(BaseObject*)>&& func)
+{
+    if (IsLargeRegion()) {
+        return func(reinterpret_cast<BaseObject*>(GetRegionStart()));
+    }
+    if (IsSmallRegion()) {
+        uintptr_t position = GetRegionStart();
+        uintptr_t allocPtr = GetRegionAllocPtr();
+        while (position < allocPtr) {
+            BaseObject* obj = reinterpret_cast<BaseObject*>(position);
+            position += RegionSpace::GetAllocSize(*obj);
+            if (!func(obj)) { return false; }
+        }
+    }
+    return true;
+}
+
 bool RegionInfo::VisitLiveObjectsUntilFalse(const std::function<bool(BaseObject*)>&& func)
 {
     // no need to visit this region.
@@ -535,6 +552,70 @@ void RegionManager::ForEachObjSafe(const std::function<void(BaseObject*)>& visit
     ForEachObjUnsafe(visitor);
 }
 
+void RegionManager::GetObjectRegions(std::vector<RegionInfo*>& regions) const
+{
+    for (uintptr_t regionAddr = regionHeapStart; regionAddr < inactiveZone;) {
+        RegionInfo* region = RegionInfo::GetRegionInfoAt(regionAddr);
+        regionAddr = region->GetRegionEnd();
+        if (region->IsValidRegion() && !region->IsFreeRegion() && !region->IsGarbageRegion()) {
+            regions.push_back(region);
+        }
+    }
+}
+
+void RegionManager::CountSurvivorsByType(GCThreadPool* threadPool, HeapHistogram& histogram)
+{
+    std::vector<RegionInfo*> regions;
+    auto addRegion = [&regions](RegionInfo* region) { regions.push_back(region); };
+    fromRegionList.VisitAllRegions(addRegion);
+    oldPinnedRegionList.VisitAllRegions(addRegion);
+    oldLargeRegionList.VisitAllRegions(addRegion);
+    auto countRegion = [](RegionInfo* region, HeapHistogram& counts) {
+        (void)region->VisitLiveObjectsUntilFalse([&counts](BaseObject* object) {
+            TypeCount& typeCount = counts[object->GetTypeInfo()];
+            ++typeCount.count;
+            typeCount.bytes += RegionSpace::GetAllocSize(*object);
+            return true;
+        });
+    };
+
+    // 64: regions taken by a worker at a time, small heaps are counted by the calling thread.
+    constexpr size_t regionsPerTake = 64;
+    if (threadPool == nullptr || regions.size() <= regionsPerTake) {
+        for (RegionInfo* region : regions) {
+            countRegion(region, histogram);
+        }
+        return;
+    }
+
+    // Every worker counts into a histogram of its own, they are merged after the pool finishes.
+    const size_t threadCount = threadPool->GetMaxThreadNum() + 1;
+    std::vector<HeapHistogram> counts(threadCount);
+    std::atomic<size_t> next = { 0 };
+    const int32_t taskNum = threadPool->GetMaxActiveThreadNum() + 1;
+    for (int32_t i = 0; i < taskNum; ++i) {
+        threadPool->AddWork(new (std::nothrow) LambdaWork([&regions, &counts, &next, &countRegion](size_t workerID) {
+            for (size_t start = next.fetch_add(regionsPerTake, std::memory_order_relaxed); start < regions.size();
+                 start = next.fetch_add(regionsPerTake, std::memory_order_relaxed)) {
+                size_t end = std::min(start + regionsPerTake, regions.size());
+                for (size_t index = start; index < end; ++index) {
+                    countRegion(regions[index], counts[workerID]);
+                }
+            }
+        }));
+    }
+    threadPool->Start();
+    threadPool->WaitFinish();
+
+    for (const HeapHistogram& workerCounts : counts) {
+        for (const auto& entry : workerCounts) {
+            TypeCount& typeCount = histogram[entry.first];
+            typeCount.count += entry.second.count;
+            typeCount.bytes += entry.second.bytes;
+        }
+    }
+}
+
 RegionInfo* RegionManager::TakeRegion(size_t num, RegionInfo::UnitRole type, bool expectPhysicalMem)
 {
     // a chance to invoke heuristic gc.
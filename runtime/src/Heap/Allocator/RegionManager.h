@@ -337,6 +337,12 @@ public:
 
     void ForEachObjUnsafe(const std::function<void(BaseObject*)>& visitor) const;
     void ForEachObjSafe(const std::function<void(BaseObject*)>& visitor) const;
+    // The regions that hold objects, in address order, for visiting them in parallel.
+    void GetObjectRegions(std::vector<RegionInfo*>& regions) const;
+    // Count the objects that survived the trace in the garbage candidates by type into `histogram`,
+    // the regions are shared out among the threads of `threadPool`. Mutators do not allocate in the
+    // candidates, so they are counted by the gc thread between the trace and their reclaim.
+    void CountSurvivorsByType(GCThreadPool* threadPool, HeapHistogram& histogram);
 
     size_t GetUsedRegionSize() const { return GetUsedUnitCount() * RegionInfo::UNIT_SIZE; }
 
@@ -396,6 +402,16 @@ public:
 
     inline size_t GetFromSpaceSize() const { return fromRegionList.GetAllocatedSize(); }
 
+    size_t GetFromSpaceLiveBytes()
+    {
+        size_t liveBytes = 0;
+        fromRegionList.VisitAllRegions([&liveBytes](RegionInfo* region) { liveBytes += region->GetLiveByteCount(); });
+        return liveBytes;
+    }
+
+    size_t GetFromRegionCount() const { return fromRegionList.GetRegionCount(); }
+    size_t GetExemptedRegionCount() const { return unmovableFromRegionList.GetRegionCount(); }
+
     inline size_t GetPinnedSpaceSize() const
     {
         return oldPinnedRegionList.GetAllocatedSize() + recentPinnedRegionList.GetAllocatedSize();
@@ -524,6 +540,15 @@ public:
         ClearLiveInfo(largeTraceRegions);
     }
 
+    // Bytes marked live by tracing, they are counted by the regions as objects are marked.
+    size_t GetAllLiveBytes()
+    {
+        return GetLiveBytes(tlRegionList) + GetLiveBytes(recentFullRegionList) + GetLiveBytes(fullTraceRegions) +
+            GetLiveBytes(unmovableFromRegionList) + GetLiveBytes(recentPinnedRegionList) +
+            GetLiveBytes(oldPinnedRegionList) + GetLiveBytes(rawPointerPinnedRegionList) +
+            GetLiveBytes(oldLargeRegionList) + GetLiveBytes(recentLargeRegionList) + GetLiveBytes(largeTraceRegions);
+    }
+
 private:
     static const size_t MAX_UNIT_COUNT_PER_REGION;
     static const size_t HUGE_PAGE;
@@ -538,6 +563,15 @@ private:
         tmp.VisitAllRegions([](RegionInfo* region) { region->ClearLiveInfo(); });
     }
 
+    size_t GetLiveBytes(RegionList& list)
+    {
+        size_t liveBytes = 0;
+        RegionList tmp("temp region list");
+        list.CopyListTo(tmp);
+        tmp.VisitAllRegions([&liveBytes](RegionInfo* region) { liveBytes += region->GetLiveByteCount(); });
+        return liveBytes;
+    }
+
     FreeRegionManager freeRegionManager;
 
     // region lists actually represent life cycle of regions.
@@ -14,6 +14,7 @@
 #endif
 #include "Common/ScopedObjectAccess.h"
 #include "Heap.h"
+#include "Inspector/Metrics.h"
 
 namespace MapleRuntime {
 MAddress RegionSpace::TryAllocateOnce(size_t allocSize, AllocType allocType)
@@ -22,6 +23,12 @@ MAddress RegionSpace::TryAllocateOnce(size_t allocSize, AllocType allocType)
         return regionManager.AllocPinned(allocSize);
     }
     if (UNLIKELY(allocSize >= regionManager.GetLargeObjectThreshold())) {
+        static MetricCounter& largeObjects = MetricsRegistry::GetInstance().RegisterCounter(
+            "cj_alloc_large_objects_total", "Objects allocated in regions of their own.");
+        static MetricCounter& largeBytes = MetricsRegistry::GetInstance().RegisterCounter(
+            "cj_alloc_large_bytes_total", "Bytes of objects allocated in regions of their own.");
+        largeObjects.Add();
+        largeBytes.Add(allocSize);
         return regionManager.AllocLarge(allocSize);
     }
     AllocBuffer* allocBuffer = AllocBuffer::GetOrCreateAllocBuffer();
@@ -30,6 +37,9 @@ MAddress RegionSpace::TryAllocateOnce(size_t allocSize, AllocType allocType)
 
 bool RegionSpace::ShouldRetryAllocation(size_t& tryTimes, size_t size) const
 {
+    static MetricCounter& retries = MetricsRegistry::GetInstance().RegisterCounter(
+        "cj_alloc_retries_total", "Allocations retried because the heap had no room.");
+    retries.Add();
     if (!IsRuntimeThread() && tryTimes <= static_cast<size_t>(TryAllocationThreshold::RESCHEDULE)) {
         CJThreadResched(); // reschedule this thread for throughput.
         return true;
@@ -196,6 +206,9 @@ MAddress AllocBuffer::AllocateImpl(size_t totalSize, AllocType allocType)
 
     // now region must be null. If a region has been ready, then use it and tell gc-assitant thread to prepare
     // a new region, or take a new one.
+    static MetricCounter& refills = MetricsRegistry::GetInstance().RegisterCounter(
+        "cj_alloc_region_refills_total", "Thread-local regions taken by allocation buffers.");
+    refills.Add();
     RegionInfo* r  = preparedRegion.load(std::memory_order_acquire);
     if (r != nullptr) {
         preparedRegion.store(nullptr, std::memory_order_release);
@@ -280,6 +293,37 @@ bool RegionSpace::IsHeapObject(MAddress addr) const
     return IsHeapAddress(addr);
 }
 #endif
+void RegionSpace::GetInstances(const TypeInfo* type, bool includeSubtypes, size_t maxCount,
+                               std::vector<MObject*>& instances) const
+{
+    TypeInfo* target = const_cast<TypeInfo*>(type);
+    auto collect = [target, includeSubtypes, maxCount, &instances](BaseObject* object) {
+        TypeInfo* objectType = object->GetTypeInfo();
+        if (objectType == target || (includeSubtypes && objectType->IsSubType(target))) {
+            instances.push_back(reinterpret_cast<MObject*>(object));
+        }
+        // Stop the walk once `maxCount` objects are collected.
+        return maxCount == 0 || instances.size() < maxCount;
+    };
+    std::vector<RegionInfo*> regions;
+    regionManager.GetObjectRegions(regions);
+    for (RegionInfo* region : regions) {
+        if (!region->VisitAllObjectsUntilFalse(collect)) {
+            return;
+        }
+    }
+}
+
+void RegionSpace::ClassInstanceNum(std::map<CString, long>& instanceNums) const
+{
+    HeapHistogram histogram;
+    regionManager.CountObjectsByType(nullptr, histogram);
+    for (const auto& entry : histogram) {
+        const char* name = entry.first->GetName();
+        instanceNums[name == nullptr ? "defaultLambda" : name] += static_cast<long>(entry.second.count);
+    }
+}
+
 void RegionSpace::FeedHungryBuffers()
 {
     ScopedObjectAccess soa;
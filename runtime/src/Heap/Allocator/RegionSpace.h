@@ -93,9 +93,16 @@ public:
     bool IsHeapObject(MAddress addr) const override;
 #endif
 
-    // info dump
-    void GetInstances(const TypeInfo*, bool, size_t, std::vector<MObject*>&) const {}
-    void ClassInstanceNum(std::map<CString, long>&) const {}
+    // info dump, the world must be stopped.
+    // Collect at most `maxCount` objects of `type`, or of its subtypes too if `includeSubtypes`, 0 for no limit.
+    void GetInstances(const TypeInfo* type, bool includeSubtypes, size_t maxCount,
+                      std::vector<MObject*>& instances) const;
+    // Count the objects by the name of their types.
+    void ClassInstanceNum(std::map<CString, long>& instanceNums) const;
+    void GetHeapHistogram(GCThreadPool* threadPool, HeapHistogram& histogram)
+    {
+        regionManager.CountSurvivorsByType(threadPool, histogram);
+    }
 
     size_t ReclaimGarbageMemory(bool releaseAll) override
     {
@@ -162,7 +169,13 @@ public:
 
     void PrepareFromSpace() { regionManager.PrepareFromRegionList(); }
 
+    // Live bytes of the from-regions, which forwarding copies.
+    size_t FromSpaceLiveBytes() { return regionManager.GetFromSpaceLiveBytes(); }
+    size_t FromRegionCount() const { return regionManager.GetFromRegionCount(); }
+    size_t ExemptedRegionCount() const { return regionManager.GetExemptedRegionCount(); }
+
     void ClearAllLiveInfo() { regionManager.ClearAllLiveInfo(); }
+    size_t AllLiveBytes() { return regionManager.GetAllLiveBytes(); }
 
     void ForwardFromSpace(GCThreadPool* threadPool)
     {
@@ -26,9 +26,8 @@ const char* Collector::GetGCPhaseName(GCPhase phase)
         "stub phase",      "stub phase",
         "init phase",      "enum phase",
         "trace phase",     "clear satb phase",
-        "forward phase",   "enum fix phase",
-        "trace fix phase", "clear trace fix phase",
-        "fix stack phase", "preforward phase",
+        "post trace phase", "preforward phase",
+        "forward phase",
     };
     return phaseNames[phase];
 }
@@ -13,8 +13,10 @@
 #include "CollectorProxy.h"
 #include "Common/RunType.h"
 #include "Common/ScopedObjectAccess.h"
+#include "Heap/Allocator/RegionSpace.h"
 #include "LoaderManager.h"
 #include "Mutator/MutatorManager.h"
+#include "schedule.h"
 
 namespace MapleRuntime {
 extern "C" uintptr_t MRT_StopGCWork()
@@ -246,11 +248,14 @@ int32_t CollectorResources::GetGCThreadCount(const bool isConcurrent) const
     if (GetThreadPool() == nullptr) {
         return 1;
     }
-    if (isConcurrent) {
-        return gcThreadCount;
-    }
     // default to 2
-    return 2;
+    int32_t threadCount = isConcurrent ? gcThreadCount : 2;
+    // GC workers should not outnumber the active processors, which may shrink at runtime.
+    int32_t processorNum = static_cast<int32_t>(ScheduleProcessorNumGet());
+    if (processorNum > 0 && processorNum < threadCount) {
+        return processorNum;
+    }
+    return threadCount;
 }
 
 void CollectorResources::BroadcastGCCompletion()
@@ -270,4 +275,37 @@ void CollectorResources::RequestHeapDump(GCTask::TaskType gcTask)
     taskQueue->EnqueueSync(dumpTask, filter);
 }
 
+bool CollectorResources::RequestHeapHistogram(HeapHistogram& histogram)
+{
+    if (!IsGCActive()) {
+        return false;
+    }
+    // Enter saferegion since the caller waits for the next gc cycle, no cycle is forced for it.
+    ScopedEnterSaferegion enterSaferegion(false);
+    std::lock_guard<std::mutex> requestLock(histogramRequestMutex);
+    std::unique_lock<std::mutex> lock(gcFinishedCondMutex);
+    histogramRequest.store(&histogram);
+    gcFinishedCondVar.wait(lock, [this] {
+        return histogramRequest.load() == nullptr || finishedGcIndex == GCTask::TASK_INDEX_FOR_EXIT;
+    });
+    // The request is still set if the gc thread exited before a cycle counted it.
+    return histogramRequest.exchange(nullptr) == nullptr;
+}
+
+// The survivors of the trace are counted in the garbage candidates, which mutators no longer
+// allocate in, so the mutators keep running. Objects allocated since the cycle started are not
+// counted, nor are the garbage objects of the candidates.
+void CollectorResources::RunHeapHistogram()
+{
+    HeapHistogram* histogram = histogramRequest.load();
+    if (histogram == nullptr) {
+        return;
+    }
+    uint64_t startTime = TimeUtil::MicroSeconds();
+    RegionSpace& space = reinterpret_cast<RegionSpace&>(Heap::GetHeap().GetAllocator());
+    space.GetHeapHistogram(gcThreadPool, *histogram);
+    VLOG(REPORT, "heap histogram: %zu types in %zu us", histogram->size(), TimeUtil::MicroSeconds() - startTime);
+    histogramRequest.store(nullptr);
+}
+
 } // namespace MapleRuntime
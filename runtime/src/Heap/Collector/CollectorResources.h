@@ -12,6 +12,7 @@
 #include "FinalizerProcessor.h"
 #include "Heap/Collector/TaskQueue.h"
 #include "Heap/GcThreadPool.h"
+#include "Heap/Heap.h"
 #include "Inspector/CjHeapData.h"
 #include "TaskQueue.h"
 
@@ -57,6 +58,10 @@ public:
     void BroadcastGCCompletion();
     GCStats& GetGCStats() { return gcStats; }
     void RequestHeapDump(GCTask::TaskType gcTask);
+    // Wait for the next gc cycle to count the objects by type, see Heap::GetHeapHistogram.
+    bool RequestHeapHistogram(HeapHistogram& histogram);
+    // Called by the gc thread once the trace is done, counts the objects if a histogram is requested.
+    void RunHeapHistogram();
 
 private:
     void StartGCThreads();
@@ -86,6 +91,11 @@ private:
     // notified when GC finished, requires gcFinishedCondMutex
     std::condition_variable gcFinishedCondVar;
 
+    // One heap histogram is requested at a time, the gc thread clears the request when it is done
+    // and the requester is woken by gcFinishedCondVar at the end of the cycle.
+    std::mutex histogramRequestMutex;
+    std::atomic<HeapHistogram*> histogramRequest = { nullptr };
+
     // Indicate whether GC is already started.
     // NOTE: When GC finishes, it clears isGcStarted, must be over-written only by gc thread.
     std::atomic<bool> isGcStarted = { false };
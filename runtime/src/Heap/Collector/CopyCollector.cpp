@@ -50,6 +50,7 @@ void CopyCollector::RunGarbageCollection(uint64_t gcIndex, GCReason reason)
     GCStats& gcStats = GetGCStats();
     gcStats.collectedBytes = 0;
     gcStats.gcStartTime = TimeUtil::NanoSeconds();
+    gcStats.BeginCycle();
 
     DoGarbageCollection();
 
@@ -60,6 +61,8 @@ void CopyCollector::RunGarbageCollection(uint64_t gcIndex, GCReason reason)
     PostGarbageCollection(gcIndex);
     gcStats.gcEndTime = TimeUtil::NanoSeconds();
     UpdateGCStats();
+    gcStats.tracedObjects = markedObjectCount.load(std::memory_order_relaxed);
+    GCEventLog::Instance().Record(gcStats.EndCycle(gcIndex));
     uint64_t gcTimeNs = gcStats.gcEndTime - gcStats.gcStartTime;
     ScheduleTraceEvent(TRACE_EV_GC_DONE, -1, nullptr, 0);
     double rate = (static_cast<double>(gcStats.collectedBytes) / gcTimeNs) * (static_cast<double>(NS_PER_S) / MB);
@@ -79,6 +82,9 @@ void CopyCollector::ForwardFromSpace()
     GCStats& stats = GetGCStats();
     stats.liveBytesBeforeGC = space.AllocatedBytes();
     stats.fromSpaceSize = space.FromSpaceSize();
+    stats.copiedBytes = space.FromSpaceLiveBytes();
+    stats.fromRegionCount = space.FromRegionCount();
+    stats.exemptedRegionCount = space.ExemptedRegionCount();
     space.ForwardFromSpace(GetThreadPool());
 }
 
@@ -7,14 +7,31 @@
 
 #include "GcStats.h"
 
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "Base/LogFile.h"
+#include "Base/SysCall.h"
 #include "Heap/Heap.h"
+#include "Inspector/Metrics.h"
 
 namespace MapleRuntime {
 size_t g_gcCount = 0;
 uint64_t g_gcTotalTimeUs = 0;
 size_t g_gcCollectedTotalBytes = 0;
 
+namespace {
+// Upper bounds of the pause and cycle histograms, in ns.
+constexpr uint64_t GC_PAUSE_BOUNDS[] = { 10000, 50000, 100000, 500000, 1000000, 5000000, 10000000, 50000000,
+                                         100000000, 500000000, 1000000000 };
+constexpr uint64_t GC_CYCLE_BOUNDS[] = { 1000000, 5000000, 10000000, 50000000, 100000000, 500000000, 1000000000,
+                                         5000000000, 10000000000 };
+constexpr double NS_TO_S = 1e-9;
+}
+
 uint64_t GCStats::prevGcStartTime = TimeUtil::NanoSeconds() - LONG_MIN_HEU_GC_INTERVAL_NS;
 uint64_t GCStats::prevGcFinishTime = TimeUtil::NanoSeconds() - LONG_MIN_HEU_GC_INTERVAL_NS;
 
@@ -46,6 +63,99 @@ void GCStats::Init()
     heapThreshold = std::min(CangjieRuntime::GetGCParam().gcThreshold, 20 * MB);
     // 0.2:set 20% heap size as intial value
     heapThreshold = std::min(static_cast<size_t>(Heap::GetHeap().GetMaxCapacity() * 0.2), heapThreshold);
+
+    cycleRunning = false;
+    prevHeapThreshold = heapThreshold;
+    heuGCInterval = 0;
+}
+
+// Called once gcStartTime is set, the time until the first phase is counted as init.
+void GCStats::BeginCycle()
+{
+    cycleRunning = true;
+    currentPhase = GC_PHASE_UNDEF;
+    phaseStartTime = gcStartTime;
+    std::fill(phaseNs, phaseNs + GC_PHASE_SLOT_NUM, 0);
+    pauseCount = 0;
+    pauseTotalNs = 0;
+    pauseMaxNs = 0;
+    tracedObjects = 0;
+    tracedBytes = 0;
+    copiedBytes = 0;
+    fromRegionCount = 0;
+    exemptedRegionCount = 0;
+    prevHeapThreshold = heapThreshold;
+    heuGCInterval = 0;
+}
+
+void GCStats::RecordPhase(uint8_t phase)
+{
+    if (!cycleRunning || phase >= GC_PHASE_SLOT_NUM) {
+        return;
+    }
+    uint64_t now = TimeUtil::NanoSeconds();
+    phaseNs[currentPhase] += now - phaseStartTime;
+    currentPhase = phase;
+    phaseStartTime = now;
+}
+
+void GCStats::RecordPause(uint64_t pauseNs)
+{
+    if (!cycleRunning) {
+        return;
+    }
+    pauseCount++;
+    pauseTotalNs += pauseNs;
+    pauseMaxNs = std::max(pauseMaxNs, pauseNs);
+    static MetricHistogram& pauses = MetricsRegistry::GetInstance().RegisterHistogram(
+        "cj_gc_pause_seconds", "Stop-the-world and light sync pauses of GC cycles.", GC_PAUSE_BOUNDS,
+        sizeof(GC_PAUSE_BOUNDS) / sizeof(GC_PAUSE_BOUNDS[0]), NS_TO_S);
+    pauses.Observe(pauseNs);
+}
+
+// Called once gcEndTime is set and the pacing of the next cycle is updated.
+GCCycleRecord GCStats::EndCycle(uint64_t gcIndex)
+{
+    if (cycleRunning) {
+        phaseNs[currentPhase] += gcEndTime - std::min(phaseStartTime, gcEndTime);
+        cycleRunning = false;
+    }
+    GCCycleRecord record {};
+    record.gcIndex = gcIndex;
+    record.reason = reason;
+    record.async = async ? 1 : 0;
+    record.startTimeNs = gcStartTime;
+    record.durationNs = gcEndTime - gcStartTime;
+
+    record.initNs = phaseNs[GC_PHASE_UNDEF] + phaseNs[GC_PHASE_INIT];
+    record.enumNs = phaseNs[GC_PHASE_ENUM];
+    record.traceNs = phaseNs[GC_PHASE_TRACE];
+    record.clearSatbNs = phaseNs[GC_PHASE_CLEAR_SATB_BUFFER];
+    record.postTraceNs = phaseNs[GC_PHASE_POST_TRACE];
+    record.preforwardNs = phaseNs[GC_PHASE_PREFORWARD];
+    record.forwardNs = phaseNs[GC_PHASE_FORWARD];
+    record.collectNs = phaseNs[GC_PHASE_IDLE];
+    record.reclaimSatbNs = phaseNs[GC_PHASE_RECLAIM_SATB_NODE];
+
+    record.pauseCount = pauseCount;
+    record.pauseTotalNs = pauseTotalNs;
+    record.pauseMaxNs = pauseMaxNs;
+
+    record.tracedObjects = tracedObjects;
+    record.tracedBytes = tracedBytes;
+    record.copiedBytes = copiedBytes;
+    record.freedBytes = collectedBytes;
+    record.liveBytesBeforeGC = liveBytesBeforeGC;
+    record.liveBytesAfterGC = liveBytesAfterGC;
+
+    record.fromRegions = fromRegionCount;
+    record.exemptedRegions = exemptedRegionCount;
+
+    record.heapThresholdBefore = prevHeapThreshold;
+    record.heapThresholdAfter = heapThreshold;
+    record.heuGCIntervalNs = heuGCInterval;
+    record.garbageRatio = garbageRatio;
+    return record;
 }
 
 void GCStats::Dump() const
@@ -71,4 +181,115 @@ void GCStats::Dump() const
     VLOG(REPORT, "allocated size: %s, heap size: %s, heap utilization: %.2f%%", Pretty(liveSize).Str(),
          Pretty(heapSize).Str(), utilization);
 }
+
+void GCEventLog::Record(const GCCycleRecord& record)
+{
+    MetricsRegistry& registry = MetricsRegistry::GetInstance();
+    static MetricHistogram& cycles = registry.RegisterHistogram(
+        "cj_gc_cycle_seconds", "Duration of GC cycles.", GC_CYCLE_BOUNDS,
+        sizeof(GC_CYCLE_BOUNDS) / sizeof(GC_CYCLE_BOUNDS[0]), NS_TO_S);
+    static MetricCounter& traced = registry.RegisterCounter("cj_gc_traced_bytes_total", "Bytes marked live by GC.");
+    static MetricCounter& copied = registry.RegisterCounter("cj_gc_copied_bytes_total", "Bytes copied by GC.");
+    cycles.Observe(record.durationNs);
+    traced.Add(record.tracedBytes);
+    copied.Add(record.copiedBytes);
+    if (record.reason < GC_REASON_MAX) {
+        registry.RegisterCounter("cj_gc_triggers_total", "GC cycles, by what triggered them.",
+                                 CString::FormatString("reason=\"%s\"", g_gcRequests[record.reason].name)).Add();
+    }
+
+    std::lock_guard<std::mutex> lg(mutex);
+    records[recordCount % CAPACITY] = record;
+    recordCount++;
+    if (!sinkOpened) {
+        OpenSink();
+    }
+    if (sinkFd >= 0) {
+        CString line = ToJson(record) + "\n";
+        if (!WriteAll(sinkFd, line.Str(), line.Length())) {
+            (void)close(sinkFd);
+            sinkFd = -1;
+        }
+    }
+}
+
+void GCEventLog::OpenSink()
+{
+    sinkOpened = true;
+    CString path = CString(std::getenv("cjGCEventLog")).RemoveBlankSpace();
+    if (path.IsEmpty()) {
+        return;
+    }
+    sinkFd = open(path.Str(), O_WRONLY | O_CREAT | O_APPEND, 0644); // 0644: rw-r--r--
+    if (sinkFd < 0) {
+        LOG(RTLOG_ERROR, "Open gc event log %s failed. msg: %s", path.Str(), strerror(errno));
+    }
+}
+
+size_t GCEventLog::GetRecords(GCCycleRecord* out, size_t num)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    size_t kept = static_cast<size_t>(std::min<uint64_t>(recordCount, CAPACITY));
+    size_t copied = std::min(num, kept);
+    uint64_t first = recordCount - copied;
+    for (size_t i = 0; i < copied; ++i) {
+        out[i] = records[(first + i) % CAPACITY];
+    }
+    return copied;
+}
+
+bool GCEventLog::Dump(int fd)
+{
+    if (fd < 0) {
+        return false;
+    }
+    CString lines;
+    {
+        std::lock_guard<std::mutex> lg(mutex);
+        uint64_t kept = std::min<uint64_t>(recordCount, CAPACITY);
+        for (uint64_t i = recordCount - kept; i < recordCount; ++i) {
+            lines += ToJson(records[i % CAPACITY]);
+            lines += "\n";
+        }
+    }
+    return WriteAll(fd, lines.Str(), lines.Length());
+}
+
+CString GCEventLog::ToJson(const GCCycleRecord& record)
+{
+    const char* reasonName = record.reason < GC_REASON_MAX ? g_gcRequests[record.reason].name : "invalid";
+    CString json = CString::FormatString("{\"gcIndex\":%llu,\"reason\":\"%s\",\"async\":%s",
+                                         static_cast<unsigned long long>(record.gcIndex), reasonName,
+                                         record.async != 0 ? "true" : "false");
+    auto field = [&json](const char* name, uint64_t value) {
+        json += CString::FormatString(",\"%s\":%llu", name, static_cast<unsigned long long>(value));
+    };
+    field("startTimeNs", record.startTimeNs);
+    field("durationNs", record.durationNs);
+    field("initNs", record.initNs);
+    field("enumNs", record.enumNs);
+    field("traceNs", record.traceNs);
+    field("clearSatbNs", record.clearSatbNs);
+    field("postTraceNs", record.postTraceNs);
+    field("preforwardNs", record.preforwardNs);
+    field("forwardNs", record.forwardNs);
+    field("collectNs", record.collectNs);
+    field("reclaimSatbNs", record.reclaimSatbNs);
+    field("pauseCount", record.pauseCount);
+    field("pauseTotalNs", record.pauseTotalNs);
+    field("pauseMaxNs", record.pauseMaxNs);
+    field("tracedObjects", record.tracedObjects);
+    field("tracedBytes", record.tracedBytes);
+    field("copiedBytes", record.copiedBytes);
+    field("freedBytes", record.freedBytes);
+    field("liveBytesBeforeGC", record.liveBytesBeforeGC);
+    field("liveBytesAfterGC", record.liveBytesAfterGC);
+    field("fromRegions", record.fromRegions);
+    field("exemptedRegions", record.exemptedRegions);
+    field("heapThresholdBefore", record.heapThresholdBefore);
+    field("heapThresholdAfter", record.heapThresholdAfter);
+    field("heuGCIntervalNs", record.heuGCIntervalNs);
+    json += CString::FormatString(",\"garbageRatio\":%.4f}", record.garbageRatio);
+    return json;
+}
 } // namespace MapleRuntime
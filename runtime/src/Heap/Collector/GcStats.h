@@ -14,11 +14,57 @@
 #include <memory>
 #include <mutex>
 
+#include "Base/CString.h"
 #include "Base/ImmortalWrapper.h"
 #include "Base/Panic.h"
 #include "GcRequest.h"
 
 namespace MapleRuntime {
+// Phase durations are kept per GCPhase value, see Collector.h.
+constexpr size_t GC_PHASE_SLOT_NUM = 16;
+
+// What a gc cycle did and how long each part of it took. It is handed out by MCC_GetGCEvents, so
+// fields are only appended.
+struct GCCycleRecord {
+    uint64_t gcIndex;
+    uint64_t reason; // GCReason
+    uint64_t async;
+    uint64_t startTimeNs;
+    uint64_t durationNs;
+
+    // Time spent in each phase, from the request to the end of the cycle.
+    uint64_t initNs;
+    uint64_t enumNs;
+    uint64_t traceNs;
+    uint64_t clearSatbNs;
+    uint64_t postTraceNs;
+    uint64_t preforwardNs;
+    uint64_t forwardNs;
+    uint64_t collectNs; // reclaiming from-space after forwarding
+    uint64_t reclaimSatbNs;
+
+    // Stop-the-world and light sync pauses.
+    uint64_t pauseCount;
+    uint64_t pauseTotalNs;
+    uint64_t pauseMaxNs;
+
+    uint64_t tracedObjects;
+    uint64_t tracedBytes;
+    uint64_t copiedBytes;
+    uint64_t freedBytes;
+    uint64_t liveBytesBeforeGC;
+    uint64_t liveBytesAfterGC;
+
+    uint64_t fromRegions;     // regions evacuated
+    uint64_t exemptedRegions; // from-regions kept in place as mostly live
+
+    // Pacing of the next cycle.
+    uint64_t heapThresholdBefore;
+    uint64_t heapThresholdAfter;
+    uint64_t heuGCIntervalNs;
+    double garbageRatio;
+};
+
 // statistics for previous gc.
 class GCStats {
 public:
@@ -31,6 +77,13 @@ public:
 
     void Dump() const;
 
+    // Per-cycle timing, updated by the gc thread only. Phase transitions and pauses outside of a cycle
+    // are not counted.
+    void BeginCycle();
+    void RecordPhase(uint8_t phase);
+    void RecordPause(uint64_t pauseNs);
+    GCCycleRecord EndCycle(uint64_t gcIndex);
+
     static uint64_t GetPrevGCStartTime() { return prevGcStartTime; }
 
     static void SetPrevGCStartTime(uint64_t timestamp) { prevGcStartTime = timestamp; }
@@ -68,6 +121,56 @@ public:
     double collectionRate; // bytes per nano-second
 
     size_t heapThreshold;
+
+    // per-cycle record, see GCCycleRecord.
+    bool cycleRunning;
+    uint8_t currentPhase;
+    uint64_t phaseStartTime;
+    uint64_t phaseNs[GC_PHASE_SLOT_NUM];
+
+    uint64_t pauseCount;
+    uint64_t pauseTotalNs;
+    uint64_t pauseMaxNs;
+
+    size_t tracedObjects;
+    size_t tracedBytes;
+    size_t copiedBytes;
+    size_t fromRegionCount;
+    size_t exemptedRegionCount;
+
+    size_t prevHeapThreshold;
+    uint64_t heuGCInterval;
+};
+
+// Keeps the records of the last cycles, and appends every record to the JSONL file named by the
+// cjGCEventLog environment variable.
+class GCEventLog {
+public:
+    static GCEventLog& Instance()
+    {
+        static GCEventLog instance;
+        return instance;
+    }
+
+    void Record(const GCCycleRecord& record);
+    // Copy the latest records, at most `num`, oldest first.
+    size_t GetRecords(GCCycleRecord* out, size_t num);
+    // Write the records kept as JSON lines.
+    bool Dump(int fd);
+
+    static CString ToJson(const GCCycleRecord& record);
+
+private:
+    GCEventLog() = default;
+    ~GCEventLog() = default;
+    void OpenSink();
+
+    static constexpr size_t CAPACITY = 256;
+    std::mutex mutex;
+    GCCycleRecord records[CAPACITY];
+    uint64_t recordCount { 0 };
+    bool sinkOpened { false };
+    int sinkFd { -1 };
 };
 extern size_t g_gcCount;
 extern uint64_t g_gcTotalTimeUs;
@@ -842,6 +842,7 @@ void TracingCollector::UpdateGCStats()
     newThreshold = std::min(newThreshold, static_cast<size_t>(space.GetMaxCapacity() * 0.98));
     gcStats.heapThreshold = std::min(newThreshold, CangjieRuntime::GetGCParam().gcThreshold);
     g_gcRequests[GC_REASON_HEU].SetMinInterval(gcInterval);
+    gcStats.heuGCInterval = gcInterval;
     VLOG(REPORT, "live bytes %zu (survived %zu, recent-allocated %zu), update gc threshold %zu -> %zu", liveBytes,
          liveBytes - recentBytes, recentBytes, oldThreshold, gcStats.heapThreshold);
     TRACE_COUNT("CJRT_post_GC_HeapSize", Heap::GetHeap().GetAllocatedSize());
@@ -300,6 +300,12 @@ public:
         MutatorManager::Instance().TransitionAllMutatorsToGCPhase(phase);
     }
 
+    void SetGCPhase(const GCPhase phase) override
+    {
+        Collector::SetGCPhase(phase);
+        GetGCStats().RecordPhase(phase);
+    }
+
     GCStats& GetGCStats() override { return collectorResources.GetGCStats(); }
 
     virtual void UpdateGCStats();
@@ -99,6 +99,7 @@ public:
     void UnregisterStaticRoots(Uptr addr, U32) override;
     void VisitStaticRoots(const RefFieldVisitor& visitor) override;
     bool ForEachObj(const std::function<void(BaseObject*)>&, bool) const override;
+    bool GetHeapHistogram(HeapHistogram& histogram) override;
     ssize_t GetHeapPhysicalMemorySize() const override;
     void InstallBarrier(const GCPhase phase) override;
     FinalizerProcessor& GetFinalizerProcessor() override;
@@ -164,6 +165,11 @@ bool HeapImpl::ForEachObj(const std::function<void(BaseObject*)>& visitor, bool
     return theSpace->ForEachObj(visitor, safe);
 }
 
+bool HeapImpl::GetHeapHistogram(HeapHistogram& histogram)
+{
+    return collectorResources.RequestHeapHistogram(histogram);
+}
+
 void HeapImpl::Init(const HeapParam& param)
 {
     theSpace->Init(param);
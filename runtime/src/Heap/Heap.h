@@ -17,6 +17,7 @@
 #include "Common/BaseObject.h"
 #include "RuntimeConfig.h"
 
+#include <unordered_map>
 #include <unordered_set>
 namespace MapleRuntime {
 class Allocator;
@@ -24,6 +25,13 @@ class AllocBuffer;
 class FinalizerProcessor;
 class CollectorResources;
 
+// The objects of one type in the heap and the bytes they occupy.
+struct TypeCount {
+    size_t count = 0;
+    size_t bytes = 0;
+};
+using HeapHistogram = std::unordered_map<TypeInfo*, TypeCount>;
+
 
 class Heap {
 public:
@@ -86,6 +94,10 @@ public:
 
     virtual bool ForEachObj(const std::function<void(BaseObject*)>&, bool safe) const = 0;
 
+    // Count the objects by type. The caller waits for the next gc cycle, which counts the survivors
+    // of its trace in parallel on the gc thread pool while the mutators keep running.
+    virtual bool GetHeapHistogram(HeapHistogram& histogram) = 0;
+
     virtual void RegisterStaticRoots(Uptr, U32) = 0;
 
     virtual void UnregisterStaticRoots(Uptr, U32) = 0;
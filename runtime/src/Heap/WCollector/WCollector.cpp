@@ -396,6 +396,9 @@ void WCollector::PostTrace()
     MRT_PHASE_TIMER("PostTrace");
     TransitionToGCPhase(GC_PHASE_POST_TRACE, true);
     RegionSpace& space = reinterpret_cast<RegionSpace&>(theAllocator);
+    // Taken before the garbage regions are reclaimed, which drops their live bytes.
+    GetGCStats().tracedBytes = space.AllLiveBytes();
+    collectorResources.RunHeapHistogram();
     space.GetRegionManager().HandleTraceRegions();
     // clear weakRef List, set the referent as null
     WeakRefBuffer::Instance().ClearWeakRefBuffer();
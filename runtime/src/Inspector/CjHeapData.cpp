@@ -6,7 +6,10 @@
 
 
 #include "CjHeapData.h"
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <thread>
 #include <Common/BaseObject.h>
 #include <Common/Runtime.h>
 #include <Common/ScopedObjectAccess.h>
@@ -17,7 +20,9 @@
 #include "ObjectModel/MArray.inline.h"
 #include "Common/BaseObject.h"
 #include "Common/StackType.h"
+#include "Base/TimeUtils.h"
 #include "Concurrency/ConcurrencyModel.h"
+#include "Heap/Allocator/RegionSpace.h"
 #include "Heap/Heap.h"
 #include "ObjectModel/RefField.h"
 #include "Sync/Sync.h"
@@ -38,6 +43,7 @@ void CjHeapData::WriteHeap()
     WriteStackTrace();
     WriteStartThread();
     WriteHeapDump();
+    (void)stream->Write(record);
 }
 
 void CjHeapData::ProcessHeap()
@@ -50,9 +56,144 @@ void CjHeapData::ProcessHeap()
     (void)LookupStringId("RefFields");
     (void)LookupStringId("ValueField");
     //  dump object contents
-    auto dumpVisitor = [this](BaseObject* obj) { ProcessHeapObject(obj); };
-    bool ret = Heap::GetHeap().ForEachObj(dumpVisitor, false);
-    CHECK_E(UNLIKELY(!ret), "theAllocator.ForEachObj() in DumpHeap() return false.");
+    reinterpret_cast<RegionSpace&>(Heap::GetHeap().GetAllocator()).GetRegionManager().GetObjectRegions(regions);
+    ProcessHeapObjects();
+}
+
+bool CjHeapData::CompressFromEnv()
+{
+    return CString::ParseFlagFromEnv(CString(std::getenv("cjHeapDumpCompress")));
+}
+
+// The world is stopped or the dump runs in a forked child, either way the heap does not change
+// while it is visited twice.
+bool CjHeapData::Dump(int fd)
+{
+    uint64_t startTime = TimeUtil::NanoSeconds();
+    unsigned int cpus = std::thread::hardware_concurrency();
+    dumpThreadNum = std::min<size_t>(cpus == 0 ? 1 : cpus, MAX_DUMP_THREADS);
+    HeapDumpStream heapDumpStream(fd, compress);
+    stream = &heapDumpStream;
+    bool ret = heapDumpStream.Begin();
+    if (ret) {
+        ProcessHeap();
+        int64_t tableBytes = static_cast<int64_t>(dumpObjects.capacity() * sizeof(DumpObject) +
+                                                  regions.capacity() * sizeof(RegionInfo*));
+        heapDumpStream.Account(tableBytes);
+        WriteHeap();
+        heapDumpStream.Account(-tableBytes);
+        ret = heapDumpStream.Finish();
+    }
+    heapDumpStream.Release(record);
+    stream = nullptr;
+
+    constexpr uint64_t nsPerMs = 1000 * 1000;
+    LOG(RTLOG_INFO, "Heap dump %s in %zu ms with %zu threads: %zu bytes of records, %zu bytes written, "
+        "%zu bytes buffered at peak", ret ? "finished" : "failed",
+        static_cast<size_t>((TimeUtil::NanoSeconds() - startTime) / nsPerMs), dumpThreadNum,
+        static_cast<size_t>(heapDumpStream.RawBytes()), static_cast<size_t>(heapDumpStream.WrittenBytes()),
+        static_cast<size_t>(heapDumpStream.PeakBufferedBytes()));
+    return ret;
+}
+
+void CjHeapData::VisitRegions(const std::function<void(size_t, RegionInfo*)>& visitor)
+{
+    // 16: regions taken by a thread at a time
+    constexpr size_t regionsPerTake = 16;
+    std::atomic<size_t> next = { 0 };
+    auto work = [this, &visitor, &next](size_t workerId) {
+        for (size_t start = next.fetch_add(regionsPerTake, std::memory_order_relaxed); start < regions.size();
+             start = next.fetch_add(regionsPerTake, std::memory_order_relaxed)) {
+            size_t end = std::min(start + regionsPerTake, regions.size());
+            for (size_t index = start; index < end; ++index) {
+                visitor(workerId, regions[index]);
+            }
+        }
+    };
+    // The pool of the gc may be busy or, in a forked child, gone, so the dump starts threads of its own.
+    std::vector<std::thread> threads;
+    for (size_t workerId = 1; workerId < dumpThreadNum; ++workerId) {
+        threads.emplace_back(work, workerId);
+    }
+    work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void CjHeapData::ProcessHeapObjects()
+{
+    struct Worker {
+        uint64_t bytes = 0;
+        std::set<TypeInfo*> classes;
+        std::set<TypeInfo*> structClasses;
+    };
+    std::vector<Worker> workers(dumpThreadNum);
+    VisitRegions([&workers](size_t workerId, RegionInfo* region) {
+        Worker& worker = workers[workerId];
+        region->VisitAllObjects([&worker](BaseObject* obj) {
+            u1 tag = HeapObjectTag(obj);
+            if (tag == 0) {
+                LOG(RTLOG_ERROR, "object %p has wrong component type", obj);
+                return;
+            }
+            if (tag == TAG_STRUCT_ARRAY_DUMP || tag == TAG_LARGE_STRUCT_ARRAY_DUMP ||
+                tag == TAG_UNMOVABLE_STRUCT_ARRAY_DUMP) {
+                worker.structClasses.insert(obj->GetTypeInfo());
+            } else {
+                worker.classes.insert(obj->GetTypeInfo());
+            }
+            worker.bytes += HeapObjectSize(obj, tag);
+        });
+    });
+    for (Worker& worker : workers) {
+        heapObjectBytes += worker.bytes;
+        for (TypeInfo* klass : worker.classes) {
+            ProcessRootClass(klass);
+        }
+        for (TypeInfo* klass : worker.structClasses) {
+            ProcessStructClass(klass);
+        }
+    }
+}
+
+bool CjHeapData::WriteHeapObjects()
+{
+    std::vector<HeapDumpChunk> chunks(dumpThreadNum);
+    // Only the heap objects are written from here on.
+    uint64_t startBytes = stream->RawBytes();
+    VisitRegions([this, &chunks](size_t workerId, RegionInfo* region) {
+        HeapDumpChunk& chunk = chunks[workerId];
+        region->VisitAllObjects([this, &chunk](BaseObject* obj) {
+            u1 tag = HeapObjectTag(obj);
+            if (tag == 0) {
+                return;
+            }
+            // Large arrays are streamed in slices instead of being buffered whole.
+            if (HeapObjectSize(obj, tag) > HeapDumpChunk::FLUSH_SIZE) {
+                (void)stream->WriteRecord(chunk, [obj, tag](HeapDumpChunk& out) { WriteHeapObject(out, obj, tag); });
+                return;
+            }
+            WriteHeapObject(chunk, obj, tag);
+            if (chunk.Size() >= HeapDumpChunk::FLUSH_SIZE) {
+                (void)stream->Write(chunk);
+            }
+        });
+    });
+    for (HeapDumpChunk& chunk : chunks) {
+        (void)stream->Write(chunk);
+        stream->Release(chunk);
+    }
+    if (stream->Failed()) {
+        return false;
+    }
+    uint64_t written = stream->RawBytes() - startBytes;
+    if (written != heapObjectBytes) {
+        LOG(RTLOG_ERROR, "Heap objects changed while dumping them, %zu bytes counted but %zu bytes written",
+            static_cast<size_t>(heapObjectBytes), static_cast<size_t>(written));
+        return false;
+    }
+    return true;
 }
 
 void CjHeapData::DumpHeap(bool needStopTheWorld)
@@ -91,22 +232,12 @@ void CjHeapData::DumpHeap(bool needStopTheWorld)
         LOG(RTLOG_ERROR, "Failed to open heap dump file, stop dumping heap info, %s", strerror(errno));
         return;
     }
-    // step2 - write file
+    // step2 - write file, records are written to the descriptor and not buffered by the file
     if (needStopTheWorld) {
         ScopedStopTheWorld scopedStopTheWorld("dump heap to file");
-        size_t allocatedSize = Heap::GetHeap().GetAllocatedSize();
-        // 40: Statistical ratio of heap size to object count, used to estimate container capacity
-        const size_t estimateSize = 40;
-        dumpObjects.reserve(allocatedSize / estimateSize);
-        ProcessHeap();
-        WriteHeap();
+        (void)Dump(fileno(fp));
     } else {
-        size_t allocatedSize = Heap::GetHeap().GetAllocatedSize();
-        // 40: Statistical ratio of heap size to object count, used to estimate container capacity
-        const size_t estimateSize = 40;
-        dumpObjects.reserve(allocatedSize / estimateSize);
-        ProcessHeap();
-        WriteHeap();
+        (void)Dump(fileno(fp));
     }
 
     // step3 - close file
@@ -140,21 +271,12 @@ bool CjHeapData::DumpHeap(int fd, bool needStopTheWorld)
         return false;
     }
 
+    bool dumped;
     if (needStopTheWorld) {
         ScopedStopTheWorld scopedStopTheWorld("dump heap to fd");
-        size_t allocatedSize = Heap::GetHeap().GetAllocatedSize();
-        // 40: Statistical ratio of heap size to object count, used to estimate container capacity
-        const size_t estimateSize = 40;
-        dumpObjects.reserve(allocatedSize / estimateSize);
-        ProcessHeap();
-        WriteHeap();
+        dumped = Dump(copyfd);
     } else {
-        size_t allocatedSize = Heap::GetHeap().GetAllocatedSize();
-        // 40: Statistical ratio of heap size to object count, used to estimate container capacity
-        const size_t estimateSize = 40;
-        dumpObjects.reserve(allocatedSize / estimateSize);
-        ProcessHeap();
-        WriteHeap();
+        dumped = Dump(copyfd);
     }
 
     // fclose will close fd
@@ -167,70 +289,94 @@ bool CjHeapData::DumpHeap(int fd, bool needStopTheWorld)
         LOG(RTLOG_ERROR, "Fail to close file when dump heap data finished, %s", strerror(errno));
         return false;
     }
-    return true;
+    return dumped;
 }
 
-void CjHeapData::ProcessHeapObject(BaseObject* obj)
+CjHeapData::u1 CjHeapData::HeapObjectTag(BaseObject* obj)
 {
-    if (obj == nullptr) {
-        return;
-    }
-
-    DumpObject dumpObject = { obj, 0, 0, 0 };
-
+    auto regionInfo = RegionInfo::GetRegionInfoAt(reinterpret_cast<MAddress>(obj));
     if (obj->IsRawArray()) {
         MArray* mArray = reinterpret_cast<MArray*>(obj);
         TypeInfo* componentTypeInfo = mArray->GetComponentTypeInfo();
         if (componentTypeInfo->IsPrimitiveType()) {
-            dumpObject.tag = TAG_PRIMITIVE_ARRAY_DUMP;
-            auto regionInfo = RegionInfo::GetRegionInfoAt(reinterpret_cast<MAddress>(obj));
             if (regionInfo->IsLargeRegion()) {
-                dumpObject.tag = TAG_LARGE_PRIMITIVE_ARRAY_DUMP;
+                return TAG_LARGE_PRIMITIVE_ARRAY_DUMP;
             } else if (regionInfo->IsUnmovableFromRegion()) {
-                dumpObject.tag = TAG_UNMOVABLE_PRIMITIVE_ARRAY_DUMP;
+                return TAG_UNMOVABLE_PRIMITIVE_ARRAY_DUMP;
             }
-            dumpObjects.push_back(dumpObject);
+            return TAG_PRIMITIVE_ARRAY_DUMP;
         } else if (componentTypeInfo->IsStructType()) {
-            dumpObject.tag = TAG_STRUCT_ARRAY_DUMP;
-            auto regionInfo = RegionInfo::GetRegionInfoAt(reinterpret_cast<MAddress>(obj));
             if (regionInfo->IsLargeRegion()) {
-                dumpObject.tag = TAG_LARGE_STRUCT_ARRAY_DUMP;
+                return TAG_LARGE_STRUCT_ARRAY_DUMP;
             } else if (regionInfo->IsUnmovableFromRegion()) {
-                dumpObject.tag = TAG_UNMOVABLE_STRUCT_ARRAY_DUMP;
+                return TAG_UNMOVABLE_STRUCT_ARRAY_DUMP;
             }
-            dumpObjects.push_back(dumpObject);
-            ProcessStructClass(obj->GetTypeInfo());
-            return;
+            return TAG_STRUCT_ARRAY_DUMP;
         } else if (componentTypeInfo->IsObjectType() ||
                    componentTypeInfo->IsArrayType() ||
                    componentTypeInfo->IsInterface()) {
-                dumpObject.tag = TAG_OBJECT_ARRAY_DUMP;
-                auto regionInfo = RegionInfo::GetRegionInfoAt(reinterpret_cast<MAddress>(obj));
-                if (regionInfo->IsLargeRegion()) {
-                    dumpObject.tag = TAG_LARGE_OBJECT_ARRAY_DUMP;
-                } else if (regionInfo->IsUnmovableFromRegion()) {
-                    dumpObject.tag = TAG_UNMOVABLE_OBJECT_ARRAY_DUMP;
-                }
-                dumpObjects.push_back(dumpObject);
-        } else {
-            LOG(RTLOG_ERROR, "array object %p has wrong component type", mArray);
+            if (regionInfo->IsLargeRegion()) {
+                return TAG_LARGE_OBJECT_ARRAY_DUMP;
+            } else if (regionInfo->IsUnmovableFromRegion()) {
+                return TAG_UNMOVABLE_OBJECT_ARRAY_DUMP;
+            }
+            return TAG_OBJECT_ARRAY_DUMP;
         }
+        return 0;
     } else if (obj->GetTypeInfo()->IsVaildType()) {
-        dumpObject.tag = TAG_INSTANCE_DUMP;
-        auto regionInfo = RegionInfo::GetRegionInfoAt(reinterpret_cast<MAddress>(obj));
         if (regionInfo->IsPinnedRegion()) {
-            dumpObject.tag = TAG_PINNED_INSTANCE_DUMP;
+            return TAG_PINNED_INSTANCE_DUMP;
         } else if (regionInfo->IsLargeRegion()) {
-            dumpObject.tag = TAG_LARGE_INSTANCE_DUMP;
+            return TAG_LARGE_INSTANCE_DUMP;
         } else if (regionInfo->IsUnmovableFromRegion()) {
-            dumpObject.tag = TAG_UNMOVABLE_INSTANCE_DUMP;
+            return TAG_UNMOVABLE_INSTANCE_DUMP;
         }
-        dumpObjects.push_back(dumpObject);
-    } else {
-        LOG(RTLOG_ERROR, "object %p has wrong component type", obj);
-        return;
+        return TAG_INSTANCE_DUMP;
+    }
+    return 0;
+}
+
+// The size of the record written by WriteHeapObject, taken from the lengths and the GCTibs.
+CjHeapData::u8 CjHeapData::HeapObjectSize(BaseObject* obj, const u1 tag)
+{
+    constexpr u8 idSize = sizeof(CjHeapDataID);
+    switch (tag) {
+        case TAG_OBJECT_ARRAY_DUMP:
+        case TAG_LARGE_OBJECT_ARRAY_DUMP:
+        case TAG_UNMOVABLE_OBJECT_ARRAY_DUMP: {
+            u8 length = reinterpret_cast<MArray*>(obj)->GetLength();
+            return sizeof(u1) + idSize + sizeof(u4) + idSize + length * idSize;
+        }
+        case TAG_STRUCT_ARRAY_DUMP:
+        case TAG_LARGE_STRUCT_ARRAY_DUMP:
+        case TAG_UNMOVABLE_STRUCT_ARRAY_DUMP: {
+            MArray* mArray = reinterpret_cast<MArray*>(obj);
+            TypeInfo* componentTypeInfo = mArray->GetComponentTypeInfo();
+            u8 num = componentTypeInfo->HasRefField() ?
+                static_cast<u8>(mArray->GetLength()) * componentTypeInfo->GetGCTib().GetRefFieldCount() : 0;
+            return sizeof(u1) + idSize + sizeof(u4) + sizeof(u4) + idSize + num * idSize;
+        }
+        case TAG_PRIMITIVE_ARRAY_DUMP:
+        case TAG_LARGE_PRIMITIVE_ARRAY_DUMP:
+        case TAG_UNMOVABLE_PRIMITIVE_ARRAY_DUMP: {
+            MSize componentSize = obj->GetTypeInfo()->GetComponentSize();
+            if (componentSize == 0) {
+                return 0;
+            }
+            // The element type is only written for components of 1, 2, 4 or 8 bytes.
+            bool typed = componentSize == 1 || componentSize == 2 || componentSize == 4 || componentSize == 8;
+            return sizeof(u1) + idSize + sizeof(u4) + (typed ? sizeof(u1) : 0);
+        }
+        case TAG_INSTANCE_DUMP:
+        case TAG_PINNED_INSTANCE_DUMP:
+        case TAG_LARGE_INSTANCE_DUMP:
+        case TAG_UNMOVABLE_INSTANCE_DUMP: {
+            u8 num = obj->HasRefField() ? obj->GetTypeInfo()->GetGCTib().GetRefFieldCount() : 0;
+            return sizeof(u1) + idSize + idSize + sizeof(u4) + num * idSize;
+        }
+        default:
+            return 0;
     }
-    ProcessRootClass(obj->GetTypeInfo());
 }
 
 void CjHeapData::ProcessRootClass(TypeInfo* klass)
@@ -349,16 +495,17 @@ void CjHeapData::ProcessRootFinalizer()
     Heap::GetHeap().GetFinalizerProcessor().VisitGCRoots(visitor);
 }
 
+// The classes and the roots are buffered with the header of the record, the heap objects are
+// streamed after them by the threads that visit them.
 void CjHeapData::WriteHeapDump()
 {
-    const size_t reservedObjSize = 24;
-    buffer.reserve(dumpObjects.size() * reservedObjSize);
     WriteRecordHeader(TAG_HEAP_DUMP, kCjHeapDataTime);
     WriteAllClass();
     WriteAllStructClass();
     WriteAllObjects();
-    ModifyLength();
-    EndRecord();
+    ModifyLength(heapObjectBytes);
+    (void)stream->Write(record);
+    (void)WriteHeapObjects();
 }
 /*
  * Record thread info:
@@ -412,32 +559,40 @@ void CjHeapData::WriteAllObjects()
             case TAG_ROOT_UNKNOWN:
                 WriteUnknownRoot(objectInfo.obj, objectInfo.tag);
                 break;
-            case TAG_OBJECT_ARRAY_DUMP:
-            case TAG_LARGE_OBJECT_ARRAY_DUMP:
-            case TAG_UNMOVABLE_OBJECT_ARRAY_DUMP:
-                WriteObjectArray(objectInfo.obj, objectInfo.tag);
-                break;
-            case TAG_STRUCT_ARRAY_DUMP:
-            case TAG_LARGE_STRUCT_ARRAY_DUMP:
-            case TAG_UNMOVABLE_STRUCT_ARRAY_DUMP:
-                WriteStructArray(objectInfo.obj, objectInfo.tag);
-                break;
-            case TAG_PRIMITIVE_ARRAY_DUMP:
-            case TAG_LARGE_PRIMITIVE_ARRAY_DUMP:
-            case TAG_UNMOVABLE_PRIMITIVE_ARRAY_DUMP:
-                WritePrimitiveArray(objectInfo.obj, objectInfo.tag);
-                break;
-            case TAG_INSTANCE_DUMP:
-            case TAG_PINNED_INSTANCE_DUMP:
-            case TAG_LARGE_INSTANCE_DUMP:
-            case TAG_UNMOVABLE_INSTANCE_DUMP:
-                WriteInstance(objectInfo.obj, objectInfo.tag);
-                break;
             default:
                 break;
         }
     }
 }
+
+void CjHeapData::WriteHeapObject(HeapDumpChunk& out, BaseObject* obj, const u1 tag)
+{
+    switch (tag) {
+        case TAG_OBJECT_ARRAY_DUMP:
+        case TAG_LARGE_OBJECT_ARRAY_DUMP:
+        case TAG_UNMOVABLE_OBJECT_ARRAY_DUMP:
+            WriteObjectArray(out, obj, tag);
+            break;
+        case TAG_STRUCT_ARRAY_DUMP:
+        case TAG_LARGE_STRUCT_ARRAY_DUMP:
+        case TAG_UNMOVABLE_STRUCT_ARRAY_DUMP:
+            WriteStructArray(out, obj, tag);
+            break;
+        case TAG_PRIMITIVE_ARRAY_DUMP:
+        case TAG_LARGE_PRIMITIVE_ARRAY_DUMP:
+        case TAG_UNMOVABLE_PRIMITIVE_ARRAY_DUMP:
+            WritePrimitiveArray(out, obj, tag);
+            break;
+        case TAG_INSTANCE_DUMP:
+        case TAG_PINNED_INSTANCE_DUMP:
+        case TAG_LARGE_INSTANCE_DUMP:
+        case TAG_UNMOVABLE_INSTANCE_DUMP:
+            WriteInstance(out, obj, tag);
+            break;
+        default:
+            break;
+    }
+}
 /*
  * Record Global Root Info:
  *     u1 tag;     //denoting the type of this sub-record
@@ -506,23 +661,21 @@ void CjHeapData::WriteThreadObjectRoot(BaseObject*& obj, const u1 tag, const u4
  *     ID elements[num];   // elements
  *
  */
-void CjHeapData::WriteObjectArray(BaseObject*& obj, const u1 tag)
+void CjHeapData::WriteObjectArray(HeapDumpChunk& out, BaseObject* obj, const u1 tag)
 {
-    AddU1(tag);
+    out.AddU1(tag);
     CjHeapDataID objId = (reinterpret_cast<CjHeapDataID>(obj));
-    AddStringId(objId);
+    out.AddU8(objId);
     // take array length and content.
     MArray* mArray = reinterpret_cast<MArray*>(obj);
     MIndex arrayLengthVal = mArray->GetLength();
     RefField<>* arrayContent = reinterpret_cast<RefField<>*>(mArray->ConvertToCArray());
+    out.AddU4(static_cast<u4>(arrayLengthVal));
+    out.AddU8(reinterpret_cast<CjHeapDataID>(obj->GetTypeInfo()));
     // for each object in array.
-    std::vector<u8> VAL(arrayLengthVal);
     for (MIndex i = 0; i < arrayLengthVal; ++i) {
-        VAL[i] = reinterpret_cast<CjHeapDataID>(arrayContent[i].GetTargetObject());
+        out.AddU8(reinterpret_cast<CjHeapDataID>(arrayContent[i].GetTargetObject()));
     }
-    AddU4(static_cast<u4>(arrayLengthVal));
-    AddStringId(reinterpret_cast<CjHeapDataID>(obj->GetTypeInfo()));
-    AddU8List(VAL.data(), VAL.size());
 }
 
 /*
@@ -536,16 +689,13 @@ void CjHeapData::WriteObjectArray(BaseObject*& obj, const u1 tag)
  *
  */
 
- void CjHeapData::WriteStructArray(BaseObject*& obj, const u1 tag)
+ void CjHeapData::WriteStructArray(HeapDumpChunk& out, BaseObject* obj, const u1 tag)
 {
-    AddU1(tag);
+    out.AddU1(tag);
     CjHeapDataID objId = (reinterpret_cast<CjHeapDataID>(obj));
-    AddStringId(objId);
-    u4 num = 0;
-    std::vector<u8> VAL;
-    RefFieldVisitor visitor = [&VAL, &num](RefField<>& arrayContent) {
-        VAL.push_back(reinterpret_cast<CjHeapDataID>(arrayContent.GetTargetObject()));
-        num++;
+    out.AddU8(objId);
+    RefFieldVisitor visitor = [&out](RefField<>& arrayContent) {
+        out.AddU8(reinterpret_cast<CjHeapDataID>(arrayContent.GetTargetObject()));
     };
     // take array length and content.
     MArray* mArray = reinterpret_cast<MArray*>(obj);
@@ -553,17 +703,16 @@ void CjHeapData::WriteObjectArray(BaseObject*& obj, const u1 tag)
     TypeInfo* componentTypeInfo = mArray->GetComponentTypeInfo();
     GCTib gcTib = componentTypeInfo->GetGCTib();
     MAddress contentAddr = reinterpret_cast<Uptr>(mArray) + MArray::GetContentOffset();
-    if (componentTypeInfo->HasRefField()) {
-        VAL.reserve(arrayLengthVal);
+    u4 num = componentTypeInfo->HasRefField() ? arrayLengthVal * gcTib.GetRefFieldCount() : 0;
+    out.AddU4(arrayLengthVal);
+    out.AddU4(num);
+    out.AddU8(reinterpret_cast<CjHeapDataID>(obj->GetTypeInfo()));
+    if (num != 0) {
         for (MIndex i = 0; i < arrayLengthVal; ++i) {
             gcTib.ForEachBitmapWord(contentAddr, visitor);
             contentAddr += mArray->GetElementSize();
         }
     }
-    AddU4(arrayLengthVal);
-    AddU4(num);
-    AddStringId(reinterpret_cast<CjHeapDataID>(obj->GetTypeInfo()));
-    AddU8List(VAL.data(), VAL.size());
 }
 
 /*
@@ -574,33 +723,33 @@ void CjHeapData::WriteObjectArray(BaseObject*& obj, const u1 tag)
  *     u1 type;         // element type
  */
 
-void CjHeapData::WritePrimitiveArray(BaseObject*& obj, const u1 tag)
+void CjHeapData::WritePrimitiveArray(HeapDumpChunk& out, BaseObject* obj, const u1 tag)
 {
     MSize componentSize = obj->GetTypeInfo()->GetComponentSize();
     if (componentSize == 0) {
         return;
     }
-    AddU1(tag);
+    out.AddU1(tag);
     CjHeapDataID objId = (reinterpret_cast<CjHeapDataID>(obj));
-    AddStringId(objId);
+    out.AddU8(objId);
     MArray* mArray = reinterpret_cast<MArray*>(obj);
-    AddU4(mArray->GetLength());
+    out.AddU4(mArray->GetLength());
     switch (componentSize) {
         // bool:1 bytes
         case 1:
-            AddU1(BOOLEAN);
+            out.AddU1(BOOLEAN);
             break;
         // short:2 bytes
         case 2:
-            AddU1(SHORT);
+            out.AddU1(SHORT);
             break;
         // int:4 bytes
         case 4:
-            AddU1(INT);
+            out.AddU1(INT);
             break;
         // long:8 bytes
         case 8:
-            AddU1(LONG);
+            out.AddU1(LONG);
             break;
         default:
             break;
@@ -651,27 +800,23 @@ void CjHeapData::WriteClass(TypeInfo* klass, CjHeapDataStringId klassId, const u
  *     u4 num;           // number of ref fields
  *     VAL entry[];      // ref contents in instance field values (this class, followed by super class, etc)
  */
-void CjHeapData::WriteInstance(BaseObject*& obj, const u1 tag)
+void CjHeapData::WriteInstance(HeapDumpChunk& out, BaseObject* obj, const u1 tag)
 {
-    AddU1(tag);
+    out.AddU1(tag);
     CjHeapDataID objId = (reinterpret_cast<CjHeapDataID>(obj));
-    AddStringId(objId);
-    AddStringId(reinterpret_cast<CjHeapDataID>(obj->GetTypeInfo()));
-    u4 num = 0;
-    std::vector<u8> VAL;
-    VAL.reserve(obj->GetTypeInfo()->GetFieldNum());
-    RefFieldVisitor visitor = [&VAL, &num](RefField<>& fieldAddr) {
-        VAL.push_back(reinterpret_cast<u8>(fieldAddr.GetTargetObject()));
-        num++;
-    };
-    TypeInfo* currentClass = obj->GetTypeInfo();
-    if (obj->HasRefField()) {
-        GCTib gcTib = currentClass->GetGCTib();
-        MAddress objAddr = reinterpret_cast<MAddress>(obj) + TYPEINFO_PTR_SIZE;
-        gcTib.ForEachBitmapWord(objAddr, visitor);
+    out.AddU8(objId);
+    out.AddU8(reinterpret_cast<CjHeapDataID>(obj->GetTypeInfo()));
+    if (!obj->HasRefField()) {
+        out.AddU4(0);
+        return;
     }
-    AddU4(num);
-    AddU8List(VAL.data(), VAL.size());
+    RefFieldVisitor visitor = [&out](RefField<>& fieldAddr) {
+        out.AddU8(reinterpret_cast<u8>(fieldAddr.GetTargetObject()));
+    };
+    GCTib gcTib = obj->GetTypeInfo()->GetGCTib();
+    out.AddU4(gcTib.GetRefFieldCount());
+    MAddress objAddr = reinterpret_cast<MAddress>(obj) + TYPEINFO_PTR_SIZE;
+    gcTib.ForEachBitmapWord(objAddr, visitor);
 }
 
 /*
@@ -759,127 +904,19 @@ void CjHeapData::WriteStackTrace()
  */
 void CjHeapData::WriteRecordHeader(const u1 tag, const u4 time)
 {
+    recordStart = record.Size();
     AddU1(tag);
     // DEADDEADEADDEAD: placeholder, the actual length is filled in Func modifyLength.
     const u8 tmpLens = 0xDEADDEADEADDEAD;
     AddU8(tmpLens);
 }
 
-void CjHeapData::AddU1(const u1 value) { AddU1List(&value, 1); }
-
-void CjHeapData::AddU2(const u2 value) { AddU2List(&value, 1); }
-
-void CjHeapData::AddU4(const u4 value) { AddU4List(&value, 1); }
-
-void CjHeapData::AddU8(const u8 value) { AddU8List(&value, 1); }
-
-void CjHeapData::AddID(const u8 value) { AddU8List(&value, 1); }
-
-void CjHeapData::AddU1List(const u1* value, size_t count)
-{
-    HandleAddU1(value, count);
-    length += count;
-}
-
-void CjHeapData::AddU2List(const u2* value, size_t count)
-{
-    HandleAddU2(value, count);
-    length += count * sizeof(u2);
-}
-
-void CjHeapData::AddU4List(const u4* value, size_t count)
-{
-    HandleAddU4(value, count);
-    length += count * sizeof(u4);
-}
-void CjHeapData::AddU8List(const u8* value, size_t count)
-{
-    HandleAddU8(value, count);
-    length += count * sizeof(u8);
-}
-
-enum ByteOffset {
-    FIRST_BYTE = 0 * 8,
-    SECOND_BYTE = 1 * 8,
-    THIRD_BYTE = 2 * 8,
-    FOURTH_BYTE = 3 * 8,
-    FIFTH_BYTE = 4 * 8,
-    SIXTH_BYTE = 5 * 8,
-    SEVENTH_BYTE = 6 * 8,
-    EIGHTH_BYTE = 7 * 8
-};
-
-void CjHeapData::HandleAddU1(const u1* value, size_t count) { buffer.insert(buffer.end(), value, value + count); }
-
-void CjHeapData::HandleAddU2(const u2* value, size_t count)
-{
-    size_t oldSize = buffer.size();
-    buffer.resize(oldSize + count * sizeof(u2));
-    uint8_t* dst = buffer.data() + oldSize;
-    for (size_t i = 0; i < count; ++i) {
-        u2 val = *value++;
-        // 0: Stores 2th byte
-        dst[0] = static_cast<uint8_t>((val >> SECOND_BYTE) & 0xFF);
-        // 1: Stores 1th byte
-        dst[1] = static_cast<uint8_t>((val >> FIRST_BYTE) & 0xFF);
-        dst += sizeof(u2);
-    }
-}
-
-void CjHeapData::HandleAddU4(const u4* value, size_t count)
-{
-    size_t oldSize = buffer.size();
-    buffer.resize(oldSize + count * sizeof(u4));
-    uint8_t* dst = buffer.data() + oldSize;
-    for (size_t i = 0; i < count; ++i) {
-        u4 val = *value++;
-        // 0: Stores 4th byte
-        dst[0] = static_cast<uint8_t>((val >> FOURTH_BYTE) & 0xFF);
-        // 1: Stores 3th byte
-        dst[1] = static_cast<uint8_t>((val >> THIRD_BYTE) & 0xFF);
-        // 2: Stores 2th byte
-        dst[2] = static_cast<uint8_t>((val >> SECOND_BYTE) & 0xFF);
-        // 3: Stores 1th byte
-        dst[3] = static_cast<uint8_t>((val >> FIRST_BYTE) & 0xFF);
-        dst += sizeof(u4);
-    }
-}
-
-void CjHeapData::HandleAddU8(const u8* value, size_t count)
-{
-    size_t oldSize = buffer.size();
-    buffer.resize(oldSize + count * sizeof(u8));
-    uint8_t* dst = buffer.data() + oldSize;
-    for (size_t i = 0; i < count; ++i) {
-        u8 val = *value++;
-        // 0: Stores 8th byte
-        dst[0] = static_cast<uint8_t>((val >> EIGHTH_BYTE) & 0xFF);
-        // 1: Stores 7th byte
-        dst[1] = static_cast<uint8_t>((val >> SEVENTH_BYTE) & 0xFF);
-        // 2: Stores 6th byte
-        dst[2] = static_cast<uint8_t>((val >> SIXTH_BYTE) & 0xFF);
-        // 3: Stores 5th byte
-        dst[3] = static_cast<uint8_t>((val >> FIFTH_BYTE) & 0xFF);
-        // 4: Stores 4th byte
-        dst[4] = static_cast<uint8_t>((val >> FOURTH_BYTE) & 0xFF);
-        // 5: Stores 3th byte
-        dst[5] = static_cast<uint8_t>((val >> THIRD_BYTE) & 0xFF);
-        // 6: Stores 2th byte
-        dst[6] = static_cast<uint8_t>((val >> SECOND_BYTE) & 0xFF);
-        // 7: Stores 1th byte
-        dst[7] = static_cast<uint8_t>((val >> FIRST_BYTE) & 0xFF);
-        dst += sizeof(u8);
-    }
-}
-
-void CjHeapData::AddStringId(CjHeapData::CjHeapDataStringId value) { AddID(static_cast<const u8>(value)); }
-
+// Records are handed to the stream once a chunk of them is buffered.
 void CjHeapData::EndRecord()
 {
-    const char* ptr = reinterpret_cast<const char*>(buffer.data());
-    fwrite(ptr, length, 1, fp);
-    length = 0;
-    std::vector<uint8_t>().swap(buffer);
+    if (record.Size() >= HeapDumpChunk::FLUSH_SIZE) {
+        (void)stream->Write(record);
+    }
 }
 
 void CjHeapData::WriteFixedHeader()
@@ -925,20 +962,13 @@ void CjHeapData::WriteClassLoad(TypeInfo* klass, CjHeapDataStringId klassId, con
     EndRecord();
 }
 
-void CjHeapData::ModifyLength()
+void CjHeapData::ModifyLength(uint64_t extraLength)
 {
     // 9: Subtract the length of the record header
     constexpr uint8_t recordHeaderLength = 9;
-    uint64_t value = length - recordHeaderLength;
-    // 1,2,3,4,5,6,7,8: Stores 64 bits for length
-    buffer[1] = (static_cast<uint8_t>((value >> EIGHTH_BYTE) & 0xFF));
-    buffer[2] = (static_cast<uint8_t>((value >> SEVENTH_BYTE) & 0xFF));
-    buffer[3] = (static_cast<uint8_t>((value >> SIXTH_BYTE) & 0xFF));
-    buffer[4] = (static_cast<uint8_t>((value >> FIFTH_BYTE) & 0xFF));
-    buffer[5] = (static_cast<uint8_t>((value >> FOURTH_BYTE) & 0xFF));
-    buffer[6] = (static_cast<uint8_t>((value >> THIRD_BYTE) & 0xFF));
-    buffer[7] = (static_cast<uint8_t>((value >> SECOND_BYTE) & 0xFF));
-    buffer[8] = (static_cast<uint8_t>((value >> FIRST_BYTE) & 0xFF));
+    uint64_t value = record.Size() - recordStart - recordHeaderLength + extraLength;
+    // 1: the length follows the tag
+    record.PatchU8(recordStart + 1, value);
 }
 
 CjHeapData::CjHeapDataStringId CjHeapData::LookupStringId(const CString& string)
@@ -10,17 +10,27 @@
 
 #include <Common/BaseObject.h>
 #include <Common/StackType.h>
+#include <functional>
 #include <map>
 #include <set>
 #include <stack>
 #include <sys/time.h>
 #include "Base/CString.h"
+#include "HeapDumpWriter.h"
 #include "UnwindStack/GcStackInfo.h"
 namespace MapleRuntime {
+class RegionInfo;
+
+// Writes the heap in the HPROF-like format of cjprof. Objects are visited and written by several
+// threads region by region, every thread streams its records to the file in chunks of a bounded
+// size, so the dump takes little memory besides the roots and the types. The records of the heap
+// are sized in a first pass to know the length of the heap dump record before it is written.
+// Set cjHeapDumpCompress to compress the dump into an LZ4 frame.
 class CjHeapData {
 public:
     CjHeapData() = default;
     explicit CjHeapData(bool fromOOM) : dumpAfterOOM(fromOOM) {}
+    CjHeapData(bool fromOOM, bool compress) : dumpAfterOOM(fromOOM), compress(compress) {}
 
     ~CjHeapData()
     {
@@ -105,6 +115,7 @@ public:
         CjHeapDataStringId klassId;
     };
 
+    // The roots, heap objects are visited by region when they are written.
     std::vector<DumpObject> dumpObjects;
     std::map<TypeInfo*, CjHeapDataStringId> dumpClassMap;
     std::map<TypeInfo*, CjHeapDataStringId> dumpStructClassMap;
@@ -119,8 +130,14 @@ public:
 
     void DumpHeap(bool needStopTheWorld = true);
     bool DumpHeap(int fd, bool needStopTheWorld = true);
+    bool Dump(int fd);
+    static bool CompressFromEnv();
     void WriteHeap();
     void ProcessHeap();
+    // Size the records of the heap objects and collect their types.
+    void ProcessHeapObjects();
+    bool WriteHeapObjects();
+    void VisitRegions(const std::function<void(size_t, RegionInfo*)>& visitor);
 
     void WriteFixedHeader();
     void WriteString();
@@ -138,32 +155,28 @@ public:
     void WriteBitmapWordFileds(GCTib tib, bool isObject, int fieldNum);
     void WriteGCTibType(GCTib tib);
     void ProcessStacktrace(RecordStackInfo* recordStackInfo);
-    void AddU1(const u1 value); // add len = 1
-    void AddU2(const u2 value); // add len = 1
-    void AddU4(const u4 value); // add len = 1
-    void AddU8(const u8 value); // add len = 1
-    void AddID(const u8 value); // add len = 1
-
-    void ModifyLength();
+    void AddU1(const u1 value) { record.AddU1(value); }
+    void AddU2(const u2 value) { record.AddU2(value); }
+    void AddU4(const u4 value) { record.AddU4(value); }
+    void AddU8(const u8 value) { record.AddU8(value); }
+    void AddID(const u8 value) { record.AddU8(value); }
 
-    void AddU1List(const u1* value, size_t count);
-    void AddU2List(const u2* value, size_t count);
-    void AddU4List(const u4* value, size_t count);
-    void AddU8List(const u8* value, size_t count);
+    // `extraLength` is the length of the contents that follow the record buffered so far.
+    void ModifyLength(uint64_t extraLength = 0);
 
-    void HandleAddU1(const u1* value, size_t count);
-    void HandleAddU2(const u2* value, size_t count);
-    void HandleAddU4(const u4* value, size_t count);
-    void HandleAddU8(const u8* value, size_t count);
+    void AddU1List(const u1* value, size_t count) { record.AddBytes(value, count); }
+    void AddU8List(const u8* value, size_t count) { record.AddU8List(value, count); }
 
-    void AddStringId(CjHeapDataStringId value);
+    void AddStringId(CjHeapDataStringId value) { record.AddU8(value); }
 
     void ProcessRootGlobal();
     void ProcessRootConcurrencyModel();
     void ProcessRootLocal();
     void ProcessRootThreadObject();
     void ProcessRootFinalizer();
-    void ProcessHeapObject(BaseObject* roots);
+    // The tag of the record of a heap object, 0 for objects that are not dumped.
+    static u1 HeapObjectTag(BaseObject* obj);
+    static u8 HeapObjectSize(BaseObject* obj, const u1 tag);
     void ProcessRootClass(TypeInfo* klass);
     void ProcessStructClass(TypeInfo* klass);
 
@@ -171,10 +184,11 @@ public:
     void WriteUnknownRoot(BaseObject*& obj, const u1 tag);
     void WriteLocalRoot(BaseObject*& obj, const u1 tag, const u4 tid, const u1 depth);
     void WriteThreadObjectRoot(BaseObject*& obj, const u1 tag, const u4 tid, const u4 stackTraceIdx);
-    void WriteObjectArray(BaseObject*& obj, const u1 tag);
-    void WriteStructArray(BaseObject*& obj, const u1 tag);
-    void WritePrimitiveArray(BaseObject*& obj, const u1 tag);
-    void WriteInstance(BaseObject*& obj, const u1 tag);
+    static void WriteHeapObject(HeapDumpChunk& out, BaseObject* obj, const u1 tag);
+    static void WriteObjectArray(HeapDumpChunk& out, BaseObject* obj, const u1 tag);
+    static void WriteStructArray(HeapDumpChunk& out, BaseObject* obj, const u1 tag);
+    static void WritePrimitiveArray(HeapDumpChunk& out, BaseObject* obj, const u1 tag);
+    static void WriteInstance(HeapDumpChunk& out, BaseObject* obj, const u1 tag);
     void WriteClass(TypeInfo* klass, CjHeapDataStringId klassId, const u1 tag);
     void WriteStructClass(TypeInfo* klass, CjHeapDataStringId klassId, const u1 tag);
 
@@ -182,8 +196,16 @@ public:
     void GetFrameInfo(FrameInfo frame, const u1 tag);
     void EndRecord();
 
-    std::vector<uint8_t> buffer; // buffer 8byte vector
-    uint64_t length = 0;
+    // Records are buffered here and handed to the stream in chunks, see EndRecord.
+    HeapDumpChunk record;
+    size_t recordStart = 0;
+    HeapDumpStream* stream = nullptr;
+    bool compress = CompressFromEnv();
+    // 8: more threads gain little as the file is written by one at a time.
+    static constexpr size_t MAX_DUMP_THREADS = 8;
+    size_t dumpThreadNum = 1;
+    std::vector<RegionInfo*> regions;
+    uint64_t heapObjectBytes = 0;
 
     CjHeapDataStringId LookupStringId(const CString& string);
     CjHeapData::CjHeapDataStringId stringId = 0x40000000;
@@ -196,7 +218,7 @@ public:
     std::unordered_map<FrameInfo*, CjHeapDataStringId> frameFuncNames;
     std::unordered_map<FrameInfo*, CjHeapDataStringId> frameFileNames;
     std::unordered_map<RecordStackInfo*, CjHeapDataStackTraceSerialNumber> stacktraces;
-    FILE* fp;
+    FILE* fp = nullptr;
     CjHeapDataStackFrameId frameId = 0;
     CjHeapDataStackFrameId threadNameId = 0;
     u4 threadId = 0;
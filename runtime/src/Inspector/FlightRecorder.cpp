@@ -0,0 +1,102 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "FlightRecorder.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Base/Log.h"
+#include "Base/TimeUtils.h"
+#include "schedule.h"
+
+namespace MapleRuntime {
+bool FlightRecorder::Start(uint32_t windowMs, uint32_t bufNum)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    if (IsRunning()) {
+        LOG(RTLOG_ERROR, "Flight recorder is already running");
+        return false;
+    }
+    constexpr uint64_t nsPerMs = 1000 * 1000;
+    const char* dirEnv = std::getenv("cjFlightRecorderDir");
+    dumpDir = CString(dirEnv).RemoveBlankSpace();
+    const char* pauseEnv = std::getenv("cjFlightRecorderPauseMs");
+    uint64_t pauseMs = DEFAULT_PAUSE_THRESHOLD_MS;
+    if (pauseEnv != nullptr) {
+        char* end = nullptr;
+        uint64_t value = std::strtoull(pauseEnv, &end, 10); // 10: decimal
+        if (end != pauseEnv && *end == '\0') {
+            pauseMs = value;
+        } else {
+            LOG(RTLOG_ERROR, "cjFlightRecorderPauseMs %s is not a number, use %llu ms", pauseEnv,
+                static_cast<unsigned long long>(DEFAULT_PAUSE_THRESHOLD_MS));
+        }
+    }
+    pauseThresholdNs = pauseMs * nsPerMs;
+    windowNs = static_cast<uint64_t>(windowMs) * nsPerMs;
+    autoDumpCnt = 0;
+    if (!ScheduleStartFlightRecorder(TRACE_TYPE_ALL, windowMs, bufNum)) {
+        LOG(RTLOG_ERROR, "Start flight recorder failed");
+        return false;
+    }
+    running.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool FlightRecorder::Stop()
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    if (!IsRunning()) {
+        return false;
+    }
+    running.store(false, std::memory_order_relaxed);
+    return ScheduleStopTrace();
+}
+
+bool FlightRecorder::Dump(int fd)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    if (!IsRunning() || fd < 0) {
+        LOG(RTLOG_ERROR, "Flight recorder is not running or fd %d is invalid", fd);
+        return false;
+    }
+    return ScheduleDumpFlightRecorder(fd);
+}
+
+// A dump already being written is not waited for, the trigger may be a thread the writer waits on.
+void FlightRecorder::AutoDump(const char* trigger)
+{
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !IsRunning() || dumpDir.IsEmpty()) {
+        return;
+    }
+    // The next window would mostly repeat the last dump, and the number of dumps is bounded.
+    uint64_t now = TimeUtil::NanoSeconds();
+    if (autoDumpCnt >= MAX_AUTO_DUMPS || (autoDumpCnt > 0 && now - lastAutoDumpNs < windowNs)) {
+        return;
+    }
+    lastAutoDumpNs = now;
+    autoDumpCnt++;
+    CString path = CString::FormatString("%s/cjflight-%d-%u-%s.trace", dumpDir.Str(), static_cast<int>(getpid()),
+                                         autoDumpCnt, trigger);
+    int fd = open(path.Str(), O_WRONLY | O_CREAT | O_TRUNC, 0644); // 0644: rw-r--r--
+    if (fd < 0) {
+        LOG(RTLOG_ERROR, "Open flight recorder dump %s failed. msg: %s", path.Str(), strerror(errno));
+        return;
+    }
+    bool dumped = ScheduleDumpFlightRecorder(fd);
+    (void)close(fd);
+    if (dumped) {
+        LOG(RTLOG_REPORT, "Flight recorder dumped to %s", path.Str());
+    } else {
+        LOG(RTLOG_ERROR, "Flight recorder dump to %s failed", path.Str());
+    }
+}
+} // namespace MapleRuntime
@@ -0,0 +1,73 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_FLIGHT_RECORDER_H
+#define MRT_FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "Base/CString.h"
+
+namespace MapleRuntime {
+// Keeps the latest window of scheduler and runtime trace events, see ScheduleStartFlightRecorder.
+// Besides the dumps asked for, the window is dumped to the directory set by cjFlightRecorderDir
+// after a long stop-the-world pause, on a stop-the-world timeout and on an uncaught exception.
+class FlightRecorder {
+public:
+    static FlightRecorder& GetInstance()
+    {
+        static FlightRecorder instance;
+        return instance;
+    }
+
+    bool Start(uint32_t windowMs, uint32_t bufNum);
+    bool Stop();
+    // Write the window to `fd` in the format of the scheduler trace.
+    bool Dump(int fd);
+    bool IsRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // Triggers of the automatic dumps, cheap while the recorder is off.
+    void OnStopTheWorldEnd(uint64_t pauseNs)
+    {
+        if (IsRunning() && pauseNs >= pauseThresholdNs) {
+            AutoDump("stw-pause");
+        }
+    }
+    void OnStopTheWorldTimeout()
+    {
+        if (IsRunning()) {
+            AutoDump("stw-timeout");
+        }
+    }
+    void OnUncaughtException()
+    {
+        if (IsRunning()) {
+            AutoDump("exception");
+        }
+    }
+
+private:
+    FlightRecorder() = default;
+    ~FlightRecorder() = default;
+    void AutoDump(const char* trigger);
+
+    static constexpr uint64_t DEFAULT_PAUSE_THRESHOLD_MS = 100;
+    static constexpr uint32_t MAX_AUTO_DUMPS = 16;
+
+    // Serializes start, stop and dumps, the trace library is unloaded by stop.
+    std::mutex mutex;
+    std::atomic<bool> running { false };
+    CString dumpDir;
+    uint64_t pauseThresholdNs { DEFAULT_PAUSE_THRESHOLD_MS * 1000 * 1000 };
+    uint64_t windowNs { 0 };
+    uint64_t lastAutoDumpNs { 0 };
+    uint32_t autoDumpCnt { 0 };
+};
+} // namespace MapleRuntime
+#endif // MRT_FLIGHT_RECORDER_H
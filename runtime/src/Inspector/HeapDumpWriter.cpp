@@ -0,0 +1,341 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "HeapDumpWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#include "Base/Log.h"
+#include "securec.h"
+
+namespace MapleRuntime {
+namespace {
+constexpr uint32_t LZ4_FRAME_MAGIC = 0x184D2204;
+// Version 01 with independent blocks, so the blocks of the threads can be written in any order.
+constexpr uint8_t LZ4_FRAME_FLG = 0x60;
+// Blocks of at most 4 MB.
+constexpr uint8_t LZ4_FRAME_BD = 0x70;
+constexpr size_t LZ4_MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+constexpr uint32_t LZ4_UNCOMPRESSED_BLOCK = 0x80000000;
+
+constexpr size_t LZ4_MIN_MATCH = 4;
+// The last 5 bytes of a block are literals and the last match starts 12 bytes before its end.
+constexpr size_t LZ4_LAST_LITERALS = 5;
+constexpr size_t LZ4_MF_LIMIT = 12;
+constexpr size_t LZ4_MAX_OFFSET = 0xFFFF;
+constexpr uint32_t LZ4_HASH_LOG = 12;
+constexpr uint8_t LZ4_RUN_MASK = 0x0F;
+constexpr uint8_t LZ4_LEN_BYTE = 0xFF;
+
+void PutLE32(uint8_t* dst, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) { // 4: bytes of uint32_t
+        dst[i] = static_cast<uint8_t>(value >> (i * 8)); // 8: bits per byte
+    }
+}
+
+uint32_t ReadU32(const uint8_t* src)
+{
+    uint32_t value;
+    (void)memcpy_s(&value, sizeof(value), src, sizeof(value));
+    return value;
+}
+
+// xxHash32 of a few bytes, the frame descriptor is checked with it.
+uint32_t XXHash32Small(const uint8_t* data, size_t size)
+{
+    constexpr uint32_t prime1 = 2654435761U;
+    constexpr uint32_t prime2 = 2246822519U;
+    constexpr uint32_t prime3 = 3266489917U;
+    constexpr uint32_t prime5 = 374761393U;
+    uint32_t hash = prime5 + static_cast<uint32_t>(size);
+    for (size_t i = 0; i < size; ++i) {
+        hash += data[i] * prime5;
+        hash = ((hash << 11) | (hash >> 21)) * prime1; // 11: rotation of xxHash32, 21: 32 - 11
+    }
+    hash ^= hash >> 15; // 15, 13, 16: avalanche shifts of xxHash32
+    hash *= prime2;
+    hash ^= hash >> 13;
+    hash *= prime3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+uint8_t* PutLength(uint8_t* op, size_t len)
+{
+    while (len >= LZ4_LEN_BYTE) {
+        *op++ = LZ4_LEN_BYTE;
+        len -= LZ4_LEN_BYTE;
+    }
+    *op++ = static_cast<uint8_t>(len);
+    return op;
+}
+
+// Literals followed by a match, or the last literals of the block if `matchLen` is 0.
+uint8_t* PutSequence(uint8_t* op, const uint8_t* literals, size_t literalLen, size_t offset, size_t matchLen)
+{
+    constexpr int literalShift = 4;
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>(std::min<size_t>(literalLen, LZ4_RUN_MASK) << literalShift);
+    if (literalLen >= LZ4_RUN_MASK) {
+        op = PutLength(op, literalLen - LZ4_RUN_MASK);
+    }
+    (void)memcpy_s(op, literalLen, literals, literalLen);
+    op += literalLen;
+    if (matchLen == 0) {
+        return op;
+    }
+    *op++ = static_cast<uint8_t>(offset & 0xFF);
+    *op++ = static_cast<uint8_t>(offset >> 8); // 8: bits per byte
+    size_t len = matchLen - LZ4_MIN_MATCH;
+    *token |= static_cast<uint8_t>(std::min<size_t>(len, LZ4_RUN_MASK));
+    if (len >= LZ4_RUN_MASK) {
+        op = PutLength(op, len - LZ4_RUN_MASK);
+    }
+    return op;
+}
+
+size_t Lz4CompressBound(size_t size) { return size + size / LZ4_LEN_BYTE + 16; } // 16: tokens at both ends
+
+// Greedy LZ4 block compression with a small hash table of the last positions. It trades ratio for
+// speed; the ids in the dump are pointers whose high bytes repeat, which it catches well.
+size_t Lz4CompressBlock(const uint8_t* src, size_t size, uint8_t* dst)
+{
+    uint32_t table[1U << LZ4_HASH_LOG] = { 0 };
+    uint8_t* op = dst;
+    size_t anchor = 0;
+    if (size > LZ4_MF_LIMIT) {
+        const size_t matchLimit = size - LZ4_LAST_LITERALS;
+        const size_t searchLimit = size - LZ4_MF_LIMIT;
+        constexpr uint32_t hashPrime = 2654435761U;
+        constexpr int skipShift = 6; // search faster in data that does not compress
+        size_t pos = 0;
+        while (pos < searchLimit) {
+            uint32_t sequence = ReadU32(src + pos);
+            uint32_t hash = (sequence * hashPrime) >> (32 - LZ4_HASH_LOG); // 32: bits of the hash
+            size_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(pos);
+            if (candidate >= pos || pos - candidate > LZ4_MAX_OFFSET || ReadU32(src + candidate) != sequence) {
+                pos += 1 + ((pos - anchor) >> skipShift);
+                continue;
+            }
+            size_t matchLen = LZ4_MIN_MATCH;
+            while (pos + matchLen < matchLimit && src[candidate + matchLen] == src[pos + matchLen]) {
+                ++matchLen;
+            }
+            op = PutSequence(op, src + anchor, pos - anchor, pos - candidate, matchLen);
+            pos += matchLen;
+            anchor = pos;
+        }
+    }
+    op = PutSequence(op, src + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+} // namespace
+
+uint8_t* HeapDumpChunk::Grow(size_t count)
+{
+    // A record streamed by HeapDumpStream::WriteRecord is written out every FLUSH_SIZE bytes.
+    if (sink != nullptr && size != 0 && size + count > FLUSH_SIZE && sink->Prepare(*this)) {
+        (void)sink->WritePrepared(*this);
+    }
+    size_t oldSize = size;
+    size += count;
+    data.resize(size);
+    return data.data() + oldSize;
+}
+
+void HeapDumpChunk::AddBytes(const uint8_t* value, size_t count)
+{
+    uint8_t* dst = Grow(count);
+    if (count != 0) {
+        (void)memcpy_s(dst, count, value, count);
+    }
+}
+
+void HeapDumpChunk::AddU2(uint16_t value)
+{
+    uint8_t* dst = Grow(sizeof(value));
+    dst[0] = static_cast<uint8_t>(value >> 8); // 8: bits per byte
+    dst[1] = static_cast<uint8_t>(value);
+}
+
+void HeapDumpChunk::AddU4(uint32_t value)
+{
+    uint8_t* dst = Grow(sizeof(value));
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        dst[i] = static_cast<uint8_t>(value >> ((sizeof(value) - 1 - i) * 8)); // 8: bits per byte
+    }
+}
+
+void HeapDumpChunk::AddU8(uint64_t value)
+{
+    uint8_t* dst = Grow(sizeof(value));
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        dst[i] = static_cast<uint8_t>(value >> ((sizeof(value) - 1 - i) * 8)); // 8: bits per byte
+    }
+}
+
+void HeapDumpChunk::AddU8List(const uint64_t* value, size_t count)
+{
+    uint8_t* dst = Grow(count * sizeof(uint64_t));
+    for (size_t n = 0; n < count; ++n) {
+        uint64_t val = value[n];
+        for (size_t i = 0; i < sizeof(val); ++i) {
+            dst[i] = static_cast<uint8_t>(val >> ((sizeof(val) - 1 - i) * 8)); // 8: bits per byte
+        }
+        dst += sizeof(val);
+    }
+}
+
+void HeapDumpChunk::PatchU8(size_t offset, uint64_t value)
+{
+    if (offset + sizeof(value) > size) {
+        return;
+    }
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        data[offset + i] = static_cast<uint8_t>(value >> ((sizeof(value) - 1 - i) * 8)); // 8: bits per byte
+    }
+}
+
+void HeapDumpChunk::Clear()
+{
+    size = 0;
+    data.clear();
+}
+
+bool HeapDumpStream::Begin()
+{
+    if (!compress) {
+        return true;
+    }
+    uint8_t header[7]; // 7: magic, FLG, BD and the header checksum
+    PutLE32(header, LZ4_FRAME_MAGIC);
+    header[4] = LZ4_FRAME_FLG; // 4: after the magic
+    header[5] = LZ4_FRAME_BD;  // 5: after FLG
+    header[6] = static_cast<uint8_t>(XXHash32Small(header + 4, 2) >> 8); // 6, 4, 2, 8: HC of FLG and BD
+    std::lock_guard<std::mutex> lock(mutex);
+    return WriteLocked(header, sizeof(header));
+}
+
+void HeapDumpStream::Compress(HeapDumpChunk& chunk)
+{
+    constexpr size_t blockSizeLen = 4;
+    const size_t blockNum = (chunk.size + LZ4_MAX_BLOCK_SIZE - 1) / LZ4_MAX_BLOCK_SIZE;
+    chunk.scratch.resize(blockNum * blockSizeLen + Lz4CompressBound(chunk.size));
+    uint8_t* op = chunk.scratch.data();
+    for (size_t offset = 0; offset < chunk.size; offset += LZ4_MAX_BLOCK_SIZE) {
+        size_t len = std::min(chunk.size - offset, LZ4_MAX_BLOCK_SIZE);
+        const uint8_t* src = chunk.data.data() + offset;
+        size_t compressedLen = Lz4CompressBlock(src, len, op + blockSizeLen);
+        if (compressedLen >= len) {
+            (void)memcpy_s(op + blockSizeLen, len, src, len);
+            PutLE32(op, static_cast<uint32_t>(len) | LZ4_UNCOMPRESSED_BLOCK);
+            compressedLen = len;
+        } else {
+            PutLE32(op, static_cast<uint32_t>(compressedLen));
+        }
+        op += blockSizeLen + compressedLen;
+    }
+    chunk.scratch.resize(static_cast<size_t>(op - chunk.scratch.data()));
+}
+
+bool HeapDumpStream::Prepare(HeapDumpChunk& chunk)
+{
+    if (chunk.size == 0 || Failed()) {
+        chunk.Clear();
+        return false;
+    }
+    if (compress) {
+        Compress(chunk);
+    }
+    AccountChunk(chunk);
+    rawBytes.fetch_add(chunk.size, std::memory_order_relaxed);
+    return true;
+}
+
+bool HeapDumpStream::WritePrepared(HeapDumpChunk& chunk)
+{
+    bool ret = compress ? WriteLocked(chunk.scratch.data(), chunk.scratch.size()) :
+                          WriteLocked(chunk.data.data(), chunk.size);
+    chunk.Clear();
+    return ret;
+}
+
+// The chunk is compressed before the stream is locked, so that the threads compress in parallel.
+bool HeapDumpStream::Write(HeapDumpChunk& chunk)
+{
+    if (!Prepare(chunk)) {
+        return !Failed();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    return WritePrepared(chunk);
+}
+
+bool HeapDumpStream::WriteRecord(HeapDumpChunk& chunk, const std::function<void(HeapDumpChunk&)>& write)
+{
+    // The records buffered so far go first, the slices of the record then fill the emptied chunk.
+    (void)Write(chunk);
+    std::lock_guard<std::mutex> lock(mutex);
+    chunk.sink = this;
+    write(chunk);
+    chunk.sink = nullptr;
+    return Prepare(chunk) ? WritePrepared(chunk) : !Failed();
+}
+
+bool HeapDumpStream::Finish()
+{
+    if (!compress) {
+        return !Failed();
+    }
+    uint8_t endMark[4] = { 0 }; // 4: a block size of 0 ends the frame
+    std::lock_guard<std::mutex> lock(mutex);
+    return WriteLocked(endMark, sizeof(endMark));
+}
+
+bool HeapDumpStream::WriteLocked(const uint8_t* data, size_t size)
+{
+    while (size > 0 && !Failed()) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            LOG(RTLOG_ERROR, "Write heap dump failed. msg: %s", strerror(errno));
+            failed.store(true, std::memory_order_relaxed);
+            break;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        writtenBytes += static_cast<uint64_t>(written);
+    }
+    return !Failed();
+}
+
+void HeapDumpStream::Account(int64_t bytes)
+{
+    int64_t now = buffered.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = peakBuffered.load(std::memory_order_relaxed);
+    while (now > peak && !peakBuffered.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void HeapDumpStream::AccountChunk(HeapDumpChunk& chunk)
+{
+    size_t capacity = chunk.data.capacity() + chunk.scratch.capacity();
+    Account(static_cast<int64_t>(capacity) - static_cast<int64_t>(chunk.accounted));
+    chunk.accounted = capacity;
+}
+
+void HeapDumpStream::Release(HeapDumpChunk& chunk)
+{
+    Account(-static_cast<int64_t>(chunk.accounted));
+    chunk.accounted = 0;
+}
+} // namespace MapleRuntime
@@ -0,0 +1,105 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_HEAP_DUMP_WRITER_H
+#define MRT_HEAP_DUMP_WRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace MapleRuntime {
+class HeapDumpStream;
+
+// Bytes of the heap dump in the making, values are stored big-endian.
+class HeapDumpChunk {
+public:
+    // Chunks are handed to the stream once they grow over this size.
+    static constexpr size_t FLUSH_SIZE = 1024 * 1024;
+
+    HeapDumpChunk() = default;
+    ~HeapDumpChunk() = default;
+
+    void AddU1(uint8_t value) { AddBytes(&value, 1); }
+    void AddU2(uint16_t value);
+    void AddU4(uint32_t value);
+    void AddU8(uint64_t value);
+    void AddBytes(const uint8_t* value, size_t count);
+    void AddU8List(const uint64_t* value, size_t count);
+    // Overwrite the u8 at `offset`, e.g. the length of a record written before its contents.
+    void PatchU8(size_t offset, uint64_t value);
+
+    size_t Size() const { return size; }
+    const uint8_t* Data() const { return data.data(); }
+    void Clear();
+
+private:
+    uint8_t* Grow(size_t count);
+
+    // Set while HeapDumpStream::WriteRecord streams a record, see Grow.
+    HeapDumpStream* sink = nullptr;
+    size_t size = 0;
+    std::vector<uint8_t> data;
+    // Compressed blocks of the chunk, see HeapDumpStream::Write.
+    std::vector<uint8_t> scratch;
+    // Bytes of the buffers above that are counted by the stream.
+    size_t accounted = 0;
+
+    friend class HeapDumpStream;
+};
+
+// Writes the heap dump to a file descriptor as chunks come. The chunks of several threads may be
+// written concurrently, each one is written in one piece. With compression on, the dump is an LZ4
+// frame of independent blocks, which `lz4 -d` restores, and every chunk is compressed by the thread
+// that wrote it before the stream is locked.
+class HeapDumpStream {
+public:
+    HeapDumpStream(int fd, bool compress) : fd(fd), compress(compress) {}
+    ~HeapDumpStream() = default;
+
+    bool Begin();
+    // Write `chunk` and clear it.
+    bool Write(HeapDumpChunk& chunk);
+    // Write the record that `write` adds to `chunk` in slices of FLUSH_SIZE, for records larger than a
+    // chunk. The stream stays locked meanwhile so that the records of other threads do not come in
+    // between, and the record is never buffered whole.
+    bool WriteRecord(HeapDumpChunk& chunk, const std::function<void(HeapDumpChunk&)>& write);
+    bool Finish();
+    // Stop counting the buffers of a chunk that is no longer used.
+    void Release(HeapDumpChunk& chunk);
+    // Count `bytes` of memory held by the dump besides the chunks, negative when released.
+    void Account(int64_t bytes);
+
+    bool Failed() const { return failed.load(std::memory_order_relaxed); }
+    uint64_t RawBytes() const { return rawBytes.load(std::memory_order_relaxed); }
+    uint64_t WrittenBytes() const { return writtenBytes; }
+    uint64_t PeakBufferedBytes() const { return peakBuffered.load(std::memory_order_relaxed); }
+
+private:
+    void Compress(HeapDumpChunk& chunk);
+    // Compress and count `chunk`, false if there is nothing to write.
+    bool Prepare(HeapDumpChunk& chunk);
+    // Write a prepared chunk and clear it, the stream is locked.
+    bool WritePrepared(HeapDumpChunk& chunk);
+    bool WriteLocked(const uint8_t* data, size_t size);
+    void AccountChunk(HeapDumpChunk& chunk);
+
+    int fd;
+    bool compress;
+    std::mutex mutex;
+    std::atomic<bool> failed { false };
+    std::atomic<uint64_t> rawBytes { 0 };
+    uint64_t writtenBytes = 0;
+    std::atomic<int64_t> buffered { 0 };
+    std::atomic<int64_t> peakBuffered { 0 };
+
+    friend class HeapDumpChunk;
+};
+} // namespace MapleRuntime
+#endif // MRT_HEAP_DUMP_WRITER_H
@@ -0,0 +1,88 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "HeapHistogram.h"
+#include <algorithm>
+#include <cstdlib>
+
+#include "Base/Log.h"
+#include "Base/SysCall.h"
+#include "Heap/Heap.h"
+#include "ObjectModel/MClass.h"
+#include "securec.h"
+
+namespace MapleRuntime {
+bool HeapHistogramReport::Collect(std::vector<Row>& rows)
+{
+    HeapHistogram histogram;
+    if (!Heap::GetHeap().GetHeapHistogram(histogram)) {
+        LOG(RTLOG_ERROR, "Get heap histogram failed, gc is not active");
+        return false;
+    }
+    rows.reserve(histogram.size());
+    for (const auto& entry : histogram) {
+        const char* name = entry.first->GetName();
+        rows.push_back({ name == nullptr ? "defaultLambda" : name, entry.second.count, entry.second.bytes });
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.bytes != b.bytes ? a.bytes > b.bytes : a.count > b.count;
+    });
+    return true;
+}
+
+HeapHistogramRecord* HeapHistogramReport::ToRecords(const std::vector<Row>& rows, size_t& num)
+{
+    size_t size = rows.size() * sizeof(HeapHistogramRecord);
+    for (const Row& row : rows) {
+        size += row.name.Length() + 1;
+    }
+    // A histogram of no types is still a valid allocation.
+    HeapHistogramRecord* records = static_cast<HeapHistogramRecord*>(malloc(size == 0 ? 1 : size));
+    if (records == nullptr) {
+        LOG(RTLOG_ERROR, "Malloc heap histogram failed");
+        return nullptr;
+    }
+    char* names = reinterpret_cast<char*>(records + rows.size());
+    char* end = reinterpret_cast<char*>(records) + size;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        size_t len = rows[i].name.Length() + 1;
+        if (memcpy_s(names, end - names, rows[i].name.Str(), len) != EOK) {
+            free(records);
+            return nullptr;
+        }
+        records[i] = { names, rows[i].count, rows[i].bytes };
+        names += len;
+    }
+    num = rows.size();
+    return records;
+}
+
+bool HeapHistogramReport::Dump(int fd)
+{
+    if (fd < 0) {
+        LOG(RTLOG_ERROR, "Dump heap histogram failed, fd %d is invalid", fd);
+        return false;
+    }
+    std::vector<Row> rows;
+    if (!Collect(rows)) {
+        return false;
+    }
+    CString text = " num     #instances         #bytes  type\n";
+    uint64_t totalCount = 0;
+    uint64_t totalBytes = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        text += CString::FormatString("%4zu: %14llu %14llu  %s\n", i + 1,
+                                      static_cast<unsigned long long>(rows[i].count),
+                                      static_cast<unsigned long long>(rows[i].bytes), rows[i].name.Str());
+        totalCount += rows[i].count;
+        totalBytes += rows[i].bytes;
+    }
+    text += CString::FormatString("Total %14llu %14llu\n", static_cast<unsigned long long>(totalCount),
+                                  static_cast<unsigned long long>(totalBytes));
+    return WriteAll(fd, text.Str(), text.Length());
+}
+} // namespace MapleRuntime
@@ -0,0 +1,43 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_HEAP_HISTOGRAM_H
+#define MRT_HEAP_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Base/CString.h"
+
+namespace MapleRuntime {
+// A type of the heap histogram as returned by MCC_GetHeapHistogram, `name` points into the same
+// allocation as the records.
+struct HeapHistogramRecord {
+    const char* name;
+    uint64_t count;
+    uint64_t bytes;
+};
+
+// The objects of the heap counted by type, a light alternative to a heap dump to find out what
+// fills the heap. See Heap::GetHeapHistogram.
+class HeapHistogramReport {
+public:
+    struct Row {
+        CString name;
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+    // The types by their bytes, largest first.
+    static bool Collect(std::vector<Row>& rows);
+    // The records followed by their names in one allocation, freed by the caller.
+    static HeapHistogramRecord* ToRecords(const std::vector<Row>& rows, size_t& num);
+    // Write the histogram to `fd` as a text table.
+    static bool Dump(int fd);
+};
+} // namespace MapleRuntime
+#endif // MRT_HEAP_HISTOGRAM_H
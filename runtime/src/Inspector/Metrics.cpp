@@ -0,0 +1,377 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "Metrics.h"
+#include <algorithm>
+#include <cstring>
+
+#include "Base/Log.h"
+#include "Base/SysCall.h"
+#include "CjScheduler.h"
+#include "Heap/Collector/GcStats.h"
+#include "Heap/Heap.h"
+#include "fileio.h"
+#include "schedule.h"
+
+namespace MapleRuntime {
+// The slot of the processor of the current thread. Threads without a processor are hashed by id.
+MetricCounter::Slot& MetricCounter::SlotGet()
+{
+    unsigned int slot = ProcessorSlotGet();
+    if (slot == 0) {
+        slot = static_cast<unsigned int>(MRT_GetCurrentThreadID());
+    }
+    return slots[slot & (SLOT_NUM - 1)];
+}
+
+uint64_t MetricCounter::Value() const
+{
+    uint64_t sum = 0;
+    for (const Slot& slot : slots) {
+        sum += slot.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+MetricHistogram::MetricHistogram(const uint64_t* bounds, size_t boundNum)
+    : bounds(bounds, bounds + boundNum), counts(new std::atomic<uint64_t>[boundNum + 1])
+{
+    for (size_t i = 0; i <= boundNum; ++i) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::Observe(uint64_t value)
+{
+    size_t index = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    counts[index].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void MetricsWriter::Family(const char* name, const char* help, const char* type)
+{
+    if (lastFamily == name) {
+        return;
+    }
+    lastFamily = name;
+    out += CString::FormatString("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void MetricsWriter::Sample(const char* name, const char* suffix, const CString& labels, const CString& value)
+{
+    out += name;
+    out += suffix;
+    if (!labels.IsEmpty()) {
+        out += "{";
+        out += labels;
+        out += "}";
+    }
+    out += " ";
+    out += value;
+    out += "\n";
+}
+
+void MetricsWriter::Counter(const char* name, const char* help, uint64_t value, const CString& labels)
+{
+    Family(name, help, "counter");
+    Sample(name, "", labels, CString(value));
+}
+
+void MetricsWriter::CounterDouble(const char* name, const char* help, double value, const CString& labels)
+{
+    Family(name, help, "counter");
+    Sample(name, "", labels, CString::FormatString("%.9g", value));
+}
+
+void MetricsWriter::Gauge(const char* name, const char* help, int64_t value, const CString& labels)
+{
+    Family(name, help, "gauge");
+    Sample(name, "", labels, CString(value));
+}
+
+void MetricsWriter::GaugeDouble(const char* name, const char* help, double value, const CString& labels)
+{
+    Family(name, help, "gauge");
+    Sample(name, "", labels, CString::FormatString("%.9g", value));
+}
+
+void MetricsWriter::Histogram(const char* name, const char* help, const uint64_t* bounds, const uint64_t* counts,
+                              size_t bucketNum, double sum, double scale, const CString& labels)
+{
+    Family(name, help, "histogram");
+    CString prefix = labels.IsEmpty() ? CString("") : labels + ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bucketNum; ++i) {
+        cumulative += counts[i];
+        CString le = i + 1 < bucketNum ? CString::FormatString("%.9g", static_cast<double>(bounds[i]) * scale)
+                                       : CString("+Inf");
+        Sample(name, "_bucket", prefix + "le=\"" + le + "\"", CString(cumulative));
+    }
+    if (sum >= 0) {
+        Sample(name, "_sum", labels, CString::FormatString("%.9g", sum * scale));
+    }
+    Sample(name, "_count", labels, CString(cumulative));
+}
+
+namespace {
+void CollectHeapMetrics(MetricsWriter& writer)
+{
+    Heap& heap = Heap::GetHeap();
+    writer.Gauge("cj_heap_allocated_bytes", "Bytes of the heap allocated to objects.",
+                 static_cast<int64_t>(heap.GetAllocatedSize()));
+    writer.Gauge("cj_heap_used_bytes", "Bytes of the heap in use by regions.",
+                 static_cast<int64_t>(heap.GetUsedPageSize()));
+    writer.Gauge("cj_heap_resident_bytes", "Bytes of the heap resident in physical memory.",
+                 static_cast<int64_t>(heap.GetHeapPhysicalMemorySize()));
+    writer.Gauge("cj_heap_max_bytes", "Maximum size of the heap.", static_cast<int64_t>(heap.GetMaxCapacity()));
+    writer.Counter("cj_gc_cycles_total", "GC cycles completed.", g_gcCount);
+    writer.CounterDouble("cj_gc_time_seconds_total", "Time spent in GC cycles.",
+                         static_cast<double>(g_gcTotalTimeUs) * 1e-6); // 1e-6: us to s
+    writer.Counter("cj_gc_freed_bytes_total", "Bytes freed by GC.", g_gcCollectedTotalBytes);
+    writer.Gauge("cj_gc_running", "Whether a GC cycle is running.", heap.IsGcStarted() ? 1 : 0);
+}
+
+// The wake-to-run latency is written with the other latencies, see CollectSchedulerLatencies. The
+// overrun histogram counts powers of 2, see SchedulePreemptStats.
+void CollectSchedulerHistograms(MetricsWriter& writer)
+{
+    struct ScheduleWakeStats wake;
+    if (ScheduleWakeStatsGet(&wake) == 0) {
+        writer.Counter("cj_sched_wake_affine_total", "Wakes placed in the next slot of the waker's processor.",
+                       wake.affineCnt);
+        writer.Counter("cj_sched_wake_handoff_total", "Wakes that were handed the time slice of the waker.",
+                       wake.handoffCnt);
+    }
+    struct SchedulePreemptStats preempt;
+    if (SchedulePreemptStatsGet(&preempt) == 0) {
+        writer.Counter("cj_sched_preempt_requests_total", "Time-slice preemption requests.", preempt.requestCnt);
+        uint64_t bounds[SCHEDULE_PREEMPT_OVERRUN_BUCKETS];
+        uint64_t counts[SCHEDULE_PREEMPT_OVERRUN_BUCKETS];
+        for (size_t i = 0; i < SCHEDULE_PREEMPT_OVERRUN_BUCKETS; ++i) {
+            bounds[i] = (1ULL << (i + 1)) - 1; // bucket i ends at 2^(i+1) - 1 us
+            counts[i] = preempt.overrunHist[i];
+        }
+        writer.Histogram("cj_sched_preempt_overrun_seconds", "Delay from a preemption request to the next schedule.",
+                         bounds, counts, SCHEDULE_PREEMPT_OVERRUN_BUCKETS, -1, 1e-6); // 1e-6: us to s
+    }
+}
+
+// The latency histograms are written at powers of 2, their finer buckets would make a long page.
+void CollectSchedulerLatencies(MetricsWriter& writer)
+{
+    static const char* kinds[SCHEDULE_LATENCY_KIND_NUM] = { "runq_wait", "wake_to_run", "slice" };
+    constexpr size_t subNum = 1U << SCHEDULE_LATENCY_SUB_BITS;
+    constexpr size_t groupNum = SCHEDULE_LATENCY_BUCKETS / subNum;
+    struct ScheduleLatencyHist hist;
+    for (int kind = 0; kind < SCHEDULE_LATENCY_KIND_NUM; ++kind) {
+        if (ScheduleLatencyStatsGet(kind, -1, &hist) != 0 || hist.count == 0) {
+            continue;
+        }
+        uint64_t bounds[groupNum];
+        uint64_t counts[groupNum] = { 0 };
+        for (size_t i = 0; i < SCHEDULE_LATENCY_BUCKETS; ++i) {
+            counts[i / subNum] += hist.buckets[i];
+        }
+        for (size_t group = 0; group < groupNum; ++group) {
+            bounds[group] = subNum << group;
+        }
+        writer.Histogram("cj_sched_latency_seconds", "Run-queue wait, wake-to-run and time slice of cjthreads.",
+                         bounds, counts, groupNum, static_cast<double>(hist.sumNs), 1e-9, // 1e-9: ns to s
+                         CString::FormatString("kind=\"%s\"", kinds[kind]));
+    }
+}
+
+void CollectSchedulerMetrics(MetricsWriter& writer)
+{
+    writer.Gauge("cj_cjthreads", "Cjthreads that exist.",
+                 static_cast<int64_t>(ScheduleCJThreadCountPublic(CJTHREAD_PSTATE_ALL)));
+    writer.Gauge("cj_cjthreads_blocking", "Cjthreads that are parked.",
+                 static_cast<int64_t>(ScheduleCJThreadCountPublic(CJTHREAD_PSTATE_BLOCKING)));
+    writer.Gauge("cj_os_threads_running", "OS threads running cjthreads.",
+                 static_cast<int64_t>(ScheduleRunningOSThreadCount()));
+    writer.Gauge("cj_timers", "Timers of all processors.", static_cast<int64_t>(ScheduleTimerNumGet()));
+
+    struct ScheduleProcessorStats processorStats;
+    if (ScheduleProcessorStatsGet(&processorStats) == 0) {
+        writer.Gauge("cj_sched_processors_active", "Processors that may run cjthreads.", processorStats.activeNum);
+        writer.Gauge("cj_sched_processors_capacity", "Processors allocated.", processorStats.capacity);
+        std::vector<ScheduleProcessorLoad> loads(processorStats.capacity);
+        unsigned int num = ScheduleProcessorLoadGet(loads.data(), processorStats.capacity);
+        for (unsigned int i = 0; i < num; ++i) {
+            writer.Gauge("cj_sched_processor_runq", "Cjthreads in the running queues of a processor.",
+                         loads[i].runqCnt, CString::FormatString("processor=\"%u\"", loads[i].processorId));
+        }
+        for (unsigned int i = 0; i < num; ++i) {
+            writer.Counter("cj_sched_processor_schedules_total", "Schedules done by a processor.", loads[i].schedCnt,
+                           CString::FormatString("processor=\"%u\"", loads[i].processorId));
+        }
+    }
+    struct ScheduleStealStats steal;
+    if (ScheduleStealStatsGet(&steal) == 0) {
+        static const char* levels[SCHEDULE_TOPOLOGY_LEVEL_NUM] = { "smt", "cache", "node", "remote" };
+        for (size_t i = 0; i < SCHEDULE_TOPOLOGY_LEVEL_NUM; ++i) {
+            writer.Counter("cj_sched_steals_total", "Cjthreads stolen, by distance to the victim.", steal.stealCnt[i],
+                           CString::FormatString("distance=\"%s\"", levels[i]));
+        }
+    }
+    struct ScheduleParkStats park;
+    if (ScheduleParkStatsGet(&park) == 0) {
+        writer.Counter("cj_sched_idle_spin_hits_total", "Idle periods ended while spinning.", park.spinHitCnt);
+        writer.Counter("cj_sched_idle_parks_total", "Idle periods ended in a sleep.", park.parkCnt);
+    }
+    struct ScheduleBusyPollStats busyPoll;
+    if (ScheduleBusyPollStatsGet(&busyPoll) == 0) {
+        writer.Counter("cj_netpoll_spin_hits_total", "Fd waits satisfied while busy-polling.", busyPoll.spinHitCnt);
+        writer.Counter("cj_netpoll_parks_total", "Fd waits that parked the cjthread.", busyPoll.parkCnt);
+    }
+    writer.Counter("cj_sched_blocking_handoffs_total", "Processor handoffs on entering blocking regions.",
+                   ScheduleBlockingHandoffCount());
+    CollectSchedulerHistograms(writer);
+    CollectSchedulerLatencies(writer);
+}
+
+void CollectFileioMetrics(MetricsWriter& writer)
+{
+    struct FileioStats stats;
+    if (FileioStatsGet(&stats) != 0) {
+        return;
+    }
+    writer.Counter("cj_fileio_requests_total", "File I/O requests completed, by engine.", stats.uringNum,
+                   "engine=\"uring\"");
+    writer.Counter("cj_fileio_requests_total", "File I/O requests completed, by engine.", stats.poolNum,
+                   "engine=\"pool\"");
+    writer.Counter("cj_fileio_requests_total", "File I/O requests completed, by engine.", stats.inlineNum,
+                   "engine=\"inline\"");
+    writer.Gauge("cj_fileio_workers", "Worker threads of file I/O.", stats.workerNum);
+}
+} // namespace
+
+MetricsRegistry::MetricsRegistry()
+{
+    collectors.push_back(CollectHeapMetrics);
+    collectors.push_back(CollectSchedulerMetrics);
+    collectors.push_back(CollectFileioMetrics);
+}
+
+MetricsRegistry::Metric* MetricsRegistry::Find(MetricType type, const char* name, const CString& labels)
+{
+    for (auto& metric : metrics) {
+        if (metric->type == type && metric->name == name && metric->labels == labels) {
+            return metric.get();
+        }
+    }
+    return nullptr;
+}
+
+MetricsRegistry::Metric& MetricsRegistry::Add(MetricType type, const char* name, const char* help,
+                                              const CString& labels)
+{
+    std::unique_ptr<Metric> metric(new Metric());
+    metric->type = type;
+    metric->name = name;
+    metric->help = help;
+    metric->labels = labels;
+    metric->scale = 1;
+    metrics.push_back(std::move(metric));
+    return *metrics.back();
+}
+
+MetricCounter& MetricsRegistry::RegisterCounter(const char* name, const char* help, const CString& labels)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    Metric* metric = Find(COUNTER, name, labels);
+    if (metric == nullptr) {
+        metric = &Add(COUNTER, name, help, labels);
+        metric->counter.reset(new MetricCounter());
+    }
+    return *metric->counter;
+}
+
+MetricGauge& MetricsRegistry::RegisterGauge(const char* name, const char* help, const CString& labels)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    Metric* metric = Find(GAUGE, name, labels);
+    if (metric == nullptr) {
+        metric = &Add(GAUGE, name, help, labels);
+        metric->gauge.reset(new MetricGauge());
+    }
+    return *metric->gauge;
+}
+
+MetricHistogram& MetricsRegistry::RegisterHistogram(const char* name, const char* help, const uint64_t* bounds,
+                                                    size_t boundNum, double scale, const CString& labels)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    Metric* metric = Find(HISTOGRAM, name, labels);
+    if (metric == nullptr) {
+        metric = &Add(HISTOGRAM, name, help, labels);
+        metric->histogram.reset(new MetricHistogram(bounds, boundNum));
+        metric->scale = scale;
+    }
+    return *metric->histogram;
+}
+
+void MetricsRegistry::AddCollector(Collector collector)
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    collectors.push_back(collector);
+}
+
+CString MetricsRegistry::RenderPrometheus()
+{
+    std::lock_guard<std::mutex> lg(mutex);
+    MetricsWriter writer;
+    // Series of one name may be registered apart, they are written together.
+    std::vector<const Metric*> sorted;
+    for (auto& metric : metrics) {
+        sorted.push_back(metric.get());
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Metric* a, const Metric* b) { return a->name < b->name; });
+    for (const Metric* metric : sorted) {
+        const char* name = metric->name.Str();
+        const char* help = metric->help.Str();
+        switch (metric->type) {
+            case COUNTER:
+                writer.Counter(name, help, metric->counter->Value(), metric->labels);
+                break;
+            case GAUGE:
+                writer.Gauge(name, help, metric->gauge->Value(), metric->labels);
+                break;
+            case HISTOGRAM: {
+                const MetricHistogram& histogram = *metric->histogram;
+                size_t bucketNum = histogram.BucketNum();
+                std::vector<uint64_t> bounds(bucketNum, 0);
+                std::vector<uint64_t> counts(bucketNum, 0);
+                for (size_t i = 0; i < bucketNum; ++i) {
+                    bounds[i] = i + 1 < bucketNum ? histogram.Bound(i) : 0;
+                    counts[i] = histogram.BucketCount(i);
+                }
+                writer.Histogram(name, help, bounds.data(), counts.data(), bucketNum,
+                                 static_cast<double>(histogram.Sum()), metric->scale, metric->labels);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    for (Collector collector : collectors) {
+        collector(writer);
+    }
+    return writer.Text();
+}
+
+bool MetricsRegistry::Dump(int fd)
+{
+    if (fd < 0) {
+        LOG(RTLOG_ERROR, "Dump metrics failed, fd %d is invalid", fd);
+        return false;
+    }
+    CString text = RenderPrometheus();
+    return WriteAll(fd, text.Str(), text.Length());
+}
+} // namespace MapleRuntime
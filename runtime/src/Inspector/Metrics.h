@@ -0,0 +1,150 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_METRICS_H
+#define MRT_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Base/CString.h"
+
+namespace MapleRuntime {
+// A monotonic counter. Every processor adds to a slot of its own, so counting on hot paths such as
+// the allocation slow path does not bounce a cache line between processors. Reads sum the slots.
+class MetricCounter {
+public:
+    MetricCounter() = default;
+    ~MetricCounter() = default;
+
+    void Add(uint64_t value = 1) { SlotGet().value.fetch_add(value, std::memory_order_relaxed); }
+    uint64_t Value() const;
+
+private:
+    static constexpr size_t SLOT_NUM = 64; // power of 2
+    struct Slot {
+        static constexpr size_t CACHE_LINE_ALIGN = 64; // for most hardware platforms
+        std::atomic<uint64_t> value { 0 };
+        char padding[CACHE_LINE_ALIGN - sizeof(std::atomic<uint64_t>)];
+    };
+
+    Slot& SlotGet();
+
+    Slot slots[SLOT_NUM];
+};
+
+// A value that goes up and down.
+class MetricGauge {
+public:
+    void Set(int64_t v) { value.store(v, std::memory_order_relaxed); }
+    void Add(int64_t v) { value.fetch_add(v, std::memory_order_relaxed); }
+    int64_t Value() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value { 0 };
+};
+
+// A distribution over fixed upper bounds, in the unit of the observed values. Values above the last
+// bound fall into the implicit +Inf bucket.
+class MetricHistogram {
+public:
+    MetricHistogram(const uint64_t* bounds, size_t boundNum);
+    ~MetricHistogram() = default;
+
+    void Observe(uint64_t value);
+
+    size_t BucketNum() const { return bounds.size() + 1; }
+    uint64_t Bound(size_t index) const { return bounds[index]; }
+    uint64_t BucketCount(size_t index) const { return counts[index].load(std::memory_order_relaxed); }
+    uint64_t Sum() const { return sum.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<uint64_t> bounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    std::atomic<uint64_t> sum { 0 };
+};
+
+// Renders metric families in the Prometheus text exposition format. Samples of one family are
+// written one after another, the help and type lines are written before the first of them.
+class MetricsWriter {
+public:
+    MetricsWriter() = default;
+    ~MetricsWriter() = default;
+
+    void Counter(const char* name, const char* help, uint64_t value, const CString& labels = "");
+    void CounterDouble(const char* name, const char* help, double value, const CString& labels = "");
+    void Gauge(const char* name, const char* help, int64_t value, const CString& labels = "");
+    void GaugeDouble(const char* name, const char* help, double value, const CString& labels = "");
+    // `scale` converts the bounds and the sum to the unit of the metric, e.g. 1e-9 from ns to
+    // seconds. A sum below 0 is unknown and not written.
+    void Histogram(const char* name, const char* help, const uint64_t* bounds, const uint64_t* counts,
+                   size_t bucketNum, double sum, double scale, const CString& labels = "");
+
+    const CString& Text() const { return out; }
+
+private:
+    void Family(const char* name, const char* help, const char* type);
+    void Sample(const char* name, const char* suffix, const CString& labels, const CString& value);
+
+    CString out;
+    CString lastFamily;
+};
+
+// Process-wide registry of the runtime metrics. Metrics registered in it are owned by it and live
+// until the process exits, so callers keep the returned references, typically in function-local
+// statics. Subsystems that already keep their own statistics add a collector instead, which is
+// sampled whenever the metrics are rendered.
+class MetricsRegistry {
+public:
+    using Collector = void (*)(MetricsWriter& writer);
+
+    static MetricsRegistry& GetInstance()
+    {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    // `labels` is the label set of the series, e.g. `reason="user"`. The same name may be
+    // registered with several label sets, and registering a series twice returns the first one.
+    MetricCounter& RegisterCounter(const char* name, const char* help, const CString& labels = "");
+    MetricGauge& RegisterGauge(const char* name, const char* help, const CString& labels = "");
+    // The unit of the observed values is converted by `scale` when rendering, see MetricsWriter.
+    MetricHistogram& RegisterHistogram(const char* name, const char* help, const uint64_t* bounds, size_t boundNum,
+                                       double scale, const CString& labels = "");
+    void AddCollector(Collector collector);
+
+    // Render all metrics in the Prometheus text exposition format.
+    CString RenderPrometheus();
+    bool Dump(int fd);
+
+private:
+    enum MetricType { COUNTER, GAUGE, HISTOGRAM };
+    struct Metric {
+        MetricType type;
+        CString name;
+        CString help;
+        CString labels;
+        double scale;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    MetricsRegistry();
+    ~MetricsRegistry() = default;
+    Metric* Find(MetricType type, const char* name, const CString& labels);
+    Metric& Add(MetricType type, const char* name, const char* help, const CString& labels);
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Metric>> metrics;
+    std::vector<Collector> collectors;
+};
+} // namespace MapleRuntime
+#endif // MRT_METRICS_H
@@ -0,0 +1,415 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "TraceExporter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#include "Base/Log.h"
+#include "Base/SysCall.h"
+#include "Heap/Collector/Collector.h"
+#include "schedule.h"
+
+namespace MapleRuntime {
+namespace {
+constexpr size_t TRACE_HEADER_SIZE = 32;
+constexpr const char* TRACE_MAGIC = "Cangjie trace";
+constexpr size_t READ_CHUNK_SIZE = 64 * 1024;
+
+// The trace keeps the low byte of the events.
+constexpr uint8_t EventType(TraceEvent event) { return static_cast<uint8_t>(event & 0xff); }
+
+bool ReadAll(int fd, std::vector<uint8_t>& data)
+{
+    uint8_t chunk[READ_CHUNK_SIZE];
+    while (true) {
+        ssize_t len = read(fd, chunk, sizeof(chunk));
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len < 0) {
+            LOG(RTLOG_ERROR, "Read trace failed. msg: %s", strerror(errno));
+            return false;
+        }
+        if (len == 0) {
+            return true;
+        }
+        data.insert(data.end(), chunk, chunk + len);
+    }
+}
+
+const char* EndReason(uint8_t type)
+{
+    switch (type) {
+        case EventType(TRACE_EV_CJTHREAD_END):
+            return "exit";
+        case EventType(TRACE_EV_CJTHREAD_RESCHED):
+            return "resched";
+        case EventType(TRACE_EV_CJTHREAD_SLEEP):
+            return "sleep";
+        case EventType(TRACE_EV_CJTHREAD_BLOCK):
+            return "block";
+        case EventType(TRACE_EV_CJTHREAD_BLOCK_SYNC):
+            return "block sync";
+        case EventType(TRACE_EV_CJTHREAD_BLOCK_NET):
+            return "block net";
+        default:
+            return "unknown";
+    }
+}
+} // namespace
+
+TraceExporter::Reader::Reader(const std::vector<uint8_t>& trace) : data(trace), pos(TRACE_HEADER_SIZE) {}
+
+bool TraceExporter::Reader::ReadByte(uint8_t& value)
+{
+    if (pos >= data.size()) {
+        failed = true;
+        return false;
+    }
+    value = data[pos++];
+    return true;
+}
+
+// Varints of 7 bits per byte, the lowest first, see TraceUint64.
+bool TraceExporter::Reader::ReadUint64(uint64_t& value)
+{
+    constexpr unsigned int bitsPerByte = 7;
+    constexpr uint8_t moreBit = 0x80;
+    value = 0;
+    for (unsigned int shift = 0; shift < sizeof(uint64_t) * 8; shift += bitsPerByte) { // 8: bits per byte
+        uint8_t byte = 0;
+        if (!ReadByte(byte)) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & (moreBit - 1)) << shift;
+        if ((byte & moreBit) == 0) {
+            return true;
+        }
+    }
+    failed = true;
+    return false;
+}
+
+bool TraceExporter::Reader::Skip(uint64_t len)
+{
+    if (len > data.size() - pos) {
+        failed = true;
+        return false;
+    }
+    pos += len;
+    return true;
+}
+
+// [stack id, number of PCs, array of {PC, func string ID, file string ID, line}]
+bool TraceExporter::Reader::SkipStack()
+{
+    constexpr uint8_t frameArgNum = 4;
+    uint64_t value = 0;
+    uint8_t frameNum = 0;
+    if (!ReadUint64(value) || !ReadByte(frameNum)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(frameNum) * frameArgNum; ++i) {
+        if (!ReadUint64(value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TraceExporter::Reader::Next(Record& record)
+{
+    while (!failed && pos < data.size()) {
+        uint8_t type = data[pos++];
+        uint8_t argNum = 0;
+        uint64_t value = 0;
+        // Strings are the only events without the number of arguments.
+        if (type == EventType(TRACE_EV_STRING)) {
+            if (!ReadUint64(value) || !ReadUint64(value) || !Skip(value)) {
+                return false;
+            }
+            continue;
+        }
+        if (type == EventType(TRACE_EV_NONE) || !ReadByte(argNum)) {
+            failed = true;
+            return false;
+        }
+        if (type == EventType(TRACE_EV_STACK)) {
+            if (!SkipStack()) {
+                return false;
+            }
+            continue;
+        }
+        record = Record {};
+        record.type = type;
+        // [pid, timestamp], the events after it are timed from the timestamp.
+        if (type == EventType(TRACE_EV_BATCH)) {
+            if (!ReadUint64(value) || !ReadUint64(ticks)) {
+                return false;
+            }
+            processorId = static_cast<uint32_t>(value);
+            record.processorId = processorId;
+            record.ticks = ticks;
+            return true;
+        }
+        if (type == EventType(TRACE_EV_FREQUENCY)) {
+            record.argNum = 1;
+            return ReadUint64(record.args[0]);
+        }
+        // [time since the last event, args...]
+        if (!ReadUint64(value)) {
+            return false;
+        }
+        ticks += value;
+        record.processorId = processorId;
+        record.ticks = ticks;
+        for (uint8_t i = 0; i < argNum; ++i) {
+            if (!ReadUint64(value)) {
+                return false;
+            }
+            if (i < MAX_ARGS) {
+                record.args[i] = value;
+            }
+        }
+        record.argNum = std::min(argNum, static_cast<uint8_t>(MAX_ARGS));
+        return true;
+    }
+    return false;
+}
+
+bool TraceExporter::ExportChromeTrace(int inFd, int outFd)
+{
+    if (inFd < 0 || outFd < 0) {
+        LOG(RTLOG_ERROR, "Export trace failed, fd %d or %d is invalid", inFd, outFd);
+        return false;
+    }
+    std::vector<uint8_t> trace;
+    if (!ReadAll(inFd, trace)) {
+        return false;
+    }
+    if (trace.size() < TRACE_HEADER_SIZE || memcmp(trace.data(), TRACE_MAGIC, strlen(TRACE_MAGIC)) != 0) {
+        LOG(RTLOG_ERROR, "Export trace failed, the input is not a cangjie trace");
+        return false;
+    }
+
+    // The frequency is in the footer, and the events are timed from the earliest traceBuf.
+    Record record;
+    uint64_t frequency = 0;
+    uint64_t baseTicks = UINT64_MAX;
+    Reader scanner(trace);
+    while (scanner.Next(record)) {
+        if (record.type == EventType(TRACE_EV_FREQUENCY)) {
+            frequency = record.args[0];
+        } else if (record.type == EventType(TRACE_EV_BATCH)) {
+            baseTicks = std::min(baseTicks, record.ticks);
+        }
+    }
+    // A trace copied while it is written may end in the middle of an event, the events before are exported.
+    if (scanner.Failed()) {
+        LOG(RTLOG_ERROR, "The trace is truncated or malformed, the rest of it is not exported");
+    }
+    if (frequency == 0) {
+        constexpr uint64_t nsPerSecond = 1000 * 1000 * 1000;
+        LOG(RTLOG_ERROR, "The trace has no cpu frequency, its ticks are taken as nanoseconds");
+        frequency = nsPerSecond;
+    }
+
+    TraceExporter exporter(outFd, baseTicks == UINT64_MAX ? 0 : baseTicks, frequency);
+    exporter.out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    exporter.Emit("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"scheduler\"}}");
+    exporter.Emit("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"gc\"}}");
+    exporter.ThreadName(GC_PID, GC_CYCLE_TID, "cycle");
+    exporter.ThreadName(GC_PID, GC_PHASE_TID, "phase");
+    exporter.ThreadName(GC_PID, GC_PAUSE_TID, "pause");
+
+    // The gc events are written by the gc threads and by the mutators that stop the world, each with
+    // traceBufs of their own. They are put in order before the phases are laid out.
+    std::vector<Record> gcRecords;
+    Reader reader(trace);
+    while (reader.Next(record)) {
+        if (record.type >= EventType(TRACE_EV_GC_START) && record.type <= EventType(TRACE_EV_GC_STW_DONE)) {
+            gcRecords.push_back(record);
+        } else if (record.type >= EventType(TRACE_EV_PROC_WAKE) &&
+                   record.type <= EventType(TRACE_EV_CJTHREAD_SYSEXIT)) {
+            exporter.OnSchedulerEvent(record);
+        }
+    }
+    std::stable_sort(gcRecords.begin(), gcRecords.end(),
+                     [](const Record& a, const Record& b) { return a.ticks < b.ticks; });
+    for (const Record& gcRecord : gcRecords) {
+        exporter.OnGCEvent(gcRecord);
+    }
+    return exporter.Finish();
+}
+
+// The events of a processor are in order, it writes its traceBufs one after another.
+void TraceExporter::OnSchedulerEvent(const Record& record)
+{
+    uint32_t tid = record.processorId;
+    auto it = processors.find(tid);
+    if (it == processors.end()) {
+        it = processors.emplace(tid, ProcessorTrack()).first;
+        ThreadName(SCHEDULER_PID, tid, CString::FormatString("processor %u", tid));
+    }
+    ProcessorTrack& track = it->second;
+    track.lastTicks = std::max(track.lastTicks, record.ticks);
+    uint64_t ticks = record.ticks;
+    switch (record.type) {
+        case EventType(TRACE_EV_PROC_WAKE):
+            Instant("processor wake", SCHEDULER_PID, tid, ticks, "thread", record.args[0]);
+            break;
+        case EventType(TRACE_EV_PROC_STOP):
+            CloseSlice(track.running, SCHEDULER_PID, tid, ticks, "processor stop");
+            Instant("processor stop", SCHEDULER_PID, tid, ticks);
+            break;
+        case EventType(TRACE_EV_CJTHREAD_CREATE):
+            Instant("cjthread create", SCHEDULER_PID, tid, ticks, "cjthread", record.args[0]);
+            break;
+        case EventType(TRACE_EV_CJTHREAD_UNBLOCK):
+            Instant("cjthread unblock", SCHEDULER_PID, tid, ticks, "cjthread", record.args[0]);
+            break;
+        case EventType(TRACE_EV_CJTHREAD_START):
+            CloseSlice(track.running, SCHEDULER_PID, tid, ticks);
+            OpenSlice(track.running, CString::FormatString("cjthread %llu",
+                static_cast<unsigned long long>(record.args[0])), "cjthread", ticks, record.args[0]);
+            break;
+        case EventType(TRACE_EV_CJTHREAD_SYSCALL): {
+            uint64_t cjthreadId = track.running.cjthreadId;
+            CloseSlice(track.running, SCHEDULER_PID, tid, ticks, "syscall");
+            OpenSlice(track.running, "syscall", "syscall", ticks, cjthreadId);
+            break;
+        }
+        case EventType(TRACE_EV_CJTHREAD_SYSEXIT):
+            CloseSlice(track.running, SCHEDULER_PID, tid, ticks, "sysexit");
+            break;
+        default:
+            CloseSlice(track.running, SCHEDULER_PID, tid, ticks, EndReason(record.type));
+            break;
+    }
+}
+
+void TraceExporter::OnGCEvent(const Record& record)
+{
+    uint64_t ticks = record.ticks;
+    gcLastTicks = std::max(gcLastTicks, ticks);
+    switch (record.type) {
+        case EventType(TRACE_EV_GC_START):
+            CloseSlice(gcCycle, GC_PID, GC_CYCLE_TID, ticks);
+            OpenSlice(gcCycle, "gc", "gc", ticks);
+            break;
+        case EventType(TRACE_EV_GC_DONE):
+            CloseSlice(gcCycle, GC_PID, GC_CYCLE_TID, ticks);
+            break;
+        case EventType(TRACE_EV_GC_PHASE): {
+            // A phase lasts until the next one, the gc is idle between the cycles.
+            CloseSlice(gcPhase, GC_PID, GC_PHASE_TID, ticks);
+            uint64_t phase = record.args[0];
+            if (phase != GC_PHASE_IDLE && phase <= GC_PHASE_FORWARD) {
+                OpenSlice(gcPhase, Collector::GetGCPhaseName(static_cast<GCPhase>(phase)), "gc", ticks);
+            }
+            break;
+        }
+        case EventType(TRACE_EV_GC_STW_START):
+            CloseSlice(gcPause, GC_PID, GC_PAUSE_TID, ticks);
+            OpenSlice(gcPause, record.args[0] == 0 ? "stop the world" : "light sync", "gc", ticks);
+            break;
+        case EventType(TRACE_EV_GC_STW_DONE):
+            CloseSlice(gcPause, GC_PID, GC_PAUSE_TID, ticks);
+            break;
+        default:
+            break;
+    }
+}
+
+void TraceExporter::OpenSlice(Slice& slice, const CString& name, const char* category, uint64_t ticks,
+                              uint64_t cjthreadId)
+{
+    slice.open = true;
+    slice.name = name;
+    slice.category = category;
+    slice.startTicks = ticks;
+    slice.cjthreadId = cjthreadId;
+}
+
+void TraceExporter::CloseSlice(Slice& slice, uint32_t pid, uint32_t tid, uint64_t ticks, const char* end)
+{
+    if (!slice.open) {
+        return;
+    }
+    slice.open = false;
+    // The events of threads without a processor share the traceBufs of processor 0 and may be out of order.
+    uint64_t durTicks = ticks > slice.startTicks ? ticks - slice.startTicks : 0;
+    CString event = CString::FormatString("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,",
+                                          slice.name.Str(), slice.category, pid, tid);
+    event += CString::FormatString("\"ts\":%s,\"dur\":%.3f", Timestamp(slice.startTicks).Str(),
+                                   static_cast<double>(durTicks) / ticksPerUs);
+    if (pid == SCHEDULER_PID) {
+        event += CString::FormatString(",\"args\":{\"cjthread\":%llu,\"end\":\"%s\"}",
+                                       static_cast<unsigned long long>(slice.cjthreadId),
+                                       end == nullptr ? "unknown" : end);
+    }
+    event += "}";
+    Emit(event);
+}
+
+void TraceExporter::Instant(const char* name, uint32_t pid, uint32_t tid, uint64_t ticks, const char* argName,
+                            uint64_t arg)
+{
+    CString event = CString::FormatString("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%s",
+                                          name, pid, tid, Timestamp(ticks).Str());
+    if (argName != nullptr) {
+        event += CString::FormatString(",\"args\":{\"%s\":%llu}", argName, static_cast<unsigned long long>(arg));
+    }
+    event += "}";
+    Emit(event);
+}
+
+void TraceExporter::ThreadName(uint32_t pid, uint32_t tid, const CString& name)
+{
+    Emit(CString::FormatString("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,"
+                               "\"args\":{\"name\":\"%s\"}}", pid, tid, name.Str()));
+}
+
+// Microseconds since the earliest traceBuf, which is what the format takes.
+CString TraceExporter::Timestamp(uint64_t ticks) const
+{
+    uint64_t sinceBase = ticks > baseTicks ? ticks - baseTicks : 0;
+    return CString::FormatString("%.3f", static_cast<double>(sinceBase) / ticksPerUs);
+}
+
+void TraceExporter::Emit(const CString& event)
+{
+    if (!firstEvent) {
+        out += ",\n";
+    }
+    firstEvent = false;
+    out += event;
+    if (out.Length() >= FLUSH_SIZE && !failed) {
+        failed = !WriteAll(fd, out.Str(), out.Length());
+        out = CString();
+    }
+}
+
+// Slices still open are closed at the last event of their track.
+bool TraceExporter::Finish()
+{
+    for (auto& processor : processors) {
+        CloseSlice(processor.second.running, SCHEDULER_PID, processor.first, processor.second.lastTicks);
+    }
+    CloseSlice(gcCycle, GC_PID, GC_CYCLE_TID, gcLastTicks);
+    CloseSlice(gcPhase, GC_PID, GC_PHASE_TID, gcLastTicks);
+    CloseSlice(gcPause, GC_PID, GC_PAUSE_TID, gcLastTicks);
+    out += "\n]}\n";
+    if (!failed) {
+        failed = !WriteAll(fd, out.Str(), out.Length());
+    }
+    return !failed;
+}
+} // namespace MapleRuntime
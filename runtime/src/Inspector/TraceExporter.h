@@ -0,0 +1,107 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_TRACE_EXPORTER_H
+#define MRT_TRACE_EXPORTER_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "Base/CString.h"
+
+namespace MapleRuntime {
+// Converts the scheduler trace, as written by the trace dump or the flight recorder, to the JSON
+// trace event format of Chrome, which Perfetto and chrome://tracing open. The cjthreads run by
+// every processor are laid out on one timeline with the cycles, phases and pauses of the GC.
+class TraceExporter {
+public:
+    // Read the trace from `inFd` and write it to `outFd`.
+    static bool ExportChromeTrace(int inFd, int outFd);
+
+private:
+    static constexpr size_t MAX_ARGS = 4;
+
+    // An event of the trace with its absolute cpu ticks, metadata events are not kept.
+    struct Record {
+        uint8_t type;
+        uint8_t argNum;
+        uint32_t processorId;
+        uint64_t ticks;
+        uint64_t args[MAX_ARGS];
+    };
+
+    // Decodes the events of the trace one after another, see TraceRecordEvent.
+    class Reader {
+    public:
+        explicit Reader(const std::vector<uint8_t>& trace);
+        // Returns false at the end of the trace or on a malformed event, see `Failed`.
+        bool Next(Record& record);
+        bool Failed() const { return failed; }
+
+    private:
+        bool ReadByte(uint8_t& value);
+        bool ReadUint64(uint64_t& value);
+        bool Skip(uint64_t len);
+        bool SkipStack();
+
+        const std::vector<uint8_t>& data;
+        size_t pos;
+        uint32_t processorId { 0 };
+        uint64_t ticks { 0 };
+        bool failed { false };
+    };
+
+    // A slice being run on a track, closed by the next event that ends it.
+    struct Slice {
+        bool open { false };
+        CString name;
+        const char* category { nullptr };
+        uint64_t startTicks { 0 };
+        uint64_t cjthreadId { 0 };
+    };
+
+    TraceExporter(int fd, uint64_t baseTicks, uint64_t frequency)
+        : fd(fd), baseTicks(baseTicks), ticksPerUs(static_cast<double>(frequency) / 1e6) {}
+    ~TraceExporter() = default;
+
+    void OnSchedulerEvent(const Record& record);
+    void OnGCEvent(const Record& record);
+    void OpenSlice(Slice& slice, const CString& name, const char* category, uint64_t ticks, uint64_t cjthreadId = 0);
+    void CloseSlice(Slice& slice, uint32_t pid, uint32_t tid, uint64_t ticks, const char* end = nullptr);
+    void Instant(const char* name, uint32_t pid, uint32_t tid, uint64_t ticks, const char* argName = nullptr,
+                 uint64_t arg = 0);
+    void ThreadName(uint32_t pid, uint32_t tid, const CString& name);
+    CString Timestamp(uint64_t ticks) const;
+    void Emit(const CString& event);
+    bool Finish();
+
+    // Processors and the tracks of the gc are the threads of two processes.
+    static constexpr uint32_t SCHEDULER_PID = 1;
+    static constexpr uint32_t GC_PID = 2;
+    enum GCTrack : uint32_t { GC_CYCLE_TID = 1, GC_PHASE_TID = 2, GC_PAUSE_TID = 3 };
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+    struct ProcessorTrack {
+        Slice running;
+        uint64_t lastTicks { 0 };
+    };
+
+    int fd;
+    uint64_t baseTicks;
+    double ticksPerUs;
+    std::map<uint32_t, ProcessorTrack> processors;
+    Slice gcCycle;
+    Slice gcPhase;
+    Slice gcPause;
+    uint64_t gcLastTicks { 0 };
+    CString out;
+    bool firstEvent { true };
+    bool failed { false };
+};
+} // namespace MapleRuntime
+#endif // MRT_TRACE_EXPORTER_H
@@ -64,10 +64,36 @@ extern "C" MRT_EXPORT bool CJ_MCC_IsGCRunning();
 __asm__(".global _CJ_MCC_IsGCRunning\n\t.set _CJ_MCC_IsGCRunning, _MCC_IsGCRunning");
 extern "C" MRT_EXPORT size_t CJ_MCC_GetGCFreedSize();
 __asm__(".global _CJ_MCC_GetGCFreedSize\n\t.set _CJ_MCC_GetGCFreedSize, _MCC_GetGCFreedSize");
+extern "C" MRT_EXPORT size_t CJ_MCC_GetGCEvents(GCCycleRecord* records, size_t num);
+__asm__(".global _CJ_MCC_GetGCEvents\n\t.set _CJ_MCC_GetGCEvents, _MCC_GetGCEvents");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpGCEvents(int fd);
+__asm__(".global _CJ_MCC_DumpGCEvents\n\t.set _CJ_MCC_DumpGCEvents, _MCC_DumpGCEvents");
 extern "C" MRT_EXPORT size_t CJ_MCC_StartCpuProfiling();
 __asm__(".global _CJ_MCC_StartCpuProfiling\n\t.set _CJ_MCC_StartCpuProfiling, _MCC_StartCpuProfiling");
 extern "C" MRT_EXPORT size_t CJ_MCC_StopCpuProfiling(int fd);
 __asm__(".global _CJ_MCC_StopCpuProfiling\n\t.set _CJ_MCC_StopCpuProfiling, _MCC_StopCpuProfiling");
+extern "C" MRT_EXPORT bool CJ_MCC_StopCpuProfilingWithFormat(int fd, int32_t format);
+__asm__(".global _CJ_MCC_StopCpuProfilingWithFormat\n\t.set _CJ_MCC_StopCpuProfilingWithFormat, "
+        "_MCC_StopCpuProfilingWithFormat");
+extern "C" MRT_EXPORT bool CJ_MCC_StartFlightRecorder(uint32_t windowMs, uint32_t bufNum);
+__asm__(".global _CJ_MCC_StartFlightRecorder\n\t.set _CJ_MCC_StartFlightRecorder, _MCC_StartFlightRecorder");
+extern "C" MRT_EXPORT bool CJ_MCC_StopFlightRecorder();
+__asm__(".global _CJ_MCC_StopFlightRecorder\n\t.set _CJ_MCC_StopFlightRecorder, _MCC_StopFlightRecorder");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpFlightRecorder(int fd);
+__asm__(".global _CJ_MCC_DumpFlightRecorder\n\t.set _CJ_MCC_DumpFlightRecorder, _MCC_DumpFlightRecorder");
+extern "C" MRT_EXPORT bool CJ_MCC_ExportChromeTrace(int inFd, int outFd);
+__asm__(".global _CJ_MCC_ExportChromeTrace\n\t.set _CJ_MCC_ExportChromeTrace, _MCC_ExportChromeTrace");
+extern "C" MRT_EXPORT char* CJ_MCC_GetMetrics();
+__asm__(".global _CJ_MCC_GetMetrics\n\t.set _CJ_MCC_GetMetrics, _MCC_GetMetrics");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpMetrics(int fd);
+__asm__(".global _CJ_MCC_DumpMetrics\n\t.set _CJ_MCC_DumpMetrics, _MCC_DumpMetrics");
+extern "C" MRT_EXPORT HeapHistogramRecord* CJ_MCC_GetHeapHistogram(size_t* num);
+__asm__(".global _CJ_MCC_GetHeapHistogram\n\t.set _CJ_MCC_GetHeapHistogram, _MCC_GetHeapHistogram");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpHeapHistogram(int fd);
+__asm__(".global _CJ_MCC_DumpHeapHistogram\n\t.set _CJ_MCC_DumpHeapHistogram, _MCC_DumpHeapHistogram");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpCJHeapDataCompressed(int fd);
+__asm__(".global _CJ_MCC_DumpCJHeapDataCompressed\n\t.set _CJ_MCC_DumpCJHeapDataCompressed, "
+        "_MCC_DumpCJHeapDataCompressed");
 extern "C" MRT_EXPORT void CJ_MCC_SetGCThreshold(uint64_t GCThreshold);
 __asm__(".global _CJ_MCC_SetGCThreshold\n\t.set _CJ_MCC_SetGCThreshold, _MCC_SetGCThreshold");
 extern "C" MRT_EXPORT void* CJ_MCC_PostThrowException(ExceptionWrapper* mExceptionWrapper);
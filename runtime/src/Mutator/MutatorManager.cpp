@@ -267,6 +267,8 @@ void MutatorManager::StopTheWorld(bool syncGCPhase, GCPhase phase)
     // Prevent multi-thread doing STW concurrently.
     syncMutex.lock();
     syncTriggered.store(true);
+    ScheduleTraceEvent(TRACE_EV_GC_STW_START, -1, nullptr, 1, 0ULL);
+    syncStartTime = TimeUtil::NanoSeconds();
 
     AcquireMutatorManagementWLock();
 
@@ -309,6 +311,12 @@ void MutatorManager::StartTheWorld() noexcept
 #else
     (void)MapleRuntime::Futex(GetSyncFutexWord(), FUTEX_WAKE, INT_MAX);
 #endif
+    ScheduleTraceEvent(TRACE_EV_GC_STW_DONE, -1, nullptr, 0);
+    // Only the gc thread records its pauses, the stats of the cycle are not shared with other threads
+    // that stop the world, e.g. for heap dumps.
+    if (Heap::GetHeap().IsGcStarted() && ThreadLocal::GetThreadType() == ThreadType::GC_THREAD) {
+        Heap::GetHeap().GetCollector().GetGCStats().RecordPause(TimeUtil::NanoSeconds() - syncStartTime);
+    }
 
     MutatorManagementWUnlock();
 
@@ -341,6 +349,8 @@ void MutatorManager::StartLightSync(bool syncGCPhase, GCPhase phase)
     // Prevent multi-thread doing lsync concurrently.
     syncMutex.lock();
     syncTriggered.store(true);
+    ScheduleTraceEvent(TRACE_EV_GC_STW_START, -1, nullptr, 1, 1ULL);
+    syncStartTime = TimeUtil::NanoSeconds();
 
     AcquireMutatorManagementWLock();
 
@@ -368,6 +378,7 @@ void MutatorManager::StartLightSync(bool syncGCPhase, GCPhase phase)
     // Set global gc phase in the scope of mutatorlist lock
     Heap::GetHeap().InstallBarrier(phase);
     Heap::GetHeap().SetGCPhase(phase);
+    ScheduleTraceEvent(TRACE_EV_GC_PHASE, -1, nullptr, 1, static_cast<unsigned long long>(phase));
     lightSyncGCPhase = phase;
     undoneLightSyncMutators.clear();
     // Broadcast mutator phase transition signal to all mutators
@@ -396,6 +407,10 @@ void MutatorManager::StopLightSync() noexcept
 #else
     (void)MapleRuntime::Futex(GetSyncFutexWord(), FUTEX_WAKE, INT_MAX);
 #endif
+    ScheduleTraceEvent(TRACE_EV_GC_STW_DONE, -1, nullptr, 0);
+    if (Heap::GetHeap().IsGcStarted() && ThreadLocal::GetThreadType() == ThreadType::GC_THREAD) {
+        Heap::GetHeap().GetCollector().GetGCStats().RecordPause(TimeUtil::NanoSeconds() - syncStartTime);
+    }
     EnsurePhaseTransition(lightSyncGCPhase, undoneLightSyncMutators);
     MutatorManagementWUnlock();
     // Release syncMutex to allow other thread call lsync.
@@ -448,6 +463,9 @@ void MutatorManager::WaitUntilAllMutatorStopped()
         if (UNLIKELY(TimeUtil::MilliSeconds() - beginTime >
             (((remainMutatorsSize / STW_TIMEOUTS_THREADS_BASE_COUNT) * STW_TIMEOUTS_BASE_MS) + STW_TIMEOUTS_BASE_MS))) {
             timeoutTimes++;
+            if (timeoutTimes == 1) {
+                FlightRecorder::GetInstance().OnStopTheWorldTimeout();
+            }
             beginTime = TimeUtil::MilliSeconds();
             DumpMutators(timeoutTimes);
         }
@@ -493,6 +511,7 @@ void MutatorManager::TransitionAllMutatorsToGCPhase(GCPhase phase)
     // Set global gc phase in the scope of mutatorlist lock
     Heap::GetHeap().InstallBarrier(phase);
     Heap::GetHeap().SetGCPhase(phase);
+    ScheduleTraceEvent(TRACE_EV_GC_PHASE, -1, nullptr, 1, static_cast<unsigned long long>(phase));
 
     std::list<Mutator*> undoneMutators;
     // Broadcast mutator phase transition signal to all mutators
@@ -18,6 +18,7 @@
 #include "Base/Panic.h"
 #include "Base/RwLock.h"
 #include "Common/PageAllocator.h"
+#include "Inspector/FlightRecorder.h"
 #include "Mutator.h"
 #if defined(__linux__) || defined(hongmeng) || defined(__APPLE__)
 #include "SafepointPageManager.h"
@@ -254,6 +255,7 @@ private:
     std::atomic<bool> worldStopped = { false };
     std::list<Mutator*> undoneLightSyncMutators;
     GCPhase lightSyncGCPhase;
+    uint64_t syncStartTime = 0;
 
 #if defined(_WIN64) || defined (__APPLE__)
     std::condition_variable mutatorSuspensionCV;
@@ -281,8 +283,11 @@ public:
 
     __attribute__((always_inline)) ~ScopedStopTheWorld()
     {
-        LOG(RTLOG_REPORT, "%s stw time %zu us", reason, GetElapsedTime() / 1000); // 1000:nsec per usec
+        uint64_t pauseNs = GetElapsedTime();
+        LOG(RTLOG_REPORT, "%s stw time %zu us", reason, pauseNs / 1000); // 1000:nsec per usec
         MutatorManager::Instance().StartTheWorld();
+        // Dumped once the world runs again, so that writing it does not lengthen the pause.
+        FlightRecorder::GetInstance().OnStopTheWorldEnd(pauseNs);
     }
 
     uint64_t GetElapsedTime() const { return TimeUtil::NanoSeconds() - startTime; }
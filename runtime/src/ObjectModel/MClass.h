@@ -228,6 +228,8 @@ typedef TypeInfo* (*GenericFunc)(TypeInfo**);
 struct ShortGCTib {
     ArchUInt bitmap; // lower 63 bits are valid, each bit indicates 8-byte width, 1:ref, 0:no-ref
 
+    U32 GetRefFieldCount() const { return static_cast<U32>(__builtin_popcountll(bitmap & (~SIGN_BIT))); }
+
     void ForEachBitmapWord(MAddress fieldAddr, const RefFieldVisitor& visitor) const
     {
         ArchUInt gcInfo = bitmap & (~SIGN_BIT);
@@ -287,6 +289,14 @@ struct StdGCTib {
         bitmapWord >>= BITS_FOR_REF;
         fieldAddr += sizeof(RefField<>);
     }
+    U32 GetRefFieldCount() const
+    {
+        U32 count = 0;
+        for (U32 i = 0; i < nBitmapWords; ++i) {
+            count += static_cast<U32>(__builtin_popcount(bitmapWords[i]));
+        }
+        return count;
+    }
     void ForEachBitmapWord(MAddress contentAddr, const RefFieldVisitor& visitor) const
     {
         const U8* bitmaps = bitmapWords;
@@ -352,6 +362,9 @@ union GCTib {
 #endif
     }
 
+    // The number of ref fields, the same as the fields visited by ForEachBitmapWord.
+    U32 GetRefFieldCount() const { return IsGCTibWord() ? bitmap.GetRefFieldCount() : gctib->GetRefFieldCount(); }
+
     void ForEachBitmapWord(MAddress contentAddr, const RefFieldVisitor& visitor) const
     {
         if (IsGCTibWord()) {
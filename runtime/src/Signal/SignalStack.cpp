@@ -10,6 +10,7 @@
 
 #include <dlfcn.h>
 #include <pthread.h>
+#include <sched.h>
 #include <csignal>
 #include <cstdlib>
 #include <climits>
@@ -77,11 +78,31 @@ static void SetHandlingSignal(bool value)
 
 void SignalStack::AddHandler(SignalAction* sa)
 {
-    handlerStack.push_back(*sa);
+    if ((sa->scFlags & SIGNAL_STACK_SYNC) == 0) {
+        handlerStack.push_back(*sa);
+        return;
+    }
+    for (size_t i = 0; i < SYNC_HANDLER_NUM; ++i) {
+        SignalHandlerFn expected = nullptr;
+        if (syncHandlers[i].compare_exchange_strong(expected, sa->saSignalAction)) {
+            return;
+        }
+    }
+    LOG(RTLOG_ERROR, "too many sync signal handlers, at most %zu", SYNC_HANDLER_NUM);
 }
 
 void SignalStack::RemoveHandler(bool (*fn)(int, siginfo_t*, void*))
 {
+    for (size_t i = 0; i < SYNC_HANDLER_NUM; ++i) {
+        SignalHandlerFn expected = fn;
+        if (fn != nullptr && syncHandlers[i].compare_exchange_strong(expected, nullptr)) {
+            // A thread may have loaded fn before the store and still be running it.
+            while (syncRunning.load() != 0) {
+                (void)sched_yield();
+            }
+            return;
+        }
+    }
     for (std::vector<SignalAction>::iterator it = handlerStack.begin(); it != handlerStack.end(); it++) {
         if ((*it).saSignalAction == fn) {
             handlerStack.erase(it);
@@ -97,8 +118,26 @@ struct SignalArgs {
     bool isAsync;
 };
 
+bool SignalStack::HandleSync(int signal, siginfo_t* siginfo, void* ucontextRaw)
+{
+    SignalStack& stack = SignalStack::stacks[signal];
+    bool handled = false;
+    stack.syncRunning.fetch_add(1);
+    for (size_t i = 0; i < SYNC_HANDLER_NUM && !handled; ++i) {
+        SignalHandlerFn fn = stack.syncHandlers[i].load();
+        handled = fn != nullptr && fn(signal, siginfo, ucontextRaw);
+    }
+    stack.syncRunning.fetch_sub(1);
+    return handled;
+}
+
 void SignalStack::Handler(int signal, siginfo_t* siginfo, void* ucontextRaw)
 {
+    int savedErrno = errno;
+    if (HandleSync(signal, siginfo, ucontextRaw)) {
+        errno = savedErrno;
+        return;
+    }
     FLOG(RTLOG_ERROR, "CJNative Handle signal: %d.", signal);
     SignalArgs* args = new SignalArgs{signal, siginfo, ucontextRaw, false};
     if (args == nullptr) {
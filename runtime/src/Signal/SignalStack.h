@@ -8,6 +8,7 @@
 #ifndef MRT_SIGNAL_STACK_H
 #define MRT_SIGNAL_STACK_H
 
+#include <atomic>
 #include <csignal>
 
 #include "Base/Log.h"
@@ -21,6 +22,12 @@ using sighandler_t = sig_t;
 namespace MapleRuntime {
 
 constexpr uint64_t SIGNAL_STACK_ALLOW_NORETURN = 0x1UL;
+// Set in SignalAction::scFlags of runtime handlers that must run in the signal context of the
+// interrupted thread, such as preemption ticks and profiling samples. They are called before the
+// other handlers, must be async-signal-safe, and are not logged since they fire at a high rate.
+constexpr uint64_t SIGNAL_STACK_SYNC = 0x1UL << 32;
+
+using SignalHandlerFn = bool (*)(int, siginfo_t*, void*);
 
 class SignalStack {
 public:
@@ -53,6 +60,7 @@ public:
 
     static void Handler(int signal, siginfo_t* siginfo, void* ucontextRaw);
     static void HandlerImpl(void* args);
+    static bool HandleSync(int signal, siginfo_t* siginfo, void* ucontextRaw);
     static void InitializeSignalStack();
     static SignalStack* GetStacks() { return stacks; }
     struct sigaction sigAction;
@@ -62,6 +70,13 @@ private:
     bool isUserSigHandler;
 
     std::vector<SignalAction> handlerStack;
+
+    // Sync handlers are read by the signal handler on any thread, so they are kept out of
+    // handlerStack in slots that are only loaded and stored atomically. syncRunning counts the
+    // threads calling them, which a removal waits to drain before the handler may go away.
+    static constexpr size_t SYNC_HANDLER_NUM = 4;
+    std::atomic<SignalHandlerFn> syncHandlers[SYNC_HANDLER_NUM] = {};
+    std::atomic<uint32_t> syncRunning = { 0 };
 #ifdef __APPLE__
     static SignalStack stacks[NSIG];
 #else
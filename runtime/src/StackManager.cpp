@@ -34,6 +34,7 @@
 #include "StackMap/StackMap.h"
 #endif
 #include "CpuProfiler/CpuProfiler.h"
+#include "CpuProfiler/SignalSampler.h"
 
 #define LIBCANGJIE_RUNTIME "libcangjie-runtime"
 #define LIBCANGJIE_STD_CORE "libcangjie-std-core"
@@ -124,6 +125,57 @@ void StackManager::PrintStackTraceForCpuProfile(UnwindContext* unContext, unsign
     CpuProfiler::GetInstance().GetGenerator().Post(cjThreadId, funcDescRefs, frameTypes, lineNumbers);
 }
 
+void StackManager::RecordRawSampleForCpuProfile(const RawSample& sample)
+{
+    // A raw stack has no unwind context, so the type of a frame follows from the stubs above it. Frames
+    // between a C2N, C2R, safepoint, stack grow or exclusive stub and the next N2C stub are managed. The
+    // leaf frames are managed unless the mutator was in saferegion, and frames of the runtime are not.
+    constexpr uintptr_t maxFuncSize = 16 * 1024 * 1024;
+    bool managed = !sample.inSaferegion;
+    std::vector<uint64_t> funcDescRefs;
+    std::vector<FrameType> frameTypes;
+    std::vector<uint32_t> lineNumbers;
+    for (uint32_t i = 0; i < sample.frameCnt; ++i) {
+        uintptr_t pc = static_cast<uintptr_t>(sample.pcs[i]);
+        uintptr_t startPC = static_cast<uintptr_t>(sample.startPCs[i]);
+#if defined(ENABLE_BACKWARD_PTRAUTH_CFI)
+        pc = PtrauthStripInstPointer(pc);
+#endif
+        MachineFrame mFrame(nullptr, reinterpret_cast<const uint32_t*>(pc));
+        if (mFrame.IsN2CStubFrame()) {
+            managed = false;
+            continue;
+        }
+        if (mFrame.IsC2NStubFrame() || mFrame.IsC2RStubFrame() || mFrame.IsSafepointHandlerStubFrame() ||
+            mFrame.IsStackGrowStubFrame() || mFrame.IsExclusiveStubFrame()) {
+            managed = true;
+            continue;
+        }
+        if (mFrame.IsRuntimeFrame()) {
+            managed = false;
+            continue;
+        }
+        // The start pc was read from the stack by the signal handler, it is checked before its function
+        // desc is read. A leaf sampled within its prologue still points at the frame of its caller.
+        if (!managed || startPC == 0 || startPC > pc || pc - startPC >= maxFuncSize) {
+            continue;
+        }
+        FuncDescRef funcDesc = MFuncDesc::GetFuncDesc(static_cast<Uptr>(startPC));
+        StackMapBuilder stackMapBuild(startPC, pc, 0, reinterpret_cast<uint64_t*>(funcDesc));
+        MethodMap methodMap = stackMapBuild.Build<MethodMap>();
+        uint32_t lineNum = methodMap.IsValid() ? methodMap.GetLineNum() : 0;
+        funcDescRefs.emplace_back(reinterpret_cast<uint64_t>(funcDesc));
+        frameTypes.emplace_back(FrameType::MANAGED);
+        lineNumbers.emplace_back(lineNum);
+    }
+    // Samples of native code called from no managed frame are not part of the profile.
+    if (funcDescRefs.empty()) {
+        return;
+    }
+    CpuProfiler::GetInstance().GetGenerator().Post(sample.timeStamp, sample.cjthreadId, sample.processorId,
+                                                   funcDescRefs, frameTypes, lineNumbers);
+}
+
 void StackManager::RecordLiteFrameInfos(std::vector<uint64_t>& liteFrameInfos, size_t steps)
 {
     PrintStackInfo printStackInfo;
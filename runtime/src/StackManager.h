@@ -16,6 +16,8 @@
 #include "UnwindStack/StackInfo.h"
 
 namespace MapleRuntime {
+struct RawSample;
+
 class StackManager {
 public:
     StackManager();
@@ -56,6 +58,9 @@ public:
 
     static void PrintStackTraceForCpuProfile(UnwindContext* unContext, unsigned long long int cjThreadId);
 
+    // Resolve the managed frames of a stack taken by the SIGPROF handler and post them to the cpu profile.
+    static void RecordRawSampleForCpuProfile(const RawSample& sample);
+
     static void RecordLiteFrameInfos(std::vector<uint64_t>& liteFrameInfos, size_t steps = STACK_UNWIND_STEP_MAX);
 
     static void GetStackTraceByLiteFrameInfos(const std::vector<uint64_t>& liteFrameInfos,
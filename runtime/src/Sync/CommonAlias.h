@@ -31,5 +31,19 @@ MRT_EXPORT void CJ_MRT_SetCJThreadName(void* handle, uint8_t* name, size_t len)
 MRT_EXPORT int64_t CJ_MRT_GetCJThreadId(void* handle) __attribute__((alias("MRT_GetCJThreadId")));
 MRT_EXPORT int64_t CJ_MRT_GetCJThreadState(void* handle) __attribute__((alias("MRT_GetCJThreadState")));
 MRT_EXPORT void* CJ_MRT_GetCurrentCJThread() __attribute__((alias("MRT_GetCurrentCJThread")));
+MRT_EXPORT int64_t CJ_MRT_SetMutexProfileRate(int64_t rate) __attribute__((alias("MRT_SetMutexProfileRate")));
+MRT_EXPORT bool CJ_MRT_DumpMutexProfile(int fd) __attribute__((alias("MRT_DumpMutexProfile")));
+MRT_EXPORT int64_t CJ_MRT_SetOffCpuProfileThreshold(int64_t thresholdNs)
+    __attribute__((alias("MRT_SetOffCpuProfileThreshold")));
+MRT_EXPORT bool CJ_MRT_DumpOffCpuProfile(int fd, int32_t kind) __attribute__((alias("MRT_DumpOffCpuProfile")));
+MRT_EXPORT void* CJ_MRT_RWLockNew(bool bigReader) __attribute__((alias("MRT_RWLockNew")));
+MRT_EXPORT void CJ_MRT_RWLockDelete(void* ptr) __attribute__((alias("MRT_RWLockDelete")));
+MRT_EXPORT void CJ_MRT_RWLockReadLock(void* ptr) __attribute__((alias("MRT_RWLockReadLock")));
+MRT_EXPORT bool CJ_MRT_RWLockReadTryLock(void* ptr) __attribute__((alias("MRT_RWLockReadTryLock")));
+MRT_EXPORT bool CJ_MRT_RWLockReadUnlock(void* ptr) __attribute__((alias("MRT_RWLockReadUnlock")));
+MRT_EXPORT void CJ_MRT_RWLockWriteLock(void* ptr) __attribute__((alias("MRT_RWLockWriteLock")));
+MRT_EXPORT bool CJ_MRT_RWLockWriteTryLock(void* ptr) __attribute__((alias("MRT_RWLockWriteTryLock")));
+MRT_EXPORT bool CJ_MRT_RWLockWriteUnlock(void* ptr) __attribute__((alias("MRT_RWLockWriteUnlock")));
+MRT_EXPORT bool CJ_MRT_RWLockDowngrade(void* ptr) __attribute__((alias("MRT_RWLockDowngrade")));
 
 #endif
\ No newline at end of file
@@ -56,5 +56,32 @@ MRT_EXPORT int64_t CJ_MRT_GetCJThreadState(void* handle);
 __asm__(".global _CJ_MRT_GetCJThreadState\n\t.set _CJ_MRT_GetCJThreadState, _MRT_GetCJThreadState");
 MRT_EXPORT void* CJ_MRT_GetCurrentCJThread();
 __asm__(".global _CJ_MRT_GetCurrentCJThread\n\t.set _CJ_MRT_GetCurrentCJThread, _MRT_GetCurrentCJThread");
+MRT_EXPORT int64_t CJ_MRT_SetMutexProfileRate(int64_t rate);
+__asm__(".global _CJ_MRT_SetMutexProfileRate\n\t.set _CJ_MRT_SetMutexProfileRate, _MRT_SetMutexProfileRate");
+MRT_EXPORT bool CJ_MRT_DumpMutexProfile(int fd);
+__asm__(".global _CJ_MRT_DumpMutexProfile\n\t.set _CJ_MRT_DumpMutexProfile, _MRT_DumpMutexProfile");
+MRT_EXPORT int64_t CJ_MRT_SetOffCpuProfileThreshold(int64_t thresholdNs);
+__asm__(".global _CJ_MRT_SetOffCpuProfileThreshold\n\t.set _CJ_MRT_SetOffCpuProfileThreshold, "
+        "_MRT_SetOffCpuProfileThreshold");
+MRT_EXPORT bool CJ_MRT_DumpOffCpuProfile(int fd, int32_t kind);
+__asm__(".global _CJ_MRT_DumpOffCpuProfile\n\t.set _CJ_MRT_DumpOffCpuProfile, _MRT_DumpOffCpuProfile");
+MRT_EXPORT void* CJ_MRT_RWLockNew(bool bigReader);
+__asm__(".global _CJ_MRT_RWLockNew\n\t.set _CJ_MRT_RWLockNew, _MRT_RWLockNew");
+MRT_EXPORT void CJ_MRT_RWLockDelete(void* ptr);
+__asm__(".global _CJ_MRT_RWLockDelete\n\t.set _CJ_MRT_RWLockDelete, _MRT_RWLockDelete");
+MRT_EXPORT void CJ_MRT_RWLockReadLock(void* ptr);
+__asm__(".global _CJ_MRT_RWLockReadLock\n\t.set _CJ_MRT_RWLockReadLock, _MRT_RWLockReadLock");
+MRT_EXPORT bool CJ_MRT_RWLockReadTryLock(void* ptr);
+__asm__(".global _CJ_MRT_RWLockReadTryLock\n\t.set _CJ_MRT_RWLockReadTryLock, _MRT_RWLockReadTryLock");
+MRT_EXPORT bool CJ_MRT_RWLockReadUnlock(void* ptr);
+__asm__(".global _CJ_MRT_RWLockReadUnlock\n\t.set _CJ_MRT_RWLockReadUnlock, _MRT_RWLockReadUnlock");
+MRT_EXPORT void CJ_MRT_RWLockWriteLock(void* ptr);
+__asm__(".global _CJ_MRT_RWLockWriteLock\n\t.set _CJ_MRT_RWLockWriteLock, _MRT_RWLockWriteLock");
+MRT_EXPORT bool CJ_MRT_RWLockWriteTryLock(void* ptr);
+__asm__(".global _CJ_MRT_RWLockWriteTryLock\n\t.set _CJ_MRT_RWLockWriteTryLock, _MRT_RWLockWriteTryLock");
+MRT_EXPORT bool CJ_MRT_RWLockWriteUnlock(void* ptr);
+__asm__(".global _CJ_MRT_RWLockWriteUnlock\n\t.set _CJ_MRT_RWLockWriteUnlock, _MRT_RWLockWriteUnlock");
+MRT_EXPORT bool CJ_MRT_RWLockDowngrade(void* ptr);
+__asm__(".global _CJ_MRT_RWLockDowngrade\n\t.set _CJ_MRT_RWLockDowngrade, _MRT_RWLockDowngrade");
 
 #endif
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "MutexProfiler.h"
+
+#include "Base/CString.h"
+#include "Base/SysCall.h"
+#include "StackManager.h"
+
+namespace MapleRuntime {
+int64_t MutexProfiler::SetRate(int64_t newRate)
+{
+    newRate = newRate < 0 ? 0 : newRate;
+    int64_t oldRate = rate.load(std::memory_order_relaxed);
+    if (oldRate <= 0 && newRate > 0) {
+        std::lock_guard<std::mutex> lg(recordsMutex);
+        records.clear();
+    }
+    rate.store(newRate, std::memory_order_relaxed);
+    return oldRate;
+}
+
+bool MutexProfiler::Sampled(int64_t currRate)
+{
+    if (currRate == 1) {
+        return true;
+    }
+    // splitmix64, good enough to pick one in `currRate` and cheaper than a lock.
+    constexpr uint64_t gamma = 0x9E3779B97F4A7C15ULL;
+    constexpr uint64_t mix1 = 0xBF58476D1CE4E5B9ULL;
+    constexpr uint64_t mix2 = 0x94D049BB133111EBULL;
+    uint64_t z = seed.fetch_add(gamma, std::memory_order_relaxed) + gamma;
+    z = (z ^ (z >> 30)) * mix1; // 30: shift of splitmix64
+    z = (z ^ (z >> 27)) * mix2; // 27: shift of splitmix64
+    z ^= z >> 31;               // 31: shift of splitmix64
+    return z % static_cast<uint64_t>(currRate) == 0;
+}
+
+void MutexProfiler::Record(uint64_t waitNs)
+{
+    int64_t currRate = rate.load(std::memory_order_relaxed);
+    if (currRate <= 0 || !Sampled(currRate)) {
+        return;
+    }
+    std::vector<uint64_t> frames;
+    StackManager::RecordLiteFrameInfos(frames, STACK_DEPTH);
+
+    std::lock_guard<std::mutex> lg(recordsMutex);
+    auto it = records.find(frames);
+    if (it == records.end()) {
+        if (records.size() >= MAX_STACKS) {
+            frames.clear();
+        }
+        it = records.emplace(std::move(frames), Contention { 0, 0 }).first;
+    }
+    it->second.count++;
+    it->second.delayNs += waitNs;
+}
+
+bool MutexProfiler::Dump(int fd)
+{
+    if (fd < 0) {
+        return false;
+    }
+    // Delays are in ns, so one cycle is one ns. Counts are not scaled, pprof scales them by the
+    // sampling period.
+    CString out = CString::FormatString("--- mutex:\ncycles/second=1000000000\nsampling period=%lld\n",
+                                        static_cast<long long>(rate.load(std::memory_order_relaxed)));
+    {
+        constexpr size_t liteFrameInfoElementSize = 3; // {ip, startPC, funcDesc} per frame
+        std::lock_guard<std::mutex> lg(recordsMutex);
+        for (const auto& record : records) {
+            const std::vector<uint64_t>& frames = record.first;
+            out.Append(CString::FormatString("%llu %llu @", static_cast<unsigned long long>(record.second.delayNs),
+                                             static_cast<unsigned long long>(record.second.count)));
+            for (size_t i = 0; i + liteFrameInfoElementSize <= frames.size(); i += liteFrameInfoElementSize) {
+                out.Append(CString::FormatString(" 0x%llx", static_cast<unsigned long long>(frames[i])));
+            }
+            out.Append("\n");
+            for (size_t i = 0; i + liteFrameInfoElementSize <= frames.size(); i += liteFrameInfoElementSize) {
+                std::vector<uint64_t> frame(frames.begin() + i, frames.begin() + i + liteFrameInfoElementSize);
+                std::vector<StackTraceElement> elements;
+                StackManager::GetStackTraceByLiteFrameInfos(frame, elements);
+                if (elements.empty()) {
+                    continue;
+                }
+                const StackTraceElement& ste = elements[0];
+                out.Append(CString::FormatString("#\t0x%llx\t%s%s%s\t%s:%lld\n",
+                                                 static_cast<unsigned long long>(frames[i]), ste.className.Str(),
+                                                 ste.className.Length() > 0 ? "." : "", ste.methodName.Str(),
+                                                 ste.fileName.Str(), static_cast<long long>(ste.lineNumber)));
+            }
+        }
+    }
+    return WriteAll(fd, out.Str(), out.Length());
+}
+} // namespace MapleRuntime
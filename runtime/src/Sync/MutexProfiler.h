@@ -0,0 +1,57 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_MUTEX_PROFILER_H
+#define MRT_MUTEX_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace MapleRuntime {
+// Samples the time spent waiting for contended mutexes, aggregated by the stack of the lock site.
+class MutexProfiler {
+public:
+    static MutexProfiler& GetInstance()
+    {
+        static MutexProfiler instance;
+        return instance;
+    }
+
+    // 0 disables the profile, otherwise one in `rate` contentions is recorded on average.
+    // Turning the profile on drops the records of the previous run. Returns the previous rate.
+    int64_t SetRate(int64_t newRate);
+    bool IsEnabled() const { return rate.load(std::memory_order_relaxed) > 0; }
+
+    // Called by a mutator that acquired a mutex after waiting `waitNs` for it.
+    void Record(uint64_t waitNs);
+
+    // Write the records to `fd` in the text format of the pprof "mutex" profile.
+    bool Dump(int fd);
+
+private:
+    struct Contention {
+        uint64_t count;
+        uint64_t delayNs;
+    };
+
+    MutexProfiler() = default;
+    ~MutexProfiler() = default;
+    bool Sampled(int64_t currRate);
+
+    static constexpr size_t MAX_STACKS = 4096; // lock sites beyond it are counted as one with no stack
+    static constexpr size_t STACK_DEPTH = 32;
+    std::atomic<int64_t> rate { 0 };
+    std::atomic<uint64_t> seed { 0 };
+    std::mutex recordsMutex;
+    // Keyed by the lite frame infos of the lock site, see `StackManager::RecordLiteFrameInfos`.
+    std::map<std::vector<uint64_t>, Contention> records;
+};
+} // namespace MapleRuntime
+#endif // MRT_MUTEX_PROFILER_H
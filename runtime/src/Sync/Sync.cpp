@@ -7,8 +7,13 @@
 
 #include "Sync.h"
 #include <atomic>
+#include <climits>
+#include <new>
+#include <thread>
 
 #include "Base/TimeUtils.h"
+#include "MutexProfiler.h"
+#include "CpuProfiler/OffCpuProfiler.h"
 #include "schedule.h"
 #include "Concurrency/ConcurrencyModel.h"
 #if defined(CANGJIE_TSAN_SUPPORT)
@@ -151,6 +156,8 @@ int MCC_MutexInit(void* ptr)
         mutex->isSemaInit = true;
         mutex->ownerThreadId = INVALID_THREAD_ID;
         mutex->ownCount = 0;
+        mutex->spinLearn.store(0, std::memory_order_relaxed);
+        mutex->ownerSlot.store(0, std::memory_order_relaxed);
     }
     return ret;
 }
@@ -163,6 +170,10 @@ const int64_t WAITER_UNIT_SHIFT = 3;
 const int64_t WAITER_UNIT = 1 << WAITER_UNIT_SHIFT;
 const uint64_t STARVING_THRESHOLD = 1000; // 1000us
 const int64_t SPIN_THRESHOLD = 4;
+const int64_t SPIN_MAX = 64; // spin rounds at most, however long the learned hold time
+// `spinLearn` is an average of spin rounds in fixed point, a new spin weighs 1/8 in it.
+const int SPIN_LEARN_SHIFT = 3;
+const int64_t SPIN_LEARN_MAX = 255;
 
 static bool IsSpinning(int64_t state) { return state & SPINNING; }
 static bool IsStarving(int64_t state) { return state & STARVING; }
@@ -196,7 +207,63 @@ static void DoSpin()
     }
 }
 
-static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
+// Spin rounds before parking: SPIN_THRESHOLD plus twice the rounds spins recently needed to get
+// the mutex, so that a hold time a bit longer than the usual one is still waited out.
+static int64_t MutexSpinBudget(const CJMutex* mutex)
+{
+    int64_t learned = (mutex->spinLearn.load(std::memory_order_relaxed) + (1 << (SPIN_LEARN_SHIFT - 1))) >>
+        SPIN_LEARN_SHIFT;
+    int64_t budget = SPIN_THRESHOLD + 2 * learned; // 2: headroom over the learned rounds
+    return budget < SPIN_MAX ? budget : SPIN_MAX;
+}
+
+// Learn from a spin that got the mutex after `rounds` rounds, or ran out of rounds with 0. The
+// average decays to 0 for a mutex held longer than spinning can wait out.
+static void MutexSpinLearn(CJMutex* mutex, int64_t rounds)
+{
+    int64_t learned = mutex->spinLearn.load(std::memory_order_relaxed);
+    learned += rounds - ((learned + (1 << SPIN_LEARN_SHIFT) - 1) >> SPIN_LEARN_SHIFT);
+    learned = learned < 0 ? 0 : (learned > SPIN_LEARN_MAX ? SPIN_LEARN_MAX : learned);
+    mutex->spinLearn.store(static_cast<uint8_t>(learned), std::memory_order_relaxed);
+}
+
+// Spinning is only worth it while the owner runs on a processor and may release the mutex soon.
+// `ownerSlot` is a hint, the processors are searched when it is stale.
+static bool MutexOwnerRunning(CJMutex* mutex)
+{
+    int64_t owner = mutex->ownerThreadId.load(std::memory_order_relaxed);
+    // The owner is being stored or the mutex is being released.
+    if (owner == INVALID_THREAD_ID) {
+        return true;
+    }
+    unsigned long long ownerId = static_cast<unsigned long long>(owner);
+    unsigned int slot = mutex->ownerSlot.load(std::memory_order_relaxed);
+    if (slot != 0 && ProcessorSlotRunning(slot, ownerId)) {
+        return true;
+    }
+    slot = ProcessorSlotFind(ownerId);
+    if (slot == 0 || slot > UINT16_MAX) {
+        return false;
+    }
+    mutex->ownerSlot.store(static_cast<uint16_t>(slot), std::memory_order_relaxed);
+    return true;
+}
+
+// Called when the slow path gets the mutex.
+static void MutexAcquired(CJMutex* mutex, uint64_t waitStart)
+{
+    unsigned int slot = ProcessorSlotGet();
+    mutex->ownerSlot.store(slot > UINT16_MAX ? 0 : static_cast<uint16_t>(slot), std::memory_order_relaxed);
+    if (waitStart != 0) {
+        uint64_t waitNs = TimeUtil::NanoSeconds() - waitStart;
+        MutexProfiler::GetInstance().Record(waitNs);
+        OffCpuProfiler::GetInstance().RecordMutexWait(waitNs);
+    }
+}
+
+// A `requeued` thread was moved from a monitor to the sema of the mutex and counted as a waiter
+// by `MutexRequeueWaiter`. It has been woken up as if it had parked below.
+static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count, bool requeued = false)
 {
     int64_t currThreadId = MRT_GetCurrentThreadID();
     if (mutex->ownerThreadId.load(std::memory_order_acquire) == currThreadId) {
@@ -209,14 +276,76 @@ static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
     bool hasSetSpinFlag = false;
     bool isStarved = false;
     uint64_t firstWaitTime = 0;
-    int trySpinCount = 0;
+    int64_t trySpinCount = 0;
+    int64_t spinBudget = MutexSpinBudget(mutex);
+    // The wait is only timed when the contention or the off-cpu profile is on.
+    uint64_t waitStart = MutexProfiler::GetInstance().IsEnabled() || OffCpuProfiler::GetInstance().IsEnabled() ?
+        TimeUtil::NanoSeconds() : 0;
+    bool isWoken = false;
+    if (requeued) {
+        firstWaitTime = TimeUtil::MicroSeconds();
+        // The sema was released for the current thread, unless a parking thread took it first.
+        MRT_SemAcquire(&mutex->sema, true);
+        isWoken = true;
+    }
     for (;;) { // The main loop to acquire the mutex
+        if (isWoken) {
+            isWoken = false;
+            // ========== After wake up ==============
+            // If waiting too long, the current thread becomes starved
+            isStarved = isStarved || (TimeUtil::MicroSeconds() - firstWaitTime) > STARVING_THRESHOLD;
+            // Read the new state
+            int64_t currState = mutex->state.load();
+            if (!IsStarving(currState)) {
+                // Retry to acquire the mutex; also, spinning restarts
+                trySpinCount = 0;
+                spinBudget = MutexSpinBudget(mutex);
+                // Since The spinning flag is always set by `unlock`,
+                // we should set the variable as well.
+                hasSetSpinFlag = true;
+                continue; // Waked up; restart
+            }
+            // Mutex is in starvation mode.
+            // When the current thread was woken up, ownership was handed off to it directly.
+            // There are some invariants:
+            //  - only ONE thread can be woken up and reach here,
+            //  - mutex cannot be spinning,
+            //  - `LOCKED` is not set, and
+            //  - #waiters must be positive because `unlock` will not change it under starvation.
+            bool valid = !IsLocked(currState) && !IsSpinning(currState) && GetWaiters(currState) > 0;
+            MRT_ASSERT(valid, "Sync error: inconsistent mutex state!\n");
+            if (!valid) {
+                LOG(RTLOG_ERROR, "Sync error: inconsistent mutex state!\n");
+                return false;
+            }
+            // So, the inconsistent state should be fixed here.
+            // A trick to use a single statement to fix all states.
+            // Fix as: state + LOCKED - WAITER_UNIT
+            int64_t delta = LOCKED - WAITER_UNIT;
+            // Exit starvation if a non-starved thread is wakeup, or there are no waiters.
+            if (!isStarved || GetWaiters(currState) == 1) {
+                // Fix as: state + LOCKED - WAITER_UNIT - STARVING
+                delta -= STARVING;
+            }
+            mutex->state.fetch_add(delta);
+            MRT_ASSERT(mutex->ownerThreadId.load(std::memory_order_acquire) == INVALID_THREAD_ID,
+                       "Sync error: invalid mutex owner\n");
+            MRT_ASSERT(mutex->ownCount == 0, "Sync error: invalid mutex owning count\n");
+            mutex->ownCount = count;
+            mutex->ownerThreadId.store(currThreadId, std::memory_order_release);
+#if defined(CANGJIE_TSAN_SUPPORT)
+            Sanitizer::TsanAcquire(reinterpret_cast<void*>(mutex));
+#endif
+            MutexAcquired(mutex, waitStart);
+            return true;
+        }
         int64_t currState = mutex->state.load();
         // ========== Do spinning ============
         if (!IsStarving(currState) &&
             IsLocked(currState) &&
-            trySpinCount < SPIN_THRESHOLD &&
-            ProcessorCanSpin()) {
+            trySpinCount < spinBudget &&
+            ProcessorCanSpin() &&
+            MutexOwnerRunning(mutex)) {
             // There are four types of threads:
             //   - Owner thread (at most one)
             //   - Newcoming thread
@@ -273,6 +402,10 @@ static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
 #if defined(CANGJIE_TSAN_SUPPORT)
             Sanitizer::TsanAcquire(reinterpret_cast<void*>(mutex));
 #endif
+            if (trySpinCount > 0) {
+                MutexSpinLearn(mutex, trySpinCount);
+            }
+            MutexAcquired(mutex, waitStart);
             return true;
         }
 
@@ -280,6 +413,10 @@ static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
         // If the current thread has already waited,
         // it will be pushed at the front of the queue.
         bool isPushToHead = firstWaitTime != 0;
+        // Spinning did not outlast the hold time. A spin cut short by a parked owner says nothing of it.
+        if (trySpinCount >= spinBudget) {
+            MutexSpinLearn(mutex, 0);
+        }
         if (firstWaitTime == 0) {
             firstWaitTime = TimeUtil::MicroSeconds();
         }
@@ -287,51 +424,7 @@ static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
         MRT_SemAcquire(&mutex->sema, isPushToHead);
         Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
 
-        // ========== After wake up ==============
-        // If waiting too long, the current thread becomes starved
-        isStarved = isStarved || (TimeUtil::MicroSeconds() - firstWaitTime) > STARVING_THRESHOLD;
-        // Read the new state
-        currState = mutex->state.load();
-        if (!IsStarving(currState)) {
-            // Retry to acquire the mutex; also, spinning restarts
-            trySpinCount = 0;
-            // Since The spinning flag is always set by `unlock`,
-            // we should set the variable as well.
-            hasSetSpinFlag = true;
-            continue; // Waked up; restart
-        }
-        // Mutex is in starvation mode.
-        // When the current thread was woken up, ownership was handed off to it directly.
-        // There are some invariants:
-        //  - only ONE thread can be woken up and reach here,
-        //  - mutex cannot be spinning,
-        //  - `LOCKED` is not set, and
-        //  - #waiters must be positive because `unlock` will not change it under starvation.
-        bool valid = !IsLocked(currState) && !IsSpinning(currState) && GetWaiters(currState) > 0;
-        MRT_ASSERT(valid, "Sync error: inconsistent mutex state!\n");
-        if (!valid) {
-            LOG(RTLOG_ERROR, "Sync error: inconsistent mutex state!\n");
-            return false;
-        }
-        // So, the inconsistent state should be fixed here.
-        // A trick to use a single statement to fix all states.
-        // Fix as: state + LOCKED - WAITER_UNIT
-        int64_t delta = LOCKED - WAITER_UNIT;
-        // Exit starvation if a non-starved thread is wakeup, or there are no waiters.
-        if (!isStarved || GetWaiters(currState) == 1) {
-            // Fix as: state + LOCKED - WAITER_UNIT - STARVING
-            delta -= STARVING;
-        }
-        mutex->state.fetch_add(delta);
-        MRT_ASSERT(mutex->ownerThreadId.load(std::memory_order_acquire) == INVALID_THREAD_ID,
-                   "Sync error: invalid mutex owner\n");
-        MRT_ASSERT(mutex->ownCount == 0, "Sync error: invalid mutex owning count\n");
-        mutex->ownCount = count;
-        mutex->ownerThreadId.store(currThreadId, std::memory_order_release);
-#if defined(CANGJIE_TSAN_SUPPORT)
-            Sanitizer::TsanAcquire(reinterpret_cast<void*>(mutex));
-#endif
-        return true;
+        isWoken = true;
     }
     return false; // Unreachable
 }
@@ -427,8 +520,9 @@ bool MCC_MutexCheckStatus(const void* ptr)
  * In Cangjie program, `checkStatus` must be called before this function.
  * @param ptr: raw pointer of a `CJMutex`.
  * @param count: number of acquision to release the mutex.
+ * @return whether the mutex is released.
  */
-static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
+static bool MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
 {
     CJMutex* mutex = CastToT<CJMutex*>(ptr);
     MRT_ASSERT(IsLocked(mutex->state.load()), "Sync error: unlock an unlocked mutex");
@@ -437,7 +531,7 @@ static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
     mutex->ownCount -= count;
     if (oldOwnCount > count) {
         // Still hold the mutex
-        return;
+        return false;
     }
     MRT_ASSERT(oldOwnCount == count, "Incorrect mutex state");
     // Release the mutex
@@ -449,7 +543,7 @@ static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
     MRT_ASSERT(IsLocked(currState), "Sync error: unlock an unlocked mutex");
     currState -= LOCKED; // Clear the locked bit
     if (currState == 0) {
-        return;
+        return true;
     }
     if (IsStarving(currState)) {
         // Starving mode: handoff mutex ownership to the next waiter.
@@ -458,14 +552,14 @@ static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
         // so, new coming threads will not acquire it.
         // Note 2: #waiters is not decreased.
         MRT_SemRelease(&mutex->sema);
-        return;
+        return true;
     }
     for (;;) {
         // If there are no waiters, or a thread has already been woken or held the lock,
         // there is no need to wake anyone.
         if (GetWaiters(currState) == 0 || IsLocked(currState) ||
             IsSpinning(currState) || IsStarving(currState)) {
-            return;
+            return true;
         }
         // Wake up a thread and make it as the spinning thread.
         int64_t newState = (currState - WAITER_UNIT) | SPINNING;
@@ -476,13 +570,19 @@ static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
             // because no threads except the waked one can reset the spinning state.
             // Thus, mutex will not be starved until the following `release` is done.
             MRT_SemRelease(&mutex->sema);
-            return;
+            return true;
         }
         currState = mutex->state.load();
     }
 }
 
-void MCC_MutexUnlock(const void* ptr) { MRT_MutexUnlockImpl(ptr, 1); }
+void MCC_MutexUnlock(const void* ptr)
+{
+    // A cjthread woken while the mutex was held can take it over now.
+    if (MRT_MutexUnlockImpl(ptr, 1)) {
+        MRT_WakeHandoff();
+    }
+}
 
 // =====================================================
 // Following functions are used to implement monitors.
@@ -498,7 +598,7 @@ static void MRT_MutexFullyLock(void* ptr, uint64_t count) { MCC_MutexLockImpl(pt
 static bool MRT_MutexFullyUnlock(void* ptr)
 {
     CJMutex* mutex = CastToT<CJMutex*>(ptr);
-    MRT_MutexUnlockImpl(ptr, mutex->ownCount);
+    (void)MRT_MutexUnlockImpl(ptr, mutex->ownCount);
     return false;
 }
 
@@ -535,9 +635,14 @@ bool MonitorWait(CJMutex* mutex, void* wq, int64_t timeout)
     Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     uint64_t ownCount = mutex->ownCount;
     // 2. Release and wait
-    bool wakeStatus = MRT_SuspendWithTimeout(wq, MRT_MutexFullyUnlock, mutex, timeout);
-    // 3. Hold the mutex again
-    MRT_MutexFullyLock(mutex, ownCount);
+    bool requeued = false;
+    bool wakeStatus = MRT_SuspendRequeueable(wq, MRT_MutexFullyUnlock, mutex, timeout, &requeued);
+    // 3. Hold the mutex again. A thread requeued by `notifyAll` is already one of its waiters.
+    if (requeued) {
+        MCC_MutexLockSlowPathImpl(mutex, ownCount, true);
+    } else {
+        MRT_MutexFullyLock(mutex, ownCount);
+    }
     Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     if (wakeStatus) {
         // Notified by other threads
@@ -579,14 +684,37 @@ void MCC_MonitorNotify(const void* ptr)
         &CastToT<CJMonitor*>(ptr)->wq, [](void*) { return false; }, NULL);
 }
 
+/**
+ * @brief Count a thread moved from a monitor to the sema of `ptr` as a waiter of the mutex.
+ * Called with both wait queues locked. If the mutex is free, no `unlock` would wake the thread,
+ * so it is woken up at once.
+ * @param ptr: raw pointer of a `CJMutex`.
+ * @return true if the thread is requeued.
+ */
+static bool MutexRequeueWaiter(void* ptr)
+{
+    CJMutex* mutex = CastToT<CJMutex*>(ptr);
+    int64_t currState = mutex->state.load();
+    for (;;) {
+        if (!IsLocked(currState) && !IsStarving(currState)) {
+            return false;
+        }
+        if (mutex->state.compare_exchange_weak(currState, currState + WAITER_UNIT)) {
+            return true;
+        }
+    }
+}
+
 /**
  * @brief Notify all thread blocked on the wait queue.
+ * Rather than waking them up to contend for the mutex the caller holds, they are moved to the
+ * wait queue of the mutex, and `unlock` wakes them up one by one.
  * In Cangjie program, `checkStatus` must be called before this function.
  */
 void MCC_MonitorNotifyAll(const void* ptr)
 {
-    MRT_ResumeAll(
-        &CastToT<CJMonitor*>(ptr)->wq, [](void*) { return false; }, NULL);
+    CJMonitor* monitor = CastToT<CJMonitor*>(ptr);
+    MRT_RequeueToSem(&monitor->wq, &monitor->mutexPtr->sema, MutexRequeueWaiter, monitor->mutexPtr);
 }
 
 bool MCC_MultiConditionMonitorWait(const void* ptr, void* waitQueuePtr, int64_t timeout)
@@ -612,13 +740,269 @@ void MCC_MultiConditionMonitorNotify(const void* ptr __attribute__((unused)), co
 }
 
 /**
- * @brief Notify all thread blocked on the wait queue.
+ * @brief Notify all thread blocked on the wait queue, see `MCC_MonitorNotifyAll`.
  * In Cangjie program, `checkStatus` must be called before this function.
  */
-void MCC_MultiConditionMonitorNotifyAll(const void* ptr __attribute__((unused)), const void* waitQueuePtr)
+void MCC_MultiConditionMonitorNotifyAll(const void* ptr, const void* waitQueuePtr)
 {
-    MRT_ResumeAll(
-        &CastToT<CJWaitQueue*>(waitQueuePtr)->wq, [](void*) { return false; }, NULL);
+    CJMutex* mutex = CastToT<CJMultiConditionMonitor*>(ptr)->mutexPtr;
+    MRT_RequeueToSem(&CastToT<CJWaitQueue*>(waitQueuePtr)->wq, &mutex->sema, MutexRequeueWaiter, mutex);
+}
+
+// Readers are counted below it, so a pending writer makes `readerCount` negative.
+const int32_t RWLOCK_MAX_READERS = 1 << 30;
+const uint32_t RWLOCK_BR_SLOT_MAX = 64;
+
+void* MRT_RWLockNew(bool bigReader)
+{
+    RWLock* lock = new (std::nothrow) RWLock();
+    if (lock == nullptr) {
+        return nullptr;
+    }
+    lock->readerCount.store(0, std::memory_order_relaxed);
+    lock->readerWait.store(0, std::memory_order_relaxed);
+    lock->bigReader = bigReader;
+    lock->brWriter.store(false, std::memory_order_relaxed);
+    lock->slotMask = 0;
+    lock->slots = nullptr;
+    if (SemaNew(&lock->writerMutex, 1) != 0 || SemaNew(&lock->writerSem, 0) != 0 ||
+        SemaNew(&lock->readerSem, 0) != 0) {
+        delete lock;
+        return nullptr;
+    }
+    if (!bigReader) {
+        return lock;
+    }
+    // One slot per CPU, rounded up to a power of 2. Processors beyond them share slots.
+    uint32_t slotNum = 1;
+    uint32_t cpus = std::thread::hardware_concurrency();
+    while (slotNum < cpus && slotNum < RWLOCK_BR_SLOT_MAX) {
+        slotNum <<= 1;
+    }
+    lock->slots = new (std::nothrow) RWLockSlot[slotNum];
+    if (lock->slots == nullptr || WaitqueueNew(&lock->brReaderQueue) != 0 ||
+        WaitqueueNew(&lock->brWriterQueue) != 0) {
+        delete[] lock->slots;
+        delete lock;
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < slotNum; ++i) {
+        lock->slots[i].readers.store(0, std::memory_order_relaxed);
+    }
+    lock->slotMask = slotNum - 1;
+    return lock;
+}
+
+void MRT_RWLockDelete(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    if (lock == nullptr) {
+        return;
+    }
+    (void)SemaDelete(&lock->writerMutex);
+    (void)SemaDelete(&lock->writerSem);
+    (void)SemaDelete(&lock->readerSem);
+    if (lock->bigReader) {
+        (void)WaitqueueDelete(&lock->brReaderQueue);
+        (void)WaitqueueDelete(&lock->brWriterQueue);
+        delete[] lock->slots;
+    }
+    delete lock;
+}
+
+// The slot of the processor of the current thread. Threads without a processor are hashed by id.
+static RWLockSlot* RWLockSlotGet(RWLock* lock)
+{
+    unsigned int slot = ProcessorSlotGet();
+    if (slot == 0) {
+        slot = static_cast<unsigned int>(MRT_GetCurrentThreadID());
+    }
+    return &lock->slots[slot & lock->slotMask];
+}
+
+// Callbacks of the big reader queues, checked under the lock of the queue. A waiter parks only
+// if they return false, and the threads it waits for change the state before they wake the queue.
+static bool RWLockBrWriterGone(void* ptr)
+{
+    return !CastToT<RWLock*>(ptr)->brWriter.load();
+}
+
+static bool RWLockBrReadersGone(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    int64_t readers = 0;
+    for (uint32_t i = 0; i <= lock->slotMask; ++i) {
+        readers += lock->slots[i].readers.load();
+    }
+    return readers == 0;
+}
+
+static void RWLockBrReadLeave(RWLock* lock)
+{
+    RWLockSlotGet(lock)->readers.fetch_sub(1);
+    // Pairs with the store of `brWriter` before the writer sums the slots.
+    if (lock->brWriter.load()) {
+        (void)WaitqueueWakeOne(&lock->brWriterQueue, nullptr, nullptr);
+    }
+}
+
+static bool RWLockBrReadTryLock(RWLock* lock)
+{
+    RWLockSlotGet(lock)->readers.fetch_add(1);
+    if (!lock->brWriter.load()) {
+        return true;
+    }
+    RWLockBrReadLeave(lock);
+    return false;
+}
+
+void MRT_RWLockReadLock(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    if (lock->bigReader) {
+        while (!RWLockBrReadTryLock(lock)) {
+            (void)WaitqueuePark(&lock->brReaderQueue, LLONG_MAX, RWLockBrWriterGone, lock, false);
+        }
+        return;
+    }
+    // A writer holds or waits for the lock, it lets the reader in when it unlocks.
+    if (lock->readerCount.fetch_add(1) + 1 < 0) {
+        MRT_SemAcquire(&lock->readerSem, false);
+    }
+}
+
+bool MRT_RWLockReadTryLock(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    if (lock->bigReader) {
+        return RWLockBrReadTryLock(lock);
+    }
+    int32_t count = lock->readerCount.load();
+    while (count >= 0) {
+        if (lock->readerCount.compare_exchange_weak(count, count + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Release a read lock. Returns false without changing the lock if it is not read locked.
+ */
+bool MRT_RWLockReadUnlock(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    if (lock->bigReader) {
+        // A reader may leave on another processor than it came on, so only the sum is checked.
+        if (RWLockBrReadersGone(lock)) {
+            return false;
+        }
+        RWLockBrReadLeave(lock);
+        return true;
+    }
+    int32_t count = lock->readerCount.load();
+    do {
+        if (count == 0 || count == -RWLOCK_MAX_READERS) {
+            return false;
+        }
+    } while (!lock->readerCount.compare_exchange_weak(count, count - 1));
+    if (count - 1 >= 0) {
+        return true;
+    }
+    // The last reader the pending writer waits for lets it in.
+    if (lock->readerWait.fetch_sub(1) - 1 == 0) {
+        MRT_SemRelease(&lock->writerSem);
+    }
+    return true;
+}
+
+void MRT_RWLockWriteLock(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    MRT_SemAcquire(&lock->writerMutex, false);
+    if (lock->bigReader) {
+        lock->brWriter.store(true);
+        while (!RWLockBrReadersGone(lock)) {
+            (void)WaitqueuePark(&lock->brWriterQueue, LLONG_MAX, RWLockBrReadersGone, lock, false);
+        }
+        return;
+    }
+    // New readers wait from now on. Wait for those already in.
+    int32_t readers = lock->readerCount.fetch_sub(RWLOCK_MAX_READERS);
+    if (readers != 0 && lock->readerWait.fetch_add(readers) + readers != 0) {
+        MRT_SemAcquire(&lock->writerSem, false);
+    }
+}
+
+bool MRT_RWLockWriteTryLock(void* ptr)
+{
+    RWLock* lock = CastToT<RWLock*>(ptr);
+    if (!SemaTryAcquire(&lock->writerMutex)) {
+        return false;
+    }
+    if (lock->bigReader) {
+        lock->brWriter.store(true);
+        if (RWLockBrReadersGone(lock)) {
+            return true;
+        }
+        lock->brWriter.store(false);
+        (void)WaitqueueWakeAll(&lock->brReaderQueue, nullptr, nullptr);
+        MRT_SemRelease(&lock->writerMutex);
+        return false;
+    }
+    int32_t expected = 0;
+    if (lock->readerCount.compare_exchange_strong(expected, -RWLOCK_MAX_READERS)) {
+        return true;
+    }
+    MRT_SemRelease(&lock->writerMutex);
+    return false;
+}
+
+// Release the writer, and count the caller as a reader if `keepRead` is set. Returns false without
+// changing the lock if it is not write locked.
+static bool RWLockWriteRelease(RWLock* lock, bool keepRead)
+{
+    if (lock->bigReader) {
+        if (!lock->brWriter.load()) {
+            return false;
+        }
+        if (keepRead) {
+            RWLockSlotGet(lock)->readers.fetch_add(1);
+        }
+        lock->brWriter.store(false);
+        (void)WaitqueueWakeAll(&lock->brReaderQueue, nullptr, nullptr);
+        MRT_SemRelease(&lock->writerMutex);
+        return true;
+    }
+    // Only the writer makes the count negative, and it stays so until the writer releases it.
+    if (lock->readerCount.load() >= 0) {
+        return false;
+    }
+    int32_t self = keepRead ? 1 : 0;
+    // Readers that came while the writer held the lock are let in before the next writer.
+    int32_t readers = lock->readerCount.fetch_add(RWLOCK_MAX_READERS + self) + RWLOCK_MAX_READERS;
+    for (int32_t i = 0; i < readers; ++i) {
+        MRT_SemRelease(&lock->readerSem);
+    }
+    MRT_SemRelease(&lock->writerMutex);
+    return true;
+}
+
+/**
+ * @brief Release the write lock. Returns false without changing the lock if it is not write locked.
+ */
+bool MRT_RWLockWriteUnlock(void* ptr)
+{
+    return RWLockWriteRelease(CastToT<RWLock*>(ptr), false);
+}
+
+/**
+ * @brief Turn the write lock held by the current thread into a read lock, without letting another
+ * writer in between.
+ */
+bool MRT_RWLockDowngrade(void* ptr)
+{
+    return RWLockWriteRelease(CastToT<RWLock*>(ptr), true);
 }
 
 bool MCC_IsThreadObjectInited()
@@ -699,6 +1083,44 @@ void MRT_ThreadWait()
 {
     CJThreadWait();
 }
+
+/**
+ * @brief Set the sampling rate of the mutex contention profile.
+ * @param rate: one in `rate` contentions is recorded on average, 0 turns the profile off.
+ * @return the previous rate.
+ */
+int64_t MRT_SetMutexProfileRate(int64_t rate)
+{
+    return MutexProfiler::GetInstance().SetRate(rate);
+}
+
+/**
+ * @brief Write the mutex contention profile to `fd` in the text format of the pprof "mutex" profile.
+ */
+bool MRT_DumpMutexProfile(int fd)
+{
+    return MutexProfiler::GetInstance().Dump(fd);
+}
+
+/**
+ * @brief Set the threshold of the off-cpu profiles.
+ * @param thresholdNs: cjthreads off cpu for at least `thresholdNs` are recorded, a negative value
+ * turns the profiles off.
+ * @return the previous threshold.
+ */
+int64_t MRT_SetOffCpuProfileThreshold(int64_t thresholdNs)
+{
+    return OffCpuProfiler::GetInstance().SetThreshold(thresholdNs);
+}
+
+/**
+ * @brief Write an off-cpu profile to `fd` as a gzip'd pprof profile.
+ * @param kind: 0 for the "mutex" profile, 1 for "block" and 2 for "io".
+ */
+bool MRT_DumpOffCpuProfile(int fd, int32_t kind)
+{
+    return OffCpuProfiler::GetInstance().Dump(fd, static_cast<OffCpuProfileKind>(kind));
+}
 #ifdef __APPLE__
 #include "MacAlias.h"
 #else
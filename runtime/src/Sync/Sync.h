@@ -50,6 +50,9 @@ struct CJMutex {
     uint64_t ownCount;
     std::atomic<int64_t> state; // includes waiter couter, locked, starve, spin
     bool isSemaInit;
+    // Spinning hints, kept in the padding before `sema` so that the object size does not change.
+    std::atomic<uint8_t> spinLearn;   // spin rounds that recently ended with the mutex acquired
+    std::atomic<uint16_t> ownerSlot;  // processor slot of the owner, see `ProcessorSlotGet`
     Sema sema;
 };
 
@@ -72,6 +75,32 @@ struct CJWaitQueue {
     Waitqueue wq;
 };
 
+// Readers of a big reader lock count themselves in the slot of their processor.
+struct RWLockSlot {
+    static constexpr size_t CACHE_LINE_ALIGN = 64; // for most hardware platforms
+    std::atomic<int64_t> readers; // may go negative, a reader can unlock on another processor
+    char padding[CACHE_LINE_ALIGN - sizeof(std::atomic<int64_t>)];
+};
+
+// Native reader-writer lock that prefers writers. It is not reentrant, std.sync counts reentrant
+// acquisitions itself and only takes it once per thread.
+struct RWLock {
+    // Readers holding or waiting for the lock. A writer takes RWLOCK_MAX_READERS off it while it
+    // holds or waits for the lock, so that a reader sees it with the single add that counts it.
+    std::atomic<int32_t> readerCount;
+    std::atomic<int32_t> readerWait; // readers the pending writer waits for
+    Sema writerMutex;                // serializes the writers, 1 while no writer holds or waits
+    Sema writerSem;                  // the pending writer waits on it for the readers to leave
+    Sema readerSem;                  // readers wait on it for the writer to leave
+    // Big reader lock: readers add to `slots` instead of `readerCount`, and writers sum the slots.
+    bool bigReader;
+    std::atomic<bool> brWriter;      // a writer holds the lock or waits for the readers to leave
+    uint32_t slotMask;
+    RWLockSlot* slots;
+    Waitqueue brReaderQueue;
+    Waitqueue brWriterQueue;
+};
+
 struct CJMultiConditionMonitor {
     void* klass;
 #ifdef __arm__
@@ -110,6 +139,19 @@ void* MRT_GetCurrentCJThread();
 void MRT_ThreadWait();
 void MRT_ThreadResumeAndWait(void* handle);
 void MRT_ThreadReady(void* handle);
+int64_t MRT_SetMutexProfileRate(int64_t rate);
+bool MRT_DumpMutexProfile(int fd);
+int64_t MRT_SetOffCpuProfileThreshold(int64_t thresholdNs);
+bool MRT_DumpOffCpuProfile(int fd, int32_t kind);
+void* MRT_RWLockNew(bool bigReader);
+void MRT_RWLockDelete(void* ptr);
+void MRT_RWLockReadLock(void* ptr);
+bool MRT_RWLockReadTryLock(void* ptr);
+bool MRT_RWLockReadUnlock(void* ptr);
+void MRT_RWLockWriteLock(void* ptr);
+bool MRT_RWLockWriteTryLock(void* ptr);
+bool MRT_RWLockWriteUnlock(void* ptr);
+bool MRT_RWLockDowngrade(void* ptr);
 #ifdef __cplusplus
 };
 #endif
@@ -250,6 +250,7 @@ make_cangjie_lib(
         std-core
         std-io
         std-time
+        std-sync
         std-collection
     CANGJIE_STD_LIB_INDIRECT_DEPENDS
         std-math
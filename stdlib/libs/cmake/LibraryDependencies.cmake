@@ -89,6 +89,7 @@ set(FS_DEPENDENCIES
     cangjie${BACKEND_TYPE}Core
     cangjie${BACKEND_TYPE}Io
     cangjie${BACKEND_TYPE}Time
+    cangjie${BACKEND_TYPE}Sync
     cangjie${BACKEND_TYPE}Collection)
 
 set(CONSOLE_DEPENDENCIES
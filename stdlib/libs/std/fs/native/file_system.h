@@ -41,6 +41,13 @@
 #define CJ_APPEND 2
 #define CJ_RDWT 3
 
+#define CJ_ADVICE_NORMAL 0
+#define CJ_ADVICE_SEQUENTIAL 1
+#define CJ_ADVICE_RANDOM 2
+#define CJ_ADVICE_WILLNEED 3
+#define CJ_ADVICE_DONTNEED 4
+#define CJ_ADVICE_HUGEPAGE 5
+
 #include <assert.h>
 #include <dirent.h>
 #include <errno.h>
@@ -72,6 +79,14 @@
 #define SLASH (char)'/'
 #endif // defined(_WIN32) && defined(__MINGW64__)
 
+/*
+ * Provided by the runtime. File reads and writes go through its file I/O engine, which parks
+ * the current cjthread instead of blocking its processor. Both return -errno on failure, and an
+ * offset of -1 means the current file position.
+ */
+extern long long CJ_FileioRead(int fd, void* buf, size_t len, long long offset);
+extern long long CJ_FileioWrite(int fd, const void* buf, size_t len, long long offset);
+
 typedef struct {
     int64_t rtnCode;
     char* msg;
@@ -7,6 +7,8 @@
  */
 
 #include <limits.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include "file_system.h"
 #include <string.h>
@@ -768,7 +770,12 @@ extern int64_t CJ_FS_CloseFile(intptr_t fd)
  */
 extern int64_t CJ_FS_FileRead(intptr_t fd, char* buffer, size_t maxLen)
 {
-    return (int64_t)read((int32_t)fd, (char*)buffer, maxLen);
+    long long ret = CJ_FileioRead((int32_t)fd, buffer, maxLen, -1);
+    if (ret < 0) {
+        errno = (int)-ret;
+        return -1;
+    }
+    return (int64_t)ret;
 }
 
 extern bool CJ_FS_FileWrite(intptr_t fd, const char* buffer, size_t maxLen)
@@ -776,8 +783,11 @@ extern bool CJ_FS_FileWrite(intptr_t fd, const char* buffer, size_t maxLen)
     const char* ptr = buffer;
     size_t remainingLen = maxLen;
     while (remainingLen > 0) {
-        ssize_t writeSize = write((int32_t)fd, (char*)ptr, remainingLen);
+        long long writeSize = CJ_FileioWrite((int32_t)fd, ptr, remainingLen, -1);
         if (writeSize <= 0) {
+            if (writeSize < 0) {
+                errno = (int)-writeSize;
+            }
             break;
         }
         remainingLen -= (size_t)writeSize;
@@ -886,3 +896,123 @@ extern FsError* CJ_FS_Truncate(int32_t fd, int64_t length)
     }
     return GetDefaultResult();
 }
+
+extern int64_t CJ_FS_PageSize(void)
+{
+    return (int64_t)sysconf(_SC_PAGESIZE);
+}
+
+/*
+ * Mapping offsets must be aligned to this value.
+ */
+extern int64_t CJ_FS_MapGranularity(void)
+{
+    return (int64_t)sysconf(_SC_PAGESIZE);
+}
+
+/*
+ * Map `length` bytes of the file from `offset`, which must be aligned to CJ_FS_MapGranularity.
+ * The mapping is shared, so writes reach the file and stay visible after the descriptor is closed.
+ * Returns NULL on failure and errno is kept.
+ */
+extern void* CJ_FS_MapFile(intptr_t fd, int64_t offset, int64_t length, bool writable)
+{
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* addr = mmap(NULL, (size_t)length, prot, MAP_SHARED, (int32_t)fd, (off_t)offset);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    return addr;
+}
+
+extern int32_t CJ_FS_UnmapFile(void* addr, int64_t length)
+{
+    return munmap(addr, (size_t)length) == 0 ? 0 : errno;
+}
+
+extern int32_t CJ_FS_SyncMappedFile(void* addr, int64_t length, bool async)
+{
+    int ret;
+    do {
+        ret = msync(addr, (size_t)length, async ? MS_ASYNC : MS_SYNC);
+    } while (ret != 0 && errno == EINTR);
+    return ret == 0 ? 0 : errno;
+}
+
+/*
+ * Returns 0 if the kernel accepted the advice, otherwise the errno. EINVAL is returned for
+ * advice that the platform does not support.
+ */
+extern int32_t CJ_FS_AdviseMappedFile(void* addr, int64_t length, int32_t advice)
+{
+    int madv;
+    switch (advice) {
+        case CJ_ADVICE_NORMAL:
+            madv = MADV_NORMAL;
+            break;
+        case CJ_ADVICE_SEQUENTIAL:
+            madv = MADV_SEQUENTIAL;
+            break;
+        case CJ_ADVICE_RANDOM:
+            madv = MADV_RANDOM;
+            break;
+        case CJ_ADVICE_WILLNEED:
+            madv = MADV_WILLNEED;
+            break;
+        case CJ_ADVICE_DONTNEED:
+            madv = MADV_DONTNEED;
+            break;
+#ifdef MADV_HUGEPAGE
+        case CJ_ADVICE_HUGEPAGE:
+            madv = MADV_HUGEPAGE;
+            break;
+#endif
+        default:
+            return EINVAL;
+    }
+    return madvise(addr, (size_t)length, madv) == 0 ? 0 : errno;
+}
+
+/*
+ * Count the pages of the mapping that are resident in memory. Returns -1 on failure.
+ */
+extern int64_t CJ_FS_MappedResidentPages(void* addr, int64_t length)
+{
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t pages = ((size_t)length + pageSize - 1) / pageSize;
+    if (pages == 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    char* vec = (char*)malloc(pages);
+#else
+    unsigned char* vec = (unsigned char*)malloc(pages);
+#endif
+    if (vec == NULL) {
+        return -1;
+    }
+    if (mincore(addr, (size_t)length, vec) != 0) {
+        free(vec);
+        return -1;
+    }
+    int64_t resident = 0;
+    for (size_t i = 0; i < pages; ++i) {
+        resident += vec[i] & 1;
+    }
+    free(vec);
+    return resident;
+}
+
+/*
+ * Page faults of the whole process so far. Returns 0 on success, otherwise the errno.
+ */
+extern int32_t CJ_FS_PageFaultsGet(int64_t* minorFaults, int64_t* majorFaults)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return errno;
+    }
+    *minorFaults = (int64_t)usage.ru_minflt;
+    *majorFaults = (int64_t)usage.ru_majflt;
+    return 0;
+}
@@ -1363,4 +1363,76 @@ extern FsError* CJ_FS_Truncate(HANDLE hFile, int64_t length)
     }
 
     return GetDefaultResult();
-}
\ No newline at end of file
+}
+extern int64_t CJ_FS_PageSize(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int64_t)info.dwPageSize;
+}
+
+/*
+ * Mapping offsets must be aligned to the allocation granularity on Windows, not the page size.
+ */
+extern int64_t CJ_FS_MapGranularity(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int64_t)info.dwAllocationGranularity;
+}
+
+extern void* CJ_FS_MapFile(HANDLE fd, int64_t offset, int64_t length, bool writable)
+{
+    LARGE_INTEGER off;
+    off.QuadPart = offset;
+    HANDLE mapping = CreateFileMappingW(fd, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        errno = EACCES;
+        return NULL;
+    }
+    void* addr = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, (DWORD)off.HighPart,
+        off.LowPart, (SIZE_T)length);
+    // The view keeps the mapping object alive.
+    CloseHandle(mapping);
+    if (addr == NULL) {
+        errno = EINVAL;
+    }
+    return addr;
+}
+
+extern int32_t CJ_FS_UnmapFile(void* addr, int64_t length)
+{
+    (void)length;
+    return UnmapViewOfFile(addr) ? 0 : EINVAL;
+}
+
+extern int32_t CJ_FS_SyncMappedFile(void* addr, int64_t length, bool async)
+{
+    (void)async;
+    return FlushViewOfFile(addr, (SIZE_T)length) ? 0 : EIO;
+}
+
+/*
+ * madvise has no Windows counterpart, the advice is not applied.
+ */
+extern int32_t CJ_FS_AdviseMappedFile(void* addr, int64_t length, int32_t advice)
+{
+    (void)addr;
+    (void)length;
+    (void)advice;
+    return EINVAL;
+}
+
+extern int64_t CJ_FS_MappedResidentPages(void* addr, int64_t length)
+{
+    (void)addr;
+    (void)length;
+    return -1;
+}
+
+extern int32_t CJ_FS_PageFaultsGet(int64_t* minorFaults, int64_t* majorFaults)
+{
+    (void)minorFaults;
+    (void)majorFaults;
+    return ENOSYS;
+}
@@ -15,6 +15,10 @@
 
 #include "securec.h"
 
+/* Provided by the runtime, hands off the processor of the current cjthread around blocking calls. */
+extern void CJ_SyscallBlockingRegionEnter(void);
+extern void CJ_SyscallBlockingRegionExit(void);
+
 extern int32_t CJ_OS_Close(int32_t fd)
 {
     return close(fd);
@@ -37,12 +41,18 @@ extern int32_t CJ_OS_Dup2(int32_t oldfd, int32_t newfd)
 
 extern ssize_t CJ_OS_Read(int32_t fd, uint8_t* buf, size_t count)
 {
-    return read(fd, buf, count);
+    CJ_SyscallBlockingRegionEnter();
+    ssize_t ret = read(fd, buf, count);
+    CJ_SyscallBlockingRegionExit();
+    return ret;
 }
 
 extern ssize_t CJ_OS_Write(int32_t fd, uint8_t* buf, size_t count)
 {
-    return write(fd, buf, count);
+    CJ_SyscallBlockingRegionEnter();
+    ssize_t ret = write(fd, buf, count);
+    CJ_SyscallBlockingRegionExit();
+    return ret;
 }
 
 extern uint32_t CJ_OS_Umask(uint32_t mask)
@@ -68,12 +78,18 @@ extern char* CJ_OS_Getlogin(void)
 #if defined(__linux__) || defined(__APPLE__) || defined(__ohos__) || defined(__ANDROID__)
 extern ssize_t CJ_OS_Pread(int32_t fd, uint8_t* buf, size_t count, int32_t offset)
 {
-    return pread(fd, buf, count, offset);
+    CJ_SyscallBlockingRegionEnter();
+    ssize_t ret = pread(fd, buf, count, offset);
+    CJ_SyscallBlockingRegionExit();
+    return ret;
 }
 
 extern ssize_t CJ_OS_Pwrite(int32_t fd, uint8_t* buf, size_t count, int32_t offset)
 {
-    return pwrite(fd, buf, count, offset);
+    CJ_SyscallBlockingRegionEnter();
+    ssize_t ret = pwrite(fd, buf, count, offset);
+    CJ_SyscallBlockingRegionExit();
+    return ret;
 }
 #endif
 
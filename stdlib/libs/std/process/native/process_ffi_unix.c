@@ -81,7 +81,10 @@ static char* GetErrMessage(int32_t errCode)
 
 extern int64_t CJ_OS_FileRead(int32_t fd, char* buffer, size_t maxLen)
 {
-    return (int64_t)read(fd, (char*)buffer, maxLen);
+    CJ_SyscallBlockingRegionEnter();
+    int64_t ret = (int64_t)read(fd, (char*)buffer, maxLen);
+    CJ_SyscallBlockingRegionExit();
+    return ret;
 }
 
 extern bool CJ_OS_FileWrite(int32_t fd, const char* buffer, size_t maxLen)
@@ -460,16 +463,20 @@ extern int64_t CJ_OS_WaitSubProcessExit(int32_t pid)
 {
     errno = 0;
     int status;
+    CJ_SyscallBlockingRegionEnter();
     while (waitpid(pid, &status, 0) < 0) {
         switch (errno) {
             case ECHILD:
+                CJ_SyscallBlockingRegionExit();
                 return -1; // No child process
             case EINTR:
                 break;
             default:
+                CJ_SyscallBlockingRegionExit();
                 return -1; // Unknown error
         }
     }
+    CJ_SyscallBlockingRegionExit();
 
     if (WIFEXITED(status)) {
         return WEXITSTATUS(status);
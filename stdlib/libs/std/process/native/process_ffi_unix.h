@@ -17,6 +17,10 @@
 extern "C" {
 #endif
 
+/* Provided by the runtime, hands off the processor of the current cjthread around blocking calls. */
+extern void CJ_SyscallBlockingRegionEnter(void);
+extern void CJ_SyscallBlockingRegionExit(void);
+
 void FreeTwoDimensionalArray(char** strArray);
 char** GetCurrentProcessEnvironment(int32_t pid);
 